@@ -9,6 +9,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "config.h"
+#include "core/peer_table.h"
 
 // =============================================================================
 // Protocol Constants
@@ -17,7 +18,18 @@
 #define PROTOCOL_VERSION        1
 #define PACKET_MAGIC            0xWT    // Magic bytes for packet identification
 #define MAX_PACKET_SIZE         256
-#define PACKET_HEADER_SIZE      12
+#define PACKET_HEADER_SIZE      16      // sizeof(packet_header_t)
+
+// חבילות שממתינות לרדיו (כולל זו שבאוויר). מלא = החבילה החדשה נזרקת,
+// כך שההשהיה בתור חסומה ב-DEPTH זמני שידור
+#ifndef PROTOCOL_TX_QUEUE_DEPTH
+#define PROTOCOL_TX_QUEUE_DEPTH 4
+#endif
+
+// TX done שלא הגיע - החבילה נחשבת אבודה והתור ממשיך (SF7: 255 בתים ~400ms)
+#ifndef PROTOCOL_TX_TIMEOUT_MS
+#define PROTOCOL_TX_TIMEOUT_MS  2000
+#endif
 
 // =============================================================================
 // ID Format (מספרים בלבד 0-9)
@@ -55,6 +67,9 @@ typedef enum {
     MSG_VOICE_DATA          = 0x30,     // נתוני קול
     MSG_VOICE_START         = 0x31,     // התחלת שידור קול
     MSG_VOICE_END           = 0x32,     // סיום שידור קול
+    MSG_VOICE_FEC           = 0x33,     // חבילת parity לשחזור קול (FEC)
+    MSG_VOICE_DTX           = 0x34,     // מעבר לשקט (DTX) + פרמטרי SID
+    MSG_VOICE_SILENCE       = 0x35,     // SID תקופתי בזמן שקט
     
     // Control
     MSG_MUTE                = 0x40,     // הודעת השתקה
@@ -81,6 +96,8 @@ typedef struct __attribute__((packed)) {
     uint16_t checksum;                  // CRC16 checksum
 } packet_header_t;
 
+_Static_assert(sizeof(packet_header_t) == PACKET_HEADER_SIZE, "PACKET_HEADER_SIZE out of sync");
+
 // =============================================================================
 // Message Payloads
 // =============================================================================
@@ -113,6 +130,13 @@ typedef struct __attribute__((packed)) {
     char target_id[DEVICE_ID_LENGTH];   // ID של המכשיר הנקרא
 } call_request_t;
 
+// Call Options - מצורף אחרי call_request_t ואחרי ה-ID ב-MSG_CALL_ACCEPT
+// מכשיר ישן שולח בלי השדות האלה, ואז FEC ודחיסת header כבויים
+typedef struct __attribute__((packed)) {
+    uint8_t fec_group_size;             // 0 = ללא FEC, אחרת 2/4/8
+    uint8_t voice_session_id;           // session לחבילות קול דחוסות (0 = ללא)
+} call_options_t;
+
 // Frequency Join Request
 typedef struct __attribute__((packed)) {
     char freq_id[FREQUENCY_ID_LENGTH];
@@ -142,6 +166,16 @@ typedef struct __attribute__((packed)) {
     uint8_t  audio_data[AUDIO_BUFFER_SIZE]; // נתוני אודיו
 } voice_data_t;
 
+// החלק הקבוע של voice_data_t - באוויר נשלחים רק audio_len בתים של אודיו
+#define VOICE_DATA_HEADER_SIZE  (sizeof(voice_data_t) - AUDIO_BUFFER_SIZE)
+
+// SID (Silence Descriptor) - ל-MSG_VOICE_DTX ו-MSG_VOICE_SILENCE
+typedef struct __attribute__((packed)) {
+    uint32_t timestamp;                 // חותמת זמן
+    uint16_t sequence;                  // sequence של ה-frame הקולי האחרון
+    uint16_t noise_level;               // RMS של רעש הרקע (לרעש נוחות)
+} voice_sid_t;
+
 // Member Info (for member list)
 typedef struct __attribute__((packed)) {
     char device_id[DEVICE_ID_LENGTH];
@@ -229,11 +263,36 @@ void protocol_send_freq_invite(const char* target_id, const char* freq_id);
  */
 void protocol_send_voice(const uint8_t* audio_data, uint16_t audio_len);
 
+/**
+ * @brief הגדרת גודל קבוצת FEC מועדף לשיחות הבאות
+ * @param group_size 0 לכיבוי, 2/4/8
+ * @note הערך בפועל נקבע במשא ומתן: המינימום בין שני הצדדים
+ */
+void protocol_set_fec_group_size(uint8_t group_size);
+
+/**
+ * @brief קבלת גודל קבוצת FEC שנקבע לשיחה הנוכחית
+ * @return 0 אם FEC כבוי
+ */
+uint8_t protocol_get_fec_group_size(void);
+
+/**
+ * @brief שליחת SID בזמן שקט (DTX)
+ * @param dtx_start true לחבילה הראשונה בשקט (MSG_VOICE_DTX)
+ * @param noise_level RMS של רעש הרקע
+ */
+void protocol_send_sid(bool dtx_start, uint16_t noise_level);
+
 /**
  * @brief שליחת הודעת סיום שיחה/תדר
  */
 void protocol_send_disconnect(void);
 
+/**
+ * @brief חבילות שנזרקו כי תור השידור היה מלא (הרדיו איטי מהאודיו)
+ */
+uint32_t protocol_get_tx_dropped(void);
+
 /**
  * @brief חישוב CRC16
  * @param data נתונים
@@ -268,5 +327,15 @@ void protocol_set_device_id(const char* device_id);
  */
 const char* protocol_get_device_id(void);
 
+/**
+ * @brief שיוך peer למיקום בגלגלת (PEER_NO_SLOT מבטל)
+ *
+ * הטבלה של שכבת הפרוטוקול ונגישה רק דרכה, תחת ה-mutex שלה:
+ * ה-RX וה-UI משנים אותה ממשימות שונות.
+ *
+ * @return false אם אין מקום בטבלה (או ה-peer לא קיים בביטול)
+ */
+bool protocol_map_peer_slot(uint32_t wire_id, peer_type_t type, int8_t slot);
+
 #endif // COMM_PROTOCOL_H
 
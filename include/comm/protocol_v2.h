@@ -8,6 +8,8 @@
  * - Timestamp ב-header
  * - CRC32 חזק יותר
  * - הפרדה בין control ו-voice channels
+ * - מזהים בינאריים של 4 בתים במקום 8 ספרות ASCII
+ *   (device_id_string_to_wire / device_id_wire_to_string)
  */
 
 #ifndef COMM_PROTOCOL_V2_H
@@ -16,6 +18,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "config.h"
+#include "core/device_id.h"
 
 // =============================================================================
 // Protocol Constants
@@ -127,8 +130,8 @@ typedef struct __attribute__((packed)) {
     uint8_t  flags;                         // Packet flags
     uint16_t sequence;                      // Sequence number
     
-    // === Addressing (8 bytes) ===
-    char     src_id[DEVICE_ID_LENGTH];      // Source device ID
+    // === Addressing (4 bytes) ===
+    uint32_t src_id;                        // Source device ID (wire format)
     
     // === Payload Info (4 bytes) ===
     uint16_t payload_len;                   // Payload length
@@ -162,6 +165,60 @@ typedef struct __attribute__((packed)) {
     uint8_t  audio_data[];                  // נתוני אודיו (flexible array)
 } voice_data_v2_t;
 
+/**
+ * @brief בקשת שיחה
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t target_id;                     // ID של המכשיר הנקרא
+} call_request_v2_t;
+
+/**
+ * @brief בקשת הצטרפות לתדר
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t freq_id;
+    char     password[PASSWORD_MAX_LENGTH]; // ריק אם אין סיסמה
+} freq_join_request_v2_t;
+
+/**
+ * @brief תגובה לבקשת הצטרפות
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t freq_id;
+    uint32_t admin_id;
+    bool     accepted;
+    uint8_t  member_count;
+} freq_join_response_v2_t;
+
+/**
+ * @brief הזמנה לתדר
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t freq_id;
+    uint32_t inviter_id;
+    char     inviter_name[16];
+} freq_invite_v2_t;
+
+/**
+ * @brief פרטי משתתף ברשימת חברים
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t device_id;
+    char     device_name[16];
+    bool     is_admin;
+    bool     is_muted;
+    int8_t   signal_strength;
+} member_info_v2_t;
+
+/**
+ * @brief SID - פרמטרי רעש נוחות (MSG_V2_VOICE_DTX / MSG_V2_VOICE_SILENCE)
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t timestamp;                     // חותמת זמן
+    uint16_t sequence;                      // sequence של ה-frame האחרון
+    uint16_t noise_level;                   // RMS של רעש הרקע
+} voice_sid_v2_t;
+
 /**
  * @brief דיווח איכות רשת
  */
@@ -242,7 +299,7 @@ void protocol_v2_build_header(
     uint8_t msg_type,
     uint8_t channel,
     uint8_t flags,
-    const char* src_id,
+    uint32_t src_id,
     uint16_t payload_len
 );
 
@@ -253,7 +310,7 @@ uint16_t protocol_v2_build_packet(
     message_type_v2_t msg_type,
     uint8_t channel,
     uint8_t flags,
-    const char* src_id,
+    uint32_t src_id,
     const void* payload,
     uint16_t payload_len,
     uint8_t* out_buffer
@@ -185,6 +185,14 @@ void radio_set_spreading_factor(uint8_t sf);
  */
 bool radio_send(const uint8_t* data, uint8_t length);
 
+/**
+ * @brief זמן באוויר של חבילה בתצורה הנוכחית (Semtech AN1200.13)
+ * @param length אורך ה-payload בבתים
+ * @return מיקרו-שניות מתחילת ה-preamble עד TX done
+ * @note SF7/125kHz/CR4/5: חבילה של 255 בתים ~400ms (~5kbps)
+ */
+uint32_t radio_get_airtime_us(uint8_t length);
+
 /**
  * @brief שליחת חבילה עם המתנה לסיום
  * @param data נתונים לשליחה
@@ -285,5 +293,26 @@ void radio_sleep(void);
  */
 void radio_wake(void);
 
+// =============================================================================
+// Simulator
+// =============================================================================
+
+#ifndef ESP32
+/**
+ * @brief "האוויר" של הסימולטור - מקבל כל חבילה ש-radio_send שולח
+ */
+typedef void (*sim_radio_air_t)(const uint8_t* data, uint8_t length, void* ctx);
+
+/**
+ * @brief חיבור האוויר. ה-TX done מגיע ב-radio_update הבא, כמו בפסיקה
+ */
+void sim_radio_set_air(sim_radio_air_t air, void* ctx);
+
+/**
+ * @brief חבילה שהגיעה מהאוויר - אותו טיפול כמו RX done בפסיקה
+ */
+void sim_radio_receive(const uint8_t* data, uint8_t length, int16_t rssi, int8_t snr);
+#endif
+
 #endif // COMM_RADIO_H
 
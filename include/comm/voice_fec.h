@@ -0,0 +1,163 @@
+/**
+ * @file voice_fec.h
+ * @brief תיקון שגיאות קדמי (FEC) לחבילות קול
+ *
+ * XOR parity על קבוצות של N חבילות קול רצופות:
+ * - המשדר שולח חבילת MSG_VOICE_FEC אחת בסוף כל קבוצה
+ * - המקלט משחזר חבילה חסרה אחת לכל קבוצה, לפני ה-jitter buffer
+ * - הקבוצות מיושרות לפי sequence (N חזקה של 2) כך שאין צורך בסנכרון
+ */
+
+#ifndef COMM_VOICE_FEC_H
+#define COMM_VOICE_FEC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "comm/protocol.h"
+
+// =============================================================================
+// Constants
+// =============================================================================
+
+#define VOICE_FEC_MAX_GROUP     8       // גודל קבוצה מקסימלי
+#define VOICE_FEC_PARITY_HEADER_SIZE 12 // גודל השדות לפני parity_data
+
+// =============================================================================
+// Parity Packet Payload
+// =============================================================================
+
+/**
+ * @brief payload של חבילת MSG_VOICE_FEC
+ *
+ * parity_data נשלח רק עד parity_len (האורך המקסימלי בקבוצה),
+ * השאר נחשב כאפסים.
+ */
+typedef struct __attribute__((packed)) {
+    uint16_t base_sequence;             // sequence של החבילה הראשונה בקבוצה
+    uint8_t  group_size;                // N
+    uint8_t  mask;                      // אילו חבילות בקבוצה כלולות ב-parity
+    uint32_t timestamp_xor;             // XOR של שדות timestamp
+    uint16_t length_xor;                // XOR של שדות audio_len
+    uint16_t parity_len;                // אורך parity_data בפועל
+    uint8_t  parity_data[AUDIO_BUFFER_SIZE]; // XOR של נתוני האודיו
+} voice_fec_parity_t;
+
+// =============================================================================
+// Statistics
+// =============================================================================
+
+typedef struct {
+    uint32_t parity_sent;               // חבילות parity ששודרו
+    uint32_t parity_received;           // חבילות parity שהתקבלו
+    uint32_t frames_recovered;          // frames ששוחזרו
+    uint32_t frames_lost;               // frames שלא ניתן היה לשחזר
+    uint32_t frames_late;               // frames שהגיעו אחרי שהקבוצה שוחררה
+} voice_fec_stats_t;
+
+// =============================================================================
+// Encoder / Decoder State
+// =============================================================================
+
+typedef struct {
+    uint8_t group_size;
+    uint16_t group_base;
+    voice_fec_parity_t parity;          // parity מצטבר לקבוצה הנוכחית
+} voice_fec_encoder_t;
+
+typedef struct {
+    uint8_t group_size;
+    bool    active;                     // יש קבוצה פתוחה
+    uint16_t group_base;
+    uint8_t received_mask;              // frames שהתקבלו (או שוחזרו)
+    uint8_t next_release;               // אינדקס ה-frame הבא לשחרור
+    bool    parity_valid;
+    voice_fec_parity_t parity;
+    // voice_data_t הוא packed - בלי יישור frames מתחיל בכתובת אי-זוגית
+    // ו-audio_data (שנקרא כ-int16) לא מיושר
+    voice_data_t frames[VOICE_FEC_MAX_GROUP] __attribute__((aligned(4)));
+} voice_fec_decoder_t;
+
+_Static_assert(sizeof(voice_data_t) % 4 == 0 && VOICE_DATA_HEADER_SIZE % 4 == 0,
+               "voice_fec_decoder_t::frames[i].audio_data must stay 4-byte aligned");
+
+/**
+ * @brief callback לשחרור frame לפי הסדר (ל-jitter buffer)
+ * @param voice ה-frame
+ * @param recovered true אם שוחזר מ-parity
+ * @param user_data פרמטר משתמש
+ */
+typedef void (*voice_fec_output_t)(const voice_data_t* voice, bool recovered,
+                                   void* user_data);
+
+// =============================================================================
+// API Functions
+// =============================================================================
+
+/**
+ * @brief בדיקה אם גודל קבוצה חוקי
+ * @param group_size 0 (כבוי), 2, 4 או 8
+ * @return true אם חוקי
+ */
+bool voice_fec_valid_group_size(uint8_t group_size);
+
+/**
+ * @brief אתחול מקודד
+ * @param enc מקודד
+ * @param group_size גודל קבוצה
+ */
+void voice_fec_encoder_init(voice_fec_encoder_t* enc, uint8_t group_size);
+
+/**
+ * @brief הוספת חבילת קול שנשלחה לקבוצה
+ * @param enc מקודד
+ * @param voice חבילת הקול
+ * @param out_parity parity לשליחה (אם הקבוצה הושלמה)
+ * @return אורך ה-payload של ה-parity לשליחה, 0 אם אין
+ */
+uint16_t voice_fec_encoder_add(voice_fec_encoder_t* enc, const voice_data_t* voice,
+                               voice_fec_parity_t* out_parity);
+
+/**
+ * @brief אתחול מפענח
+ * @param dec מפענח
+ * @param group_size גודל קבוצה
+ */
+void voice_fec_decoder_init(voice_fec_decoder_t* dec, uint8_t group_size);
+
+/**
+ * @brief קבלת חבילת קול
+ * @param dec מפענח
+ * @param voice החבילה
+ * @param out callback לשחרור frames לפי הסדר
+ * @param user_data פרמטר ל-callback
+ */
+void voice_fec_decoder_push_voice(voice_fec_decoder_t* dec, const voice_data_t* voice,
+                                  voice_fec_output_t out, void* user_data);
+
+/**
+ * @brief קבלת חבילת parity
+ * @param dec מפענח
+ * @param parity ה-payload
+ * @param len אורך ה-payload
+ * @param out callback לשחרור frames לפי הסדר
+ * @param user_data פרמטר ל-callback
+ */
+void voice_fec_decoder_push_parity(voice_fec_decoder_t* dec, const voice_fec_parity_t* parity,
+                                   uint16_t len, voice_fec_output_t out, void* user_data);
+
+/**
+ * @brief שחרור כל מה שממתין בקבוצה הנוכחית (סוף שידור)
+ */
+void voice_fec_decoder_flush(voice_fec_decoder_t* dec, voice_fec_output_t out, void* user_data);
+
+/**
+ * @brief קבלת סטטיסטיקות FEC
+ */
+const voice_fec_stats_t* voice_fec_get_stats(void);
+
+/**
+ * @brief איפוס סטטיסטיקות FEC
+ */
+void voice_fec_reset_stats(void);
+
+#endif // COMM_VOICE_FEC_H
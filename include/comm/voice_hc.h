@@ -0,0 +1,116 @@
+/**
+ * @file voice_hc.h
+ * @brief דחיסת header לחבילות קול (בסגנון ROHC)
+ *
+ * במקום packet_header_t מלא (16 בתים) + שדות voice_data_t (8 בתים),
+ * חבילת קול דחוסה נושאת 3-5 בתים בלבד:
+ *
+ *   [0] marker | flags   - 0xC0 בניבל העליון (לא מתנגש ב-magic 0x54)
+ *   [1] session ID       - נקבע ב-call setup (call_options_t)
+ *   [2] sequence LSB     - 8 ביטים תחתונים, משוחזר מול ה-reference
+ *   [3-4] timestamp delta - רק אם VOICE_HC_FLAG_TS (ms מה-reference)
+ *   [..] audio data      - האורך נגזר מאורך החבילה
+ *
+ * ה-reference (sequence, timestamp ואורך) נקבע ע"י חבילת MSG_VOICE_DATA
+ * מלאה בתחילת שידור ואחת לכל VOICE_HC_REFRESH_INTERVAL. כל חבילה דחוסה
+ * מקודדת מול ה-reference ולא מול קודמתה, כך שאובדן חבילות לא שובר
+ * את הפענוח. בלי FLAG_TS ה-timestamp נגזר מה-sequence: כל חבילה מוסיפה
+ * את משך האודיו של חבילת ה-reference (דגימות / AUDIO_LINK_RATE) - frame
+ * של 20ms יוצא בכמה חבילות, כל אחת עם sequence משלה.
+ */
+
+#ifndef COMM_VOICE_HC_H
+#define COMM_VOICE_HC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "comm/protocol.h"
+
+// =============================================================================
+// Constants
+// =============================================================================
+
+#define VOICE_HC_MARKER             0xC0    // ניבל עליון של הבית הראשון
+#define VOICE_HC_MARKER_MASK        0xF0
+#define VOICE_HC_FLAG_TS            0x01    // timestamp delta מפורש
+
+#define VOICE_HC_MIN_HEADER         3
+#define VOICE_HC_MAX_HEADER         5
+#define VOICE_HC_REFRESH_INTERVAL   100     // חבילה מלאה כל 50 frames (~שנייה, 2 חבילות ל-frame)
+
+// =============================================================================
+// Compression Context
+// =============================================================================
+
+// צד שולח
+typedef struct {
+    uint8_t  session_id;                // 0 = דחיסה כבויה
+    bool     has_ref;
+    uint16_t ref_sequence;
+    uint32_t ref_timestamp;
+    uint16_t ref_audio_len;             // קובע את קצב ה-timestamp הצפוי
+    uint16_t since_refresh;             // חבילות דחוסות מאז רענון
+} voice_hc_tx_t;
+
+// צד מקבל
+typedef struct {
+    uint8_t  session_id;                // 0 = דחיסה כבויה
+    bool     has_ref;
+    uint16_t ref_sequence;
+    uint32_t ref_timestamp;
+    uint16_t ref_audio_len;
+    char     peer_id[DEVICE_ID_LENGTH + 1];  // המכשיר שה-session שייך אליו
+} voice_hc_rx_t;
+
+// =============================================================================
+// API Functions
+// =============================================================================
+
+/**
+ * @brief אתחול context שליחה
+ * @param tx context
+ * @param session_id מזהה session (0 לכיבוי)
+ */
+void voice_hc_tx_init(voice_hc_tx_t* tx, uint8_t session_id);
+
+/**
+ * @brief דחיסת חבילת קול
+ * @param tx context
+ * @param voice חבילת הקול
+ * @param out באפר פלט (כולל header דחוס ואודיו)
+ * @param out_size גודל באפר הפלט
+ * @return אורך החבילה הדחוסה, 0 אם צריך לשלוח חבילה מלאה (רענון context)
+ */
+uint16_t voice_hc_compress(voice_hc_tx_t* tx, const voice_data_t* voice,
+                           uint8_t* out, uint16_t out_size);
+
+/**
+ * @brief אתחול context קבלה
+ * @param rx context
+ * @param session_id מזהה ה-session של הצד השני (0 לכיבוי)
+ * @param peer_id מזהה המכשיר השולח
+ */
+void voice_hc_rx_init(voice_hc_rx_t* rx, uint8_t session_id, const char* peer_id);
+
+/**
+ * @brief רענון context מחבילת MSG_VOICE_DATA מלאה
+ */
+void voice_hc_rx_refresh(voice_hc_rx_t* rx, const voice_data_t* voice);
+
+/**
+ * @brief בדיקה אם חבילה היא חבילת קול דחוסה
+ */
+bool voice_hc_is_compressed(const uint8_t* buffer, uint16_t len);
+
+/**
+ * @brief פריסת חבילה דחוסה ל-voice_data_t מלא
+ * @param rx context
+ * @param buffer החבילה
+ * @param len אורך החבילה
+ * @param out חבילת קול משוחזרת
+ * @return true אם ה-session תואם ויש context תקף
+ */
+bool voice_hc_decompress(voice_hc_rx_t* rx, const uint8_t* buffer, uint16_t len,
+                         voice_data_t* out);
+
+#endif // COMM_VOICE_HC_H
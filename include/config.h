@@ -28,6 +28,46 @@
 // Device ID: ייחודי לצמיתות - נוצר פעם אחת ונשמר
 // Frequency ID: ייחודי רק בזמן שהתדר פעיל - אחרי סגירה הקוד חוזר להיות פנוי
 
+// =============================================================================
+// Build Profile
+// =============================================================================
+
+// גדלי הטבלאות לפי הלוח: כל env ב-platformio.ini בוחר קובץ מ-include/profiles.
+// הפרופיל מגדיר רק מה ששונה; השאר נשאר ברירת המחדל (#ifndef) של המודול
+#ifdef BUILD_PROFILE
+    #include BUILD_PROFILE
+#else
+    #include "profiles/profile_esp32.h"
+#endif
+
+#if !defined(PROFILE_NAME) || !defined(PROFILE_HAS_PSRAM) || !defined(PROFILE_STATIC_RAM_BUDGET)
+    #error "Build profile must define PROFILE_NAME, PROFILE_HAS_PSRAM and PROFILE_STATIC_RAM_BUDGET"
+#endif
+
+// =============================================================================
+// Memory Placement
+// =============================================================================
+
+// LARGE_TABLE_ATTR - טבלאות גדולות מחוץ לנתיב האודיו (peers, תור ההקלטה, מצב ה-UI).
+//                    ב-PSRAM כשיש בפרופיל, אחרת bss רגיל.
+// HOT_BUFFER_ATTR  - באפרי אודיו/רדיו/DMA. סימון בלבד: bss רגיל הוא כבר DRAM
+//                    פנימי, ו-DRAM_ATTR היה מעביר אותם ל-.dram0.data (מאופס
+//                    בתמונת ה-flash) בלי להרוויח כלום
+#ifdef ESP_PLATFORM
+    #include "esp_attr.h"
+    #if PROFILE_HAS_PSRAM
+        #if !CONFIG_SPIRAM_ALLOW_BSS_SEG_EXTERNAL_MEMORY
+            #error "PSRAM profile needs CONFIG_SPIRAM_ALLOW_BSS_SEG_EXTERNAL_MEMORY=y (sdkconfig.defaults.<target>)"
+        #endif
+        #define LARGE_TABLE_ATTR    EXT_RAM_BSS_ATTR
+    #else
+        #define LARGE_TABLE_ATTR
+    #endif
+#else
+    #define LARGE_TABLE_ATTR
+#endif
+#define HOT_BUFFER_ATTR
+
 // =============================================================================
 // Hardware Pin Definitions (ESP32)
 // =============================================================================
@@ -105,16 +145,33 @@
 #define CALL_TIMEOUT            30000   // זמן המתנה לתשובה לשיחה
 #define DISPLAY_REFRESH_RATE    100     // רענון מסך
 
+// שורת מדדים בלוג (core/telemetry.h). 0 = רק לפי בקשה ב-USB
+#ifndef TELEMETRY_LOG_INTERVAL_MS
+#define TELEMETRY_LOG_INTERVAL_MS   0
+#endif
+
+// trace לנתיבים החמים (core/trace.h). 0 = המאקרו ריקים; esp32-debug מדליק
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED               0
+#endif
+
 // =============================================================================
 // Protocol Constants
 // =============================================================================
 
 // FREQUENCY_ID_LENGTH מוגדר למעלה עם DEVICE_ID_LENGTH
 #define PASSWORD_MAX_LENGTH     16      // אורך מקסימלי לסיסמה
+#ifndef MAX_SAVED_CODES
 #define MAX_SAVED_CODES         50      // מקסימום קודים שמורים
+#endif
+#ifndef MAX_FREQ_MEMBERS
 #define MAX_FREQ_MEMBERS        100     // מקסימום משתתפים בתדר
+#endif
 #define MAX_SCAN_RESULTS        20      // מקסימום תוצאות סריקה
 
+// המונים ב-device_context_t וב-member_list_t הם uint8_t
+_Static_assert(MAX_SAVED_CODES <= 255 && MAX_FREQ_MEMBERS <= 255, "saved codes / members counted in u8");
+
 // =============================================================================
 // Radio Configuration
 // =============================================================================
@@ -140,5 +197,25 @@
 #define AUDIO_BITS              16
 #define AUDIO_BUFFER_SIZE       256
 
+// קצבים לכל שלב - כשהם שונים עוברים דרך resampler (I2S לא מאותחל מחדש)
+// נתמכים: 8000 / 16000 (CODEC_PCM_8KHZ / CODEC_PCM_16KHZ)
+#define AUDIO_LINK_RATE         AUDIO_SAMPLE_RATE   // קצב הקול ברדיו
+#define AUDIO_RECORD_RATE       AUDIO_SAMPLE_RATE   // קצב קבצי ההקלטה
+
+// הקלטה תמידית לטבעת על מחיצת "recordings" הגולמית (partitions_custom_s3.csv)
+// במקום לקבצים; כפתור ההקלטה שומר את הדקות האחרונות לקובץ. 0 = קבצים בלבד
+#ifndef RECORDER_RING_ENABLED
+#define RECORDER_RING_ENABLED   0
+#endif
+
+// Voice FEC - חבילת parity אחת לכל קבוצה של N חבילות קול (0 = כבוי)
+// ערכים חוקיים: 0, 2, 4, 8 (תקורה של 50%, 25%, 12.5%)
+#define VOICE_FEC_GROUP_SIZE    4
+
+// Echo cancellation (duplex) - אורך מסנן NLMS והשהיה קבועה רמקול->מיקרופון
+#define AEC_ENABLED             1
+#define AEC_FILTER_TAPS         256     // 32ms ב-8kHz
+#define AEC_BULK_DELAY          0       // דגימות
+
 #endif // CONFIG_H
 
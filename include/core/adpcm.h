@@ -0,0 +1,52 @@
+/**
+ * @file adpcm.h
+ * @brief קודק IMA-ADPCM (4 ביט לדגימה)
+ *
+ * דחיסה של 4:1 מ-PCM 16 ביט, כמה פעולות שלמות לדגימה - בלי טבלאות
+ * גדולות ובלי float. זה הקודק של פורמט ההקלטה (rec_format.h).
+ * סדר ה-nibbles כמו ב-WAV IMA: הדגימה הראשונה בחצי הנמוך של הבית.
+ */
+
+#ifndef CORE_ADPCM_H
+#define CORE_ADPCM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// =============================================================================
+// State
+// =============================================================================
+
+typedef struct {
+    int16_t predictor;      // הדגימה המשוחזרת האחרונה
+    uint8_t step_index;     // 0..88
+} adpcm_state_t;
+
+// =============================================================================
+// API Functions
+// =============================================================================
+
+/**
+ * @brief איפוס מצב (מתחילים מ-0 בצעד הקטן ביותר)
+ */
+void adpcm_init(adpcm_state_t* state);
+
+/**
+ * @brief קידוד דגימות
+ * @param state מצב המקודד (מתעדכן)
+ * @param in דגימות PCM
+ * @param count מספר דגימות
+ * @param out פלט - (count + 1) / 2 בתים
+ */
+void adpcm_encode(adpcm_state_t* state, const int16_t* in, uint16_t count, uint8_t* out);
+
+/**
+ * @brief פענוח דגימות
+ * @param state מצב המפענח (מתעדכן)
+ * @param in נתונים מקודדים
+ * @param count מספר דגימות לפענח
+ * @param out פלט PCM
+ */
+void adpcm_decode(adpcm_state_t* state, const uint8_t* in, uint16_t count, int16_t* out);
+
+#endif // CORE_ADPCM_H
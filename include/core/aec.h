@@ -0,0 +1,110 @@
+/**
+ * @file aec.h
+ * @brief ביטול הד אקוסטי (AEC) - NLMS ב-fixed point
+ *
+ * במצב duplex הרמקול נכנס חזרה למיקרופון. המסנן לומד את מסלול ההד
+ * (רמקול -> אוויר -> מיקרופון) מתוך ההשמעה (reference) ומחסיר את ההד
+ * המשוערך מהקלט:
+ *
+ *   e[n] = mic[n] - sum(w[k] * ref[n-k])
+ *   w[k] += mu * e[n] * ref[n-k] / (|ref|^2 + delta)
+ *
+ * - משקלות ב-Q28 (int32), הקלט וה-reference ב-int16
+ * - אין עדכון (וגם אין סינון) כשאין השמעה - חוסך CPU
+ * - גלאי double-talk (Geigel) מקפיא את הלמידה כשמדברים בשני הצדדים
+ * - ה-reference עובר דרך FIFO: נדחף בזמן ההשמעה, נצרך בקצב הקלט
+ */
+
+#ifndef CORE_AEC_H
+#define CORE_AEC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#define AEC_FIFO_SIZE           2048    // FIFO של reference (חזקה של 2)
+#define AEC_MU_Q15              8192    // גודל צעד (0.25)
+#define AEC_REF_FLOOR           64      // RMS reference מינימלי לסינון
+#define AEC_DT_HANGOVER         240     // דגימות הקפאה אחרי double-talk (30ms)
+
+// =============================================================================
+// State
+// =============================================================================
+
+typedef struct {
+    bool     enabled;
+
+    // מסנן
+    int32_t  weights[AEC_FILTER_TAPS];          // Q28, weights[0] = הדגימה החדשה
+    int16_t  history[AEC_FILTER_TAPS * 2];      // חלון reference כפול (רציף בזיכרון)
+    uint16_t history_pos;
+    uint64_t ref_energy;                        // sum(ref^2) על החלון
+
+    // FIFO של reference
+    int16_t  fifo[AEC_FIFO_SIZE];
+    uint16_t fifo_head;
+    uint16_t fifo_tail;
+    uint16_t fifo_count;
+
+    // הסרת DC מהמיקרופון (ה-ADC עם היסט קבוע)
+    int32_t  dc_prev_x;
+    int32_t  dc_prev_y;
+
+    // גלאי double-talk
+    int16_t  ref_peak;                          // max|ref| על החלון
+    uint16_t ref_peak_age;
+    uint16_t dt_hold;                           // דגימות שנותרו בהקפאה
+
+    // סטטיסטיקות
+    uint32_t mic_energy_avg;                    // ממוצע נע של אנרגיית הקלט
+    uint32_t out_energy_avg;                    // ממוצע נע של אנרגיית הפלט
+    uint32_t double_talk_samples;
+    uint32_t fifo_overflows;
+    uint32_t fifo_underruns;
+} aec_state_t;
+
+// =============================================================================
+// API Functions
+// =============================================================================
+
+/**
+ * @brief אתחול (מסנן מאופס, FIFO עם AEC_BULK_DELAY דגימות שקט)
+ */
+void aec_init(aec_state_t* aec);
+
+/**
+ * @brief איפוס המסנן וה-FIFO (למשל בתחילת שיחה)
+ */
+void aec_reset(aec_state_t* aec);
+
+/**
+ * @brief הפעלה/כיבוי (כבוי = הקלט עובר כמו שהוא)
+ */
+void aec_set_enabled(aec_state_t* aec, bool enabled);
+
+/**
+ * @brief דחיפת דגימות שהושמעו לרמקול (אחרי עוצמה)
+ * @param aec מצב
+ * @param samples דגימות
+ * @param count מספר דגימות
+ */
+void aec_push_reference(aec_state_t* aec, const int16_t* samples, uint16_t count);
+
+/**
+ * @brief ביטול הד מבלוק קלט (במקום)
+ * @param aec מצב
+ * @param mic דגימות מיקרופון
+ * @param count מספר דגימות
+ */
+void aec_process(aec_state_t* aec, int16_t* mic, uint16_t count);
+
+/**
+ * @brief ERLE משוער (dB) - כמה הד הוסר
+ */
+int16_t aec_get_erle_db(const aec_state_t* aec);
+
+#endif // CORE_AEC_H
@@ -19,7 +19,9 @@
 
 #define AUDIO_FRAME_SAMPLES     160         // 20ms @ 8kHz
 #define AUDIO_FRAME_SIZE        (AUDIO_FRAME_SAMPLES * 2)  // 16-bit samples
+#ifndef AUDIO_BUFFER_FRAMES
 #define AUDIO_BUFFER_FRAMES     32          // Number of frames in ring buffer
+#endif
 #define AUDIO_FRAME_DURATION_MS 20          // Frame duration
 
 // =============================================================================
@@ -213,6 +215,14 @@ void audio_buffer_reset_stats(audio_ring_buffer_t* buffer);
  */
 uint32_t audio_buffer_duration_ms(const audio_ring_buffer_t* buffer);
 
+/**
+ * @brief מספר הדגימות בפועל ב-buffer (לפי אורך כל frame)
+ * 
+ * @param buffer מצביע ל-buffer
+ * @return מספר דגימות
+ */
+uint32_t audio_buffer_samples(const audio_ring_buffer_t* buffer);
+
 /**
  * @brief בדיקת פער ב-sequence
  * 
@@ -0,0 +1,108 @@
+/**
+ * @file audio_dsp.h
+ * @brief שרשרת עיבוד אודיו ב-fixed point (Q15)
+ *
+ * מעבר אחד על הבלוק, לכל דגימה:
+ *   gain -> הסרת DC -> noise gate (attack/release) -> AGC
+ *
+ * - אין float בנתיב הדגימות
+ * - ה-AGC מתעדכן פעם בבלוק לפי מעטפת מוחלקת, והגבר עובר
+ *   אינטרפולציה לינארית לאורך הבלוק הבא (בלי "קפיצות")
+ * - כל המצב במבנה - אפשר להחזיק כמה שרשראות (קלט/פלט)
+ */
+
+#ifndef CORE_AUDIO_DSP_H
+#define CORE_AUDIO_DSP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// =============================================================================
+// Constants
+// =============================================================================
+
+#define DSP_Q15_ONE             32767
+#define DSP_DC_POLE_Q15         32604   // 0.995 - קוטב high-pass להסרת DC
+#define DSP_GATE_ATTACK_MS      1       // פתיחת gate
+#define DSP_GATE_RELEASE_MS     50      // סגירת gate
+#define DSP_AGC_TARGET          8000    // RMS יעד
+#define DSP_AGC_MIN_GAIN_Q12    1024    // 0.25
+#define DSP_AGC_MAX_GAIN_Q12    16384   // 4.0
+#define DSP_AGC_UNITY_Q12       4096    // 1.0
+
+// =============================================================================
+// DSP Chain State
+// =============================================================================
+
+typedef struct {
+    // הגדרות
+    int32_t  gain_q15;              // הגבר קלט (Q15)
+    bool     dc_block;              // הסרת DC
+    bool     gate_enabled;
+    uint16_t gate_threshold;        // סף פתיחה (מעטפת |x|)
+    int32_t  gate_attack_step;      // צעד Q15 לדגימה בפתיחה
+    int32_t  gate_release_step;     // צעד Q15 לדגימה בסגירה
+    bool     agc_enabled;
+    uint16_t agc_target;            // RMS יעד
+
+    // מצב
+    int32_t  dc_prev_x;
+    int32_t  dc_prev_y;
+    int32_t  envelope;              // מעטפת |x| ל-gate
+    int32_t  gate_gain;             // Q15
+    int32_t  agc_gain_q16;          // הגבר AGC נוכחי (Q12 << 4 לדיוק באינטרפולציה)
+    int32_t  agc_step_q16;          // שינוי לדגימה עד היעד
+    int32_t  agc_target_q12;        // הגבר היעד לבלוק הנוכחי
+
+    // רמות מהבלוק האחרון
+    uint16_t input_level;           // RMS לפני gate/AGC
+    uint16_t output_level;          // RMS ביציאה
+} audio_dsp_t;
+
+// =============================================================================
+// API Functions
+// =============================================================================
+
+/**
+ * @brief אתחול שרשרת (gain=1, DC/gate/AGC כבויים)
+ * @param dsp מצב
+ * @param sample_rate קצב דגימה (לחישוב זמני attack/release)
+ */
+void audio_dsp_init(audio_dsp_t* dsp, uint32_t sample_rate);
+
+/**
+ * @brief הגדרת הגבר באחוזים (0-100 => 0.0-1.0)
+ */
+void audio_dsp_set_gain(audio_dsp_t* dsp, uint8_t percent);
+
+/**
+ * @brief הגדרת noise gate
+ * @param enabled הפעלה
+ * @param threshold סף פתיחה
+ */
+void audio_dsp_set_gate(audio_dsp_t* dsp, bool enabled, uint16_t threshold);
+
+/**
+ * @brief הפעלת/כיבוי AGC
+ */
+void audio_dsp_set_agc(audio_dsp_t* dsp, bool enabled);
+
+/**
+ * @brief הפעלת/כיבוי הסרת DC
+ */
+void audio_dsp_set_dc_block(audio_dsp_t* dsp, bool enabled);
+
+/**
+ * @brief עיבוד בלוק במקום (in-place)
+ * @param dsp מצב
+ * @param samples דגימות
+ * @param count מספר דגימות
+ */
+void audio_dsp_process(audio_dsp_t* dsp, int16_t* samples, uint16_t count);
+
+/**
+ * @brief שורש ריבועי שלם (לחישובי RMS בלי float)
+ */
+uint32_t audio_dsp_isqrt(uint32_t x);
+
+#endif // CORE_AUDIO_DSP_H
@@ -0,0 +1,90 @@
+/**
+ * @file audio_kernels.h
+ * @brief קרנלים וקטוריים לאודיו int16 (ESP32-S3 PIE) + גרסאות ייחוס ב-C
+ *
+ * - ב-ESP32-S3: הוראות PIE של ה-LX7 (128 ביט = 8 דגימות בהוראה)
+ * - בשאר הפלטפורמות (ESP32, C3, native): גרסאות ה-C הניידות
+ * - גרסאות ה-_ref תמיד מקומפלות - משמשות לבדיקה עצמית באתחול
+ *
+ * הנתיב הווקטורי דורש באפרים מיושרים ל-16 בתים; אחרת נופלים לגרסת C.
+ */
+
+#ifndef CORE_AUDIO_KERNELS_H
+#define CORE_AUDIO_KERNELS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#if (defined(ESP32S3) || defined(CONFIG_IDF_TARGET_ESP32S3)) && !defined(AUDIO_KERNELS_NO_PIE)
+    #define AUDIO_KERNELS_PIE   1
+#else
+    #define AUDIO_KERNELS_PIE   0
+#endif
+
+#define AUDIO_KERNEL_ALIGN      16      // יישור נדרש לנתיב הווקטורי (בתים)
+#define AUDIO_KERNEL_LANES      8       // דגימות int16 לאוגר 128 ביט
+
+// באפרי אודיו שעוברים בקרנלים - להצהיר עם זה
+#define AUDIO_ALIGNED           __attribute__((aligned(AUDIO_KERNEL_ALIGN)))
+
+// =============================================================================
+// API Functions
+// =============================================================================
+
+/**
+ * @brief אתחול - בדיקה עצמית של הנתיב הווקטורי מול גרסאות הייחוס
+ * @return true אם הנתיב הווקטורי פעיל
+ *
+ * אם יש אי-התאמה, הנתיב הווקטורי מכובה ונשארים עם C.
+ */
+bool audio_kernels_init(void);
+
+/**
+ * @brief האם הנתיב הווקטורי פעיל
+ */
+bool audio_kernels_accelerated(void);
+
+/**
+ * @brief הכפלה בהגבר עם רוויה: dst[i] = sat((src[i] * gain) >> 15)
+ * @param dst יעד (יכול להיות src)
+ * @param src מקור
+ * @param gain_q15 הגבר Q15
+ * @param count מספר דגימות
+ */
+void audio_kernel_scale(int16_t* dst, const int16_t* src, int16_t gain_q15, uint16_t count);
+
+/**
+ * @brief הכפלה-צבירה עם רוויה: acc[i] = sat(acc[i] + ((src[i] * gain) >> 15))
+ */
+void audio_kernel_mac(int16_t* acc, const int16_t* src, int16_t gain_q15, uint16_t count);
+
+/**
+ * @brief ערבוב עם רוויה: dst[i] = sat(a[i] + b[i])
+ * @param dst יעד (יכול להיות a או b)
+ */
+void audio_kernel_mix(int16_t* dst, const int16_t* a, const int16_t* b, uint16_t count);
+
+/**
+ * @brief מכפלה סקלרית: sum(a[i] * b[i])
+ */
+int64_t audio_kernel_dot(const int16_t* a, const int16_t* b, uint16_t count);
+
+/**
+ * @brief RMS של בלוק
+ */
+uint16_t audio_kernel_rms(const int16_t* samples, uint16_t count);
+
+// =============================================================================
+// Portable Reference Versions
+// =============================================================================
+
+void audio_kernel_scale_ref(int16_t* dst, const int16_t* src, int16_t gain_q15, uint16_t count);
+void audio_kernel_mac_ref(int16_t* acc, const int16_t* src, int16_t gain_q15, uint16_t count);
+void audio_kernel_mix_ref(int16_t* dst, const int16_t* a, const int16_t* b, uint16_t count);
+int64_t audio_kernel_dot_ref(const int16_t* a, const int16_t* b, uint16_t count);
+
+#endif // CORE_AUDIO_KERNELS_H
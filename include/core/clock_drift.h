@@ -0,0 +1,70 @@
+/**
+ * @file clock_drift.h
+ * @brief פיצוי סחיפת שעון בין שעוני האודיו של השולח והמקבל
+ *
+ * שני גבישים של 8kHz אף פעם לא זהים (±50-100ppm). בערוץ פתוח ארוך
+ * ה-jitter buffer מתמלא או מתרוקן לאט, והשהיה "זוחלת".
+ *
+ * המעריך דוגם את מילוי ה-buffer, מחליק אותו (ממוצע נע ארוך - מסנן את
+ * ה-jitter), ובקר PI מחזיר תיקון ב-ppm ל-resampler של צד הקבלה:
+ * - buffer מתמלא => ppm שלילי => פחות דגימות => מתרוקן
+ * - buffer מתרוקן => ppm חיובי
+ * היעד הוא המילוי שנמדד בתחילת ההשמעה.
+ */
+
+#ifndef CORE_CLOCK_DRIFT_H
+#define CORE_CLOCK_DRIFT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#define DRIFT_UPDATE_MS         100     // מרווח בין מדידות
+#define DRIFT_AVG_SHIFT         6       // ממוצע נע: 1/64 (~6 שניות)
+#define DRIFT_SETTLE_UPDATES    32      // מדידות לפני קביעת היעד
+#define DRIFT_KP_Q8             128     // 0.5 ppm לכל דגימת שגיאה
+#define DRIFT_KI_DIV            800     // אינטגרל: ppm = sum(err) / DIV
+#define DRIFT_MAX_PPM           500     // תיקון מקסימלי
+
+// =============================================================================
+// State
+// =============================================================================
+
+typedef struct {
+    bool     settled;               // היעד נקבע
+    uint16_t updates;               // מדידות עד קביעת היעד
+    uint32_t last_update;
+
+    int32_t  fill_avg_q8;           // מילוי מוחלק (דגימות, Q8)
+    int32_t  target_q8;             // מילוי יעד (Q8)
+    int64_t  integral_q8;           // סכום שגיאות (Q8)
+    int32_t  ppm;                   // תיקון נוכחי
+} clock_drift_t;
+
+// =============================================================================
+// API Functions
+// =============================================================================
+
+/**
+ * @brief אתחול/איפוס (תחילת השמעה חדשה)
+ */
+void clock_drift_reset(clock_drift_t* drift);
+
+/**
+ * @brief עדכון עם מילוי ה-buffer הנוכחי
+ * @param drift מצב
+ * @param fill_samples דגימות ב-jitter buffer
+ * @param now זמן נוכחי (ms)
+ * @return true אם ה-ppm השתנה (צריך לעדכן את ה-resampler)
+ */
+bool clock_drift_update(clock_drift_t* drift, uint32_t fill_samples, uint32_t now);
+
+/**
+ * @brief התיקון הנוכחי ב-ppm
+ */
+int32_t clock_drift_get_ppm(const clock_drift_t* drift);
+
+#endif // CORE_CLOCK_DRIFT_H
@@ -22,6 +22,8 @@
 #define DEVICE_ID_RAW_SIZE      16      // גודל מזהה גולמי (bytes)
 #define DEVICE_ID_STRING_SIZE   8       // גודל מזהה כמחרוזת ספרות
 #define DEVICE_ID_HEX_SIZE      32      // גודל מזהה כ-hex string
+#define DEVICE_ID_WIRE_SIZE     4       // גודל מזהה בינארי על האוויר (protocol v2)
+#define DEVICE_ID_WIRE_INVALID  0xFFFFFFFF  // ערך לא חוקי (8 ספרות < 2^27)
 
 // =============================================================================
 // ID Source Types
@@ -214,6 +216,25 @@ bool device_get_flash_id(uint8_t* flash_id);
  */
 void device_id_raw_to_string(const uint8_t* raw, size_t raw_size, char* output);
 
+/**
+ * @brief המרת מזהה 8 ספרות לפורמט הבינארי של protocol v2
+ * 
+ * 8 ספרות עשרוניות נכנסות ב-27 ביט, כך שכל מזהה (מכשיר או תדר)
+ * נשלח כ-uint32_t אחד והשוואה היא השוואת מספרים במקום strcmp.
+ * 
+ * @param id מחרוזת 8 ספרות (לא חייבת להסתיים ב-'\0' אחרי 8 תווים)
+ * @return הערך המספרי, או DEVICE_ID_WIRE_INVALID אם הפורמט לא תקין
+ */
+uint32_t device_id_string_to_wire(const char* id);
+
+/**
+ * @brief המרת מזהה בינארי חזרה ל-8 ספרות
+ * @param wire מזהה בינארי
+ * @param output מחרוזת פלט (9 bytes לפחות)
+ * @return true אם הערך בטווח של 8 ספרות
+ */
+bool device_id_wire_to_string(uint32_t wire, char* output);
+
 /**
  * @brief המרת מזהה גולמי ל-hex
  * @param raw מזהה גולמי
@@ -9,6 +9,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "config.h"
+#include "hal/buttons.h"
 
 // =============================================================================
 // Device States
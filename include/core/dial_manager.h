@@ -17,7 +17,9 @@
 // Constants
 // =============================================================================
 
+#ifndef DIAL_POSITIONS
 #define DIAL_POSITIONS          15      // מספר מיקומים בגלגלת
+#endif
 #define MAX_DIAL_THREADS        15      // מקסימום threads במקביל
 #define DIAL_TASK_STACK_SIZE    4096    // גודל stack לכל task
 #define DIAL_TASK_PRIORITY      5       // עדיפות task
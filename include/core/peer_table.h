@@ -0,0 +1,107 @@
+/**
+ * @file peer_table.h
+ * @brief טבלת peers עם גישה ב-O(1) לפי מזהה מספרי
+ *
+ * Hash table בגודל קבוע עם open addressing (linear probing):
+ * - מפתח: מזהה בינארי (device_id_string_to_wire) + סוג (מכשיר/תדר)
+ * - מחזיק רק את מה שנקרא: שיוך לגלגלת (מקבע את הרשומה) וזמן קבלה אחרון
+ *   (לבחירת רשומה לפינוי)
+ * - חיפוש ב-RX לא תלוי במספר המשתתפים או הקודים השמורים
+ * - מחיקה ב-backward shift, ללא tombstones
+ * - פינוי בעלות חסומה: נבחר מתוך ה-cluster שה-probing עובר עליו בכל מקרה
+ */
+
+#ifndef CORE_PEER_TABLE_H
+#define CORE_PEER_TABLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+
+// =============================================================================
+// Constants
+// =============================================================================
+
+#ifndef PEER_TABLE_BITS
+#define PEER_TABLE_BITS         8       // גודל הטבלה בחזקות של 2 (הפרופיל קובע)
+#endif
+#define PEER_TABLE_CAPACITY     (1u << PEER_TABLE_BITS)
+#define PEER_TABLE_MAX_LOAD     (PEER_TABLE_CAPACITY * 3 / 4)   // 75% - מעבר לזה probing מתארך
+#define PEER_EVICT_SCAN         16      // רשומות נוספות לבדיקה כשב-cluster אין מועמד
+#define PEER_NO_SLOT            -1      // לא משויך למיקום בגלגלת
+
+// =============================================================================
+// Peer Type
+// =============================================================================
+
+typedef enum {
+    PEER_TYPE_DEVICE = 0,
+    PEER_TYPE_FREQUENCY
+} peer_type_t;
+
+// =============================================================================
+// Peer Entry
+// =============================================================================
+
+typedef struct {
+    uint32_t key;                           // מזהה + סוג (0 = ריק)
+    uint32_t id;                            // מזהה בינארי
+    uint8_t  type;                          // peer_type_t
+    int8_t   dial_slot;                     // מיקום בגלגלת או PEER_NO_SLOT
+    uint32_t last_seen;                     // ms
+} peer_entry_t;
+
+typedef struct {
+    peer_entry_t entries[PEER_TABLE_CAPACITY];
+    uint16_t count;
+    uint16_t evict_hand;                    // מחוג הסריקה כשב-cluster אין מועמד
+} peer_table_t;
+
+// =============================================================================
+// API Functions
+// =============================================================================
+
+/**
+ * @brief אתחול טבלה ריקה
+ */
+void peer_table_init(peer_table_t* table);
+
+/**
+ * @brief חיפוש peer
+ * @param table הטבלה
+ * @param id מזהה בינארי
+ * @param type סוג
+ * @return מצביע לרשומה או NULL
+ */
+peer_entry_t* peer_table_find(peer_table_t* table, uint32_t id, peer_type_t type);
+
+/**
+ * @brief חיפוש או יצירת peer
+ *
+ * כשהטבלה מלאה נזרקת הרשומה הישנה ביותר שאינה משויכת לגלגלת מתוך
+ * ה-cluster של מיקום הבית. אם כולן משויכות, נבדקות עוד PEER_EVICT_SCAN
+ * רשומות ממחוג שמתקדם בין קריאות - בלי סריקה של כל הטבלה.
+ *
+ * @return מצביע לרשומה או NULL אם לא נמצאה רשומה לפינוי
+ */
+peer_entry_t* peer_table_insert(peer_table_t* table, uint32_t id, peer_type_t type);
+
+/**
+ * @brief מחיקת peer
+ * @return true אם נמצא ונמחק
+ */
+bool peer_table_remove(peer_table_t* table, uint32_t id, peer_type_t type);
+
+/**
+ * @brief מספר peers בטבלה
+ */
+uint16_t peer_table_count(const peer_table_t* table);
+
+/**
+ * @brief עדכון זמן הקבלה האחרון של peer
+ * @param peer הרשומה (NULL מתעלם)
+ * @param now זמן נוכחי (ms)
+ */
+void peer_touch(peer_entry_t* peer, uint32_t now);
+
+#endif // CORE_PEER_TABLE_H
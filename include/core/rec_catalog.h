@@ -0,0 +1,135 @@
+/**
+ * @file rec_catalog.h
+ * @brief קטלוג הקלטות - קובץ אחד עם רשומות בגודל קבוע
+ *
+ * במקום לסרוק את תיקיית ההקלטות ולפתוח כל קובץ (עד 1000 ב-FAT/SPIFFS),
+ * כל הקלטה מקבלת רשומה בקובץ CATALOG.DAT:
+ * - התחלה: רשומה חדשה בסוף הקובץ (OPEN)
+ * - סיום/תיקון: עדכון הרשומה במקומה (COMPLETE, אורך, גודל, שולח)
+ * - מחיקה: סימון DELETED; דחיסה כשחצי מהרשומות מחוקות
+ *
+ * בזיכרון נשמרת רק מפת ביטים של רשומות חיות, כך שדף ברשימה הוא
+ * קריאה של הרשומות שבדף בלבד. אם הקטלוג חסר או פגום - נבנה מחדש
+ * מסריקת התיקייה (פעם אחת).
+ *
+ * מזהה רשומה הוא מיקומה בקובץ. דחיסה ובנייה מחדש ממספרות מחדש, ולכן
+ * מזהה תקף רק עד הקריאה הבאה שעלולה למחוק - לא שומרים אותו לאורך זמן.
+ */
+
+#ifndef CORE_REC_CATALOG_H
+#define CORE_REC_CATALOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hal/storage.h"
+#include "core/rec_format.h"
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#define REC_CATALOG_FILE_NAME   "CATALOG.DAT"
+#define REC_CATALOG_MAGIC       "WTCL"
+#define REC_CATALOG_VERSION     1
+#define REC_CATALOG_MAX         STORAGE_MAX_RECORDINGS
+#define REC_CATALOG_NAME_LENGTH 31
+
+typedef enum {
+    REC_CATALOG_OPEN     = 'O',     // מקליטים (או נקטע - יתוקן באתחול)
+    REC_CATALOG_COMPLETE = 'C',
+    REC_CATALOG_DELETED  = 'D'
+} rec_catalog_state_t;
+
+// =============================================================================
+// Entry (on disk, 64 bytes)
+// =============================================================================
+
+#pragma pack(push, 1)
+typedef struct {
+    uint8_t  state;                 // rec_catalog_state_t
+    uint8_t  reserved[3];
+    uint32_t timestamp;             // Unix timestamp
+    uint32_t duration_ms;
+    uint32_t size_bytes;
+    uint32_t sample_rate;
+    char     name[REC_CATALOG_NAME_LENGTH + 1];
+    char     peer_id[REC_PEER_ID_LENGTH + 1];
+} rec_catalog_entry_t;
+#pragma pack(pop)
+
+// =============================================================================
+// API Functions
+// =============================================================================
+
+/**
+ * @brief טעינת הקטלוג (או בנייה מחדש מהתיקייה)
+ * @return true בהצלחה
+ */
+bool rec_catalog_init(void);
+
+/**
+ * @brief רשומה להקלטה חדשה
+ * @param name שם הקובץ (בלי תיקייה)
+ * @param timestamp זמן התחלה
+ * @param sample_rate קצב דגימה
+ * @return מזהה רשומה, או -1
+ */
+int32_t rec_catalog_add(const char* name, uint32_t timestamp, uint32_t sample_rate);
+
+/**
+ * @brief סיום הקלטה
+ *
+ * לפי שם ולא לפי מזהה: הקלטה ארוכה יכולה לחצות דחיסה, שממספרת מחדש
+ * את הרשומות.
+ *
+ * @param name שם הקובץ (כמו ב-rec_catalog_add)
+ * @param duration_ms אורך
+ * @param size_bytes גודל הקובץ
+ * @param peer_id השולח הראשון (או NULL)
+ */
+bool rec_catalog_finish(const char* name, uint32_t duration_ms, uint32_t size_bytes,
+                        const char* peer_id);
+
+/**
+ * @brief עדכון רשומה מהקובץ עצמו (אחרי rec_repair)
+ */
+bool rec_catalog_refresh(int32_t id);
+
+/**
+ * @brief חיפוש רשומה לפי שם (מהחדשה לישנה)
+ * @return מזהה, או -1
+ */
+int32_t rec_catalog_find(const char* name);
+
+/**
+ * @brief מחיקת הקלטה - הקובץ והרשומה
+ */
+bool rec_catalog_delete(int32_t id);
+
+/**
+ * @brief מספר ההקלטות (בלי מחוקות)
+ */
+uint32_t rec_catalog_count(void);
+
+/**
+ * @brief סה"כ בתים בהקלטות
+ */
+uint32_t rec_catalog_total_size(void);
+
+/**
+ * @brief דף ברשימה, מהחדשה לישנה
+ * @param first מיקום ברשימה (0 = החדשה ביותר)
+ * @param entries פלט
+ * @param ids פלט מזהים (אופציונלי)
+ * @param max_count גודל הדף
+ * @return מספר רשומות שהוחזרו
+ */
+uint32_t rec_catalog_get_page(uint32_t first, rec_catalog_entry_t* entries,
+                              int32_t* ids, uint32_t max_count);
+
+/**
+ * @brief בנייה מחדש מסריקת התיקייה (אחרי שינוי קבצים דרך USB MSC)
+ */
+bool rec_catalog_rebuild(void);
+
+#endif // CORE_REC_CATALOG_H
@@ -0,0 +1,283 @@
+/**
+ * @file rec_format.h
+ * @brief פורמט הקלטה דחוס - IMA-ADPCM ב-slots קבועים, עם אינדקס ומטא-דאטה
+ *
+ * WAV של 8kHz/16 ביט הוא 16KB לשנייה - 8 שניות בלבד במחיצת ה-SPIFFS.
+ * כאן כל הקובץ בנוי מ-slots של 256 בתים (חצי סקטור - כתיבות מיושרות):
+ *
+ *   slot 0       כותרת הקובץ (rec_file_header_t)
+ *   'A' slots    497 דגימות ADPCM; כל slot מפוענח לבד (predictor + step)
+ *   'S' slots    תחילת מקטע: מזהה השולח, RSSI, זמן
+ *   'I' slots    אינדקס (slot, דגימה) לדילוג מהיר - בסוף הקובץ
+ *
+ * ~4.1KB לשנייה (פי 3.9 מ-WAV), ובנוסף נשמר רק קול שהתקבל - השקט בין
+ * מקטעים (DTX) לא נכתב בכלל. בייצוא ב-USB הקובץ מומר ל-WAV בזרימה.
+ *
+ * עמידות לנפילת מתח: כל slot נושא את ה-session של הקובץ (slots ישנים
+ * בשטח שהוקצה מראש לא נראים תקינים), והכותרת מתעדכנת כל כמה שניות עם
+ * נקודת ביקורת - כמה slots ודגימות כבר בטוח בכרטיס. קובץ שלא נסגר
+ * עדיין קריא (סריקה), ו-rec_repair סוגר אותו בסריקה מנקודת הביקורת
+ * בלבד - זמן חסום, לא תלוי באורך ההקלטה.
+ */
+
+#ifndef CORE_REC_FORMAT_H
+#define CORE_REC_FORMAT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "core/adpcm.h"
+#include "hal/storage.h"
+
+// =============================================================================
+// Format Constants
+// =============================================================================
+
+#define REC_MAGIC               "WTRC"
+#define REC_VERSION             1
+#define REC_EXTENSION           ".wtr"
+
+#define REC_SLOT_SIZE           256
+#define REC_AUDIO_HEADER_SIZE   8
+#define REC_AUDIO_DATA_SIZE     (REC_SLOT_SIZE - REC_AUDIO_HEADER_SIZE)
+#define REC_SLOT_SAMPLES        (1 + REC_AUDIO_DATA_SIZE * 2)       // predictor + nibbles
+
+#define REC_INDEX_MAX           256     // רשומות בזיכרון (2KB)
+#define REC_INDEX_INTERVAL      16      // audio slots בין רשומות (~1 שנייה), מוכפל כשמתמלא
+#define REC_INDEX_PER_SLOT      ((REC_SLOT_SIZE - 8) / 8)
+
+#define REC_PEER_ID_LENGTH      11
+
+typedef enum {
+    REC_CODEC_IMA_ADPCM = 1
+} rec_codec_t;
+
+typedef enum {
+    REC_SLOT_AUDIO   = 'A',
+    REC_SLOT_SEGMENT = 'S',
+    REC_SLOT_INDEX   = 'I'
+} rec_slot_type_t;
+
+// =============================================================================
+// On-Disk Structures (little endian)
+// =============================================================================
+
+#pragma pack(push, 1)
+
+typedef struct {
+    char     magic[4];              // "WTRC"
+    uint8_t  version;
+    uint8_t  codec;                 // rec_codec_t
+    uint8_t  channels;
+    uint8_t  reserved0;
+    uint32_t sample_rate;
+    uint32_t created;               // Unix timestamp
+    uint32_t total_samples;         // 0 = הקובץ לא נסגר
+    uint32_t slot_count;
+    uint32_t index_slot;            // ה-slot הראשון של האינדקס
+    uint16_t index_entries;
+    uint16_t slot_samples;          // REC_SLOT_SAMPLES
+    uint16_t session;               // מופיע בכל slot של הקובץ
+    uint16_t reserved1;
+    uint32_t checkpoint_slots;      // slots שנכתבו ו-sync-ו (כולל הכותרת)
+    uint32_t checkpoint_samples;    // הדגימות שבהם
+} rec_file_header_t;
+
+typedef struct {
+    uint8_t  type;                  // REC_SLOT_AUDIO
+    uint8_t  step_index;
+    int16_t  predictor;             // הדגימה הראשונה
+    uint16_t samples;               // דגימות ב-slot (slot אחרון במקטע חלקי)
+    uint16_t session;
+    uint8_t  data[REC_AUDIO_DATA_SIZE];
+} rec_audio_slot_t;
+
+typedef struct {
+    uint8_t  type;                  // REC_SLOT_SEGMENT
+    uint8_t  reserved;
+    uint16_t session;
+    uint32_t start_sample;          // מיקום בהקלטה
+    uint32_t timestamp;             // Unix timestamp מקומי
+    uint32_t remote_timestamp;      // חותמת הזמן של השולח
+    char     peer_id[REC_PEER_ID_LENGTH + 1];
+    int16_t  rssi;
+    int8_t   snr;
+    uint8_t  reserved2;
+} rec_segment_slot_t;
+
+typedef struct {
+    uint32_t slot;
+    uint32_t sample;
+} rec_index_entry_t;
+
+typedef struct {
+    uint8_t  type;                  // REC_SLOT_INDEX
+    uint8_t  reserved;
+    uint16_t count;
+    uint16_t session;
+    uint16_t reserved2;
+    rec_index_entry_t entries[REC_INDEX_PER_SLOT];
+} rec_index_slot_t;
+
+#pragma pack(pop)
+
+// =============================================================================
+// Segment Metadata
+// =============================================================================
+
+typedef struct {
+    char     peer_id[REC_PEER_ID_LENGTH + 1];
+    int16_t  rssi;
+    int8_t   snr;
+    uint32_t timestamp;
+    uint32_t remote_timestamp;
+} rec_segment_info_t;
+
+// =============================================================================
+// Writer
+// =============================================================================
+
+/**
+ * @brief מקבל כל slot מוכן (REC_SLOT_SIZE בתים) לפי הסדר בקובץ
+ */
+typedef void (*rec_emit_callback_t)(const uint8_t* slot, void* ctx);
+
+typedef struct {
+    rec_emit_callback_t emit;
+    void*    ctx;
+
+    uint32_t sample_rate;
+    uint32_t created;
+    uint16_t session;
+
+    adpcm_state_t adpcm;
+    int16_t  pcm[REC_SLOT_SAMPLES];
+    uint16_t pcm_count;
+
+    uint32_t total_samples;
+    uint32_t slot_count;
+    uint32_t audio_slots;
+
+    rec_index_entry_t index[REC_INDEX_MAX];
+    uint16_t index_count;
+    uint32_t index_interval;
+    uint32_t index_slot;
+} rec_writer_t;
+
+/**
+ * @brief התחלת קובץ - שולח slot כותרת (זמני, יעודכן ב-finish)
+ */
+void rec_writer_init(rec_writer_t* w, uint32_t sample_rate, uint32_t created,
+                     rec_emit_callback_t emit, void* ctx);
+
+/**
+ * @brief הוספת דגימות
+ */
+void rec_writer_audio(rec_writer_t* w, const int16_t* samples, uint32_t count);
+
+/**
+ * @brief תחילת מקטע חדש (סוגר את ה-slot החלקי)
+ */
+void rec_writer_segment(rec_writer_t* w, const rec_segment_info_t* info);
+
+/**
+ * @brief כותרת נקודת ביקורת (הקובץ עדיין פתוח)
+ * @param w מצב
+ * @param slots slots שכבר בכרטיס (כולל הכותרת)
+ * @param samples הדגימות ב-slots האלה
+ * @param header פלט לכתיבה ב-slot 0
+ */
+void rec_writer_checkpoint(const rec_writer_t* w, uint32_t slots, uint32_t samples,
+                           uint8_t header[REC_SLOT_SIZE]);
+
+/**
+ * @brief סיום - slot חלקי אחרון ואינדקס
+ * @param header פלט: הכותרת הסופית, לכתיבה מחדש ב-slot 0
+ */
+void rec_writer_finish(rec_writer_t* w, uint8_t header[REC_SLOT_SIZE]);
+
+// =============================================================================
+// Reader
+// =============================================================================
+
+typedef struct {
+    storage_file_t file;
+    rec_file_header_t header;
+    uint32_t slot_total;            // slots בקובץ (לפי הגודל)
+    uint32_t total_samples;
+
+    uint32_t next_slot;
+    uint32_t position;              // הדגימה הבאה שתוחזר
+
+    int16_t  pcm[REC_SLOT_SAMPLES];
+    uint16_t pcm_count;
+    uint16_t pcm_pos;
+
+    rec_segment_info_t segment;     // המקטע של המיקום הנוכחי
+    bool     has_segment;
+} rec_reader_t;
+
+/**
+ * @brief פתיחת הקלטה לקריאה
+ * @return false אם זה לא קובץ הקלטה תקין
+ */
+bool rec_reader_open(rec_reader_t* r, const char* path);
+
+/**
+ * @brief סגירה
+ */
+void rec_reader_close(rec_reader_t* r);
+
+/**
+ * @brief קריאת דגימות PCM
+ * @return מספר דגימות (0 = סוף)
+ */
+uint32_t rec_reader_read(rec_reader_t* r, int16_t* out, uint32_t max_samples);
+
+/**
+ * @brief דילוג לדגימה (דרך האינדקס, ואז פענוח קדימה)
+ */
+bool rec_reader_seek(rec_reader_t* r, uint32_t sample);
+
+/**
+ * @brief מטא-דאטה של המקטע הנוכחי
+ * @return false אם עוד לא עברנו תחילת מקטע
+ */
+bool rec_reader_get_segment(const rec_reader_t* r, rec_segment_info_t* info);
+
+// =============================================================================
+// Recovery
+// =============================================================================
+
+/**
+ * @brief סגירת הקלטה שנקטעה (נפילת מתח)
+ *
+ * סורק מנקודת הביקורת האחרונה עד ה-slot התקין האחרון (לכל היותר
+ * max_scan_slots), מקצץ את הזנב וכותב כותרת סופית בלי אינדקס.
+ * @param path נתיב הקובץ
+ * @param max_scan_slots גבול לסריקה
+ * @return true אם הקובץ תקין עכשיו (או שכבר היה סגור)
+ */
+bool rec_repair(const char* path, uint32_t max_scan_slots);
+
+// =============================================================================
+// Export
+// =============================================================================
+
+/**
+ * @brief מקבל בתים של ה-WAV המיוצא
+ * @return false לעצירת הייצוא
+ */
+typedef bool (*rec_output_callback_t)(const uint8_t* data, uint32_t length, void* ctx);
+
+/**
+ * @brief גודל ה-WAV שייוצא (header + PCM)
+ */
+uint32_t rec_export_wav_size(const rec_reader_t* r);
+
+/**
+ * @brief ייצוא הקלטה פתוחה כ-WAV 16 ביט, בזרימה
+ * @return true אם כל הקובץ יוצא
+ */
+bool rec_export_wav(rec_reader_t* r, rec_output_callback_t output, void* ctx);
+
+#endif // CORE_REC_FORMAT_H
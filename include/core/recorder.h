@@ -0,0 +1,127 @@
+/**
+ * @file recorder.h
+ * @brief צינור הקלטה - תור בלי נעילות ו-task כתיבה ברקע
+ *
+ * נתיב האודיו לא נוגע בקבצים: הוא רק מעתיק דגימות לתור SPSC
+ * (כותב אחד, קורא אחד) וחוזר מיד. task בעדיפות נמוכה מרוקן את התור,
+ * ממיר לקצב ההקלטה, מקודד ל-ADPCM (rec_format.h) וכותב לכרטיס:
+ * - כל כתיבה היא בלוק מלא של RECORDER_WRITE_BLOCK, מיושר לסקטור בקובץ
+ * - clusters מוקצים מראש בקפיצות של RECORDER_PREALLOC_BYTES
+ * - עיכוב של הכרטיס (עד ~2 שניות) נספג בתור; מעבר לזה דגימות נזרקות
+ *   ונספרות - האודיו עצמו אף פעם לא נחסם
+ * - כל RECORDER_CHECKPOINT_MS הכותרת מתעדכנת ועושים sync; קובץ יומן
+ *   מחזיק את ההקלטה הפתוחה, ובאתחול אחרי נפילת מתח היא נסגרת (rec_repair)
+ *
+ * עם RECORDER_RING_ENABLED (ומחיצת RECORDER_RING_PARTITION) ההקלטה תמידית
+ * ונכתבת לטבעת על ה-flash הגולמי (hal/flash_ring.h) במקום לקבצים;
+ * recorder_save מעתיק את ההקלטה מהטבעת - הדקות האחרונות - לקובץ .wtr.
+ *
+ * recorder_push / recorder_start / recorder_stop נקראים מאותו task.
+ */
+
+#ifndef CORE_RECORDER_H
+#define CORE_RECORDER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+#include "core/rec_format.h"
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#ifndef RECORDER_QUEUE_SAMPLES
+#define RECORDER_QUEUE_SAMPLES      16384           // 32KB, ~2 שניות ב-8kHz (חזקת 2)
+#endif
+#define RECORDER_WRITE_BLOCK        8192            // בתים לכתיבה (16 סקטורים)
+#define RECORDER_PREALLOC_BYTES     (64 * 1024)     // הקצאה מראש (~16 שניות ADPCM ב-8kHz)
+#define RECORDER_CHUNK_SAMPLES      256             // דגימות לכל מעבר של ה-resampler
+#define RECORDER_POLL_MS            200             // ה-task מתעורר לפחות בקצב הזה
+#define RECORDER_MAX_MARKERS        8               // תחילות מקטעים בהמתנה (חזקת 2)
+#define RECORDER_SEGMENT_GAP_MS     1000            // הפסקה בקבלה שפותחת מקטע חדש
+#define RECORDER_CHECKPOINT_MS      5000            // עדכון כותרת + sync (מה שיאבד בנפילת מתח)
+#define RECORDER_REPAIR_MAX_SLOTS   (2 * RECORDER_PREALLOC_BYTES / REC_SLOT_SIZE)   // גבול סריקה בתיקון
+#define RECORDER_JOURNAL_NAME       "ACTIVE.JNL"    // בתיקיית ההקלטות
+#define RECORDER_RING_PARTITION     "recordings"    // מחיצה גולמית לטבעת
+
+// =============================================================================
+// Statistics
+// =============================================================================
+
+typedef struct {
+    uint32_t samples_written;       // דגימות בקובץ (בקצב ההקלטה)
+    uint32_t bytes_written;
+    uint32_t blocks_written;
+    uint32_t dropped_samples;       // התור היה מלא
+    uint32_t queue_high_water;      // מילוי מקסימלי של התור (דגימות)
+    uint32_t max_write_ms;          // הכתיבה האיטית ביותר
+    uint32_t write_errors;
+    uint32_t checkpoints;
+} recorder_stats_t;
+
+// =============================================================================
+// API Functions
+// =============================================================================
+
+/**
+ * @brief אתחול (ויצירת ה-task ב-ESP32). סוגר הקלטה שנקטעה, אם יש.
+ * אחרי storage_init.
+ * @param input_rate קצב הדגימות שנדחפות לתור
+ * @return true בהצלחה
+ */
+bool recorder_init(uint32_t input_rate);
+
+/**
+ * @brief התחלת הקלטה (הקובץ נפתח ב-task הכתיבה)
+ * @return false אם כבר מקליטים
+ */
+bool recorder_start(void);
+
+/**
+ * @brief סיום הקלטה - ה-task מרוקן את התור וסוגר את הקובץ
+ */
+void recorder_stop(void);
+
+/**
+ * @brief האם הקלטה פעילה (כולל סגירה שעוד לא הסתיימה)
+ */
+bool recorder_is_active(void);
+
+/**
+ * @brief דחיפת דגימות לתור - לא חוסם
+ * @param samples דגימות בקצב input_rate
+ * @param count מספר דגימות
+ * @return false אם לא מקליטים או שהתור מלא (הדגימות נזרקות)
+ */
+bool recorder_push(const int16_t* samples, uint16_t count);
+
+/**
+ * @brief תחילת מקטע חדש (דובר חדש / אחרי הפסקה) - לפני הדגימות שלו
+ * @param info מטא-דאטה של המקטע
+ * @return false אם לא מקליטים או שיש יותר מדי מקטעים בהמתנה
+ */
+bool recorder_mark_segment(const rec_segment_info_t* info);
+
+/**
+ * @brief צעד כתיבה (בסימולטור; ב-ESP32 ה-task עושה את זה)
+ */
+void recorder_update(void);
+
+/**
+ * @brief האם ההקלטה נכתבת לטבעת ה-flash (ולא לקבצים)
+ */
+bool recorder_uses_ring(void);
+
+/**
+ * @brief שמירת ההקלטה הנוכחית מהטבעת לקובץ (ב-task הכתיבה)
+ * @return false אם אין טבעת או שלא מקליטים
+ */
+bool recorder_save(void);
+
+/**
+ * @brief סטטיסטיקות
+ */
+void recorder_get_stats(recorder_stats_t* stats);
+
+#endif // CORE_RECORDER_H
@@ -0,0 +1,98 @@
+/**
+ * @file resampler.h
+ * @brief המרת קצב דגימה - polyphase FIR ב-fixed point
+ *
+ * מנוע אחד לכל היחסים:
+ * - 2:1 (16kHz -> 8kHz), 1:2 (8kHz -> 16kHz)
+ * - יחס שברי קרוב ל-1 (תיקון סחיפת שעון, ±ppm)
+ *
+ * המסנן (windowed sinc) מחושב באתחול לפי היחס: בהורדת קצב ה-cutoff
+ * יורד לנייקוויסט של קצב היציאה כדי למנוע aliasing. בין שתי פאזות
+ * סמוכות יש אינטרפולציה לינארית, כך שגם יחס שברי נקי.
+ */
+
+#ifndef CORE_RESAMPLER_H
+#define CORE_RESAMPLER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#define RESAMPLER_PHASES        32      // פאזות בטבלה
+#define RESAMPLER_TAPS          24      // מקדמים לפאזה (השהיה של TAPS/2 דגימות)
+#define RESAMPLER_FRAC_BITS     16      // מיקום שברי Q16
+#define RESAMPLER_MAX_PPM       2000    // תיקון סחיפה מקסימלי
+
+// =============================================================================
+// State
+// =============================================================================
+
+typedef struct {
+    uint32_t in_rate;
+    uint32_t out_rate;
+    bool     bypass;                    // אותו קצב בלי תיקון - העתקה (באותה השהיה)
+
+    uint32_t step_nominal;              // in/out ב-Q16
+    uint32_t step;                      // כולל תיקון ppm
+    int32_t  ppm;
+    uint32_t frac;                      // מיקום בין דגימות קלט (Q16)
+
+    // מקדמים Q15; שורה PHASES = שורה 0 מוזזת בדגימה (לאינטרפולציה)
+    int16_t  coeffs[RESAMPLER_PHASES + 1][RESAMPLER_TAPS];
+
+    // היסטוריית קלט (כפולה, רציפה בזיכרון)
+    int16_t  history[RESAMPLER_TAPS * 2];
+    uint16_t history_pos;
+} resampler_t;
+
+// =============================================================================
+// API Functions
+// =============================================================================
+
+/**
+ * @brief אתחול ממיר
+ * @param rs מצב
+ * @param in_rate קצב קלט
+ * @param out_rate קצב פלט
+ * @return true בהצלחה (יחס בטווח 1:4 עד 4:1)
+ */
+bool resampler_init(resampler_t* rs, uint32_t in_rate, uint32_t out_rate);
+
+/**
+ * @brief איפוס היסטוריה ומיקום (בלי לחשב מקדמים מחדש)
+ */
+void resampler_reset(resampler_t* rs);
+
+/**
+ * @brief תיקון עדין של היחס (סחיפת שעון)
+ * @param rs מצב
+ * @param ppm חיובי = יותר דגימות פלט (מאריך), שלילי = פחות
+ */
+void resampler_set_drift_ppm(resampler_t* rs, int32_t ppm);
+
+/**
+ * @brief המרת בלוק
+ * @param rs מצב
+ * @param in דגימות קלט
+ * @param in_count מספר דגימות קלט
+ * @param out באפר פלט
+ * @param out_max גודל באפר פלט
+ * @return מספר דגימות פלט
+ */
+uint16_t resampler_process(resampler_t* rs, const int16_t* in, uint16_t in_count,
+                           int16_t* out, uint16_t out_max);
+
+/**
+ * @brief מספר דגימות פלט מקסימלי לבלוק קלט נתון
+ */
+uint16_t resampler_max_output(const resampler_t* rs, uint16_t in_count);
+
+/**
+ * @brief האם זה ממיר "שקוף" (אותו קצב)
+ */
+bool resampler_is_bypass(const resampler_t* rs);
+
+#endif // CORE_RESAMPLER_H
@@ -7,6 +7,11 @@
  * - task_audio_out: פלט אודיו לרמקול (עדיפות גבוהה)
  * - task_comm:      תקשורת RF (עדיפות בינונית)
  * - task_ui:        ממשק משתמש (עדיפות נמוכה)
+ * - rec_writer:     כתיבת הקלטות לכרטיס (עדיפות נמוכה ביותר מעל idle)
+ *
+ * כרגע audio_task (hal/audio.c) עושה גם קלט וגם פלט ונרשם כ-TASK_ID_AUDIO_IN,
+ * והלופ הראשי (app_main) מריץ תקשורת, פרוטוקול ו-UI ונרשם כ-TASK_ID_MAIN.
+ * tasks_get_stats מודד רק tasks שנרשמו ב-tasks_watchdog_register.
  */
 
 #ifndef CORE_TASKS_H
@@ -45,17 +50,26 @@
 #define TASK_PRIORITY_COMM          (configMAX_PRIORITIES - 2)  // High
 #define TASK_PRIORITY_PROTOCOL      (configMAX_PRIORITIES - 3)  // Medium-High
 #define TASK_PRIORITY_UI            (configMAX_PRIORITIES - 4)  // Medium
+#define TASK_PRIORITY_STORAGE       2                            // Low (background I/O)
 #define TASK_PRIORITY_IDLE          1                            // Lowest
 
 // =============================================================================
 // Stack Sizes
 // =============================================================================
 
-#define TASK_STACK_AUDIO_IN         2048
+#define TASK_STACK_AUDIO_IN         4096    // audio_task: קלט ופלט יחד
 #define TASK_STACK_AUDIO_OUT        2048
 #define TASK_STACK_COMM             4096
 #define TASK_STACK_PROTOCOL         3072
 #define TASK_STACK_UI               2048
+#define TASK_STACK_STORAGE          4096    // FATFS צריך מחסנית
+
+// app_main - נקבע ב-sdkconfig, כאן רק בשביל דוח השימוש
+#ifdef CONFIG_ESP_MAIN_TASK_STACK_SIZE
+    #define TASK_STACK_MAIN         CONFIG_ESP_MAIN_TASK_STACK_SIZE
+#else
+    #define TASK_STACK_MAIN         3584
+#endif
 
 // =============================================================================
 // Task Handles
@@ -208,12 +222,15 @@ EventBits_t tasks_wait_event(
 // =============================================================================
 
 typedef struct {
-    uint32_t run_count;             // פעמים שה-task רץ
-    uint32_t wake_count;            // פעמים שה-task התעורר
-    uint32_t error_count;           // שגיאות
-    uint32_t high_watermark;        // שימוש מקסימלי ב-stack
-    uint32_t avg_runtime_us;        // זמן ריצה ממוצע
-    uint32_t last_run_time;         // זמן ריצה אחרון
+    const char* name;               // שם ה-task ב-FreeRTOS; NULL = לא רשום
+    uint32_t run_count;             // סיבובי לופ (tasks_watchdog_feed)
+    uint32_t wake_count;            // סיבובים מאז הקריאה הקודמת
+    uint32_t error_count;           // פעמים שה-watchdog מצא אותו תקוע
+    uint32_t high_watermark;        // שימוש מקסימלי ב-stack (בתים)
+    uint32_t stack_size;            // גודל ה-stack (בתים, TASK_STACK_*)
+    uint32_t avg_runtime_us;        // זמן CPU ממוצע לסיבוב, מאז הקריאה הקודמת
+    uint32_t last_run_time;         // ms מאז ה-feed האחרון
+    uint8_t  cpu_percent;           // מאז הקריאה הקודמת
 } task_stats_t;
 
 typedef struct {
@@ -222,17 +239,30 @@ typedef struct {
     task_stats_t comm;
     task_stats_t protocol;
     task_stats_t ui;
+    task_stats_t storage;
+    task_stats_t main;
     uint32_t free_heap;
     uint32_t min_free_heap;
+    uint32_t min_free_internal;     // RAM פנימי (DMA, מחסניות) - נגמר לפני PSRAM
     uint32_t uptime_seconds;
 } system_stats_t;
 
 /**
  * @brief קבלת סטטיסטיקות מערכת
+ *
+ * זמני CPU מהמונים של FreeRTOS (CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+ * ו-CONFIG_FREERTOS_USE_TRACE_FACILITY), מחושבים כהפרש מהקריאה הקודמת -
+ * קוראים במרווחים קבועים. בלי run-time stats השדות נשארים 0.
  * @param stats מצביע לקבלת הסטטיסטיקות
  */
 void tasks_get_stats(system_stats_t* stats);
 
+/**
+ * @brief הסטטיסטיקות של task לפי מזהה (TASK_ID_*)
+ * @return NULL למזהה לא חוקי
+ */
+const task_stats_t* tasks_stats_of(const system_stats_t* stats, uint8_t task_id);
+
 // =============================================================================
 // Individual Task Declarations
 // =============================================================================
@@ -306,22 +336,55 @@ void task_ui(void* param);
 // =============================================================================
 
 /**
- * @brief רישום task ל-watchdog
+ * @brief מזהי tasks - הסדר של השדות ב-system_stats_t
+ */
+typedef enum {
+    TASK_ID_AUDIO_IN = 0,
+    TASK_ID_AUDIO_OUT,
+    TASK_ID_COMM,
+    TASK_ID_PROTOCOL,
+    TASK_ID_UI,
+    TASK_ID_STORAGE,
+    TASK_ID_MAIN,
+    TASK_ID_COUNT
+} task_id_t;
+
+#define TASK_WATCHDOG_TIMEOUT_MS    5000    // ייצוא USB ארוך חוסם את הלופ הראשי לכמה שניות
+#define TASK_WATCHDOG_CHECK_MS      1000
+
+/**
+ * @brief רישום ה-task הנוכחי לסטטיסטיקות ול-watchdog
+ *
+ * ב-ESP32 הרישום הראשון מפעיל esp_timer שבודק כל TASK_WATCHDOG_CHECK_MS,
+ * כך שגם תקיעה של הלופ הראשי מתגלה.
+ * @param task_id מזהה ה-task
+ * @param timeout_ms זמן מקסימלי בין feeds; 0 = סטטיסטיקות בלבד
+ */
+void tasks_watchdog_register(uint8_t task_id, uint32_t timeout_ms);
+
+/**
+ * @brief הסרת רישום - לפני שה-task נמחק
  * @param task_id מזהה ה-task
  */
-void tasks_watchdog_register(uint8_t task_id);
+void tasks_watchdog_unregister(uint8_t task_id);
 
 /**
- * @brief דיווח פעילות ל-watchdog
+ * @brief דיווח פעילות ל-watchdog - פעם בסיבוב לופ
  * @param task_id מזהה ה-task
  */
 void tasks_watchdog_feed(uint8_t task_id);
 
 /**
- * @brief בדיקת watchdog
+ * @brief בדיקת watchdog - task תקוע נרשם בלוג בשמו (פעם אחת לכל תקיעה)
  * @return true אם כל ה-tasks מדווחים
  */
 bool tasks_watchdog_check(void);
 
+/**
+ * @brief שם ה-task האחרון שנמצא תקוע
+ * @return NULL אם לא היה
+ */
+const char* tasks_watchdog_last_stalled(void);
+
 #endif // CORE_TASKS_H
 
@@ -0,0 +1,177 @@
+/**
+ * @file telemetry.h
+ * @brief מדדים מאוחדים - מונים, היסטוגרמות השהיה ו-snapshot בינארי
+ *
+ * כל מדד הוא תא קבוע ברישום (enum), כך שעדכון הוא פעולה אטומית אחת
+ * בלי נעילה - בטוח ממשימת האודיו, מה-callback של הרדיו ומהלופ הראשי.
+ *
+ * - מונים: telemetry_inc מהמקום שבו האירוע קורה, או telemetry_set
+ *   מתוך ה-collector שמעתיק סטטיסטיקות קיימות (radio/audio/...) רגע
+ *   לפני snapshot
+ * - היסטוגרמות: דליי log2 במיקרו-שניות, ועוד count/sum/min/max
+ * - snapshot: מבנה בינארי קומפקטי (USB_FRAME_METRICS, scripts/wt_usb.py
+ *   metrics), פקודת הטקסט METRICS, ושורת לוג כל TELEMETRY_LOG_INTERVAL_MS
+ */
+
+#ifndef CORE_TELEMETRY_H
+#define CORE_TELEMETRY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// =============================================================================
+// Constants
+// =============================================================================
+
+#define TELEMETRY_MAGIC             0x4D545457  // "WTTM"
+#define TELEMETRY_VERSION           1
+#define TELEMETRY_HIST_BUCKETS      16
+#define TELEMETRY_HIST_MIN_SHIFT    6           // דלי 0: מתחת ל-64us; דלי i: [2^(i+5), 2^(i+6))
+
+// =============================================================================
+// Registry
+// =============================================================================
+
+/**
+ * @brief מונים ומדדים רגעיים. סדר קבוע - הוספה רק בסוף (המחשב מפענח לפי אינדקס)
+ */
+typedef enum {
+    TM_UPTIME_MS = 0,
+    TM_HEAP_FREE,
+    TM_HEAP_MIN_FREE,
+    TM_VOICE_TX_FRAMES,         // חבילות קול ששודרו
+    TM_VOICE_SID_TX,            // SID/DTX במקום קול
+    TM_VOICE_RX_FRAMES,         // חבילות קול שהתקבלו
+    TM_RADIO_TX_PACKETS,
+    TM_RADIO_RX_PACKETS,
+    TM_RADIO_CRC_ERRORS,
+    TM_RADIO_TX_TIMEOUTS,
+    TM_AUDIO_FRAMES_CAPTURED,
+    TM_AUDIO_FRAMES_PLAYED,
+    TM_AUDIO_UNDERRUNS,
+    TM_PLAYBACK_DROPPED,        // תור ההשמעה מלא
+    TM_PLAYBACK_MISSED,         // פערי sequence
+    TM_PLAYBACK_MAX_FILL,
+    TM_USB_BYTES_TX,
+    TM_USB_BYTES_RX,
+    TM_USB_RX_STALLS,           // טבעת הקבלה מלאה (flow control)
+    TM_METRIC_COUNT
+} telemetry_metric_t;
+
+/**
+ * @brief היסטוגרמות השהיה
+ */
+typedef enum {
+    TM_HIST_CAPTURE_TO_TX = 0,  // סוף קריאת I2S עד שהחבילה בתור הרדיו
+    TM_HIST_RX_TO_PLAYOUT,      // הגעת חבילה עד שה-frame יוצא ל-DAC
+    TM_HIST_TX_AIRTIME,         // תחילת TX עד TX done
+    TM_HIST_RENDER,             // ציור מסך (render_state)
+    TM_HIST_COUNT
+} telemetry_hist_t;
+
+// =============================================================================
+// Snapshot
+// =============================================================================
+
+#pragma pack(push, 1)
+typedef struct {
+    uint32_t count;
+    uint32_t sum_us;            // גולש - ממוצע לפי הפרש בין snapshots
+    uint32_t min_us;
+    uint32_t max_us;
+    uint32_t buckets[TELEMETRY_HIST_BUCKETS];
+} telemetry_hist_snapshot_t;
+
+typedef struct {
+    uint32_t magic;             // TELEMETRY_MAGIC
+    uint8_t  version;
+    uint8_t  metric_count;      // TM_METRIC_COUNT
+    uint8_t  hist_count;        // TM_HIST_COUNT
+    uint8_t  bucket_count;      // TELEMETRY_HIST_BUCKETS
+    uint32_t metrics[TM_METRIC_COUNT];
+    telemetry_hist_snapshot_t hist[TM_HIST_COUNT];
+} telemetry_snapshot_t;
+#pragma pack(pop)
+
+/**
+ * @brief נקרא לפני כל snapshot כדי להעתיק סטטיסטיקות של מודולים
+ */
+typedef void (*telemetry_collector_t)(void);
+
+// =============================================================================
+// API Functions
+// =============================================================================
+
+/**
+ * @brief זמן מונוטוני במיקרו-שניות (גולש כל ~71 דקות)
+ */
+uint32_t telemetry_now_us(void);
+
+/**
+ * @brief הוספה למונה
+ */
+void telemetry_add(telemetry_metric_t metric, uint32_t value);
+
+/**
+ * @brief הוספת 1 למונה
+ */
+static inline void telemetry_inc(telemetry_metric_t metric) {
+    telemetry_add(metric, 1);
+}
+
+/**
+ * @brief קביעת ערך (מדד רגעי או העתק של מונה קיים)
+ */
+void telemetry_set(telemetry_metric_t metric, uint32_t value);
+
+/**
+ * @brief רישום מדידה בהיסטוגרמה
+ */
+void telemetry_record(telemetry_hist_t hist, uint32_t us);
+
+/**
+ * @brief רישום משך מ-start (telemetry_now_us) עד עכשיו
+ */
+static inline void telemetry_record_since(telemetry_hist_t hist, uint32_t start_us) {
+    telemetry_record(hist, telemetry_now_us() - start_us);
+}
+
+/**
+ * @brief רישום ה-collector (אחד)
+ */
+void telemetry_set_collector(telemetry_collector_t collector);
+
+/**
+ * @brief צילום כל המדדים
+ */
+void telemetry_snapshot(telemetry_snapshot_t* snapshot);
+
+/**
+ * @brief אחוזון מוערך מהדליים (הגבול העליון של הדלי)
+ */
+uint32_t telemetry_hist_percentile(const telemetry_hist_snapshot_t* hist, uint8_t percent);
+
+/**
+ * @brief איפוס ההיסטוגרמות (המונים ממשיכים לרוץ)
+ */
+void telemetry_reset_histograms(void);
+
+/**
+ * @brief שמות לתצוגה
+ */
+const char* telemetry_metric_name(telemetry_metric_t metric);
+const char* telemetry_hist_name(telemetry_hist_t hist);
+
+/**
+ * @brief טקסט קריא של snapshot (פקודת METRICS)
+ * @return אורך הטקסט
+ */
+size_t telemetry_format(char* buffer, size_t size);
+
+/**
+ * @brief שורת לוג תקופתית - מהלופ הראשי
+ */
+void telemetry_update(void);
+
+#endif // CORE_TELEMETRY_H
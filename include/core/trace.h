@@ -0,0 +1,139 @@
+/**
+ * @file trace.h
+ * @brief מקליט trace לנתיבים החמים - אירועי begin/end בטבעת לכל ליבה
+ *
+ * TRACE_BEGIN/TRACE_END מסמנים אזור (audio_task, radio_handle_interrupt,
+ * render_state, ...). כל אירוע הוא 8 בתים: מונה מחזורים
+ * (esp_cpu_get_cycle_count, ב-host ננו-שניות מ-clock_gettime), מזהה אזור,
+ * שלב והמשימה שרשמה אותו. לכל ליבה טבעת משלה - הרישום הוא חיפוש בטבלת
+ * משימות קטנה ו-fetch_add אחד על אינדקס מקומי, בלי נעילה ובלי תחרות בין
+ * ליבות; כשהטבעת מלאה נדרסים הישנים.
+ *
+ * עלות:
+ * - TRACE_ENABLED 0 (ברירת מחדל): המאקרו ריקים, אין קוד ואין זיכרון
+ * - מקומפל אבל לא פעיל: קריאה של דגל אחד וקפיצה
+ * - הטבעות מוקצות רק ב-trace_start
+ *
+ * הייצוא הוא Chrome Trace Event JSON (פותחים ב-ui.perfetto.dev או
+ * chrome://tracing): track לכל משימה (גם כשהיא עוברת ליבה), ts במיקרו-שניות
+ * מ-trace_start. כל E מוצמד ל-B של אותו אזור באותה משימה; אירוע בלי בן זוג
+ * (נדרס בטבעת) לא נכתב.
+ * דרך USB_FRAME_TRACE (scripts/wt_usb.py trace) או פקודת הטקסט TRACE.
+ */
+
+#ifndef CORE_TRACE_H
+#define CORE_TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+
+// =============================================================================
+// Constants
+// =============================================================================
+
+#define TRACE_RING_EVENTS       1024        // לכל ליבה (חזקה של 2), 8KB
+#define TRACE_MAX_CORES         2
+#define TRACE_MAX_TASKS         16          // משימות נפרדות בייצוא; השאר ב-"other"
+#define TRACE_MAX_DEPTH         8           // קינון אזורים בתוך משימה
+
+// =============================================================================
+// Regions
+// =============================================================================
+
+/**
+ * @brief אזורים מסומנים. השמות ב-trace.c
+ */
+typedef enum {
+    TRACE_AUDIO_CAPTURE = 0,    // מעבר לכידה ב-audio_task (אחרי קריאת I2S)
+    TRACE_AUDIO_AEC,            // aec_process
+    TRACE_AUDIO_DSP,            // process_input_samples
+    TRACE_AUDIO_PLAYBACK,       // מעבר השמעה ב-audio_task
+    TRACE_VOICE_TX,             // on_audio_captured: VAD, resampling, שליחה
+    TRACE_VOICE_RX,             // טיפול בחבילת קול נכנסת
+    TRACE_RADIO_SEND,           // radio_send
+    TRACE_RADIO_IRQ,            // radio_handle_interrupt
+    TRACE_RENDER,               // render_state
+    TRACE_USB_UPDATE,           // usb_update
+    TRACE_REGION_COUNT
+} trace_region_t;
+
+typedef enum {
+    TRACE_PHASE_BEGIN = 0,
+    TRACE_PHASE_END
+} trace_phase_t;
+
+// =============================================================================
+// Statistics
+// =============================================================================
+
+typedef struct {
+    bool     running;
+    uint8_t  cores;
+    uint32_t events[TRACE_MAX_CORES];   // אירועים שנרשמו בכל ליבה (כולל שנדרסו)
+} trace_stats_t;
+
+/**
+ * @brief פלט הייצוא - אותה חתימה כמו rec_output_callback_t
+ * @return false לעצירה
+ */
+typedef bool (*trace_output_t)(const uint8_t* data, uint32_t length, void* ctx);
+
+// =============================================================================
+// Recording
+// =============================================================================
+
+extern volatile bool g_trace_running;
+
+/**
+ * @brief רישום אירוע - דרך המאקרו, לא ישירות
+ */
+void trace_event(trace_region_t region, trace_phase_t phase);
+
+#if TRACE_ENABLED
+    #define TRACE_BEGIN(region) \
+        do { if (g_trace_running) trace_event((region), TRACE_PHASE_BEGIN); } while (0)
+    #define TRACE_END(region) \
+        do { if (g_trace_running) trace_event((region), TRACE_PHASE_END); } while (0)
+#else
+    #define TRACE_BEGIN(region) ((void)0)
+    #define TRACE_END(region)   ((void)0)
+#endif
+
+// =============================================================================
+// API Functions
+// =============================================================================
+
+/**
+ * @brief התחלת הקלטה - הקצאת הטבעות (בפעם הראשונה) וניקוין
+ * @return false אם TRACE_ENABLED 0 או שאין זיכרון
+ */
+bool trace_start(void);
+
+/**
+ * @brief עצירת ההקלטה - התוכן נשמר לייצוא
+ */
+void trace_stop(void);
+
+/**
+ * @brief האם מקליט
+ */
+bool trace_is_running(void);
+
+/**
+ * @brief ייצוא JSON של התוכן (עוצר הקלטה פעילה קודם)
+ * @return false אם הפלט נעצר
+ */
+bool trace_export_json(trace_output_t output, void* ctx);
+
+/**
+ * @brief סטטיסטיקות
+ */
+void trace_get_stats(trace_stats_t* stats);
+
+/**
+ * @brief שם אזור
+ */
+const char* trace_region_name(trace_region_t region);
+
+#endif // CORE_TRACE_H
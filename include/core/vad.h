@@ -0,0 +1,130 @@
+/**
+ * @file vad.h
+ * @brief זיהוי דיבור (VAD), שידור לא רציף (DTX) ורעש נוחות (CNG)
+ *
+ * צד שולח:
+ * - VAD לפי אנרגיה + zero-crossing rate מול רצפת רעש אדפטיבית
+ * - hangover: ממשיכים לשדר זמן קצר אחרי סוף הדיבור (סופי מילים)
+ * - בשקט: חבילת DTX אחת ואז SID תקופתי עם רמת הרעש, במקום frames מלאים
+ *
+ * צד מקבל:
+ * - comfort noise ברמה שהתקבלה ב-SID, כדי שהשקט לא יישמע כניתוק
+ */
+
+#ifndef CORE_VAD_H
+#define CORE_VAD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#define VAD_HANGOVER_MS         300     // המשך שידור אחרי סוף דיבור
+#define VAD_SID_INTERVAL_MS     480     // מרווח בין חבילות SID בשקט
+#define VAD_MIN_ENERGY          200     // מתחת לזה תמיד שקט (RMS)
+#define VAD_SPEECH_RATIO_Q4     48      // אנרגיה > 3.0 * רצפת רעש (Q4)
+#define VAD_UNVOICED_RATIO_Q4   24      // 1.5 * רצפה + ZCR גבוה = עיצור
+#define VAD_ZCR_UNVOICED        30      // ZCR (לכל 100 דגימות) של עיצורים שורקים
+
+// =============================================================================
+// Types
+// =============================================================================
+
+typedef enum {
+    DTX_SEND_VOICE = 0,         // דיבור (או hangover) - לשלוח frame
+    DTX_SEND_DTX_START,         // מעבר לשקט - לשלוח MSG_VOICE_DTX
+    DTX_SEND_SID,               // עדכון SID תקופתי
+    DTX_SUPPRESS                // שקט - לא לשדר
+} dtx_action_t;
+
+typedef struct {
+    bool     enabled;
+    uint32_t noise_floor;       // רצפת רעש (RMS)
+    uint32_t sid_level;         // רמת רעש ל-SID (RMS לפני gate)
+    bool     in_speech;         // כולל hangover
+    uint32_t hangover_left;     // דגימות שנותרו ב-hangover
+    uint32_t since_sid;         // דגימות מאז SID אחרון
+    uint32_t sample_rate;
+
+    // סטטיסטיקות
+    uint32_t frames_sent;
+    uint32_t frames_suppressed;
+    uint32_t sid_sent;
+} vad_state_t;
+
+typedef struct {
+    bool     active;            // הצד השני בשקט - לייצר רעש
+    uint16_t level;             // RMS יעד
+    uint32_t seed;              // מצב מחולל רעש
+    int32_t  lp_state;          // מסנן low-pass לרעש רך יותר
+} comfort_noise_t;
+
+// =============================================================================
+// API Functions - VAD / DTX (TX)
+// =============================================================================
+
+/**
+ * @brief אתחול VAD
+ * @param vad מצב
+ * @param sample_rate קצב דגימה
+ */
+void vad_init(vad_state_t* vad, uint32_t sample_rate);
+
+/**
+ * @brief הפעלת/כיבוי DTX (כבוי = תמיד DTX_SEND_VOICE)
+ */
+void vad_set_enabled(vad_state_t* vad, bool enabled);
+
+/**
+ * @brief ניתוח בלוק דגימות והחלטה מה לשדר
+ * @param vad מצב
+ * @param samples דגימות אחרי עיבוד
+ * @param count מספר דגימות
+ * @param input_level RMS לפני noise gate (להערכת רעש ל-SID)
+ * @return פעולה לביצוע
+ */
+dtx_action_t vad_process(vad_state_t* vad, const int16_t* samples, uint16_t count,
+                         uint16_t input_level);
+
+/**
+ * @brief רמת הרעש הנוכחית לשליחה ב-SID
+ */
+uint16_t vad_get_sid_level(const vad_state_t* vad);
+
+/**
+ * @brief איפוס מצב (תחילת שידור חדש)
+ */
+void vad_reset(vad_state_t* vad);
+
+// =============================================================================
+// API Functions - Comfort Noise (RX)
+// =============================================================================
+
+/**
+ * @brief אתחול מחולל רעש נוחות
+ */
+void comfort_noise_init(comfort_noise_t* cn);
+
+/**
+ * @brief עדכון מ-SID שהתקבל (מפעיל רעש)
+ * @param cn מצב
+ * @param level RMS מה-SID
+ */
+void comfort_noise_update(comfort_noise_t* cn, uint16_t level);
+
+/**
+ * @brief עצירת רעש (חזר דיבור / סוף שיחה)
+ */
+void comfort_noise_stop(comfort_noise_t* cn);
+
+/**
+ * @brief יצירת בלוק רעש נוחות
+ * @param cn מצב
+ * @param out באפר פלט
+ * @param count מספר דגימות
+ */
+void comfort_noise_generate(comfort_noise_t* cn, int16_t* out, uint16_t count);
+
+#endif // CORE_VAD_H
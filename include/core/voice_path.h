@@ -0,0 +1,87 @@
+/**
+ * @file voice_path.h
+ * @brief נתיב הקול בין האודיו לפרוטוקול
+ *
+ * שידור: VAD/DTX, המרה לקצב הרדיו ו-protocol_send_voice / protocol_send_sid.
+ * קבלה: המרה מקצב הרדיו (כולל תיקון סחיפת שעון), jitter buffer ההשמעה
+ * ורעש נוחות בזמן DTX.
+ *
+ * main.c ו-test_latency קוראים לאותן פונקציות - הבדיקה מודדת את הנתיב
+ * של המכשיר ולא עותק שלו.
+ *
+ * voice_path_capture נקרא ממשימת האודיו; כל השאר מהלולאה הראשית.
+ */
+
+#ifndef CORE_VOICE_PATH_H
+#define CORE_VOICE_PATH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "comm/protocol.h"
+#include "core/audio_buffer.h"
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#ifndef VOICE_PATH_JITTER_DEPTH
+#define VOICE_PATH_JITTER_DEPTH     4       // frames לפני תחילת השמעה
+#endif
+
+// =============================================================================
+// API Functions
+// =============================================================================
+
+/**
+ * @brief אתחול ה-VAD, רעש הנוחות ו-buffer ההשמעה
+ * @param capture_rate קצב הלכידה/השמעה
+ * @note אחריו voice_path_set_link_rate
+ */
+void voice_path_init(uint32_t capture_rate);
+
+/**
+ * @brief קביעת קצב הקול ברדיו (wideband/narrowband) בלי לאתחל את I2S
+ * @return false אם הצירוף לא נתמך ע"י ה-resampler
+ */
+bool voice_path_set_link_rate(uint32_t capture_rate, uint32_t link_rate);
+
+/**
+ * @brief איפוס ה-VAD בתחילת שידור
+ */
+void voice_path_tx_reset(void);
+
+/**
+ * @brief frame מהמיקרופון: VAD ושליחה כקול או SID
+ */
+void voice_path_capture(const int16_t* samples, uint16_t sample_count);
+
+/**
+ * @brief חבילת קול שהתקבלה: המרה לקצב ההשמעה וכתיבה ל-jitter buffer
+ * @param voice החבילה (MSG_VOICE_DATA)
+ * @param samples מקבל את הדגימות אחרי ההמרה (בתוקף עד הקריאה הבאה)
+ * @return מספר הדגימות
+ */
+uint16_t voice_path_receive(const voice_data_t* voice, const int16_t** samples);
+
+/**
+ * @brief SID שהתקבל (MSG_VOICE_DTX / MSG_VOICE_SILENCE) - מפעיל רעש נוחות
+ */
+void voice_path_receive_sid(const voice_sid_t* sid);
+
+/**
+ * @brief עצירת רעש הנוחות (סיום שיחה)
+ */
+void voice_path_stop_comfort_noise(void);
+
+/**
+ * @brief התחלת השמעה כשה-jitter buffer מוכן, רעש נוחות ותיקון סחיפה
+ * @param now זמן נוכחי (ms)
+ */
+void voice_path_update(uint32_t now);
+
+/**
+ * @brief buffer ההשמעה (ל-audio_start_playback ולמדדים)
+ */
+audio_ring_buffer_t* voice_path_playback_buffer(void);
+
+#endif // CORE_VOICE_PATH_H
@@ -27,8 +27,12 @@
 #define AUDIO_BITS_8            8
 #define AUDIO_BITS_16           16
 
+#ifndef AUDIO_DMA_BUFFER_COUNT
 #define AUDIO_DMA_BUFFER_COUNT  4
-#define AUDIO_DMA_BUFFER_SIZE   512
+#endif
+#ifndef AUDIO_DMA_BUFFER_SIZE
+#define AUDIO_DMA_BUFFER_SIZE   512     // דגימות לבלוק DMA
+#endif
 
 // =============================================================================
 // Audio Mode
@@ -79,6 +83,7 @@ typedef struct {
     uint16_t peak_input_level;
     uint16_t peak_output_level;
     uint16_t avg_input_level;
+    int16_t  aec_erle_db;       // הד שהוסר (dB, duplex בלבד)
 } audio_stats_t;
 
 // =============================================================================
@@ -284,6 +289,12 @@ void audio_set_noise_gate_threshold(uint16_t threshold);
  */
 void audio_enable_agc(bool enable);
 
+/**
+ * @brief הפעלת/כיבוי ביטול הד (פעיל רק במצב duplex)
+ * @param enable true להפעלה
+ */
+void audio_enable_aec(bool enable);
+
 // =============================================================================
 // API Functions - Utility
 // =============================================================================
@@ -321,5 +332,23 @@ void audio_play_tone(uint16_t frequency, uint16_t duration_ms);
  */
 void audio_beep(void);
 
+// =============================================================================
+// Simulator
+// =============================================================================
+
+#ifndef ESP32
+/**
+ * @brief דגימות "מהמיקרופון" - אותו מסלול לכידה כמו audio_task
+ * (taps, AEC, DSP, ואז ה-buffer או ה-callback של ההקלטה)
+ */
+void sim_audio_capture(const int16_t* samples, uint16_t count);
+
+/**
+ * @brief הרמקול מושך count דגימות דרך מסלול ההשמעה של audio_task
+ * @return דגימות שהושמעו; השאר ב-out הוא שקט (underrun)
+ */
+uint16_t sim_audio_playback(int16_t* out, uint16_t count);
+#endif
+
 #endif // HAL_AUDIO_H
 
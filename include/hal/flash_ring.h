@@ -0,0 +1,117 @@
+/**
+ * @file flash_ring.h
+ * @brief טבעת רשומות על מחיצת flash גולמית (בלי מערכת קבצים)
+ *
+ * FAT על ה-flash הפנימי מעדכן FAT ורשומת תיקייה בכל כתיבה - אותם
+ * סקטורים נמחקים שוב ושוב. כאן המחיצה היא יומן מעגלי:
+ * - כתיבה רק קדימה, ברשומות של FLASH_RING_RECORD_SIZE (עמוד flash אחד)
+ * - כל סקטור (4KB) מתחיל בעמוד כותרת עם מספר סידורי ו-tag
+ * - FLASH_RING_ERASE_AHEAD סקטורים לפני הראש תמיד מחוקים מראש, כך
+ *   שכתיבה היא תכנות עמוד בלבד (~1ms) - המחיקה (~45ms) ב-maintain
+ * - כשהטבעת מלאה, הסקטור הישן ביותר נמחק - ההקלטות הישנות נדרסות
+ * כל סקטור נמחק פעם אחת לכל סיבוב של הטבעת - שחיקה אחידה על כל המחיצה.
+ *
+ * הבית הראשון של רשומה לא יכול להיות 0xFF (כך מזהים עמוד ריק).
+ * ב-ESP32 דרך esp_partition; בסימולטור קובץ שמדמה flash.
+ */
+
+#ifndef HAL_FLASH_RING_H
+#define HAL_FLASH_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#define FLASH_RING_SECTOR_SIZE      4096
+#define FLASH_RING_RECORD_SIZE      256
+#define FLASH_RING_RECORDS_PER_SECTOR   (FLASH_RING_SECTOR_SIZE / FLASH_RING_RECORD_SIZE - 1)
+#define FLASH_RING_ERASE_AHEAD      2           // סקטורים מחוקים לפני הראש
+#define FLASH_RING_MIN_SECTORS      (FLASH_RING_ERASE_AHEAD + 4)
+#define FLASH_RING_SIM_FILE         "simulated_flash_ring.bin"
+#define FLASH_RING_SIM_SIZE         (1024 * 1024)
+
+// =============================================================================
+// Statistics
+// =============================================================================
+
+typedef struct {
+    uint32_t sector_count;
+    uint32_t records_written;
+    uint32_t sectors_erased;
+    uint32_t inline_erases;         // append שחיכה למחיקה (maintain לא הספיק)
+    uint32_t write_errors;
+    uint32_t max_append_us;
+} flash_ring_stats_t;
+
+// =============================================================================
+// API Functions
+// =============================================================================
+
+/**
+ * @brief פתיחת המחיצה ומציאת הראש (סריקה של כותרות הסקטורים)
+ * @param label שם המחיצה בטבלה
+ * @return false אם אין מחיצה כזו או שהיא קטנה מדי
+ */
+bool flash_ring_init(const char* label);
+
+/**
+ * @brief סגירה
+ */
+void flash_ring_deinit(void);
+
+/**
+ * @brief האם הטבעת פתוחה
+ */
+bool flash_ring_is_ready(void);
+
+/**
+ * @brief התחלת רצף חדש - הרשומה הבאה פותחת סקטור חדש עם ה-tag הזה
+ * @return המספר הסידורי של הסקטור שייפתח
+ */
+uint32_t flash_ring_begin(uint32_t tag);
+
+/**
+ * @brief הוספת רשומה (FLASH_RING_RECORD_SIZE בתים)
+ */
+bool flash_ring_append(const void* record);
+
+/**
+ * @brief מחיקה מראש של הסקטורים הבאים - מה-task הכותב, בין כתיבות
+ */
+void flash_ring_maintain(void);
+
+/**
+ * @brief המספר הסידורי של הסקטור הנוכחי (הראש)
+ */
+uint32_t flash_ring_head_seq(void);
+
+/**
+ * @brief המספר הסידורי הישן ביותר שעוד לא נדרס
+ */
+uint32_t flash_ring_oldest_seq(void);
+
+/**
+ * @brief קריאת כותרת סקטור
+ * @param seq מספר סידורי
+ * @param tag פלט (אופציונלי)
+ * @return false אם הסקטור כבר נדרס או עוד לא נכתב
+ */
+bool flash_ring_sector_tag(uint32_t seq, uint32_t* tag);
+
+/**
+ * @brief קריאת רשומות מסקטור
+ * @param seq מספר סידורי
+ * @param records פלט: עד FLASH_RING_RECORDS_PER_SECTOR רשומות
+ * @return מספר הרשומות שנכתבו בסקטור (0 אם נדרס)
+ */
+uint32_t flash_ring_read_sector(uint32_t seq, void* records);
+
+/**
+ * @brief סטטיסטיקות
+ */
+void flash_ring_get_stats(flash_ring_stats_t* stats);
+
+#endif // HAL_FLASH_RING_H
@@ -22,6 +22,8 @@
 #define STORAGE_MAX_PATH_LENGTH     128
 #define STORAGE_MAX_FILENAME_LENGTH 64
 #define STORAGE_BUFFER_SIZE         512
+#define STORAGE_IO_BLOCK_SIZE       8192    // כתיבה/העתקה בבלוקים (כפולה של סקטור)
+#define STORAGE_SECTOR_SIZE         512
 #define STORAGE_MAX_RECORDINGS      1000
 #define STORAGE_RECORDING_DIR       "/recordings"
 #define STORAGE_CONFIG_DIR          "/config"
@@ -53,14 +55,16 @@ typedef enum {
     STORAGE_ERROR_FORMAT,
     STORAGE_ERROR_INVALID_PATH,
     STORAGE_ERROR_ALREADY_EXISTS,
-    STORAGE_ERROR_NO_SPACE
+    STORAGE_ERROR_NO_SPACE,
+    STORAGE_ERROR_BUSY              // יש קבצים פתוחים בכרטיס
 } storage_error_t;
 
 typedef enum {
     FILE_MODE_READ = 0,
     FILE_MODE_WRITE,
     FILE_MODE_APPEND,
-    FILE_MODE_READ_WRITE
+    FILE_MODE_READ_WRITE,
+    FILE_MODE_WRITE_STREAM      // כתיבה בבלוקים גדולים - בלי באפר stdio
 } file_mode_t;
 
 // =============================================================================
@@ -165,6 +169,38 @@ bool storage_sd_is_mounted(void);
  */
 storage_error_t storage_sd_get_info(storage_info_t* info);
 
+// =============================================================================
+// SD Raw Sectors (USB Mass Storage)
+// =============================================================================
+
+#define STORAGE_SD_SECTOR_SIZE  512
+
+/**
+ * @brief ניתוק ה-FAT מה-VFS - הכרטיס נשאר פעיל לגישה ישירה
+ *
+ * כל עוד המחשב מחזיק בדיסק אסור לפתוח קבצים ב-SD: storage_file_open
+ * נכשל על נתיבי SD, ו-storage_recording_dir נכשל (לא עובר ל-SPIFFS).
+ *
+ * @param sector_count פלט: מספר הסקטורים בכרטיס
+ * @return STORAGE_OK בהצלחה, STORAGE_ERROR_BUSY אם קובץ ב-SD עדיין פתוח
+ */
+storage_error_t storage_sd_raw_begin(uint32_t* sector_count);
+
+/**
+ * @brief קריאת סקטורים רצופים - פקודה אחת (CMD18) גם לכמה סקטורים
+ */
+storage_error_t storage_sd_read_sectors(void* dst, uint32_t sector, uint32_t count);
+
+/**
+ * @brief כתיבת סקטורים רצופים - פקודה אחת (CMD25) גם לכמה סקטורים
+ */
+storage_error_t storage_sd_write_sectors(const void* src, uint32_t sector, uint32_t count);
+
+/**
+ * @brief חיבור ה-FAT מחדש ובניית הקטלוג (המחשב יכול היה לשנות קבצים)
+ */
+void storage_sd_raw_end(void);
+
 // =============================================================================
 // SPIFFS Operations
 // =============================================================================
@@ -248,7 +284,7 @@ storage_error_t storage_file_seek(storage_file_t* file, int32_t offset, int when
 uint32_t storage_file_tell(storage_file_t* file);
 
 /**
- * @brief סנכרון קובץ לדיסק
+ * @brief סנכרון קובץ לדיסק (כולל גודל הקובץ ברשומת התיקייה)
  */
 storage_error_t storage_file_sync(storage_file_t* file);
 
@@ -257,6 +293,23 @@ storage_error_t storage_file_sync(storage_file_t* file);
  */
 bool storage_file_eof(storage_file_t* file);
 
+/**
+ * @brief הקצאה מראש של מקום לקובץ
+ *
+ * ב-FAT ההקצאה של clusters חדשים (חיפוש ב-FAT ועדכונה) היא החלק האיטי
+ * בכתיבה. הקצאה מראש מוציאה אותה מנתיב הכתיבה השוטף.
+ * המיקום הנוכחי לא משתנה.
+ * @param file מבנה קובץ
+ * @param size גודל כולל (בתים)
+ * @return STORAGE_OK בהצלחה, STORAGE_ERROR_NO_SPACE אם אין מקום
+ */
+storage_error_t storage_file_preallocate(storage_file_t* file, uint32_t size);
+
+/**
+ * @brief קיצוץ קובץ לגודל נתון (שחרור הקצאה מראש שלא נוצלה)
+ */
+storage_error_t storage_file_truncate(storage_file_t* file, uint32_t size);
+
 // =============================================================================
 // File Management
 // =============================================================================
@@ -319,11 +372,37 @@ int32_t storage_dir_list(const char* path, file_info_t* files, uint32_t max_coun
 // =============================================================================
 
 /**
- * @brief התחלת הקלטה חדשה
+ * @brief תיקיית ההקלטות הפעילה (SD, ואם אין - SPIFFS)
+ */
+storage_error_t storage_recording_dir(char* path, size_t path_size);
+
+/**
+ * @brief יצירת קובץ הקלטה ריק (שם לפי זמן, SD ואם אין - SPIFFS)
+ * @param file מבנה קובץ (פלט, פתוח לכתיבה בבלוקים)
+ * @param extension סיומת הקובץ (NULL = RECORDING_EXTENSION)
+ * @param path_out הנתיב המלא שנוצר (אופציונלי)
+ * @param path_size גודל path_out
+ * @return STORAGE_OK בהצלחה
+ */
+storage_error_t storage_recording_create(storage_file_t* file, const char* extension,
+                                         char* path_out, size_t path_size);
+
+/**
+ * @brief נתיב מלא של הקלטה לפי שם קובץ
+ * @param filename שם בלבד (בלי תיקיות)
+ * @param path פלט
+ * @param path_size גודל הפלט
+ * @return STORAGE_OK אם הקובץ נמצא
+ */
+storage_error_t storage_recording_get_path(const char* filename, char* path, size_t path_size);
+
+/**
+ * @brief התחלת הקלטת WAV חדשה
  * @param file מבנה קובץ (פלט)
+ * @param sample_rate קצב דגימה לקובץ (0 = AUDIO_RECORD_RATE)
  * @return STORAGE_OK בהצלחה
  */
-storage_error_t storage_recording_start(storage_file_t* file);
+storage_error_t storage_recording_start(storage_file_t* file, uint32_t sample_rate);
 
 /**
  * @brief סיום הקלטה ועדכון header
@@ -333,7 +412,7 @@ storage_error_t storage_recording_start(storage_file_t* file);
 storage_error_t storage_recording_finish(storage_file_t* file, uint32_t sample_count);
 
 /**
- * @brief קבלת רשימת הקלטות
+ * @brief קבלת רשימת הקלטות (מהקטלוג, מהחדשה לישנה)
  * @param recordings מערך פלט
  * @param max_count גודל מקסימלי
  * @return מספר הקלטות
@@ -429,6 +508,21 @@ storage_error_t storage_wav_write_header(storage_file_t* file,
                                          uint8_t bits_per_sample,
                                          uint8_t channels);
 
+/**
+ * @brief בניית WAV header בזיכרון (לייצוא בזרימה, בלי קובץ יעד)
+ * @param buffer פלט - 44 בתים
+ * @param sample_rate קצב דגימה
+ * @param bits_per_sample ביטים לדגימה
+ * @param channels ערוצים
+ * @param data_size גודל נתוני האודיו
+ * @return גודל ה-header
+ */
+uint32_t storage_wav_build_header(uint8_t* buffer,
+                                  uint32_t sample_rate,
+                                  uint8_t bits_per_sample,
+                                  uint8_t channels,
+                                  uint32_t data_size);
+
 /**
  * @brief עדכון WAV header עם גודל סופי
  * @param file קובץ פתוח
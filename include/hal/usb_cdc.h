@@ -6,6 +6,7 @@
  * - USB CDC לתקשורת סריאלית
  * - USB Mass Storage לגישה לכרטיס SD
  * - גיבוי וייצוא הקלטות דרך USB
+ * - פרוטוקול בינארי במסגרות (usb_proto.h) לצד פקודות הטקסט
  */
 
 #ifndef HAL_USB_CDC_H
@@ -19,7 +20,9 @@
 // USB Constants
 // =============================================================================
 
-#define USB_CDC_BUFFER_SIZE     512
+#define USB_CDC_BUFFER_SIZE     512         // באפר הקבלה של TinyUSB
+#define USB_CDC_RX_RING_SIZE    2048        // טבעת הקבלה שלנו (חזקה של 2)
+#define USB_CDC_WRITE_TIMEOUT_MS 100        // המתנה ל-FIFO מלא לפני ויתור
 #define USB_VID                 0x303A      // Espressif VID
 #define USB_PID                 0x4001      // Custom PID for Walkie-Talkie
 #define USB_MANUFACTURER        "WT-PRO"
@@ -76,6 +79,7 @@ typedef struct {
     bool msc_connected;
     uint32_t bytes_sent;
     uint32_t bytes_received;
+    uint32_t rx_stalls;         // פעמים שהטבעת התמלאה והמחשב הושהה
     char serial_number[32];
 } usb_info_t;
 
@@ -127,7 +131,7 @@ void usb_get_info(usb_info_t* info);
 bool usb_cdc_is_connected(void);
 
 /**
- * @brief שליחת נתונים דרך CDC
+ * @brief שליחת נתונים דרך CDC (לתור; נשלח ב-usb_update או ב-flush_tx)
  * @param data נתונים לשליחה
  * @param length אורך
  * @return מספר בתים שנשלחו
@@ -150,6 +154,10 @@ int32_t usb_cdc_printf(const char* format, ...);
 
 /**
  * @brief קריאת נתונים מ-CDC
+ *
+ * הקבלה היא טבעת SPSC: ה-callback של TinyUSB כותב, והלופ הראשי קורא.
+ * פונקציות הקריאה (read/readline/available/flush_rx) רק מהלופ הראשי.
+ *
  * @param buffer באפר פלט
  * @param max_length גודל מקסימלי
  * @return מספר בתים שנקראו
@@ -158,9 +166,13 @@ int32_t usb_cdc_read(uint8_t* buffer, size_t max_length);
 
 /**
  * @brief קריאת שורה מ-CDC
+ *
+ * שורה שעוד לא הגיעה עד הסוף נשארת בטבעת. שורה ארוכה מהבאפר
+ * מוחזרת בחלקים.
+ *
  * @param buffer באפר פלט
  * @param max_length גודל מקסימלי
- * @return מספר בתים שנקראו (כולל \n)
+ * @return מספר בתים שנקראו (כולל \n או \r), 0 אם אין שורה שלמה
  */
 int32_t usb_cdc_readline(char* buffer, size_t max_length);
 
@@ -198,7 +210,8 @@ bool usb_msc_is_connected(void);
  * 
  * כשמופעל, כרטיס ה-SD יופיע כדיסק נייד במחשב
  * 
- * @return true בהצלחה
+ * @return true בהצלחה; false בזמן הקלטה לקובץ או כשקובץ ב-SD פתוח
+ *         (קודם recorder_stop)
  */
 bool usb_msc_enable(void);
 
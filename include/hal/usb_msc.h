@@ -0,0 +1,103 @@
+/**
+ * @file usb_msc.h
+ * @brief דיסק USB Mass Storage מעל סקטורי ה-SD - מטמון כתיבה וקריאה מוקדמת
+ *
+ * המחשב קורא וכותב בבקשות SCSI של עד CONFIG_TINYUSB_MSC_BUFSIZE. כל בקשה
+ * הופכת להעברת SD אחת של כמה סקטורים (CMD18/CMD25) במקום סקטור לכל
+ * טרנזקציית SPI:
+ * - קריאה מוקדמת: חלון של USB_MSC_READAHEAD_SECTORS אחרי כל החטאה,
+ *   כך שקריאה רציפה (העתקת הקלטות) עולה העברה אחת לכל חלון
+ * - מטמון כתיבה: רצף סקטורים סמוכים נאסף ונכתב ב-CMD25 אחד - כשהרצף
+ *   נשבר, כשהמטמון מלא, ב-SYNCHRONIZE CACHE, בהוצאת הדיסק, או אחרי
+ *   USB_MSC_FLUSH_IDLE_MS בלי כתיבות (usb_msc_disk_update)
+ *
+ * הקריאות מ-TinyUSB (משימת ה-USB) ומהלופ הראשי מוגנות ב-mutex.
+ */
+
+#ifndef HAL_USB_MSC_H
+#define HAL_USB_MSC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// =============================================================================
+// Constants
+// =============================================================================
+
+#define USB_MSC_SECTOR_SIZE         512
+#define USB_MSC_READAHEAD_SECTORS   64      // 32KB
+#define USB_MSC_WRITE_CACHE_SECTORS 32      // 16KB
+#define USB_MSC_FLUSH_IDLE_MS       200
+
+// =============================================================================
+// Statistics
+// =============================================================================
+
+typedef struct {
+    uint32_t read_hits;             // סקטורים מחלון הקריאה
+    uint32_t read_misses;           // סקטורים שנקראו מה-SD
+    uint32_t write_sectors;         // סקטורים שהתקבלו מהמחשב
+    uint32_t write_flushes;         // העברות CMD25 בפועל
+    uint32_t sd_transfers;          // כל הפקודות ל-SD
+    uint32_t errors;
+} usb_msc_stats_t;
+
+// =============================================================================
+// API Functions
+// =============================================================================
+
+/**
+ * @brief פתיחת הדיסק - ניתוק ה-FAT והקצאת המטמונים
+ * @return true בהצלחה
+ */
+bool usb_msc_disk_open(void);
+
+/**
+ * @brief סגירת הדיסק - כתיבת המטמון וחיבור ה-FAT מחדש
+ */
+void usb_msc_disk_close(void);
+
+/**
+ * @brief האם הדיסק פתוח (והמחשב לא הוציא אותו)
+ */
+bool usb_msc_disk_is_open(void);
+
+/**
+ * @brief מספר הסקטורים בדיסק
+ */
+uint32_t usb_msc_disk_sectors(void);
+
+/**
+ * @brief קריאת סקטורים לבקשת המחשב
+ * @return true בהצלחה
+ */
+bool usb_msc_disk_read(uint32_t sector, void* buffer, uint32_t count);
+
+/**
+ * @brief כתיבת סקטורים מהמחשב (למטמון; ל-SD אולי רק אחר כך)
+ * @return true בהצלחה
+ */
+bool usb_msc_disk_write(uint32_t sector, const void* buffer, uint32_t count);
+
+/**
+ * @brief כתיבת המטמון ל-SD
+ * @return true בהצלחה
+ */
+bool usb_msc_disk_flush(void);
+
+/**
+ * @brief האם יש במטמון נתונים שעוד לא נכתבו
+ */
+bool usb_msc_disk_dirty(void);
+
+/**
+ * @brief כתיבת המטמון אחרי זמן בלי כתיבות - מהלופ הראשי
+ */
+void usb_msc_disk_update(void);
+
+/**
+ * @brief סטטיסטיקות
+ */
+void usb_msc_disk_get_stats(usb_msc_stats_t* stats);
+
+#endif // HAL_USB_MSC_H
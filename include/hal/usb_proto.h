@@ -0,0 +1,152 @@
+/**
+ * @file usb_proto.h
+ * @brief פרוטוקול בינארי ב-USB CDC - מסגרות עם אורך, סוג, מזהה בקשה ו-CRC
+ *
+ * פקודות הטקסט (INFO/STATUS/...) נשארות לשימוש ידני בטרמינל. תוכנה
+ * במחשב מדברת במסגרות:
+ *
+ *   A5 5A | length (2) | type (1) | flags (1) | request_id (2) | payload | crc16 (2)
+ *
+ * - CRC-16/CCITT (0x1021, התחלה 0xFFFF) על כל מה שאחרי ה-sync
+ * - תשובה חוזרת עם אותו type ו-request_id ו-USB_FRAME_FLAG_RESPONSE
+ * - נתונים גדולים (הקלטות, לוגים, טלמטריה) בזרם: רצף מסגרות של עד
+ *   USB_PROTO_MAX_PAYLOAD עם USB_FRAME_FLAG_STREAM, האחרונה גם עם END
+ * - הבית הראשון 0xA5 מבדיל מסגרת משורת טקסט
+ *
+ * כל הכתיבה ל-CDC נעשית מה-context של usb_update (הלופ הראשי).
+ */
+
+#ifndef HAL_USB_PROTO_H
+#define HAL_USB_PROTO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// =============================================================================
+// Frame Format
+// =============================================================================
+
+#define USB_PROTO_SYNC0             0xA5
+#define USB_PROTO_SYNC1             0x5A
+#define USB_PROTO_HEADER_SIZE       8
+#define USB_PROTO_CRC_SIZE          2
+#define USB_PROTO_MAX_PAYLOAD       4096    // מסגרות זרם (64 חבילות full-speed)
+#define USB_PROTO_MAX_REQUEST       256     // מסגרות נכנסות
+
+#define USB_FRAME_FLAG_RESPONSE     0x01
+#define USB_FRAME_FLAG_STREAM       0x02
+#define USB_FRAME_FLAG_END          0x04
+#define USB_FRAME_FLAG_ERROR        0x08
+
+/**
+ * @brief סוגי מסגרות. 0x40 ומעלה - זרמים יזומים מהמכשיר (request_id 0)
+ */
+typedef enum {
+    USB_FRAME_PING      = 0x01,     // payload חוזר כמו שהוא
+    USB_FRAME_COMMAND   = 0x02,     // פקודת טקסט; התשובה כטקסט
+    USB_FRAME_LIST      = 0x10,     // u32 first, u16 count -> rec_catalog_entry_t[]
+    USB_FRAME_READ      = 0x11,     // u32 offset, שם -> בתי הקובץ בזרם
+    USB_FRAME_EXPORT    = 0x12,     // שם -> WAV בזרם
+    USB_FRAME_DELETE    = 0x13,     // שם
+    USB_FRAME_TAP       = 0x14,     // u8 mask (ריק - שאילתה) -> u8 mask פעיל
+    USB_FRAME_METRICS   = 0x15,     // u8 reset (אופציונלי) -> telemetry_snapshot_t
+    USB_FRAME_TRACE     = 0x16,     // u8 1 start / 0 stop -> u8 running; ריק -> JSON בזרם
+    USB_FRAME_AUDIO_TAP = 0x40      // יזום: usb_tap_frame_t ודגימות (usb_tap.h)
+} usb_frame_type_t;
+
+typedef enum {
+    USB_PROTO_ERR_UNKNOWN_TYPE = 1,
+    USB_PROTO_ERR_BAD_REQUEST,
+    USB_PROTO_ERR_NOT_FOUND,
+    USB_PROTO_ERR_IO
+} usb_proto_error_t;
+
+#pragma pack(push, 1)
+typedef struct {
+    uint8_t  sync[2];
+    uint16_t length;                // payload בלבד
+    uint8_t  type;                  // usb_frame_type_t
+    uint8_t  flags;
+    uint16_t request_id;
+} usb_frame_header_t;
+#pragma pack(pop)
+
+// =============================================================================
+// Streams
+// =============================================================================
+
+/**
+ * @brief זרם יוצא - נתונים נאספים למסגרות מלאות
+ */
+typedef struct {
+    uint8_t  type;
+    uint16_t request_id;
+    uint32_t total;                 // בתים שנשלחו בזרם
+    bool     ok;
+} usb_stream_t;
+
+// =============================================================================
+// Statistics
+// =============================================================================
+
+typedef struct {
+    uint32_t frames_rx;
+    uint32_t frames_tx;
+    uint32_t crc_errors;
+    uint32_t dropped_bytes;         // בתים שנזרקו בחיפוש sync
+    uint32_t stream_bytes;
+} usb_proto_stats_t;
+
+// =============================================================================
+// API Functions
+// =============================================================================
+
+/**
+ * @brief CRC-16/CCITT, ניתן לשרשור (התחלה: 0xFFFF)
+ */
+uint16_t usb_proto_crc16(uint16_t crc, const void* data, size_t length);
+
+/**
+ * @brief האם מסגרת נכנסת באמצע קבלה (הבתים הבאים שייכים לה)
+ */
+bool usb_proto_busy(void);
+
+/**
+ * @brief קבלה ועיבוד של מסגרות מבאפר הקבלה של CDC
+ */
+void usb_proto_poll(void);
+
+/**
+ * @brief שליחת מסגרת אחת
+ * @return false אם CDC לא מחובר או שהכתיבה נכשלה
+ */
+bool usb_proto_send(uint8_t type, uint8_t flags, uint16_t request_id,
+                    const void* payload, uint16_t length);
+
+/**
+ * @brief תשובת שגיאה לבקשה
+ */
+bool usb_proto_send_error(uint8_t type, uint16_t request_id, usb_proto_error_t error);
+
+/**
+ * @brief פתיחת זרם (אחד בכל פעם)
+ */
+void usb_proto_stream_begin(usb_stream_t* stream, uint8_t type, uint16_t request_id);
+
+/**
+ * @brief הוספת נתונים לזרם - מסגרת יוצאת בכל USB_PROTO_MAX_PAYLOAD
+ */
+bool usb_proto_stream_write(usb_stream_t* stream, const void* data, uint32_t length);
+
+/**
+ * @brief סיום זרם (מסגרת END, אולי ריקה)
+ */
+bool usb_proto_stream_end(usb_stream_t* stream);
+
+/**
+ * @brief סטטיסטיקות
+ */
+void usb_proto_get_stats(usb_proto_stats_t* stats);
+
+#endif // HAL_USB_PROTO_H
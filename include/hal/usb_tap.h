@@ -0,0 +1,116 @@
+/**
+ * @file usb_tap.h
+ * @brief הזרמת אודיו חי ל-USB - נקודות האזנה (taps) במסלול הקול
+ *
+ * כל tap הוא טבעת SPSC משלו: המפיק (משימת האודיו או הלופ הראשי) מעתיק
+ * דגימות בלי לחכות, ו-usb_tap_poll (מתוך usb_update) שולח אותן למחשב
+ * כמסגרות USB_FRAME_AUDIO_TAP יזומות. כשאין מקום בטבעת הרשומה נזרקת
+ * שלמה - המפיק אף פעם לא נחסם, והפער נראה במחשב לפי ה-seq.
+ *
+ * הקישור ברדיו נושא PCM בקצב הקישור (ללא codec), ולכן ENCODED ו-DECODED
+ * הם ה-PCM שיוצא לרדיו ושנכנס ממנו, לפני/אחרי ה-resampler.
+ */
+
+#ifndef HAL_USB_TAP_H
+#define HAL_USB_TAP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// =============================================================================
+// Constants
+// =============================================================================
+
+#define USB_TAP_RING_SIZE       8192    // בתים לכל tap (חזקה של 2, ~250ms ב-16kHz)
+#define USB_TAP_MAX_RECORD      1040    // דגימות ברשומה אחת (בלוק DMA אחרי resampling 1:2)
+#define USB_TAP_POLL_BUDGET     8192    // בתים לכל קריאה ל-usb_tap_poll
+
+#define USB_TAP_FORMAT_PCM16    0       // PCM חתום 16 ביט, מונו, little-endian
+
+// =============================================================================
+// Taps
+// =============================================================================
+
+typedef enum {
+    USB_TAP_MIC_RAW = 0,    // קלט I2S לפני AEC ו-DSP
+    USB_TAP_MIC_DSP,        // אחרי AEC, gain, gate ו-AGC
+    USB_TAP_ENCODED,        // יוצא לרדיו (קצב הקישור)
+    USB_TAP_DECODED,        // התקבל מהרדיו (קצב הקישור)
+    USB_TAP_PLAYBACK,       // אחרי עוצמה, לפני ה-DAC
+    USB_TAP_COUNT
+} usb_tap_t;
+
+#define USB_TAP_MASK(tap)       (1u << (tap))
+#define USB_TAP_MASK_ALL        ((1u << USB_TAP_COUNT) - 1)
+
+/**
+ * @brief כותרת ה-payload של USB_FRAME_AUDIO_TAP (אחריה הדגימות)
+ */
+#pragma pack(push, 1)
+typedef struct {
+    uint8_t  tap;                   // usb_tap_t
+    uint8_t  format;                // USB_TAP_FORMAT_*
+    uint16_t sample_rate;
+    uint32_t timestamp_us;          // זמן הלכידה אצל המפיק
+    uint16_t seq;                   // לכל tap; פער = רשומות שנזרקו
+    uint16_t reserved;
+} usb_tap_frame_t;
+#pragma pack(pop)
+
+// =============================================================================
+// Statistics
+// =============================================================================
+
+typedef struct {
+    uint32_t mask;
+    uint32_t records_sent[USB_TAP_COUNT];
+    uint32_t records_dropped[USB_TAP_COUNT];
+    uint32_t bytes_sent;
+} usb_tap_stats_t;
+
+// =============================================================================
+// API Functions
+// =============================================================================
+
+/**
+ * @brief בחירת ה-taps הפעילים (מהלופ הראשי)
+ *
+ * טבעת מוקצית בהפעלה הראשונה של tap ונשארת; כיבוי מרוקן אותה.
+ *
+ * @param mask צירוף של USB_TAP_MASK
+ * @return ה-mask שהופעל בפועל (בלי taps שההקצאה שלהם נכשלה)
+ */
+uint32_t usb_tap_set_mask(uint32_t mask);
+
+/**
+ * @brief ה-taps הפעילים
+ */
+uint32_t usb_tap_get_mask(void);
+
+/**
+ * @brief קצב הדגימה שנשלח בכותרת של tap
+ */
+void usb_tap_set_rate(usb_tap_t tap, uint32_t sample_rate);
+
+/**
+ * @brief העתקת דגימות ל-tap - לא חוסם, בטוח ממשימת האודיו
+ *
+ * זול כשה-tap כבוי (בדיקת mask בלבד).
+ *
+ * @param tap ה-tap
+ * @param samples דגימות
+ * @param count מספר דגימות (עד USB_TAP_MAX_RECORD)
+ */
+void usb_tap_push(usb_tap_t tap, const int16_t* samples, uint16_t count);
+
+/**
+ * @brief שליחת מה שהצטבר למחשב (מתוך usb_update)
+ */
+void usb_tap_poll(void);
+
+/**
+ * @brief סטטיסטיקות
+ */
+void usb_tap_get_stats(usb_tap_stats_t* stats);
+
+#endif // HAL_USB_TAP_H
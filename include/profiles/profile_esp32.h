@@ -0,0 +1,18 @@
+/**
+ * @file profile_esp32.h
+ * @brief פרופיל ESP32 (esp32dev): 520KB SRAM, בלי PSRAM
+ *
+ * פרופיל הייחוס - הגדלים הם ברירות המחדל של המודולים, כאן רק התקציב.
+ * גם ברירת המחדל כשאין BUILD_PROFILE (esp32-arduino, native).
+ */
+
+#ifndef PROFILE_ESP32_H
+#define PROFILE_ESP32_H
+
+#define PROFILE_NAME                "esp32"
+#define PROFILE_HAS_PSRAM           0
+
+// .data + .bss ב-DRAM הפנימי, כולל של IDF (נבדק אחרי הלינק: scripts/ram_budget.py)
+#define PROFILE_STATIC_RAM_BUDGET   (144 * 1024)
+
+#endif // PROFILE_ESP32_H
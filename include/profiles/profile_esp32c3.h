@@ -0,0 +1,29 @@
+/**
+ * @file profile_esp32c3.h
+ * @brief פרופיל ESP32-C3: 400KB SRAM, בלי PSRAM
+ *
+ * ה-SRAM משותף לקוד ב-IRAM, ל-heap ולמחסניות ה-tasks - הטבלאות מוקטנות.
+ */
+
+#ifndef PROFILE_ESP32C3_H
+#define PROFILE_ESP32C3_H
+
+#define PROFILE_NAME                "esp32c3"
+#define PROFILE_HAS_PSRAM           0
+
+// .data + .bss ב-DRAM הפנימי, כולל של IDF (נבדק אחרי הלינק: scripts/ram_budget.py)
+#define PROFILE_STATIC_RAM_BUDGET   (96 * 1024)
+
+// Audio
+#define AUDIO_BUFFER_FRAMES         16      // 320ms
+#define AUDIO_DMA_BUFFER_SIZE       256     // דגימות לבלוק DMA
+
+// Protocol
+#define MAX_SAVED_CODES             20
+#define MAX_FREQ_MEMBERS            32
+#define PEER_TABLE_BITS             6       // 64 רשומות
+
+// Recorder
+#define RECORDER_QUEUE_SAMPLES      8192    // 16KB, ~1 שנייה ב-8kHz
+
+#endif // PROFILE_ESP32C3_H
@@ -0,0 +1,26 @@
+/**
+ * @file profile_esp32s3.h
+ * @brief פרופיל ESP32-S3 עם PSRAM
+ *
+ * הטבלאות הגדולות (LARGE_TABLE_ATTR) עוברות ל-PSRAM ולכן גדלות;
+ * באפרי האודיו והרדיו נשארים בזיכרון הפנימי בגודל של ESP32.
+ * דורש CONFIG_SPIRAM_ALLOW_BSS_SEG_EXTERNAL_MEMORY (sdkconfig.defaults.esp32s3).
+ */
+
+#ifndef PROFILE_ESP32S3_H
+#define PROFILE_ESP32S3_H
+
+#define PROFILE_NAME                "esp32s3"
+#define PROFILE_HAS_PSRAM           1
+
+// .data + .bss ב-DRAM הפנימי, בלי PSRAM (נבדק אחרי הלינק: scripts/ram_budget.py)
+#define PROFILE_STATIC_RAM_BUDGET   (96 * 1024)
+
+// Protocol
+#define MAX_SAVED_CODES             100
+#define PEER_TABLE_BITS             9       // 512 רשומות
+
+// Recorder
+#define RECORDER_QUEUE_SAMPLES      65536   // 128KB, ~8 שניות ב-8kHz
+
+#endif // PROFILE_ESP32S3_H
@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+"""
+RAM Budget Script (PlatformIO post-script)
+בודק את ה-RAM הסטטי הפנימי מול תקציב פרופיל הלוח
+
+This script is called automatically by PlatformIO after the ELF is linked.
+It sums the sizes of the internal DRAM sections (.data, .bss, .noinit) as
+the linker placed them and fails the build if they exceed
+PROFILE_STATIC_RAM_BUDGET from the env's build profile (include/profiles).
+PSRAM sections (.ext_ram.*) are reported but not counted.
+"""
+
+import re
+import subprocess
+from pathlib import Path
+
+Import("env")
+
+# סקשנים שיושבים ב-DRAM הפנימי (ESP-IDF, כל ה-targets)
+INTERNAL_SECTIONS = (".dram0.data", ".dram0.bss", ".noinit")
+PSRAM_PREFIX = ".ext_ram"
+DEFAULT_PROFILE = "profiles/profile_esp32.h"
+
+
+def get_profile_path():
+    """Profile header chosen by -DBUILD_PROFILE (same default as config.h)."""
+    profile = DEFAULT_PROFILE
+    for define in env.get("CPPDEFINES", []):
+        if isinstance(define, (tuple, list)) and define[0] == "BUILD_PROFILE":
+            profile = str(define[1]).strip('\\"')
+    return Path(env.get("PROJECT_DIR", ".")) / "include" / profile
+
+
+def get_budget(profile_path):
+    """PROFILE_STATIC_RAM_BUDGET - a plain arithmetic expression like (96 * 1024)."""
+    content = profile_path.read_text(encoding="utf-8")
+    match = re.search(r"#define\s+PROFILE_STATIC_RAM_BUDGET[ \t]+([0-9()*+ \t]+)", content)
+    if not match:
+        return None
+    return int(eval(match.group(1), {"__builtins__": {}}))
+
+
+def get_sections(elf_path):
+    """Section sizes from `size -A`."""
+    output = subprocess.check_output([env.subst("$SIZETOOL"), "-A", str(elf_path)]).decode()
+    sections = {}
+    for line in output.splitlines():
+        parts = line.split()
+        if len(parts) >= 2 and parts[0].startswith(".") and parts[1].isdigit():
+            sections[parts[0]] = int(parts[1])
+    return sections
+
+
+def check_ram_budget(source, target, env):
+    """Fail the build when internal static RAM exceeds the profile budget."""
+    elf_path = Path(str(target[0]))
+    profile_path = get_profile_path()
+
+    budget = get_budget(profile_path)
+    if budget is None:
+        print(f"Error: PROFILE_STATIC_RAM_BUDGET not found in {profile_path}")
+        env.Exit(1)
+
+    sections = get_sections(elf_path)
+    internal = sum(sections.get(name, 0) for name in INTERNAL_SECTIONS)
+    psram = sum(size for name, size in sections.items() if name.startswith(PSRAM_PREFIX))
+
+    print(f"\n{'='*50}")
+    print(f"Profile: {profile_path.name}")
+    for name in INTERNAL_SECTIONS:
+        print(f"  {name:<14} {sections.get(name, 0):>8,} bytes")
+    print(f"Internal static RAM: {internal:,} / {budget:,} bytes ({internal/1024:.1f} KB)")
+    print(f"PSRAM static RAM:    {psram:,} bytes")
+    print(f"{'='*50}\n")
+
+    if internal > budget:
+        print(f"Error: internal static RAM exceeds PROFILE_STATIC_RAM_BUDGET by "
+              f"{internal - budget:,} bytes ({profile_path.name})")
+        env.Exit(1)
+
+# Register post-link action
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", check_ram_budget)
@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+"""
+WT-PRO Live Audio Tap
+קבלת אודיו חי מנקודות האזנה במכשיר (include/hal/usb_tap.h) - שמירה ל-WAV או השמעה
+
+Usage:
+    python scripts/wt_tap.py /dev/ttyACM0 save mic,dsp [--seconds 10] [--prefix tap]
+    python scripts/wt_tap.py /dev/ttyACM0 play rx
+    python scripts/wt_tap.py /dev/ttyACM0 off
+
+Taps: mic (raw), dsp (post-DSP), tx (sent to radio), rx (received), out (playback)
+
+Requires: pip install pyserial  (play: pip install sounddevice)
+"""
+
+import argparse
+import struct
+import sys
+import time
+import wave
+
+from wt_usb import Device, FRAME_TAP, FRAME_AUDIO_TAP
+
+TAPS = {"mic": 0, "dsp": 1, "tx": 2, "rx": 3, "out": 4}
+TAP_NAMES = {v: k for k, v in TAPS.items()}
+TAP_FRAME = struct.Struct("<BBHIHH")    # tap, format, sample_rate, timestamp_us, seq, reserved
+FORMAT_PCM16 = 0
+
+
+def parse_mask(spec):
+    mask = 0
+    for name in spec.split(","):
+        if name not in TAPS:
+            raise SystemExit(f"unknown tap: {name} (use {', '.join(TAPS)})")
+        mask |= 1 << TAPS[name]
+    return mask
+
+
+def set_taps(device, mask):
+    active = device.request(FRAME_TAP, bytes([mask]))[0]
+    if active != mask:
+        print(f"warning: device enabled 0x{active:02X} of 0x{mask:02X}", file=sys.stderr)
+    return active
+
+
+def tap_frames(device, seconds):
+    """Audio frames until the timeout: (tap, rate, timestamp_us, seq, samples)."""
+    end = time.time() + seconds if seconds else None
+    while end is None or time.time() < end:
+        try:
+            frame_type, _, _, payload = device.read_frame()
+        except TimeoutError:
+            continue
+        if frame_type != FRAME_AUDIO_TAP or len(payload) < TAP_FRAME.size:
+            continue
+        tap, fmt, rate, timestamp, seq, _ = TAP_FRAME.unpack_from(payload)
+        if fmt != FORMAT_PCM16:
+            continue
+        yield tap, rate, timestamp, seq, payload[TAP_FRAME.size:]
+
+
+class TapTrack:
+    """Per-tap sequence tracking; gaps are filled with silence."""
+
+    def __init__(self):
+        self.next_seq = None
+        self.lost = 0
+        self.last_len = 0
+
+    def gap(self, seq, length):
+        missing = 0 if self.next_seq is None else (seq - self.next_seq) & 0xFFFF
+        self.next_seq = (seq + 1) & 0xFFFF
+        self.lost += missing
+        fill = b"\0" * (missing * (self.last_len or length))
+        self.last_len = length
+        return fill
+
+
+def save(device, seconds, prefix):
+    writers, tracks = {}, {}
+    try:
+        for tap, rate, _, seq, samples in tap_frames(device, seconds):
+            if tap not in writers:
+                path = f"{prefix}_{TAP_NAMES.get(tap, tap)}.wav"
+                w = wave.open(path, "wb")
+                w.setnchannels(1)
+                w.setsampwidth(2)
+                w.setframerate(rate)
+                writers[tap], tracks[tap] = w, TapTrack()
+                print(f"{path}: {rate} Hz")
+            writers[tap].writeframes(tracks[tap].gap(seq, len(samples)) + samples)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        for tap, w in writers.items():
+            seconds_saved = w.getnframes() / w.getframerate()
+            print(f"{TAP_NAMES.get(tap, tap)}: {seconds_saved:.1f}s, {tracks[tap].lost} records lost")
+            w.close()
+
+
+def play(device, tap_name):
+    import sounddevice
+
+    want = TAPS[tap_name]
+    stream, track = None, TapTrack()
+    try:
+        for tap, rate, _, seq, samples in tap_frames(device, None):
+            if tap != want:
+                continue
+            if stream is None:
+                stream = sounddevice.RawOutputStream(samplerate=rate, channels=1, dtype="int16")
+                stream.start()
+            stream.write(track.gap(seq, len(samples)) + samples)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if stream:
+            stream.stop()
+            stream.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Live audio taps over USB")
+    parser.add_argument("port")
+    parser.add_argument("command", choices=["save", "play", "off"])
+    parser.add_argument("taps", nargs="?", default="mic")
+    parser.add_argument("--seconds", type=float, default=0, help="save: stop after N seconds")
+    parser.add_argument("--prefix", default="tap", help="save: output file prefix")
+    args = parser.parse_args()
+
+    device = Device(args.port, timeout=0.5)
+    try:
+        if args.command == "off":
+            set_taps(device, 0)
+        elif args.command == "save":
+            set_taps(device, parse_mask(args.taps))
+            save(device, args.seconds, args.prefix)
+        else:
+            if "," in args.taps:
+                raise SystemExit("play takes a single tap")
+            set_taps(device, parse_mask(args.taps))
+            play(device, args.taps)
+    finally:
+        # ה-taps נשארים פעילים עד שמכבים אותם
+        if args.command != "off":
+            set_taps(device, 0)
+        device.close()
+
+
+if __name__ == "__main__":
+    main()
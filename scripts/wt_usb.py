@@ -0,0 +1,249 @@
+#!/usr/bin/env python3
+"""
+WT-PRO USB Client
+לקוח לפרוטוקול הבינארי ב-USB CDC (include/hal/usb_proto.h)
+
+Usage:
+    python scripts/wt_usb.py /dev/ttyACM0 ping
+    python scripts/wt_usb.py /dev/ttyACM0 cmd STATUS
+    python scripts/wt_usb.py /dev/ttyACM0 list
+    python scripts/wt_usb.py /dev/ttyACM0 read REC_20241207_120000.wtr
+    python scripts/wt_usb.py /dev/ttyACM0 export REC_20241207_120000.wtr out.wav
+    python scripts/wt_usb.py /dev/ttyACM0 metrics [reset]
+    python scripts/wt_usb.py /dev/ttyACM0 trace out.json [seconds]   (open in ui.perfetto.dev)
+
+Requires: pip install pyserial
+"""
+
+import struct
+import sys
+import time
+
+import serial
+
+SYNC = b"\xA5\x5A"
+HEADER = struct.Struct("<2sHBBH")       # sync, length, type, flags, request_id
+
+FRAME_PING = 0x01
+FRAME_COMMAND = 0x02
+FRAME_LIST = 0x10
+FRAME_READ = 0x11
+FRAME_EXPORT = 0x12
+FRAME_DELETE = 0x13
+FRAME_TAP = 0x14
+FRAME_METRICS = 0x15
+FRAME_TRACE = 0x16
+FRAME_AUDIO_TAP = 0x40
+
+FLAG_RESPONSE = 0x01
+FLAG_STREAM = 0x02
+FLAG_END = 0x04
+FLAG_ERROR = 0x08
+
+CATALOG_ENTRY = struct.Struct("<B3xIIII32s12s")
+
+# include/core/telemetry.h - אותו סדר כמו ה-enums
+TELEMETRY_MAGIC = 0x4D545457
+TELEMETRY_HEADER = struct.Struct("<IBBBB")
+TELEMETRY_HIST_MIN_SHIFT = 6
+METRIC_NAMES = [
+    "uptime_ms", "heap_free", "heap_min_free", "voice_tx", "voice_sid_tx", "voice_rx",
+    "radio_tx", "radio_rx", "radio_crc_err", "radio_tx_timeout", "audio_captured",
+    "audio_played", "audio_underruns", "playback_dropped", "playback_missed",
+    "playback_max_fill", "usb_tx_bytes", "usb_rx_bytes", "usb_rx_stalls",
+]
+HIST_NAMES = ["capture_to_tx", "rx_to_playout", "tx_airtime", "render"]
+
+
+def _crc16_table():
+    table = []
+    for i in range(256):
+        crc = i << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+        table.append(crc & 0xFFFF)
+    return table
+
+
+CRC16_TABLE = _crc16_table()
+
+
+def crc16(data, crc=0xFFFF):
+    """CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)."""
+    for byte in data:
+        crc = ((crc << 8) & 0xFFFF) ^ CRC16_TABLE[(crc >> 8) ^ byte]
+    return crc
+
+
+class Device:
+    """Framed connection to the device."""
+
+    def __init__(self, port, timeout=2.0):
+        # USB CDC ignores the baud rate; large reads keep up with full speed
+        self.serial = serial.Serial(port, 115200, timeout=timeout)
+        self.next_id = 1
+
+    def close(self):
+        self.serial.close()
+
+    def send(self, frame_type, payload=b""):
+        request_id = self.next_id
+        self.next_id = (self.next_id % 0xFFFF) + 1
+        header = HEADER.pack(SYNC, len(payload), frame_type, 0, request_id)
+        crc = crc16(header[2:] + payload)
+        self.serial.write(header + payload + struct.pack("<H", crc))
+        return request_id
+
+    def read_frame(self):
+        """Next valid frame: (type, flags, request_id, payload)."""
+        while True:
+            first = self.serial.read(1)
+            if not first:
+                raise TimeoutError("no response")
+            if first != SYNC[:1]:
+                continue
+            if self.serial.read(1) != SYNC[1:]:
+                continue
+            rest = self.serial.read(HEADER.size - 2)
+            if len(rest) < HEADER.size - 2:
+                raise TimeoutError("no response")
+            length, frame_type, flags, request_id = struct.unpack("<HBBH", rest)
+            payload = self.serial.read(length)
+            crc_bytes = self.serial.read(2)
+            if len(payload) < length or len(crc_bytes) < 2:
+                raise TimeoutError("truncated frame")
+            if crc16(rest + payload) != struct.unpack("<H", crc_bytes)[0]:
+                print("warning: CRC mismatch, frame dropped", file=sys.stderr)
+                continue
+            return frame_type, flags, request_id, payload
+
+    def request(self, frame_type, payload=b"", sink=None):
+        """Send a request and collect the reply (all stream frames)."""
+        request_id = self.send(frame_type, payload)
+        chunks = []
+        while True:
+            rtype, flags, rid, data = self.read_frame()
+            if rid != request_id or not flags & FLAG_RESPONSE:
+                continue        # frames from another stream
+            if flags & FLAG_ERROR and len(data) == 2:
+                raise RuntimeError(f"device error {struct.unpack('<H', data)[0]}")
+            if sink:
+                sink(data)
+            else:
+                chunks.append(data)
+            if not flags & FLAG_STREAM or flags & FLAG_END:
+                return b"".join(chunks)
+
+
+def print_list(device):
+    first = 0
+    while True:
+        data = device.request(FRAME_LIST, struct.pack("<IH", first, 32))
+        count = len(data) // CATALOG_ENTRY.size
+        for i in range(count):
+            state, ts, duration, size, rate, name, peer = CATALOG_ENTRY.unpack_from(
+                data, i * CATALOG_ENTRY.size)
+            name = name.split(b"\0")[0].decode()
+            peer = peer.split(b"\0")[0].decode() or "-"
+            when = time.strftime("%Y-%m-%d %H:%M:%S", time.localtime(ts)) if ts else "-"
+            print(f"{name:28} {when}  {duration / 1000:8.1f}s  {size:9,} B  {peer}")
+        if count < 32:
+            return
+        first += count
+
+
+def percentile(buckets, max_us, percent):
+    """Upper bound of the bucket holding the percentile (telemetry_hist_percentile)."""
+    total = sum(buckets)
+    if not total:
+        return 0
+    target = (total * percent + 99) // 100
+    seen = 0
+    for i, n in enumerate(buckets[:-1]):
+        seen += n
+        if seen >= target:
+            upper = 1 << (i + TELEMETRY_HIST_MIN_SHIFT)
+            return min(max_us, upper)
+    return max_us
+
+
+def print_metrics(device, reset):
+    data = device.request(FRAME_METRICS, b"\x01" if reset else b"")
+    magic, version, metric_count, hist_count, bucket_count = TELEMETRY_HEADER.unpack_from(data)
+    if magic != TELEMETRY_MAGIC:
+        raise ValueError("bad telemetry snapshot")
+
+    offset = TELEMETRY_HEADER.size
+    metrics = struct.unpack_from(f"<{metric_count}I", data, offset)
+    offset += 4 * metric_count
+    for i, value in enumerate(metrics):
+        name = METRIC_NAMES[i] if i < len(METRIC_NAMES) else f"metric_{i}"
+        print(f"{name:20} {value:>12,}")
+
+    print(f"\n{'histogram':20} {'count':>8} {'avg':>8} {'min':>8} {'p50':>8} {'p99':>8} {'max':>8}  (us)")
+    for i in range(hist_count):
+        count, total, low, high, *buckets = struct.unpack_from(f"<4I{bucket_count}I", data, offset)
+        offset += 4 * (4 + bucket_count)
+        name = HIST_NAMES[i] if i < len(HIST_NAMES) else f"hist_{i}"
+        avg = total // count if count else 0
+        print(f"{name:20} {count:>8} {avg:>8} {low:>8} {percentile(buckets, high, 50):>8} "
+              f"{percentile(buckets, high, 99):>8} {high:>8}")
+
+
+def download(device, frame_type, payload, output):
+    start = time.time()
+    total = 0
+    with open(output, "wb") as f:
+        def sink(data):
+            nonlocal total
+            f.write(data)
+            total += len(data)
+        device.request(frame_type, payload, sink)
+    elapsed = max(time.time() - start, 1e-6)
+    print(f"{output}: {total:,} bytes in {elapsed:.2f}s ({total / elapsed / 1024:.0f} KB/s)")
+
+
+def main():
+    if len(sys.argv) < 3:
+        print(__doc__)
+        sys.exit(1)
+
+    device = Device(sys.argv[1])
+    command, args = sys.argv[2], sys.argv[3:]
+
+    try:
+        if command == "ping":
+            start = time.time()
+            device.request(FRAME_PING, b"ping")
+            print(f"pong in {(time.time() - start) * 1000:.1f} ms")
+        elif command == "cmd":
+            print(device.request(FRAME_COMMAND, " ".join(args).encode()).decode(), end="")
+        elif command == "list":
+            print_list(device)
+        elif command == "read":
+            download(device, FRAME_READ, struct.pack("<I", 0) + args[0].encode(),
+                     args[1] if len(args) > 1 else args[0])
+        elif command == "export":
+            name = args[0]
+            output = args[1] if len(args) > 1 else name.rsplit(".", 1)[0] + ".wav"
+            download(device, FRAME_EXPORT, name.encode(), output)
+        elif command == "metrics":
+            print_metrics(device, args[:1] == ["reset"])
+        elif command == "trace":
+            # דורש TRACE_ENABLED (env:esp32-debug)
+            output = args[0] if args else "trace.json"
+            device.request(FRAME_TRACE, b"\x01")
+            time.sleep(float(args[1]) if len(args) > 1 else 2.0)
+            download(device, FRAME_TRACE, b"", output)
+        elif command == "delete":
+            device.request(FRAME_DELETE, args[0].encode())
+            print(f"deleted {args[0]}")
+        else:
+            print(f"Unknown command: {command}")
+            sys.exit(1)
+    finally:
+        device.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -5,6 +5,10 @@
 
 #include "comm/protocol.h"
 #include "comm/radio.h"
+#include "comm/voice_fec.h"
+#include "comm/voice_hc.h"
+#include "core/device_id.h"
+#include "core/peer_table.h"
 #include "config.h"
 #include <string.h>
 #include <stdio.h>
@@ -25,6 +29,15 @@
     #define LOG_ERROR(fmt, ...) ESP_LOGE(TAG, fmt, ##__VA_ARGS__)
     #define LOG_DEBUG(fmt, ...) ESP_LOGD(TAG, fmt, ##__VA_ARGS__)
     #define GET_MILLIS() (esp_timer_get_time() / 1000)
+    
+    // טבלת ה-peers משותפת ל-RX ולמשימת ה-UI (שיוך לגלגלת)
+    #define PEERS_LOCK()   xSemaphoreTake(g_protocol_mutex, portMAX_DELAY)
+    #define PEERS_UNLOCK() xSemaphoreGive(g_protocol_mutex)
+    
+    // תור השידור ומקודדי הקול: audio_task שולח קול, הלופ הראשי שולח
+    // הודעות בקרה ומקדם את התור ב-TX done
+    #define TX_LOCK()      xSemaphoreTake(g_tx_mutex, portMAX_DELAY)
+    #define TX_UNLOCK()    xSemaphoreGive(g_tx_mutex)
 #else
     #include <time.h>
     #define LOG_INFO(fmt, ...) printf("[PROTOCOL] " fmt "\n", ##__VA_ARGS__)
@@ -36,6 +49,10 @@
         return (ts.tv_sec * 1000) + (ts.tv_nsec / 1000000);
     }
     #define GET_MILLIS() sim_millis()
+    #define PEERS_LOCK()
+    #define PEERS_UNLOCK()
+    #define TX_LOCK()
+    #define TX_UNLOCK()
 #endif
 
 // =============================================================================
@@ -44,21 +61,67 @@
 
 #define PACKET_MAGIC_VALUE  0x5754  // "WT" in little-endian
 
+// אודיו מקסימלי בחבילת קול שנכנסת לרדיו (דגימות שלמות). ה-header של
+// parity גדול משל חבילת קול, וה-parity באורך החבילה הארוכה בקבוצה
+#define VOICE_MAX_AUDIO_LEN ((RADIO_MAX_PACKET_SIZE - PACKET_HEADER_SIZE - VOICE_FEC_PARITY_HEADER_SIZE) & ~1u)
+_Static_assert(VOICE_FEC_PARITY_HEADER_SIZE >= VOICE_DATA_HEADER_SIZE, "voice header larger than parity header");
+
+// פיגור מקסימלי של שעון המדיה אחרי השעון לפני סנכרון מחדש (פער DTX)
+#define VOICE_CLOCK_SLACK_MS    20
+
 // =============================================================================
 // Internal State
 // =============================================================================
 
 static bool g_initialized = false;
 static char g_local_device_id[DEVICE_ID_LENGTH + 1] = {0};
+static uint32_t g_local_wire_id = DEVICE_ID_WIRE_INVALID;  // להשוואה מספרית ב-RX
+static uint32_t g_call_peer_wire = DEVICE_ID_WIRE_INVALID;  // הצד השני בשיחה (או זה שחייגנו אליו)
 static protocol_callback_t g_callback = NULL;
 
-static uint8_t g_tx_buffer[MAX_PACKET_SIZE];
-static uint8_t g_rx_buffer[MAX_PACKET_SIZE];
+static uint8_t g_rx_buffer[MAX_PACKET_SIZE] HOT_BUFFER_ATTR;
+
+// תור השידור: radio_send מתחיל TX מ-standby ומפיל TX שעוד באוויר, לכן
+// רק חבילה אחת נמסרת לרדיו והבאה יוצאת מ-on_radio_tx. החבילות נבנות
+// ישר לתא בתור
+typedef struct {
+    uint8_t  data[MAX_PACKET_SIZE];
+    uint16_t length;
+} tx_slot_t;
+
+static tx_slot_t g_tx_queue[PROTOCOL_TX_QUEUE_DEPTH] HOT_BUFFER_ATTR;
+static uint8_t  g_tx_head = 0;                 // הבאה לשידור (או זו שבאוויר)
+static uint8_t  g_tx_count = 0;
+static bool     g_tx_on_air = false;
+static uint32_t g_tx_started_ms = 0;
+static uint32_t g_tx_dropped = 0;
 
 static uint16_t g_voice_sequence = 0;
 
+// שעון מדיה לשידור: timestamp של הדגימה הבאה, מתקדם לפי כמות האודיו
+static bool     g_voice_clock_valid = false;
+static uint32_t g_voice_clock_ms = 0;
+static uint32_t g_voice_clock_frac = 0;        // שארית (דגימות * 1000) שעוד לא הגיעה ל-ms
+
+// מצב לכל מכשיר/תדר - חיפוש O(1) לפי מזהה מספרי
+static peer_table_t g_peers LARGE_TABLE_ATTR;
+
+// Voice FEC - נקבע במשא ומתן בתחילת כל שיחה
+static uint8_t g_fec_preferred = VOICE_FEC_GROUP_SIZE;
+static uint8_t g_fec_offered = 0;              // מה שהצד המתקשר הציע
+static voice_fec_encoder_t g_fec_encoder;
+static voice_fec_decoder_t g_fec_decoder;
+static voice_fec_parity_t g_fec_parity_tx;
+
+// Voice header compression - session לכל כיוון, נקבע ב-call setup
+static uint8_t g_hc_local_session = 0;         // ה-session שהצענו לצד השני
+static uint8_t g_hc_offered_session = 0;       // ה-session שהמתקשר הציע
+static voice_hc_tx_t g_hc_tx;
+static voice_hc_rx_t g_hc_rx;
+
 #ifdef ESP32
 static SemaphoreHandle_t g_protocol_mutex = NULL;
+static SemaphoreHandle_t g_tx_mutex = NULL;
 #endif
 
 // =============================================================================
@@ -121,10 +184,133 @@ static void on_radio_rx(const uint8_t* data, uint8_t length, int16_t rssi, int8_
     protocol_handle_received(data, length);
 }
 
+// =============================================================================
+// TX Queue (תחת TX_LOCK)
+// =============================================================================
+
+static void tx_pop_locked(void) {
+    g_tx_head = (uint8_t)((g_tx_head + 1) % PROTOCOL_TX_QUEUE_DEPTH);
+    g_tx_count--;
+    g_tx_on_air = false;
+}
+
+// מוסר לרדיו את הראשונה בתור אם הוא פנוי
+static void tx_kick_locked(void) {
+    while (!g_tx_on_air && g_tx_count > 0) {
+        tx_slot_t* slot = &g_tx_queue[g_tx_head];
+        if (radio_send(slot->data, (uint8_t)slot->length)) {
+            g_tx_on_air = true;
+            g_tx_started_ms = GET_MILLIS();
+        } else {
+            LOG_ERROR("radio_send failed (%u bytes)", (unsigned)slot->length);
+            tx_pop_locked();
+        }
+    }
+}
+
+/**
+ * @brief תא פנוי בסוף התור לבניית חבילה, או NULL כשהתור מלא
+ */
+static uint8_t* tx_reserve_locked(void) {
+    if (g_tx_on_air && (uint32_t)(GET_MILLIS() - g_tx_started_ms) > PROTOCOL_TX_TIMEOUT_MS) {
+        LOG_ERROR("TX done missing - dropping packet");
+        tx_pop_locked();
+        tx_kick_locked();
+    }
+    
+    if (g_tx_count >= PROTOCOL_TX_QUEUE_DEPTH) {
+        g_tx_dropped++;
+        return NULL;
+    }
+    return g_tx_queue[(g_tx_head + g_tx_count) % PROTOCOL_TX_QUEUE_DEPTH].data;
+}
+
+/**
+ * @brief הכנסת התא מ-tx_reserve_locked לתור (length 0 = לא נבנה)
+ */
+static bool tx_commit_locked(uint16_t length) {
+    if (length == 0 || length > RADIO_MAX_PACKET_SIZE) {
+        return false;
+    }
+    g_tx_queue[(g_tx_head + g_tx_count) % PROTOCOL_TX_QUEUE_DEPTH].length = length;
+    g_tx_count++;
+    tx_kick_locked();
+    return true;
+}
+
 static void on_radio_tx(bool success) {
     if (!success) {
         LOG_ERROR("TX failed");
     }
+    
+    TX_LOCK();
+    if (g_tx_on_air) {
+        tx_pop_locked();
+    }
+    tx_kick_locked();
+    TX_UNLOCK();
+}
+
+// =============================================================================
+// Voice FEC
+// =============================================================================
+
+static void fec_activate(uint8_t group_size) {
+    if (!voice_fec_valid_group_size(group_size)) {
+        group_size = 0;
+    }
+    
+    TX_LOCK();
+    voice_fec_encoder_init(&g_fec_encoder, group_size);
+    TX_UNLOCK();
+    voice_fec_decoder_init(&g_fec_decoder, group_size);
+    
+    if (group_size > 0) {
+        LOG_INFO("Voice FEC enabled: 1 parity per %d frames", group_size);
+    }
+}
+
+static void on_fec_voice_out(const voice_data_t* voice, bool recovered, void* user_data) {
+    const char* src_id = (const char*)user_data;
+    
+    if (recovered) {
+        LOG_DEBUG("FEC recovered voice seq=%d", voice->sequence);
+    }
+    
+    if (g_callback) {
+        g_callback(MSG_VOICE_DATA, src_id, voice, sizeof(voice_data_t));
+    }
+}
+
+// =============================================================================
+// Voice Header Compression
+// =============================================================================
+
+static uint8_t hc_new_session_id(void) {
+    // כל ערך שונה מ-0 תקין; מספיק שיהיה שונה בין שיחות סמוכות
+    uint8_t id = (uint8_t)(GET_MILLIS() ^ protocol_crc16((const uint8_t*)g_local_device_id,
+                                                         DEVICE_ID_LENGTH));
+    return id ? id : 1;
+}
+
+static void hc_activate(uint8_t peer_session, const char* peer_id) {
+    // דוחסים רק אם שני הצדדים הסכימו (לכל אחד session משלו)
+    if (peer_session == 0) {
+        g_hc_local_session = 0;
+    }
+    
+    TX_LOCK();
+    voice_hc_tx_init(&g_hc_tx, g_hc_local_session);
+    TX_UNLOCK();
+    voice_hc_rx_init(&g_hc_rx, g_hc_local_session ? peer_session : 0, peer_id);
+}
+
+void protocol_set_fec_group_size(uint8_t group_size) {
+    g_fec_preferred = voice_fec_valid_group_size(group_size) ? group_size : 0;
+}
+
+uint8_t protocol_get_fec_group_size(void) {
+    return g_fec_encoder.group_size;
 }
 
 // =============================================================================
@@ -138,7 +324,8 @@ void protocol_init(void) {
     
 #ifdef ESP32
     g_protocol_mutex = xSemaphoreCreateMutex();
-    if (!g_protocol_mutex) {
+    g_tx_mutex = xSemaphoreCreateMutex();
+    if (!g_protocol_mutex || !g_tx_mutex) {
         LOG_ERROR("Failed to create protocol mutex");
         return;
     }
@@ -158,6 +345,13 @@ void protocol_init(void) {
     radio_start_receive();
     
     g_voice_sequence = 0;
+    g_voice_clock_valid = false;
+    g_tx_head = 0;
+    g_tx_count = 0;
+    g_tx_on_air = false;
+    peer_table_init(&g_peers);
+    fec_activate(0);
+    hc_activate(0, NULL);
     g_initialized = true;
     
     LOG_INFO("Protocol initialized");
@@ -268,14 +462,16 @@ bool protocol_parse_packet(const uint8_t* buffer, uint16_t buffer_len,
 // =============================================================================
 
 static bool send_packet(message_type_t msg_type, const void* payload, uint16_t payload_len) {
-    uint16_t packet_len = protocol_build_packet(msg_type, g_local_device_id,
-                                                 payload, payload_len, g_tx_buffer);
-    
-    if (packet_len == 0) {
-        return false;
+    TX_LOCK();
+    uint8_t* buffer = tx_reserve_locked();
+    bool ok = buffer && tx_commit_locked(protocol_build_packet(msg_type, g_local_device_id,
+                                                               payload, payload_len, buffer));
+    TX_UNLOCK();
+    
+    if (!buffer) {
+        LOG_ERROR("TX queue full - message %d dropped", msg_type);
     }
-    
-    return radio_send(g_tx_buffer, packet_len);
+    return ok;
 }
 
 // =============================================================================
@@ -298,10 +494,18 @@ void protocol_send_call_request(const char* target_id) {
     
     LOG_INFO("Sending call request to: %s", target_id);
     
-    call_request_t request;
-    strncpy(request.target_id, target_id, DEVICE_ID_LENGTH);
+    // call_request_t + call_options_t (הצעת FEC)
+    uint8_t payload[sizeof(call_request_t) + sizeof(call_options_t)];
+    call_request_t* request = (call_request_t*)payload;
+    call_options_t* options = (call_options_t*)(payload + sizeof(call_request_t));
+    
+    strncpy(request->target_id, target_id, DEVICE_ID_LENGTH);
+    g_call_peer_wire = device_id_string_to_wire(target_id);
+    options->fec_group_size = g_fec_preferred;
+    g_hc_local_session = hc_new_session_id();
+    options->voice_session_id = g_hc_local_session;
     
-    send_packet(MSG_CALL_REQUEST, &request, sizeof(request));
+    send_packet(MSG_CALL_REQUEST, payload, sizeof(payload));
 }
 
 void protocol_send_call_response(const char* target_id, bool accept) {
@@ -309,10 +513,25 @@ void protocol_send_call_response(const char* target_id, bool accept) {
     
     LOG_INFO("Sending call %s to: %s", accept ? "accept" : "reject", target_id);
     
-    message_type_t msg_type = accept ? MSG_CALL_ACCEPT : MSG_CALL_REJECT;
+    if (!accept) {
+        // Target ID as payload
+        send_packet(MSG_CALL_REJECT, target_id, DEVICE_ID_LENGTH);
+        return;
+    }
+    
+    // Target ID + call_options_t - הצד המקבל קובע את FEC הסופי
+    uint8_t payload[DEVICE_ID_LENGTH + sizeof(call_options_t)];
+    call_options_t* options = (call_options_t*)(payload + DEVICE_ID_LENGTH);
     
-    // Target ID as payload
-    send_packet(msg_type, target_id, DEVICE_ID_LENGTH);
+    strncpy((char*)payload, target_id, DEVICE_ID_LENGTH);
+    options->fec_group_size = (g_fec_offered < g_fec_preferred) ? g_fec_offered : g_fec_preferred;
+    g_hc_local_session = g_hc_offered_session ? hc_new_session_id() : 0;
+    options->voice_session_id = g_hc_local_session;
+    
+    send_packet(MSG_CALL_ACCEPT, payload, sizeof(payload));
+    g_call_peer_wire = device_id_string_to_wire(target_id);
+    fec_activate(options->fec_group_size);
+    hc_activate(g_hc_offered_session, target_id);
 }
 
 void protocol_send_freq_join_request(const char* freq_id, const char* password) {
@@ -345,27 +564,82 @@ void protocol_send_freq_invite(const char* target_id, const char* freq_id) {
     send_packet(MSG_FREQ_INVITE, &invite, sizeof(invite));
 }
 
-void protocol_send_voice(const uint8_t* audio_data, uint16_t audio_len) {
-    if (!audio_data || audio_len == 0) return;
-    
+static void send_voice_packet(const uint8_t* audio_data, uint16_t audio_len, uint32_t timestamp) {
     voice_data_t voice;
-    voice.timestamp = GET_MILLIS();
+    voice.timestamp = timestamp;
     voice.sequence = g_voice_sequence++;
-    voice.audio_len = (audio_len > AUDIO_BUFFER_SIZE) ? AUDIO_BUFFER_SIZE : audio_len;
-    memcpy(voice.audio_data, audio_data, voice.audio_len);
+    voice.audio_len = audio_len;
+    memcpy(voice.audio_data, audio_data, audio_len);
+    
+    TX_LOCK();
+    
+    // Voice packets are best effort: תור מלא = ה-frame נזרק (ה-parity עוד יכול לשחזר אותו)
+    uint8_t* buffer = tx_reserve_locked();
+    if (buffer) {
+        // header דחוס אם יש context, אחרת חבילה מלאה שמרעננת את ה-context
+        uint16_t packet_len = voice_hc_compress(&g_hc_tx, &voice, buffer, RADIO_MAX_PACKET_SIZE);
+        if (packet_len == 0) {
+            packet_len = protocol_build_packet(MSG_VOICE_DATA, g_local_device_id,
+                                               &voice, VOICE_DATA_HEADER_SIZE + audio_len, buffer);
+        }
+        tx_commit_locked(packet_len);
+    }
+    
+    // parity נכנס לתור אחרי חבילת הקול האחרונה בקבוצה
+    uint16_t parity_len = voice_fec_encoder_add(&g_fec_encoder, &voice, &g_fec_parity_tx);
+    if (parity_len > 0 && (buffer = tx_reserve_locked()) != NULL) {
+        tx_commit_locked(protocol_build_packet(MSG_VOICE_FEC, g_local_device_id,
+                                               &g_fec_parity_tx, parity_len, buffer));
+    }
     
-    // Voice packets are sent without waiting (best effort)
-    uint16_t packet_len = protocol_build_packet(MSG_VOICE_DATA, g_local_device_id,
-                                                 &voice, sizeof(voice), g_tx_buffer);
+    TX_UNLOCK();
+}
+
+void protocol_send_voice(const uint8_t* audio_data, uint16_t audio_len) {
+    if (!audio_data || audio_len == 0) return;
     
-    if (packet_len > 0) {
-        radio_send(g_tx_buffer, packet_len);
+    // בלוק גדול מחבילה אחת מתפצל לחלקים שווים (בדגימות שלמות), כל אחד
+    // עם sequence משלו - כך גם המקבל מקבל frames בגודל דומה
+    uint16_t packets = (audio_len + VOICE_MAX_AUDIO_LEN - 1) / VOICE_MAX_AUDIO_LEN;
+    uint16_t chunk = ((audio_len + packets - 1) / packets + 1) & ~1u;
+    
+    // timestamp של האודיו ולא של השליחה: כל חלק מקבל את זמן הדגימה הראשונה
+    // שלו, כך שה-timestamp של חבילה צפוי מקודמתה (דחיסת ה-header).
+    // מסתנכרן רק קדימה - timestamps לא חוזרים אחורה
+    uint32_t now = GET_MILLIS();
+    if (!g_voice_clock_valid || (int32_t)(now - g_voice_clock_ms) > VOICE_CLOCK_SLACK_MS) {
+        g_voice_clock_valid = true;
+        g_voice_clock_ms = now;
+        g_voice_clock_frac = 0;
+    }
+    
+    for (uint16_t off = 0; off < audio_len; off += chunk) {
+        uint16_t len = audio_len - off;
+        if (len > chunk) len = chunk;
+        send_voice_packet(audio_data + off, len, g_voice_clock_ms);
+        
+        uint32_t total = g_voice_clock_frac + (uint32_t)(len / sizeof(int16_t)) * 1000;
+        g_voice_clock_ms += total / AUDIO_LINK_RATE;
+        g_voice_clock_frac = total % AUDIO_LINK_RATE;
     }
 }
 
+void protocol_send_sid(bool dtx_start, uint16_t noise_level) {
+    voice_sid_t sid = {
+        .timestamp = GET_MILLIS(),
+        .sequence = (uint16_t)(g_voice_sequence - 1),
+        .noise_level = noise_level
+    };
+    
+    send_packet(dtx_start ? MSG_VOICE_DTX : MSG_VOICE_SILENCE, &sid, sizeof(sid));
+}
+
 void protocol_send_disconnect(void) {
     LOG_INFO("Sending disconnect");
     send_packet(MSG_CALL_END, NULL, 0);
+    g_call_peer_wire = DEVICE_ID_WIRE_INVALID;
+    fec_activate(0);
+    hc_activate(0, NULL);
 }
 
 // =============================================================================
@@ -376,6 +650,22 @@ void protocol_handle_received(const uint8_t* buffer, uint16_t len) {
     packet_header_t header;
     const void* payload = NULL;
     
+    // חבילת קול דחוסה - אין packet_header_t, המקור נגזר מה-session
+    if (voice_hc_is_compressed(buffer, len)) {
+        voice_data_t voice;
+        if (voice_hc_decompress(&g_hc_rx, buffer, len, &voice)) {
+            PEERS_LOCK();
+            peer_entry_t* peer = peer_table_find(&g_peers,
+                device_id_string_to_wire(g_hc_rx.peer_id), PEER_TYPE_DEVICE);
+            peer_touch(peer, GET_MILLIS());
+            PEERS_UNLOCK();
+            voice_fec_decoder_push_voice(&g_fec_decoder, &voice, on_fec_voice_out, g_hc_rx.peer_id);
+        } else {
+            LOG_DEBUG("Compressed voice without context");
+        }
+        return;
+    }
+    
     if (!protocol_parse_packet(buffer, len, &header, &payload)) {
         LOG_DEBUG("Failed to parse received packet");
         return;
@@ -388,6 +678,15 @@ void protocol_handle_received(const uint8_t* buffer, uint16_t len) {
     
     LOG_DEBUG("Received msg type 0x%02X from %s", header.msg_type, src_id);
     
+    // עדכון מצב ה-peer - hash lookup, לא תלוי במספר המכשירים המוכרים
+    uint32_t src_wire_id = device_id_string_to_wire(header.src_id);
+    if (src_wire_id != DEVICE_ID_WIRE_INVALID) {
+        PEERS_LOCK();
+        peer_entry_t* peer = peer_table_insert(&g_peers, src_wire_id, PEER_TYPE_DEVICE);
+        peer_touch(peer, GET_MILLIS());
+        PEERS_UNLOCK();
+    }
+    
     // Handle specific message types
     switch ((message_type_t)header.msg_type) {
         case MSG_DISCOVER_REQUEST:
@@ -403,26 +702,93 @@ void protocol_handle_received(const uint8_t* buffer, uint16_t len) {
             // Someone is calling us
             if (header.payload_len >= sizeof(call_request_t)) {
                 const call_request_t* req = (const call_request_t*)payload;
-                char target[DEVICE_ID_LENGTH + 1];
-                memcpy(target, req->target_id, DEVICE_ID_LENGTH);
-                target[DEVICE_ID_LENGTH] = '\0';
                 
                 // Check if we're the target
-                if (strcmp(target, g_local_device_id) == 0) {
+                if (device_id_string_to_wire(req->target_id) == g_local_wire_id &&
+                    g_local_wire_id != DEVICE_ID_WIRE_INVALID) {
                     LOG_INFO("Incoming call from %s", src_id);
+                    
+                    // הצעות המתקשר (מכשיר ישן לא שולח - FEC ודחיסה כבויים)
+                    g_fec_offered = 0;
+                    g_hc_offered_session = 0;
+                    if (header.payload_len >= sizeof(call_request_t) + sizeof(call_options_t)) {
+                        const call_options_t* options = (const call_options_t*)
+                            ((const uint8_t*)payload + sizeof(call_request_t));
+                        if (voice_fec_valid_group_size(options->fec_group_size)) {
+                            g_fec_offered = options->fec_group_size;
+                        }
+                        g_hc_offered_session = options->voice_session_id;
+                    }
                 }
             }
             break;
             
+        case MSG_CALL_ACCEPT:
+            // אישור בין שני מכשירים אחרים לא נוגע ב-FEC ובדחיסה שלנו
+            if (header.payload_len < DEVICE_ID_LENGTH ||
+                device_id_string_to_wire((const char*)payload) != g_local_wire_id ||
+                g_local_wire_id == DEVICE_ID_WIRE_INVALID) {
+                LOG_DEBUG("Call accept not for us (from %s)", src_id);
+                return;
+            }
+            g_call_peer_wire = src_wire_id;
+            
+            // FEC שנקבע ע"י הצד המקבל
+            if (header.payload_len >= DEVICE_ID_LENGTH + sizeof(call_options_t)) {
+                const call_options_t* options = (const call_options_t*)
+                    ((const uint8_t*)payload + DEVICE_ID_LENGTH);
+                fec_activate(options->fec_group_size <= g_fec_preferred ?
+                             options->fec_group_size : 0);
+                hc_activate(options->voice_session_id, src_id);
+            } else {
+                fec_activate(0);
+                hc_activate(0, NULL);
+            }
+            break;
+            
+        case MSG_CALL_END:
+            // רק הצד השני בשיחה מנתק אותנו
+            if (src_wire_id != g_call_peer_wire || src_wire_id == DEVICE_ID_WIRE_INVALID) {
+                LOG_DEBUG("Call end from %s - not our call", src_id);
+                return;
+            }
+            g_call_peer_wire = DEVICE_ID_WIRE_INVALID;
+            voice_fec_decoder_flush(&g_fec_decoder, on_fec_voice_out, src_id);
+            fec_activate(0);
+            hc_activate(0, NULL);
+            break;
+            
         case MSG_VOICE_DATA:
-            // Pass audio data to playback
-            if (header.payload_len >= sizeof(voice_data_t)) {
-                const voice_data_t* voice = (const voice_data_t*)payload;
-                LOG_DEBUG("Voice data: seq=%d, len=%d", voice->sequence, voice->audio_len);
-                // TODO: Add to playback buffer
+            // Pass audio data to playback - דרך מפענח FEC ששומר על סדר
+            // באוויר רק audio_len בתים - משלימים ל-voice_data_t מלא
+            if (header.payload_len >= VOICE_DATA_HEADER_SIZE) {
+                voice_data_t voice;
+                memcpy(&voice, payload, VOICE_DATA_HEADER_SIZE);
+                if (voice.audio_len > AUDIO_BUFFER_SIZE ||
+                    voice.audio_len > header.payload_len - VOICE_DATA_HEADER_SIZE) {
+                    LOG_DEBUG("Voice data: bad length %d", voice.audio_len);
+                    return;
+                }
+                memcpy(voice.audio_data, (const uint8_t*)payload + VOICE_DATA_HEADER_SIZE,
+                       voice.audio_len);
+                LOG_DEBUG("Voice data: seq=%d, len=%d", voice.sequence, voice.audio_len);
+                if (strcmp(src_id, g_hc_rx.peer_id) == 0) {
+                    voice_hc_rx_refresh(&g_hc_rx, &voice);
+                }
+                voice_fec_decoder_push_voice(&g_fec_decoder, &voice, on_fec_voice_out, src_id);
             }
+            return;
+            
+        case MSG_VOICE_DTX:
+            // השולח עבר לשקט - אין טעם להמתין להשלמת קבוצת FEC
+            voice_fec_decoder_flush(&g_fec_decoder, on_fec_voice_out, src_id);
             break;
             
+        case MSG_VOICE_FEC:
+            voice_fec_decoder_push_parity(&g_fec_decoder, (const voice_fec_parity_t*)payload,
+                                          header.payload_len, on_fec_voice_out, src_id);
+            return;
+            
         case MSG_PING:
             // Respond with pong
             send_packet(MSG_PONG, src_id, DEVICE_ID_LENGTH);
@@ -451,6 +817,7 @@ void protocol_set_device_id(const char* device_id) {
     
     strncpy(g_local_device_id, device_id, DEVICE_ID_LENGTH);
     g_local_device_id[DEVICE_ID_LENGTH] = '\0';
+    g_local_wire_id = device_id_string_to_wire(g_local_device_id);
     
     LOG_INFO("Device ID set: %s", g_local_device_id);
 }
@@ -463,3 +830,25 @@ const char* protocol_get_device_id(void) {
     return g_local_device_id;
 }
 
+uint32_t protocol_get_tx_dropped(void) {
+    return g_tx_dropped;
+}
+
+/**
+ * @brief Map a peer to a dial position (PEER_NO_SLOT clears it)
+ *
+ * The table is only touched under the protocol mutex - a backward-shift
+ * delete racing a lookup would break the probe chains.
+ */
+bool protocol_map_peer_slot(uint32_t wire_id, peer_type_t type, int8_t slot) {
+    PEERS_LOCK();
+    peer_entry_t* peer = (slot == PEER_NO_SLOT) ?
+                         peer_table_find(&g_peers, wire_id, type) :
+                         peer_table_insert(&g_peers, wire_id, type);
+    if (peer) {
+        peer->dial_slot = slot;
+    }
+    PEERS_UNLOCK();
+    return peer != NULL;
+}
+
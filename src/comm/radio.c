@@ -5,6 +5,8 @@
 
 #include "comm/radio.h"
 #include "config.h"
+#include "core/telemetry.h"
+#include "core/trace.h"
 #include <string.h>
 
 // =============================================================================
@@ -53,13 +55,18 @@ static radio_stats_t g_stats;
 static radio_rx_callback_t g_rx_callback = NULL;
 static radio_tx_callback_t g_tx_callback = NULL;
 
-static uint8_t g_rx_buffer[RADIO_MAX_PACKET_SIZE];
+static uint8_t g_rx_buffer[RADIO_MAX_PACKET_SIZE] HOT_BUFFER_ATTR;
 static uint8_t g_rx_length = 0;
 static bool g_packet_available = false;
+static uint32_t g_tx_start_us = 0;      // לזמן השידור באוויר
 
 #ifdef ESP32
 static spi_device_handle_t g_spi_handle;
 static SemaphoreHandle_t g_mutex;
+#else
+static sim_radio_air_t g_sim_air = NULL;
+static void* g_sim_air_ctx = NULL;
+static bool g_sim_tx_pending = false;
 #endif
 
 // =============================================================================
@@ -400,11 +407,35 @@ void radio_set_spreading_factor(uint8_t sf) {
     }
 }
 
+uint32_t radio_get_airtime_us(uint8_t length) {
+    uint32_t sf = g_config.spreading_factor;
+    uint32_t bw = g_config.bandwidth;
+    if (sf < 6 || bw == 0) {
+        return 0;
+    }
+    
+    // Low data rate optimize חובה כשסימבול ארוך מ-16ms (SF11/12 ב-125kHz)
+    bool ldro = ((1000000u << sf) / bw) > 16000;
+    
+    // סימבולים של ה-payload: 8 + ceil((8PL - 4SF + 28 + 16CRC - 20IH) / 4(SF - 2DE)) * (CR + 4)
+    int32_t bits = 8 * (int32_t)length - 4 * (int32_t)sf + 28
+                 + (g_config.crc_enabled ? 16 : 0) - (g_config.implicit_header ? 20 : 0);
+    int32_t per_block = 4 * ((int32_t)sf - (ldro ? 2 : 0));
+    int32_t blocks = bits > 0 ? (bits + per_block - 1) / per_block : 0;
+    uint32_t payload_symbols = 8 + (uint32_t)blocks * g_config.coding_rate;
+    
+    // preamble + 4.25 סימבולים של sync, הכל ברבעי סימבול
+    uint64_t quarter_symbols = (uint64_t)g_config.preamble_length * 4 + 17 + payload_symbols * 4;
+    return (uint32_t)((quarter_symbols * 1000000u << sf) / (4 * (uint64_t)bw));
+}
+
 bool radio_send(const uint8_t* data, uint8_t length) {
     if (!g_initialized || !data || length == 0 || length > RADIO_MAX_PACKET_SIZE) {
         return false;
     }
     
+    TRACE_BEGIN(TRACE_RADIO_SEND);
+    
 #ifdef ESP32
     xSemaphoreTake(g_mutex, portMAX_DELAY);
 #endif
@@ -430,6 +461,14 @@ bool radio_send(const uint8_t* data, uint8_t length) {
     // Start transmission
     set_mode(MODE_TX);
     g_state = RADIO_STATE_TX;
+    g_tx_start_us = telemetry_now_us();
+    
+#ifndef ESP32
+    if (g_sim_air) {
+        g_sim_air(data, length, g_sim_air_ctx);
+    }
+    g_sim_tx_pending = true;
+#endif
     
     LOG_DEBUG("TX started, %d bytes", length);
     
@@ -437,6 +476,7 @@ bool radio_send(const uint8_t* data, uint8_t length) {
     xSemaphoreGive(g_mutex);
 #endif
     
+    TRACE_END(TRACE_RADIO_SEND);
     return true;
 }
 
@@ -580,26 +620,45 @@ void radio_set_tx_callback(radio_tx_callback_t callback) {
     g_tx_callback = callback;
 }
 
+static void on_tx_done(void) {
+    g_stats.packets_sent++;
+    g_state = RADIO_STATE_IDLE;
+    telemetry_record_since(TM_HIST_TX_AIRTIME, g_tx_start_us);
+    
+    LOG_DEBUG("TX done");
+    
+    if (g_tx_callback) {
+        g_tx_callback(true);
+    }
+    
+    // Auto-return to RX mode - אלא אם ה-callback כבר שלח את החבילה הבאה
+    if (g_state != RADIO_STATE_TX) {
+        radio_start_receive();
+    }
+}
+
+static void on_rx_done(void) {
+    g_stats.packets_received++;
+    g_packet_available = true;
+    
+    LOG_DEBUG("RX done: %d bytes, RSSI=%d, SNR=%d", 
+              g_rx_length, g_stats.last_rssi, g_stats.last_snr);
+    
+    if (g_rx_callback) {
+        g_rx_callback(g_rx_buffer, g_rx_length, g_stats.last_rssi, g_stats.last_snr);
+    }
+}
+
 void radio_handle_interrupt(void) {
     if (!g_initialized) return;
     
+    TRACE_BEGIN(TRACE_RADIO_IRQ);
     uint8_t irq_flags = spi_read_register(REG_IRQ_FLAGS);
     
     // TX Done
     if (irq_flags & IRQ_TX_DONE_MASK) {
         spi_write_register(REG_IRQ_FLAGS, IRQ_TX_DONE_MASK);
-        
-        g_stats.packets_sent++;
-        g_state = RADIO_STATE_IDLE;
-        
-        LOG_DEBUG("TX done");
-        
-        if (g_tx_callback) {
-            g_tx_callback(true);
-        }
-        
-        // Auto-return to RX mode
-        radio_start_receive();
+        on_tx_done();
     }
     
     // RX Done
@@ -611,6 +670,7 @@ void radio_handle_interrupt(void) {
             spi_write_register(REG_IRQ_FLAGS, IRQ_PAYLOAD_CRC_ERROR);
             g_stats.crc_errors++;
             LOG_DEBUG("RX CRC error");
+            TRACE_END(TRACE_RADIO_IRQ);
             return;
         }
         
@@ -625,16 +685,10 @@ void radio_handle_interrupt(void) {
         g_stats.last_rssi = spi_read_register(REG_PKT_RSSI_VALUE) - 157;
         g_stats.last_snr = (int8_t)spi_read_register(REG_PKT_SNR_VALUE) / 4;
         
-        g_stats.packets_received++;
-        g_packet_available = true;
-        
-        LOG_DEBUG("RX done: %d bytes, RSSI=%d, SNR=%d", 
-                  g_rx_length, g_stats.last_rssi, g_stats.last_snr);
-        
-        if (g_rx_callback) {
-            g_rx_callback(g_rx_buffer, g_rx_length, g_stats.last_rssi, g_stats.last_snr);
-        }
+        on_rx_done();
     }
+    
+    TRACE_END(TRACE_RADIO_IRQ);
 }
 
 void radio_update(void) {
@@ -643,6 +697,11 @@ void radio_update(void) {
     if (gpio_get_level(PIN_RADIO_DIO0)) {
         radio_handle_interrupt();
     }
+#else
+    if (g_sim_tx_pending) {
+        g_sim_tx_pending = false;
+        on_tx_done();
+    }
 #endif
 }
 
@@ -655,3 +714,24 @@ void radio_wake(void) {
     set_idle();
 }
 
+// =============================================================================
+// Simulator
+// =============================================================================
+
+#ifndef ESP32
+void sim_radio_set_air(sim_radio_air_t air, void* ctx) {
+    g_sim_air = air;
+    g_sim_air_ctx = ctx;
+}
+
+void sim_radio_receive(const uint8_t* data, uint8_t length, int16_t rssi, int8_t snr) {
+    if (!g_initialized || !data || length == 0) return;
+    
+    memcpy(g_rx_buffer, data, length);
+    g_rx_length = length;
+    g_stats.last_rssi = rssi;
+    g_stats.last_snr = snr;
+    
+    on_rx_done();
+}
+#endif
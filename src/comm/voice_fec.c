@@ -0,0 +1,306 @@
+/**
+ * @file voice_fec.c
+ * @brief מימוש XOR parity לחבילות קול
+ */
+
+#include "comm/voice_fec.h"
+#include <string.h>
+#include <stdio.h>
+
+// =============================================================================
+// Platform-Specific Includes
+// =============================================================================
+
+#ifdef ESP32
+    #include "esp_log.h"
+
+    static const char* TAG = "VOICE_FEC";
+    #define LOG_DEBUG(fmt, ...) ESP_LOGD(TAG, fmt, ##__VA_ARGS__)
+#else
+    #define LOG_DEBUG(fmt, ...)
+#endif
+
+// =============================================================================
+// Internal State
+// =============================================================================
+
+static voice_fec_stats_t g_stats = {0};
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+static inline uint16_t group_base_of(uint16_t sequence, uint8_t group_size) {
+    return sequence & (uint16_t)~(group_size - 1);
+}
+
+// חיובי אם a חדש יותר מ-b (עם wraparound של 16 ביט)
+static inline int16_t seq_diff(uint16_t a, uint16_t b) {
+    return (int16_t)(a - b);
+}
+
+static void xor_bytes(uint8_t* dst, const uint8_t* src, uint16_t len) {
+    for (uint16_t i = 0; i < len; i++) {
+        dst[i] ^= src[i];
+    }
+}
+
+bool voice_fec_valid_group_size(uint8_t group_size) {
+    return group_size == 0 || group_size == 2 || group_size == 4 ||
+           group_size == VOICE_FEC_MAX_GROUP;
+}
+
+// =============================================================================
+// Encoder
+// =============================================================================
+
+void voice_fec_encoder_init(voice_fec_encoder_t* enc, uint8_t group_size) {
+    if (!enc) return;
+
+    memset(enc, 0, sizeof(voice_fec_encoder_t));
+    enc->group_size = voice_fec_valid_group_size(group_size) ? group_size : 0;
+}
+
+uint16_t voice_fec_encoder_add(voice_fec_encoder_t* enc, const voice_data_t* voice,
+                               voice_fec_parity_t* out_parity) {
+    if (!enc || !voice || !out_parity || enc->group_size == 0) return 0;
+
+    uint16_t base = group_base_of(voice->sequence, enc->group_size);
+    uint8_t index = (uint8_t)(voice->sequence - base);
+    uint16_t audio_len = (voice->audio_len > AUDIO_BUFFER_SIZE) ?
+                         AUDIO_BUFFER_SIZE : voice->audio_len;
+
+    // קבוצה חדשה - מתחילים parity מאפס (קבוצה חלקית קודמת נזנחת)
+    if (base != enc->group_base || enc->parity.mask == 0) {
+        memset(&enc->parity, 0, sizeof(voice_fec_parity_t));
+        enc->group_base = base;
+        enc->parity.base_sequence = base;
+        enc->parity.group_size = enc->group_size;
+    }
+
+    voice_fec_parity_t* p = &enc->parity;
+    p->mask |= (uint8_t)(1u << index);
+    p->timestamp_xor ^= voice->timestamp;
+    p->length_xor ^= audio_len;
+    xor_bytes(p->parity_data, voice->audio_data, audio_len);
+    if (audio_len > p->parity_len) {
+        p->parity_len = audio_len;
+    }
+
+    // רק ב-frame האחרון של הקבוצה משחררים parity
+    if (index != enc->group_size - 1) {
+        return 0;
+    }
+
+    uint16_t payload_len = VOICE_FEC_PARITY_HEADER_SIZE + p->parity_len;
+    memcpy(out_parity, p, payload_len);
+    p->mask = 0;
+    g_stats.parity_sent++;
+
+    return payload_len;
+}
+
+// =============================================================================
+// Decoder - Internal
+// =============================================================================
+
+static void decoder_try_recover(voice_fec_decoder_t* dec) {
+    if (!dec->parity_valid) return;
+
+    uint8_t missing = dec->parity.mask & (uint8_t)~dec->received_mask;
+
+    // XOR משחזר בדיוק frame אחד חסר
+    if (missing == 0 || (missing & (missing - 1)) != 0) return;
+
+    uint8_t index = 0;
+    while (!(missing & (1u << index))) index++;
+
+    uint32_t timestamp = dec->parity.timestamp_xor;
+    uint16_t audio_len = dec->parity.length_xor;
+    uint8_t data[AUDIO_BUFFER_SIZE];
+    memcpy(data, dec->parity.parity_data, AUDIO_BUFFER_SIZE);
+
+    for (uint8_t i = 0; i < dec->group_size; i++) {
+        if (i == index || !(dec->parity.mask & (1u << i))) continue;
+
+        const voice_data_t* v = &dec->frames[i];
+        uint16_t len = (v->audio_len > AUDIO_BUFFER_SIZE) ? AUDIO_BUFFER_SIZE : v->audio_len;
+        timestamp ^= v->timestamp;
+        audio_len ^= len;
+        xor_bytes(data, v->audio_data, len);
+    }
+
+    if (audio_len > AUDIO_BUFFER_SIZE) {
+        // parity לא עקבי עם ה-frames שהתקבלו
+        dec->parity_valid = false;
+        return;
+    }
+
+    voice_data_t* rebuilt = &dec->frames[index];
+    rebuilt->timestamp = timestamp;
+    rebuilt->sequence = (uint16_t)(dec->group_base + index);
+    rebuilt->audio_len = audio_len;
+    memcpy(rebuilt->audio_data, data, audio_len);
+
+    dec->received_mask |= (uint8_t)(1u << index);
+    g_stats.frames_recovered++;
+
+    LOG_DEBUG("Recovered seq=%u", rebuilt->sequence);
+}
+
+static void decoder_release(voice_fec_decoder_t* dec, bool flush,
+                            uint8_t recovered_mask,
+                            voice_fec_output_t out, void* user_data) {
+    uint8_t limit = dec->group_size;
+
+    if (flush) {
+        // frames אחרי האחרון הידוע לא נחשבים אבודים (סוף שידור)
+        uint8_t known = dec->received_mask | (dec->parity_valid ? dec->parity.mask : 0);
+        limit = 0;
+        while (known >> limit) limit++;
+    }
+
+    while (dec->next_release < limit) {
+        uint8_t bit = (uint8_t)(1u << dec->next_release);
+
+        if (dec->received_mask & bit) {
+            if (out) {
+                out(&dec->frames[dec->next_release], (recovered_mask & bit) != 0, user_data);
+            }
+        } else if (flush) {
+            g_stats.frames_lost++;
+        } else {
+            // חור - ממתינים ל-parity או לסוף הקבוצה
+            break;
+        }
+
+        dec->next_release++;
+    }
+
+    if (flush) {
+        dec->next_release = dec->group_size;
+    }
+}
+
+static void decoder_recover_and_release(voice_fec_decoder_t* dec, bool flush,
+                                        voice_fec_output_t out, void* user_data) {
+    uint8_t before = dec->received_mask;
+    decoder_try_recover(dec);
+    decoder_release(dec, flush, (uint8_t)(dec->received_mask & ~before), out, user_data);
+}
+
+static void decoder_start_group(voice_fec_decoder_t* dec, uint16_t base) {
+    dec->active = true;
+    dec->group_base = base;
+    dec->received_mask = 0;
+    dec->next_release = 0;
+    dec->parity_valid = false;
+}
+
+// מחזיר false אם החבילה שייכת לקבוצה ישנה שכבר שוחררה
+static bool decoder_select_group(voice_fec_decoder_t* dec, uint16_t base,
+                                 voice_fec_output_t out, void* user_data) {
+    if (!dec->active) {
+        decoder_start_group(dec, base);
+        return true;
+    }
+
+    int16_t diff = seq_diff(base, dec->group_base);
+    if (diff == 0) return true;
+    if (diff < 0) return false;
+
+    // קבוצה חדשה התחילה - הקודמת לא תקבל יותר חבילות
+    decoder_recover_and_release(dec, true, out, user_data);
+    decoder_start_group(dec, base);
+    return true;
+}
+
+// =============================================================================
+// Decoder - Public
+// =============================================================================
+
+void voice_fec_decoder_init(voice_fec_decoder_t* dec, uint8_t group_size) {
+    if (!dec) return;
+
+    memset(dec, 0, sizeof(voice_fec_decoder_t));
+    dec->group_size = voice_fec_valid_group_size(group_size) ? group_size : 0;
+}
+
+void voice_fec_decoder_push_voice(voice_fec_decoder_t* dec, const voice_data_t* voice,
+                                  voice_fec_output_t out, void* user_data) {
+    if (!dec || !voice) return;
+
+    // FEC כבוי - מעבירים ישירות
+    if (dec->group_size == 0) {
+        if (out) out(voice, false, user_data);
+        return;
+    }
+
+    uint16_t base = group_base_of(voice->sequence, dec->group_size);
+    uint8_t index = (uint8_t)(voice->sequence - base);
+    bool first = !dec->active;
+
+    if (!decoder_select_group(dec, base, out, user_data)) {
+        g_stats.frames_late++;
+        return;
+    }
+
+    // תחילת שידור באמצע קבוצה - אין מה לחכות ל-frames שלפני
+    if (first) {
+        dec->next_release = index;
+    }
+    uint8_t bit = (uint8_t)(1u << index);
+
+    if (index < dec->next_release || (dec->received_mask & bit)) {
+        // כפילות או frame שהגיע אחרי שכבר דילגנו עליו
+        g_stats.frames_late++;
+        return;
+    }
+
+    memcpy(&dec->frames[index], voice, sizeof(voice_data_t));
+    dec->received_mask |= bit;
+
+    decoder_recover_and_release(dec, false, out, user_data);
+}
+
+void voice_fec_decoder_push_parity(voice_fec_decoder_t* dec, const voice_fec_parity_t* parity,
+                                   uint16_t len, voice_fec_output_t out, void* user_data) {
+    if (!dec || !parity || dec->group_size == 0) return;
+    if (len < VOICE_FEC_PARITY_HEADER_SIZE) return;
+    if (parity->group_size != dec->group_size) return;
+    if (parity->parity_len > AUDIO_BUFFER_SIZE ||
+        len < VOICE_FEC_PARITY_HEADER_SIZE + parity->parity_len) return;
+
+    g_stats.parity_received++;
+
+    if (!decoder_select_group(dec, parity->base_sequence, out, user_data)) {
+        return;
+    }
+
+    // שדות שלא נשלחו באוויר נחשבים אפס
+    memset(&dec->parity, 0, sizeof(voice_fec_parity_t));
+    memcpy(&dec->parity, parity, VOICE_FEC_PARITY_HEADER_SIZE + parity->parity_len);
+    dec->parity_valid = true;
+
+    // parity הוא החבילה האחרונה בקבוצה - אחריו אין למה לחכות
+    decoder_recover_and_release(dec, true, out, user_data);
+}
+
+void voice_fec_decoder_flush(voice_fec_decoder_t* dec, voice_fec_output_t out, void* user_data) {
+    if (!dec || !dec->active) return;
+
+    decoder_recover_and_release(dec, true, out, user_data);
+    dec->active = false;
+}
+
+// =============================================================================
+// Statistics
+// =============================================================================
+
+const voice_fec_stats_t* voice_fec_get_stats(void) {
+    return &g_stats;
+}
+
+void voice_fec_reset_stats(void) {
+    memset(&g_stats, 0, sizeof(voice_fec_stats_t));
+}
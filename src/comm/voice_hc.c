@@ -0,0 +1,134 @@
+/**
+ * @file voice_hc.c
+ * @brief מימוש דחיסת header לחבילות קול
+ */
+
+#include "comm/voice_hc.h"
+#include "config.h"
+#include <string.h>
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+// timestamp צפוי: כל חבילה נושאת אודיו באורך חבילת ה-reference
+static inline uint32_t predict_timestamp(uint16_t ref_sequence, uint32_t ref_timestamp,
+                                         uint16_t ref_audio_len, uint16_t sequence) {
+    uint32_t samples = (uint32_t)(uint16_t)(sequence - ref_sequence) * (ref_audio_len / sizeof(int16_t));
+    return ref_timestamp + samples * 1000 / AUDIO_LINK_RATE;
+}
+
+// =============================================================================
+// Compressor
+// =============================================================================
+
+void voice_hc_tx_init(voice_hc_tx_t* tx, uint8_t session_id) {
+    if (!tx) return;
+
+    memset(tx, 0, sizeof(voice_hc_tx_t));
+    tx->session_id = session_id;
+}
+
+uint16_t voice_hc_compress(voice_hc_tx_t* tx, const voice_data_t* voice,
+                           uint8_t* out, uint16_t out_size) {
+    if (!tx || !voice || !out || tx->session_id == 0) return 0;
+
+    uint16_t audio_len = (voice->audio_len > AUDIO_BUFFER_SIZE) ?
+                         AUDIO_BUFFER_SIZE : voice->audio_len;
+    uint16_t seq_delta = (uint16_t)(voice->sequence - tx->ref_sequence);
+    uint32_t ts_delta = voice->timestamp - tx->ref_timestamp;
+
+    // רענון: אין context, עבר זמן רב, או delta שלא נכנס בשדות הדחוסים
+    if (!tx->has_ref || tx->since_refresh >= VOICE_HC_REFRESH_INTERVAL ||
+        seq_delta == 0 || seq_delta > 0xFF || ts_delta > 0xFFFF) {
+        tx->has_ref = true;
+        tx->ref_sequence = voice->sequence;
+        tx->ref_timestamp = voice->timestamp;
+        tx->ref_audio_len = audio_len;
+        tx->since_refresh = 0;
+        return 0;
+    }
+
+    bool explicit_ts = voice->timestamp !=
+        predict_timestamp(tx->ref_sequence, tx->ref_timestamp, tx->ref_audio_len, voice->sequence);
+    uint16_t header_len = explicit_ts ? VOICE_HC_MAX_HEADER : VOICE_HC_MIN_HEADER;
+
+    if (header_len + audio_len > out_size) return 0;
+
+    out[0] = VOICE_HC_MARKER | (explicit_ts ? VOICE_HC_FLAG_TS : 0);
+    out[1] = tx->session_id;
+    out[2] = (uint8_t)voice->sequence;
+    if (explicit_ts) {
+        out[3] = (uint8_t)(ts_delta & 0xFF);
+        out[4] = (uint8_t)(ts_delta >> 8);
+    }
+    memcpy(out + header_len, voice->audio_data, audio_len);
+
+    // ה-reference לא מתקדם - כל חבילה דחוסה מפוענחת מול חבילת הרענון,
+    // כך שאובדן חבילות דחוסות לא שובר את ה-context
+    tx->since_refresh++;
+
+    return header_len + audio_len;
+}
+
+// =============================================================================
+// Decompressor
+// =============================================================================
+
+void voice_hc_rx_init(voice_hc_rx_t* rx, uint8_t session_id, const char* peer_id) {
+    if (!rx) return;
+
+    memset(rx, 0, sizeof(voice_hc_rx_t));
+    rx->session_id = session_id;
+    if (peer_id) {
+        strncpy(rx->peer_id, peer_id, DEVICE_ID_LENGTH);
+        rx->peer_id[DEVICE_ID_LENGTH] = '\0';
+    }
+}
+
+void voice_hc_rx_refresh(voice_hc_rx_t* rx, const voice_data_t* voice) {
+    if (!rx || !voice || rx->session_id == 0) return;
+
+    rx->has_ref = true;
+    rx->ref_sequence = voice->sequence;
+    rx->ref_timestamp = voice->timestamp;
+    rx->ref_audio_len = (voice->audio_len > AUDIO_BUFFER_SIZE) ? AUDIO_BUFFER_SIZE : voice->audio_len;
+}
+
+bool voice_hc_is_compressed(const uint8_t* buffer, uint16_t len) {
+    return buffer && len >= VOICE_HC_MIN_HEADER &&
+           (buffer[0] & VOICE_HC_MARKER_MASK) == VOICE_HC_MARKER;
+}
+
+bool voice_hc_decompress(voice_hc_rx_t* rx, const uint8_t* buffer, uint16_t len,
+                         voice_data_t* out) {
+    if (!rx || !out || !voice_hc_is_compressed(buffer, len)) return false;
+    if (rx->session_id == 0 || buffer[1] != rx->session_id || !rx->has_ref) return false;
+
+    bool explicit_ts = (buffer[0] & VOICE_HC_FLAG_TS) != 0;
+    uint16_t header_len = explicit_ts ? VOICE_HC_MAX_HEADER : VOICE_HC_MIN_HEADER;
+    if (len < header_len) return false;
+
+    uint16_t audio_len = len - header_len;
+    if (audio_len > AUDIO_BUFFER_SIZE) return false;
+
+    // LSB decoding מול ה-reference. המשדר מרענן כל REFRESH_INTERVAL חבילות,
+    // כך ש-delta גדול יותר אומר שחבילת הרענון האחרונה אבדה - לא מפענחים
+    uint8_t lsb_delta = (uint8_t)(buffer[2] - (uint8_t)rx->ref_sequence);
+    if (lsb_delta == 0 || lsb_delta > VOICE_HC_REFRESH_INTERVAL + 1) return false;
+    uint16_t sequence = (uint16_t)(rx->ref_sequence + lsb_delta);
+
+    uint32_t timestamp;
+    if (explicit_ts) {
+        timestamp = rx->ref_timestamp + (uint32_t)(buffer[3] | (buffer[4] << 8));
+    } else {
+        timestamp = predict_timestamp(rx->ref_sequence, rx->ref_timestamp, rx->ref_audio_len, sequence);
+    }
+
+    out->timestamp = timestamp;
+    out->sequence = sequence;
+    out->audio_len = audio_len;
+    memcpy(out->audio_data, buffer + header_len, audio_len);
+
+    return true;
+}
@@ -0,0 +1,116 @@
+/**
+ * @file adpcm.c
+ * @brief מימוש IMA-ADPCM
+ */
+
+#include "core/adpcm.h"
+
+// =============================================================================
+// Tables
+// =============================================================================
+
+static const int8_t INDEX_TABLE[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+static const int16_t STEP_TABLE[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+    19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+    130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+    337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+    5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+// צעד פענוח אחד - משותף למקודד (שחייב לעקוב אחרי המפענח) ולמפענח
+static inline int16_t decode_nibble(adpcm_state_t* state, uint8_t nibble) {
+    int32_t step = STEP_TABLE[state->step_index];
+
+    int32_t diff = step >> 3;
+    if (nibble & 4) diff += step;
+    if (nibble & 2) diff += step >> 1;
+    if (nibble & 1) diff += step >> 2;
+
+    int32_t pred = state->predictor;
+    pred += (nibble & 8) ? -diff : diff;
+    if (pred > 32767) pred = 32767;
+    if (pred < -32768) pred = -32768;
+    state->predictor = (int16_t)pred;
+
+    int32_t index = state->step_index + INDEX_TABLE[nibble];
+    if (index < 0) index = 0;
+    if (index > 88) index = 88;
+    state->step_index = (uint8_t)index;
+
+    return state->predictor;
+}
+
+static inline uint8_t encode_sample(adpcm_state_t* state, int16_t sample) {
+    int32_t step = STEP_TABLE[state->step_index];
+    int32_t diff = (int32_t)sample - state->predictor;
+
+    uint8_t nibble = 0;
+    if (diff < 0) {
+        nibble = 8;
+        diff = -diff;
+    }
+
+    if (diff >= step) {
+        nibble |= 4;
+        diff -= step;
+    }
+    step >>= 1;
+    if (diff >= step) {
+        nibble |= 2;
+        diff -= step;
+    }
+    step >>= 1;
+    if (diff >= step) {
+        nibble |= 1;
+    }
+
+    decode_nibble(state, nibble);
+    return nibble;
+}
+
+// =============================================================================
+// API
+// =============================================================================
+
+void adpcm_init(adpcm_state_t* state) {
+    if (!state) return;
+    state->predictor = 0;
+    state->step_index = 0;
+}
+
+void adpcm_encode(adpcm_state_t* state, const int16_t* in, uint16_t count, uint8_t* out) {
+    if (!state || !in || !out) return;
+
+    for (uint16_t i = 0; i + 1 < count; i += 2) {
+        uint8_t lo = encode_sample(state, in[i]);
+        uint8_t hi = encode_sample(state, in[i + 1]);
+        *out++ = (uint8_t)(lo | (hi << 4));
+    }
+
+    if (count & 1) {
+        *out = encode_sample(state, in[count - 1]);
+    }
+}
+
+void adpcm_decode(adpcm_state_t* state, const uint8_t* in, uint16_t count, int16_t* out) {
+    if (!state || !in || !out) return;
+
+    for (uint16_t i = 0; i < count; i++) {
+        uint8_t byte = in[i >> 1];
+        uint8_t nibble = (i & 1) ? (byte >> 4) : (byte & 0x0F);
+        out[i] = decode_nibble(state, nibble);
+    }
+}
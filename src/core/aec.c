@@ -0,0 +1,218 @@
+/**
+ * @file aec.c
+ * @brief מימוש ביטול הד - NLMS ב-fixed point
+ */
+
+#include "core/aec.h"
+#include "core/audio_dsp.h"
+#include <string.h>
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+#define FIFO_MASK           (AEC_FIFO_SIZE - 1)
+#define WEIGHT_SHIFT        28
+#define REF_ENERGY_MIN      ((uint64_t)AEC_FILTER_TAPS * AEC_REF_FLOOR * AEC_REF_FLOOR)
+
+static inline int16_t sat16(int32_t x) {
+    if (x > 32767) return 32767;
+    if (x < -32768) return -32768;
+    return (int16_t)x;
+}
+
+static inline int32_t sat32(int64_t x) {
+    if (x > INT32_MAX) return INT32_MAX;
+    if (x < INT32_MIN) return INT32_MIN;
+    return (int32_t)x;
+}
+
+static inline int16_t fifo_pop(aec_state_t* aec) {
+    if (aec->fifo_count == 0) {
+        aec->fifo_underruns++;
+        return 0;
+    }
+
+    int16_t s = aec->fifo[aec->fifo_tail];
+    aec->fifo_tail = (aec->fifo_tail + 1) & FIFO_MASK;
+    aec->fifo_count--;
+    return s;
+}
+
+static void fifo_push(aec_state_t* aec, int16_t s) {
+    // ההשמעה רצה קדימה מהקלט - זורקים את הישן ביותר
+    if (aec->fifo_count == AEC_FIFO_SIZE) {
+        aec->fifo_tail = (aec->fifo_tail + 1) & FIFO_MASK;
+        aec->fifo_count--;
+        aec->fifo_overflows++;
+    }
+
+    aec->fifo[aec->fifo_head] = s;
+    aec->fifo_head = (aec->fifo_head + 1) & FIFO_MASK;
+    aec->fifo_count++;
+}
+
+// log2 שלם - ל-ERLE מספיקה רזולוציה של ~3dB
+static int16_t ilog2(uint32_t x) {
+    int16_t r = 0;
+    while (x > 1) {
+        x >>= 1;
+        r++;
+    }
+    return r;
+}
+
+// =============================================================================
+// Initialization
+// =============================================================================
+
+void aec_init(aec_state_t* aec) {
+    if (!aec) return;
+
+    memset(aec, 0, sizeof(aec_state_t));
+    aec->enabled = true;
+    aec_reset(aec);
+}
+
+void aec_reset(aec_state_t* aec) {
+    if (!aec) return;
+
+    memset(aec->weights, 0, sizeof(aec->weights));
+    memset(aec->history, 0, sizeof(aec->history));
+    aec->history_pos = 0;
+    aec->ref_energy = 0;
+
+    aec->fifo_head = 0;
+    aec->fifo_tail = 0;
+    aec->fifo_count = 0;
+#if AEC_BULK_DELAY > 0
+    for (uint16_t i = 0; i < AEC_BULK_DELAY && i < AEC_FIFO_SIZE; i++) {
+        fifo_push(aec, 0);
+    }
+#endif
+
+    aec->dc_prev_x = 0;
+    aec->dc_prev_y = 0;
+    aec->ref_peak = 0;
+    aec->ref_peak_age = 0;
+    aec->dt_hold = 0;
+    aec->mic_energy_avg = 0;
+    aec->out_energy_avg = 0;
+}
+
+void aec_set_enabled(aec_state_t* aec, bool enabled) {
+    if (!aec) return;
+
+    if (enabled && !aec->enabled) {
+        aec_reset(aec);
+    }
+    aec->enabled = enabled;
+}
+
+// =============================================================================
+// Processing
+// =============================================================================
+
+void aec_push_reference(aec_state_t* aec, const int16_t* samples, uint16_t count) {
+    if (!aec || !aec->enabled) return;
+
+    for (uint16_t i = 0; i < count; i++) {
+        fifo_push(aec, samples ? samples[i] : 0);
+    }
+}
+
+void aec_process(aec_state_t* aec, int16_t* mic, uint16_t count) {
+    if (!aec || !aec->enabled || !mic || count == 0) return;
+
+    uint64_t mic_energy = 0;
+    uint64_t out_energy = 0;
+    bool far_active = false;
+
+    for (uint16_t n = 0; n < count; n++) {
+        // Reference חדש לחלון: pos יורד, הדגימה החדשה ב-history[pos]
+        int16_t ref = fifo_pop(aec);
+        uint16_t pos = (aec->history_pos == 0) ? (AEC_FILTER_TAPS - 1) : (aec->history_pos - 1);
+        int32_t dropped = aec->history[pos + AEC_FILTER_TAPS];
+
+        aec->ref_energy -= (uint64_t)(dropped * dropped);
+        aec->ref_energy += (uint64_t)(ref * ref);
+        aec->history[pos] = ref;
+        aec->history[pos + AEC_FILTER_TAPS] = ref;
+        aec->history_pos = pos;
+
+        // שיא reference לגלאי double-talk - מוחזק חלון אחד ואז דועך
+        int16_t mag = (ref < 0) ? (int16_t)((ref == -32768) ? 32767 : -ref) : ref;
+        if (mag >= aec->ref_peak) {
+            aec->ref_peak = mag;
+            aec->ref_peak_age = 0;
+        } else if (++aec->ref_peak_age > AEC_FILTER_TAPS) {
+            aec->ref_peak -= aec->ref_peak >> 3;
+        }
+
+        // הסרת DC מהמיקרופון
+        int32_t x = mic[n];
+        int32_t d = x - aec->dc_prev_x + ((DSP_DC_POLE_Q15 * aec->dc_prev_y) >> 15);
+        aec->dc_prev_x = x;
+        aec->dc_prev_y = d;
+        d = sat16(d);
+
+        mic_energy += (uint64_t)(d * d);
+
+        // אין השמעה בחלון - אין הד להסיר
+        if (aec->ref_energy < REF_ENERGY_MIN) {
+            mic[n] = (int16_t)d;
+            out_energy += (uint64_t)(d * d);
+            continue;
+        }
+        far_active = true;
+
+        // הערכת ההד
+        const int16_t* window = &aec->history[pos];
+        int64_t acc = 0;
+        for (uint16_t k = 0; k < AEC_FILTER_TAPS; k++) {
+            acc += (int64_t)aec->weights[k] * window[k];
+        }
+
+        int32_t e = d - (int32_t)(acc >> WEIGHT_SHIFT);
+        int16_t out = sat16(e);
+        mic[n] = out;
+        out_energy += (uint64_t)(out * out);
+
+        // Geigel: קלט חזק מחצי משיא ה-reference = מדברים גם מקומית
+        int32_t d_mag = (d < 0) ? -d : d;
+        if (d_mag > (aec->ref_peak >> 1)) {
+            aec->dt_hold = AEC_DT_HANGOVER;
+        }
+
+        if (aec->dt_hold > 0) {
+            aec->dt_hold--;
+            aec->double_talk_samples++;
+            continue;
+        }
+
+        // NLMS: dw = mu * e * x / |x|^2 (ב-Q28)
+        int64_t scale = ((int64_t)AEC_MU_Q15 * e * (1 << (WEIGHT_SHIFT - 15))) /
+                        (int64_t)aec->ref_energy;
+        if (scale == 0) continue;
+
+        for (uint16_t k = 0; k < AEC_FILTER_TAPS; k++) {
+            aec->weights[k] = sat32((int64_t)aec->weights[k] + scale * window[k]);
+        }
+    }
+
+    // ממוצעים נעים לאומדן ERLE - רק כשיש הד לבטל
+    if (far_active) {
+        uint32_t mic_avg = (uint32_t)(mic_energy / count);
+        uint32_t out_avg = (uint32_t)(out_energy / count);
+        aec->mic_energy_avg = aec->mic_energy_avg - (aec->mic_energy_avg >> 3) + (mic_avg >> 3);
+        aec->out_energy_avg = aec->out_energy_avg - (aec->out_energy_avg >> 3) + (out_avg >> 3);
+    }
+}
+
+int16_t aec_get_erle_db(const aec_state_t* aec) {
+    if (!aec || aec->mic_energy_avg == 0) return 0;
+
+    // 10*log10(a/b) ~= 3 * (log2(a) - log2(b))
+    int16_t erle = 3 * (ilog2(aec->mic_energy_avg) - ilog2(aec->out_energy_avg + 1));
+    return (erle < 0) ? 0 : erle;
+}
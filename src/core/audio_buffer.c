@@ -29,6 +29,8 @@
 
 static uint8_t g_jitter_depth = 3;  // Default jitter buffer depth
 
+_Static_assert(AUDIO_BUFFER_FRAMES >= 8 && AUDIO_BUFFER_FRAMES <= 255, "ring indices are u8, jitter depth up to FRAMES/2");
+
 // =============================================================================
 // Initialization
 // =============================================================================
@@ -232,6 +234,21 @@ uint32_t audio_buffer_duration_ms(const audio_ring_buffer_t* buffer) {
     return audio_buffer_count(buffer) * AUDIO_FRAME_DURATION_MS;
 }
 
+uint32_t audio_buffer_samples(const audio_ring_buffer_t* buffer) {
+    if (!buffer) return 0;
+    
+    uint32_t total = 0;
+    uint8_t idx = buffer->read_idx;
+    uint8_t count = audio_buffer_count(buffer);
+    
+    for (uint8_t i = 0; i < count; i++) {
+        total += buffer->frames[idx].length / sizeof(int16_t);
+        idx = (idx + 1) % AUDIO_BUFFER_FRAMES;
+    }
+    
+    return total;
+}
+
 uint16_t audio_buffer_sequence_gap(uint16_t expected, uint16_t received) {
     // Handle wraparound
     if (received >= expected) {
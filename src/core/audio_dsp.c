@@ -0,0 +1,210 @@
+/**
+ * @file audio_dsp.c
+ * @brief מימוש שרשרת עיבוד אודיו ב-fixed point
+ */
+
+#include "core/audio_dsp.h"
+#include "core/audio_kernels.h"
+#include <string.h>
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+static inline int32_t sat16(int32_t x) {
+    if (x > 32767) return 32767;
+    if (x < -32768) return -32768;
+    return x;
+}
+
+uint32_t audio_dsp_isqrt(uint32_t x) {
+    uint32_t result = 0;
+    uint32_t bit = 1u << 30;
+
+    while (bit > x) bit >>= 2;
+
+    while (bit) {
+        if (x >= result + bit) {
+            x -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return result;
+}
+
+static int32_t ms_to_step(uint32_t sample_rate, uint32_t ms) {
+    uint32_t samples = (sample_rate * ms) / 1000;
+    if (samples == 0) samples = 1;
+    return (int32_t)(DSP_Q15_ONE / samples) + 1;
+}
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+void audio_dsp_init(audio_dsp_t* dsp, uint32_t sample_rate) {
+    if (!dsp) return;
+
+    memset(dsp, 0, sizeof(audio_dsp_t));
+
+    if (sample_rate == 0) sample_rate = 8000;
+
+    dsp->gain_q15 = DSP_Q15_ONE;
+    dsp->gate_attack_step = ms_to_step(sample_rate, DSP_GATE_ATTACK_MS);
+    dsp->gate_release_step = ms_to_step(sample_rate, DSP_GATE_RELEASE_MS);
+    dsp->gate_gain = DSP_Q15_ONE;
+    dsp->agc_target = DSP_AGC_TARGET;
+    dsp->agc_target_q12 = DSP_AGC_UNITY_Q12;
+    dsp->agc_gain_q16 = DSP_AGC_UNITY_Q12 << 4;
+}
+
+void audio_dsp_set_gain(audio_dsp_t* dsp, uint8_t percent) {
+    if (!dsp) return;
+    if (percent > 100) percent = 100;
+    dsp->gain_q15 = (DSP_Q15_ONE * percent) / 100;
+}
+
+void audio_dsp_set_gate(audio_dsp_t* dsp, bool enabled, uint16_t threshold) {
+    if (!dsp) return;
+    dsp->gate_enabled = enabled;
+    dsp->gate_threshold = threshold;
+    if (!enabled) {
+        dsp->gate_gain = DSP_Q15_ONE;
+    }
+}
+
+void audio_dsp_set_agc(audio_dsp_t* dsp, bool enabled) {
+    if (!dsp) return;
+    dsp->agc_enabled = enabled;
+    if (!enabled) {
+        dsp->agc_target_q12 = DSP_AGC_UNITY_Q12;
+        dsp->agc_gain_q16 = DSP_AGC_UNITY_Q12 << 4;
+        dsp->agc_step_q16 = 0;
+    }
+}
+
+void audio_dsp_set_dc_block(audio_dsp_t* dsp, bool enabled) {
+    if (!dsp) return;
+    dsp->dc_block = enabled;
+    dsp->dc_prev_x = 0;
+    dsp->dc_prev_y = 0;
+}
+
+// =============================================================================
+// Processing
+// =============================================================================
+
+void audio_dsp_process(audio_dsp_t* dsp, int16_t* samples, uint16_t count) {
+    if (!dsp || !samples || count == 0) return;
+
+    // רק הגבר (למשל שרשרת הפלט) - אין תלות בין דגימות, עוברים לקרנלים הווקטוריים
+    if (!dsp->dc_block && !dsp->gate_enabled && !dsp->agc_enabled) {
+        audio_kernel_scale(samples, samples, (int16_t)dsp->gain_q15, count);
+        dsp->output_level = audio_kernel_rms(samples, count);
+        dsp->input_level = dsp->output_level;
+        return;
+    }
+
+    // מצב לרגיסטרים מקומיים - הלולאה לא נוגעת ב-struct
+    const int32_t gain = dsp->gain_q15;
+    const bool dc_block = dsp->dc_block;
+    const bool gate_enabled = dsp->gate_enabled;
+    const int32_t gate_open_level = dsp->gate_threshold;
+    const int32_t gate_close_level = dsp->gate_threshold / 2;  // hysteresis
+    const int32_t attack = dsp->gate_attack_step;
+    const int32_t release = dsp->gate_release_step;
+    const int32_t agc_step = dsp->agc_enabled ? dsp->agc_step_q16 : 0;
+
+    int32_t prev_x = dsp->dc_prev_x;
+    int32_t prev_y = dsp->dc_prev_y;
+    int32_t env = dsp->envelope;
+    int32_t gate_gain = dsp->gate_gain;
+    int32_t agc_gain = dsp->agc_gain_q16;
+    bool gate_open = gate_gain > 0;
+
+    uint64_t in_energy = 0;
+    uint64_t out_energy = 0;
+    uint32_t open_samples = 0;
+
+    for (uint16_t i = 0; i < count; i++) {
+        // Gain
+        int32_t x = (samples[i] * gain) >> 15;
+
+        // DC removal: y[n] = x[n] - x[n-1] + a * y[n-1]
+        if (dc_block) {
+            int32_t y = x - prev_x + ((DSP_DC_POLE_Q15 * prev_y) >> 15);
+            prev_x = x;
+            prev_y = y;
+            x = sat16(y);
+        }
+
+        in_energy += (uint64_t)(x * x);
+
+        // Noise gate - מעטפת עם עלייה מהירה וירידה איטית
+        if (gate_enabled) {
+            int32_t mag = (x < 0) ? -x : x;
+            env += (mag > env) ? ((mag - env) >> 4) : ((mag - env) >> 9);
+
+            if (env > gate_open_level) gate_open = true;
+            else if (env < gate_close_level) gate_open = false;
+
+            if (gate_open) {
+                gate_gain += attack;
+                if (gate_gain > DSP_Q15_ONE) gate_gain = DSP_Q15_ONE;
+                open_samples++;
+            } else {
+                gate_gain -= release;
+                if (gate_gain < 0) gate_gain = 0;
+            }
+
+            x = (x * gate_gain) >> 15;
+        }
+
+        // AGC - הגבר עובר אינטרפולציה לכיוון היעד שחושב בבלוק הקודם
+        agc_gain += agc_step;
+        x = sat16((x * (agc_gain >> 4)) >> 12);
+
+        out_energy += (uint64_t)(x * x);
+        samples[i] = (int16_t)x;
+    }
+
+    dsp->dc_prev_x = prev_x;
+    dsp->dc_prev_y = prev_y;
+    dsp->envelope = env;
+    dsp->gate_gain = gate_gain;
+    dsp->agc_gain_q16 = agc_gain;
+
+    uint32_t in_rms = audio_dsp_isqrt((uint32_t)(in_energy / count));
+    dsp->input_level = (in_rms > 0xFFFF) ? 0xFFFF : (uint16_t)in_rms;
+    uint32_t out_rms = audio_dsp_isqrt((uint32_t)(out_energy / count));
+    dsp->output_level = (out_rms > 0xFFFF) ? 0xFFFF : (uint16_t)out_rms;
+
+    if (!dsp->agc_enabled) return;
+
+    // סוף האינטרפולציה - מקבעים בדיוק על היעד
+    dsp->agc_gain_q16 = dsp->agc_target_q12 << 4;
+
+    // עדכון AGC פעם בבלוק - רק כשיש דיבור (gate פתוח והבלוק מעל הסף),
+    // אחרת זנב ה-release של ה-gate מושך את ההגבר למקסימום ומגביר רעש
+    bool has_signal = gate_enabled ? (open_samples > count / 2 && in_rms >= dsp->gate_threshold)
+                                   : (in_rms > 0);
+    if (has_signal) {
+        int32_t current = dsp->agc_target_q12;
+        int32_t desired = (int32_t)(((uint32_t)dsp->agc_target << 12) / in_rms);
+
+        // Fast attack (הורדת הגבר), slow release
+        int32_t next = (desired < current) ? current + (desired - current) / 10
+                                           : current + (desired - current) / 100;
+
+        if (next > DSP_AGC_MAX_GAIN_Q12) next = DSP_AGC_MAX_GAIN_Q12;
+        if (next < DSP_AGC_MIN_GAIN_Q12) next = DSP_AGC_MIN_GAIN_Q12;
+
+        dsp->agc_target_q12 = next;
+    }
+
+    dsp->agc_step_q16 = ((dsp->agc_target_q12 << 4) - dsp->agc_gain_q16) / count;
+}
@@ -0,0 +1,319 @@
+/**
+ * @file audio_kernels.c
+ * @brief מימוש קרנלים לאודיו - PIE ב-ESP32-S3, C בכל השאר
+ */
+
+#include "core/audio_kernels.h"
+#include "core/audio_dsp.h"
+#include <string.h>
+
+// =============================================================================
+// Platform-Specific Includes
+// =============================================================================
+
+#ifdef ESP32
+    #include "esp_log.h"
+
+    static const char* TAG = "KERNELS";
+    #define LOG_INFO(fmt, ...) ESP_LOGI(TAG, fmt, ##__VA_ARGS__)
+    #define LOG_ERROR(fmt, ...) ESP_LOGE(TAG, fmt, ##__VA_ARGS__)
+#else
+    #include <stdio.h>
+    #define LOG_INFO(fmt, ...) printf("[KERNELS] " fmt "\n", ##__VA_ARGS__)
+    #define LOG_ERROR(fmt, ...) printf("[KERNELS ERROR] " fmt "\n", ##__VA_ARGS__)
+#endif
+
+// =============================================================================
+// Internal State
+// =============================================================================
+
+#if AUDIO_KERNELS_PIE
+static bool g_use_pie = true;
+#endif
+
+// ACCX הוא 40 ביט - 256 מכפלות של 2^30 עדיין נכנסות בלי גלישה
+#define DOT_CHUNK_SAMPLES   256
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+static inline int16_t sat16(int32_t x) {
+    if (x > 32767) return 32767;
+    if (x < -32768) return -32768;
+    return (int16_t)x;
+}
+
+#if AUDIO_KERNELS_PIE
+static inline bool is_aligned(const void* p) {
+    return ((uintptr_t)p & (AUDIO_KERNEL_ALIGN - 1)) == 0;
+}
+#endif
+
+// =============================================================================
+// Portable Reference Versions
+// =============================================================================
+
+void audio_kernel_scale_ref(int16_t* dst, const int16_t* src, int16_t gain_q15, uint16_t count) {
+    for (uint16_t i = 0; i < count; i++) {
+        dst[i] = sat16((src[i] * gain_q15) >> 15);
+    }
+}
+
+void audio_kernel_mac_ref(int16_t* acc, const int16_t* src, int16_t gain_q15, uint16_t count) {
+    for (uint16_t i = 0; i < count; i++) {
+        int32_t scaled = sat16((src[i] * gain_q15) >> 15);
+        acc[i] = sat16(acc[i] + scaled);
+    }
+}
+
+void audio_kernel_mix_ref(int16_t* dst, const int16_t* a, const int16_t* b, uint16_t count) {
+    for (uint16_t i = 0; i < count; i++) {
+        dst[i] = sat16(a[i] + b[i]);
+    }
+}
+
+int64_t audio_kernel_dot_ref(const int16_t* a, const int16_t* b, uint16_t count) {
+    int64_t sum = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+// =============================================================================
+// ESP32-S3 PIE Versions
+// =============================================================================
+// כל פונקציה מעבדת בלוקים של 8 דגימות; השארית עוברת בגרסת הייחוס.
+// ee.vmul.s16 מזיז ימינה לפי SAR ורווה ל-16 ביט, ee.vadds.s16 רווה.
+
+#if AUDIO_KERNELS_PIE
+
+static void pie_scale(int16_t* dst, const int16_t* src, int16_t gain_q15, uint16_t blocks) {
+    int16_t gain = gain_q15;
+
+    __asm__ volatile (
+        "movi           a8, 15                  \n"
+        "wsr.sar        a8                      \n"
+        "ee.vldbc.16    q1, %[g]                \n"
+        "loopgtz        %[n], 1f                \n"
+        "ee.vld.128.ip  q0, %[s], 16            \n"
+        "ee.vmul.s16    q2, q0, q1              \n"
+        "ee.vst.128.ip  q2, %[d], 16            \n"
+        "1:                                     \n"
+        : [s] "+r" (src), [d] "+r" (dst)
+        : [n] "r" (blocks), [g] "r" (&gain)
+        : "a8", "memory"
+    );
+}
+
+static void pie_mac(int16_t* acc, const int16_t* src, int16_t gain_q15, uint16_t blocks) {
+    int16_t gain = gain_q15;
+    int16_t* acc_out = acc;
+
+    __asm__ volatile (
+        "movi           a8, 15                  \n"
+        "wsr.sar        a8                      \n"
+        "ee.vldbc.16    q1, %[g]                \n"
+        "loopgtz        %[n], 1f                \n"
+        "ee.vld.128.ip  q0, %[s], 16            \n"
+        "ee.vld.128.ip  q3, %[a], 16            \n"
+        "ee.vmul.s16    q2, q0, q1              \n"
+        "ee.vadds.s16   q3, q3, q2              \n"
+        "ee.vst.128.ip  q3, %[o], 16            \n"
+        "1:                                     \n"
+        : [s] "+r" (src), [a] "+r" (acc), [o] "+r" (acc_out)
+        : [n] "r" (blocks), [g] "r" (&gain)
+        : "a8", "memory"
+    );
+}
+
+static void pie_mix(int16_t* dst, const int16_t* a, const int16_t* b, uint16_t blocks) {
+    __asm__ volatile (
+        "loopgtz        %[n], 1f                \n"
+        "ee.vld.128.ip  q0, %[a], 16            \n"
+        "ee.vld.128.ip  q1, %[b], 16            \n"
+        "ee.vadds.s16   q2, q0, q1              \n"
+        "ee.vst.128.ip  q2, %[d], 16            \n"
+        "1:                                     \n"
+        : [a] "+r" (a), [b] "+r" (b), [d] "+r" (dst)
+        : [n] "r" (blocks)
+        : "memory"
+    );
+}
+
+static int64_t pie_dot(const int16_t* a, const int16_t* b, uint16_t blocks) {
+    uint32_t lo, hi;
+
+    __asm__ volatile (
+        "ee.zero.accx                           \n"
+        "loopgtz        %[n], 1f                \n"
+        "ee.vld.128.ip  q0, %[a], 16            \n"
+        "ee.vld.128.ip  q1, %[b], 16            \n"
+        "ee.vmulas.s16.accx q0, q1              \n"
+        "1:                                     \n"
+        "rur.accx_0     %[lo]                   \n"
+        "rur.accx_1     %[hi]                   \n"
+        : [a] "+r" (a), [b] "+r" (b), [lo] "=r" (lo), [hi] "=r" (hi)
+        : [n] "r" (blocks)
+        : "memory"
+    );
+
+    // ACCX: 32 ביט תחתונים + 8 עליונים עם סימן
+    return ((int64_t)(int8_t)(hi & 0xFF) << 32) | lo;
+}
+
+#endif // AUDIO_KERNELS_PIE
+
+// =============================================================================
+// Dispatch
+// =============================================================================
+
+void audio_kernel_scale(int16_t* dst, const int16_t* src, int16_t gain_q15, uint16_t count) {
+    if (!dst || !src || count == 0) return;
+
+#if AUDIO_KERNELS_PIE
+    if (g_use_pie && is_aligned(dst) && is_aligned(src)) {
+        uint16_t blocks = count / AUDIO_KERNEL_LANES;
+        uint16_t done = blocks * AUDIO_KERNEL_LANES;
+        pie_scale(dst, src, gain_q15, blocks);
+        audio_kernel_scale_ref(dst + done, src + done, gain_q15, count - done);
+        return;
+    }
+#endif
+
+    audio_kernel_scale_ref(dst, src, gain_q15, count);
+}
+
+void audio_kernel_mac(int16_t* acc, const int16_t* src, int16_t gain_q15, uint16_t count) {
+    if (!acc || !src || count == 0) return;
+
+#if AUDIO_KERNELS_PIE
+    if (g_use_pie && is_aligned(acc) && is_aligned(src)) {
+        uint16_t blocks = count / AUDIO_KERNEL_LANES;
+        uint16_t done = blocks * AUDIO_KERNEL_LANES;
+        pie_mac(acc, src, gain_q15, blocks);
+        audio_kernel_mac_ref(acc + done, src + done, gain_q15, count - done);
+        return;
+    }
+#endif
+
+    audio_kernel_mac_ref(acc, src, gain_q15, count);
+}
+
+void audio_kernel_mix(int16_t* dst, const int16_t* a, const int16_t* b, uint16_t count) {
+    if (!dst || !a || !b || count == 0) return;
+
+#if AUDIO_KERNELS_PIE
+    if (g_use_pie && is_aligned(dst) && is_aligned(a) && is_aligned(b)) {
+        uint16_t blocks = count / AUDIO_KERNEL_LANES;
+        uint16_t done = blocks * AUDIO_KERNEL_LANES;
+        pie_mix(dst, a, b, blocks);
+        audio_kernel_mix_ref(dst + done, a + done, b + done, count - done);
+        return;
+    }
+#endif
+
+    audio_kernel_mix_ref(dst, a, b, count);
+}
+
+int64_t audio_kernel_dot(const int16_t* a, const int16_t* b, uint16_t count) {
+    if (!a || !b || count == 0) return 0;
+
+#if AUDIO_KERNELS_PIE
+    if (g_use_pie && is_aligned(a) && is_aligned(b)) {
+        int64_t sum = 0;
+        uint16_t offset = 0;
+
+        // מקטעים כדי שה-accumulator לא יגלוש
+        while (count - offset >= AUDIO_KERNEL_LANES) {
+            uint16_t chunk = count - offset;
+            if (chunk > DOT_CHUNK_SAMPLES) chunk = DOT_CHUNK_SAMPLES;
+            uint16_t blocks = chunk / AUDIO_KERNEL_LANES;
+
+            sum += pie_dot(a + offset, b + offset, blocks);
+            offset += blocks * AUDIO_KERNEL_LANES;
+        }
+
+        return sum + audio_kernel_dot_ref(a + offset, b + offset, count - offset);
+    }
+#endif
+
+    return audio_kernel_dot_ref(a, b, count);
+}
+
+uint16_t audio_kernel_rms(const int16_t* samples, uint16_t count) {
+    if (!samples || count == 0) return 0;
+
+    uint64_t energy = (uint64_t)audio_kernel_dot(samples, samples, count);
+    uint32_t rms = audio_dsp_isqrt((uint32_t)(energy / count));
+
+    return (rms > 0xFFFF) ? 0xFFFF : (uint16_t)rms;
+}
+
+// =============================================================================
+// Self Test
+// =============================================================================
+
+bool audio_kernels_init(void) {
+#if AUDIO_KERNELS_PIE
+    // אותות בדיקה עם ערכי קצה - כדי לתפוס הבדלי רוויה ועיגול
+    static int16_t a[64] AUDIO_ALIGNED;
+    static int16_t b[64] AUDIO_ALIGNED;
+    static int16_t out_vec[64] AUDIO_ALIGNED;
+    static int16_t out_ref[64] AUDIO_ALIGNED;
+
+    uint32_t seed = 0x1234567;
+    for (uint16_t i = 0; i < 64; i++) {
+        seed = seed * 1103515245u + 12345u;
+        a[i] = (int16_t)(seed >> 16);
+        seed = seed * 1103515245u + 12345u;
+        b[i] = (int16_t)(seed >> 16);
+    }
+    a[0] = -32768; b[0] = -32768;
+    a[1] = 32767;  b[1] = 32767;
+
+    const int16_t gains[] = { 32767, 22938, 1, -32768 };
+    bool ok = true;
+
+    for (uint8_t g = 0; g < sizeof(gains) / sizeof(gains[0]) && ok; g++) {
+        pie_scale(out_vec, a, gains[g], 8);
+        audio_kernel_scale_ref(out_ref, a, gains[g], 64);
+        ok = ok && memcmp(out_vec, out_ref, sizeof(out_vec)) == 0;
+
+        memcpy(out_vec, b, sizeof(out_vec));
+        memcpy(out_ref, b, sizeof(out_ref));
+        pie_mac(out_vec, a, gains[g], 8);
+        audio_kernel_mac_ref(out_ref, a, gains[g], 64);
+        ok = ok && memcmp(out_vec, out_ref, sizeof(out_vec)) == 0;
+    }
+
+    pie_mix(out_vec, a, b, 8);
+    audio_kernel_mix_ref(out_ref, a, b, 64);
+    ok = ok && memcmp(out_vec, out_ref, sizeof(out_vec)) == 0;
+
+    ok = ok && pie_dot(a, b, 8) == audio_kernel_dot_ref(a, b, 64);
+    ok = ok && pie_dot(a, a, 8) == audio_kernel_dot_ref(a, a, 64);
+
+    g_use_pie = ok;
+
+    if (ok) {
+        LOG_INFO("PIE kernels enabled");
+    } else {
+        LOG_ERROR("PIE kernel mismatch - using C reference");
+    }
+
+    return ok;
+#else
+    LOG_INFO("Using portable C kernels");
+    return false;
+#endif
+}
+
+bool audio_kernels_accelerated(void) {
+#if AUDIO_KERNELS_PIE
+    return g_use_pie;
+#else
+    return false;
+#endif
+}
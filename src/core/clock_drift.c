@@ -0,0 +1,69 @@
+/**
+ * @file clock_drift.c
+ * @brief מימוש מעריך סחיפת שעון (בקר PI על מילוי ה-jitter buffer)
+ */
+
+#include "core/clock_drift.h"
+#include <string.h>
+
+// =============================================================================
+// API
+// =============================================================================
+
+void clock_drift_reset(clock_drift_t* drift) {
+    if (!drift) return;
+    memset(drift, 0, sizeof(clock_drift_t));
+}
+
+bool clock_drift_update(clock_drift_t* drift, uint32_t fill_samples, uint32_t now) {
+    if (!drift) return false;
+
+    if (drift->updates > 0 && now - drift->last_update < DRIFT_UPDATE_MS) {
+        return false;
+    }
+    drift->last_update = now;
+
+    int32_t fill_q8 = (int32_t)(fill_samples << 8);
+
+    // עד שהיעד נקבע - ממוצע פשוט (ממוצע נע מזרע רועש היה מטה את היעד)
+    if (!drift->settled) {
+        drift->updates++;
+        drift->fill_avg_q8 += (fill_q8 - drift->fill_avg_q8) / drift->updates;
+
+        // היעד = המילוי בתחילת ההשמעה (עומק ה-jitter)
+        if (drift->updates < DRIFT_SETTLE_UPDATES) {
+            return false;
+        }
+        drift->target_q8 = drift->fill_avg_q8;
+        drift->settled = true;
+        return false;
+    }
+
+    drift->fill_avg_q8 += (fill_q8 - drift->fill_avg_q8) >> DRIFT_AVG_SHIFT;
+
+    int32_t err_q8 = drift->fill_avg_q8 - drift->target_q8;
+
+    // אינטגרל עם anti-windup
+    const int64_t integral_limit = (int64_t)DRIFT_MAX_PPM * DRIFT_KI_DIV * 256;
+    drift->integral_q8 += err_q8;
+    if (drift->integral_q8 > integral_limit) drift->integral_q8 = integral_limit;
+    if (drift->integral_q8 < -integral_limit) drift->integral_q8 = -integral_limit;
+
+    int64_t p_term = ((int64_t)err_q8 * DRIFT_KP_Q8) >> 16;
+    int64_t i_term = drift->integral_q8 / ((int64_t)DRIFT_KI_DIV * 256);
+    int32_t ppm = (int32_t)-(p_term + i_term);
+
+    if (ppm > DRIFT_MAX_PPM) ppm = DRIFT_MAX_PPM;
+    if (ppm < -DRIFT_MAX_PPM) ppm = -DRIFT_MAX_PPM;
+
+    if (ppm == drift->ppm) {
+        return false;
+    }
+
+    drift->ppm = ppm;
+    return true;
+}
+
+int32_t clock_drift_get_ppm(const clock_drift_t* drift) {
+    return drift ? drift->ppm : 0;
+}
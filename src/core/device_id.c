@@ -142,6 +142,30 @@ void device_id_raw_to_string(const uint8_t* raw, size_t raw_size, char* output)
     snprintf(output, DEVICE_ID_STRING_SIZE + 1, "%08u", value);
 }
 
+uint32_t device_id_string_to_wire(const char* id) {
+    if (!id) return DEVICE_ID_WIRE_INVALID;
+    
+    uint32_t value = 0;
+    for (int i = 0; i < DEVICE_ID_STRING_SIZE; i++) {
+        if (!isdigit((unsigned char)id[i])) return DEVICE_ID_WIRE_INVALID;
+        value = (value * 10) + (uint32_t)(id[i] - '0');
+    }
+    
+    return value;
+}
+
+bool device_id_wire_to_string(uint32_t wire, char* output) {
+    if (!output) return false;
+    
+    if (wire > 99999999) {
+        output[0] = '\0';
+        return false;
+    }
+    
+    snprintf(output, DEVICE_ID_STRING_SIZE + 1, "%08u", (unsigned)wire);
+    return true;
+}
+
 void device_id_raw_to_hex(const uint8_t* raw, size_t raw_size, char* output) {
     if (!raw || !output) {
         if (output) output[0] = '\0';
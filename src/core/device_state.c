@@ -6,6 +6,8 @@
 #include "core/device_state.h"
 #include "hal/buttons.h"
 #include "hal/display.h"
+#include "core/telemetry.h"
+#include "core/trace.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -397,8 +399,8 @@ static void render_saved_list(device_context_t* ctx) {
     if (ctx->saved_code_count == 0) {
         display_print_aligned(28, "No saved codes", FONT_SMALL, ALIGN_CENTER);
     } else {
-        static char list_items[MAX_SAVED_CODES][24];
-        static const char* list_ptrs[MAX_SAVED_CODES];
+        static char list_items[MAX_SAVED_CODES][24] LARGE_TABLE_ATTR;
+        static const char* list_ptrs[MAX_SAVED_CODES] LARGE_TABLE_ATTR;
         
         for (uint8_t i = 0; i < ctx->saved_code_count; i++) {
             saved_code_t* s = &ctx->saved_codes[i];
@@ -515,6 +517,9 @@ static void render_invite_menu(device_context_t* ctx) {
 }
 
 static void render_state(device_context_t* ctx) {
+    uint32_t start_us = telemetry_now_us();
+    TRACE_BEGIN(TRACE_RENDER);
+    
     switch (ctx->current_state) {
         case STATE_IDLE:
             render_idle(ctx);
@@ -561,6 +566,9 @@ static void render_state(device_context_t* ctx) {
             render_message(ctx);
             break;
     }
+    
+    TRACE_END(TRACE_RENDER);
+    telemetry_record_since(TM_HIST_RENDER, start_us);
 }
 
 // =============================================================================
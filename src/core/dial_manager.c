@@ -5,6 +5,8 @@
 
 #include "core/dial_manager.h"
 #include "comm/protocol.h"
+#include "core/device_id.h"
+#include "core/peer_table.h"
 #include <string.h>
 #include <stdio.h>
 
@@ -51,6 +53,20 @@ typedef struct {
 // Static task parameters (one per slot)
 static dial_task_param_t task_params[DIAL_POSITIONS];
 
+// =============================================================================
+// Peer Table Mapping
+// =============================================================================
+
+// שיוך ה-peer למיקום בגלגלת, כדי שה-RX ימצא את ה-slot בלי לעבור על כולם
+static void map_slot_peer(const dial_slot_t* slot, int8_t position) {
+    uint32_t wire_id = device_id_string_to_wire(slot->code);
+    if (wire_id == DEVICE_ID_WIRE_INVALID) return;
+    
+    peer_type_t type = (slot->conn_type == DIAL_CONN_FREQUENCY) ?
+                       PEER_TYPE_FREQUENCY : PEER_TYPE_DEVICE;
+    protocol_map_peer_slot(wire_id, type, position);
+}
+
 // =============================================================================
 // Initialization
 // =============================================================================
@@ -152,6 +168,10 @@ bool dial_manager_save_slot(dial_manager_t* dm, uint8_t position,
         destroy_connection_thread(dm, position);
     }
     
+    if (slot->is_configured) {
+        map_slot_peer(slot, PEER_NO_SLOT);
+    }
+    
     // Save configuration
     slot->is_configured = true;
     slot->conn_type = conn_type;
@@ -166,6 +186,7 @@ bool dial_manager_save_slot(dial_manager_t* dm, uint8_t position,
     }
     
     slot->state = DIAL_SLOT_SAVED;
+    map_slot_peer(slot, (int8_t)position);
     
     LOG_INFO("Saved slot %d: %s (%s)", position, slot->code, 
              conn_type == DIAL_CONN_FREQUENCY ? "freq" : "device");
@@ -194,6 +215,10 @@ bool dial_manager_clear_slot(dial_manager_t* dm, uint8_t position) {
         destroy_connection_thread(dm, position);
     }
     
+    if (slot->is_configured) {
+        map_slot_peer(slot, PEER_NO_SLOT);
+    }
+    
     // Clear slot
     memset(slot, 0, sizeof(dial_slot_t));
     slot->state = DIAL_SLOT_EMPTY;
@@ -561,6 +586,7 @@ bool dial_manager_load_from_nvs(dial_manager_t* dm) {
             strncpy(slot->name, save_data.name, 16);
             strncpy(slot->password, save_data.password, PASSWORD_MAX_LENGTH + 1);
             slot->state = DIAL_SLOT_SAVED;
+            map_slot_peer(slot, (int8_t)i);
             loaded++;
         }
     }
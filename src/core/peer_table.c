@@ -0,0 +1,174 @@
+/**
+ * @file peer_table.c
+ * @brief מימוש טבלת peers (open addressing)
+ */
+
+#include "core/peer_table.h"
+#include <string.h>
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+#define TABLE_MASK  (PEER_TABLE_CAPACITY - 1)
+
+_Static_assert(PEER_TABLE_BITS >= 4 && PEER_TABLE_BITS <= 15, "probe counters are u16");
+
+// מזהים הם עד 27 ביט - הסוג נכנס בביטים העליונים, וביט 31 מבטיח key != 0
+static inline uint32_t make_key(uint32_t id, peer_type_t type) {
+    return 0x80000000u | ((uint32_t)type << 28) | (id & 0x0FFFFFFFu);
+}
+
+// Fibonacci hashing - מפזר היטב גם מזהים רציפים
+static inline uint16_t hash_key(uint32_t key) {
+    return (uint16_t)((key * 2654435769u) >> (32 - PEER_TABLE_BITS));
+}
+
+static inline bool is_pinned(const peer_entry_t* e) {
+    return e->dial_slot != PEER_NO_SLOT;
+}
+
+static void clear_entry(peer_entry_t* e) {
+    memset(e, 0, sizeof(peer_entry_t));
+    e->dial_slot = PEER_NO_SLOT;
+}
+
+static int find_index(const peer_table_t* table, uint32_t key) {
+    uint16_t idx = hash_key(key);
+
+    for (uint16_t probe = 0; probe < PEER_TABLE_CAPACITY; probe++) {
+        const peer_entry_t* e = &table->entries[idx];
+        if (e->key == 0) return -1;
+        if (e->key == key) return idx;
+        idx = (idx + 1) & TABLE_MASK;
+    }
+
+    return -1;
+}
+
+// Backward shift deletion - מזיז רשומות בהמשך ה-cluster כדי לסגור את החור
+static void remove_at(peer_table_t* table, uint16_t hole) {
+    uint16_t idx = (hole + 1) & TABLE_MASK;
+
+    while (table->entries[idx].key != 0) {
+        uint16_t home = hash_key(table->entries[idx].key);
+
+        // האם ה-home של הרשומה לא נמצא בטווח (hole, idx] - אז אפשר להזיז
+        bool movable = (hole <= idx) ? (home <= hole || home > idx)
+                                     : (home <= hole && home > idx);
+        if (movable) {
+            table->entries[hole] = table->entries[idx];
+            hole = idx;
+        }
+        idx = (idx + 1) & TABLE_MASK;
+    }
+
+    clear_entry(&table->entries[hole]);
+    table->count--;
+}
+
+// מועמד לפינוי: לא מקובע, וישן יותר מהנוכחי (השוואה עמידה ל-wrap של millis)
+static void consider_victim(const peer_table_t* table, uint16_t idx, int* victim) {
+    const peer_entry_t* e = &table->entries[idx];
+    if (e->key == 0 || is_pinned(e)) return;
+    if (*victim < 0 || (int32_t)(e->last_seen - table->entries[*victim].last_seen) < 0) {
+        *victim = idx;
+    }
+}
+
+/**
+ * @brief בחירת רשומה לפינוי בעלות חסומה
+ *
+ * קודם ה-cluster של home - ההכנסה עוברת עליו בכל מקרה עד החור הפנוי,
+ * ובעומס של 75% הוא קצר. רק אם כולו מקובע, PEER_EVICT_SCAN רשומות
+ * ממחוג שממשיך מהמקום שעצר בקריאה הקודמת.
+ */
+static int pick_victim(peer_table_t* table, uint16_t home) {
+    int victim = -1;
+
+    for (uint16_t idx = home; table->entries[idx].key != 0; idx = (idx + 1) & TABLE_MASK) {
+        consider_victim(table, idx, &victim);
+    }
+
+    for (uint16_t n = 0; victim < 0 && n < PEER_EVICT_SCAN; n++) {
+        consider_victim(table, table->evict_hand, &victim);
+        table->evict_hand = (table->evict_hand + 1) & TABLE_MASK;
+    }
+
+    return victim;
+}
+
+// =============================================================================
+// Table Operations
+// =============================================================================
+
+void peer_table_init(peer_table_t* table) {
+    if (!table) return;
+
+    for (uint16_t i = 0; i < PEER_TABLE_CAPACITY; i++) {
+        clear_entry(&table->entries[i]);
+    }
+    table->count = 0;
+    table->evict_hand = 0;
+}
+
+peer_entry_t* peer_table_find(peer_table_t* table, uint32_t id, peer_type_t type) {
+    if (!table) return NULL;
+
+    int idx = find_index(table, make_key(id, type));
+    return (idx >= 0) ? &table->entries[idx] : NULL;
+}
+
+peer_entry_t* peer_table_insert(peer_table_t* table, uint32_t id, peer_type_t type) {
+    if (!table) return NULL;
+
+    uint32_t key = make_key(id, type);
+    int existing = find_index(table, key);
+    if (existing >= 0) return &table->entries[existing];
+
+    // שומרים על load factor נמוך כדי שה-probing יישאר קצר
+    uint16_t home = hash_key(key);
+    if (table->count >= PEER_TABLE_MAX_LOAD) {
+        int victim = pick_victim(table, home);
+        if (victim < 0) return NULL;
+        remove_at(table, (uint16_t)victim);
+    }
+
+    uint16_t idx = home;
+    while (table->entries[idx].key != 0) {
+        idx = (idx + 1) & TABLE_MASK;
+    }
+
+    peer_entry_t* e = &table->entries[idx];
+    clear_entry(e);
+    e->key = key;
+    e->id = id;
+    e->type = (uint8_t)type;
+    table->count++;
+
+    return e;
+}
+
+bool peer_table_remove(peer_table_t* table, uint32_t id, peer_type_t type) {
+    if (!table) return false;
+
+    int idx = find_index(table, make_key(id, type));
+    if (idx < 0) return false;
+
+    remove_at(table, (uint16_t)idx);
+    return true;
+}
+
+uint16_t peer_table_count(const peer_table_t* table) {
+    return table ? table->count : 0;
+}
+
+// =============================================================================
+// Per-Peer State
+// =============================================================================
+
+void peer_touch(peer_entry_t* peer, uint32_t now) {
+    if (!peer) return;
+
+    peer->last_seen = now;
+}
@@ -0,0 +1,605 @@
+/**
+ * @file rec_catalog.c
+ * @brief מימוש קטלוג ההקלטות
+ */
+
+#include "core/rec_catalog.h"
+#include "config.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// =============================================================================
+// Platform-Specific
+// =============================================================================
+
+#ifdef ESP32
+    #include "esp_log.h"
+    #include "freertos/FreeRTOS.h"
+    #include "freertos/semphr.h"
+    #include <dirent.h>
+
+    static const char* TAG = "CATALOG";
+    #define LOG_INFO(fmt, ...) ESP_LOGI(TAG, fmt, ##__VA_ARGS__)
+    #define LOG_ERROR(fmt, ...) ESP_LOGE(TAG, fmt, ##__VA_ARGS__)
+
+    static SemaphoreHandle_t g_mutex = NULL;
+    #define CATALOG_LOCK()   xSemaphoreTake(g_mutex, portMAX_DELAY)
+    #define CATALOG_UNLOCK() xSemaphoreGive(g_mutex)
+#else
+    #include <dirent.h>
+
+    #define LOG_INFO(fmt, ...) printf("[CATALOG] " fmt "\n", ##__VA_ARGS__)
+    #define LOG_ERROR(fmt, ...) printf("[CATALOG ERROR] " fmt "\n", ##__VA_ARGS__)
+    #define CATALOG_LOCK()
+    #define CATALOG_UNLOCK()
+#endif
+
+// =============================================================================
+// File Layout
+// =============================================================================
+
+#define CATALOG_HEADER_SIZE     64
+#define CATALOG_ENTRY_SIZE      ((uint32_t)sizeof(rec_catalog_entry_t))
+#define CATALOG_READ_ENTRIES    8           // קריאה בטעינה: 512 בתים (סקטור)
+#define CATALOG_COMPACT_MIN     64          // לא דוחסים קטלוג קטן
+#define CATALOG_TMP_NAME        "CATALOG.TMP"
+
+// תיקייה + '/' + שם רשומה - נכנס תמיד, בלי קיצוץ
+#define CATALOG_PATH_SIZE       (STORAGE_MAX_PATH_LENGTH + 1 + REC_CATALOG_NAME_LENGTH + 1)
+
+#pragma pack(push, 1)
+typedef struct {
+    char     magic[4];              // "WTCL"
+    uint8_t  version;
+    uint8_t  reserved0[3];
+    uint32_t entry_size;
+    uint8_t  reserved[CATALOG_HEADER_SIZE - 12];
+} catalog_header_t;
+#pragma pack(pop)
+
+_Static_assert(sizeof(rec_catalog_entry_t) == 64, "catalog entry must stay 64 bytes");
+_Static_assert(sizeof(catalog_header_t) == CATALOG_HEADER_SIZE, "catalog header size");
+
+// =============================================================================
+// Internal State
+// =============================================================================
+
+// בזיכרון רק מה שצריך לדפדוף: אילו רשומות חיות (125 בתים ל-1000)
+static bool     g_loaded = false;
+static char     g_dir[STORAGE_MAX_PATH_LENGTH];
+static char     g_path[CATALOG_PATH_SIZE];
+static uint32_t g_count = 0;                        // רשומות בקובץ, כולל מחוקות
+static uint32_t g_live_count = 0;
+static uint32_t g_total_size = 0;
+static uint8_t  g_live[(REC_CATALOG_MAX + 7) / 8];
+
+static inline bool is_live(uint32_t id) {
+    return (g_live[id >> 3] >> (id & 7)) & 1;
+}
+
+static inline void set_live(uint32_t id, bool live) {
+    if (live) {
+        g_live[id >> 3] |= (uint8_t)(1 << (id & 7));
+    } else {
+        g_live[id >> 3] &= (uint8_t)~(1 << (id & 7));
+    }
+}
+
+static inline int32_t entry_offset(uint32_t id) {
+    return (int32_t)(CATALOG_HEADER_SIZE + id * CATALOG_ENTRY_SIZE);
+}
+
+// =============================================================================
+// Entry I/O
+// =============================================================================
+
+static bool read_entry(uint32_t id, rec_catalog_entry_t* entry) {
+    storage_file_t file;
+    if (storage_file_open(&file, g_path, FILE_MODE_READ) != STORAGE_OK) {
+        return false;
+    }
+    bool ok = storage_file_seek(&file, entry_offset(id), SEEK_SET) == STORAGE_OK &&
+              storage_file_read(&file, entry, CATALOG_ENTRY_SIZE) == (int32_t)CATALOG_ENTRY_SIZE;
+    storage_file_close(&file);
+    return ok;
+}
+
+// רשומה קיימת נכתבת במקומה - 64 בתים, בלי להזיז שום דבר אחר
+static bool write_entry(uint32_t id, const rec_catalog_entry_t* entry) {
+    storage_file_t file;
+    if (storage_file_open(&file, g_path, FILE_MODE_READ_WRITE) != STORAGE_OK) {
+        return false;
+    }
+    bool ok = storage_file_seek(&file, entry_offset(id), SEEK_SET) == STORAGE_OK &&
+              storage_file_write(&file, entry, CATALOG_ENTRY_SIZE) == (int32_t)CATALOG_ENTRY_SIZE;
+    storage_file_sync(&file);
+    storage_file_close(&file);
+    return ok;
+}
+
+static bool append_entry(const rec_catalog_entry_t* entry) {
+    storage_file_t file;
+    if (storage_file_open(&file, g_path, FILE_MODE_APPEND) != STORAGE_OK) {
+        return false;
+    }
+    bool ok = storage_file_write(&file, entry, CATALOG_ENTRY_SIZE) == (int32_t)CATALOG_ENTRY_SIZE;
+    storage_file_sync(&file);
+    storage_file_close(&file);
+    return ok;
+}
+
+static void account_entry(uint32_t id, const rec_catalog_entry_t* entry) {
+    bool live = (entry->state == REC_CATALOG_OPEN || entry->state == REC_CATALOG_COMPLETE);
+    set_live(id, live);
+    if (live) {
+        g_live_count++;
+        g_total_size += entry->size_bytes;
+    }
+}
+
+// =============================================================================
+// Build & Load
+// =============================================================================
+
+static void copy_name(char* dst, size_t size, const char* src) {
+    snprintf(dst, size, "%s", src ? src : "");
+}
+
+/**
+ * רשומה מהקובץ עצמו - רק בבנייה מחדש ואחרי תיקון.
+ * ב-.wtr: הכותרת ומקטע ראשון; ב-.wav: 44 בתי הכותרת.
+ */
+static bool entry_from_file(const char* name, rec_catalog_entry_t* entry) {
+    char path[CATALOG_PATH_SIZE];
+    if (snprintf(path, sizeof(path), "%s/%s", g_dir, name) >= (int)sizeof(path)) {
+        return false;
+    }
+
+    memset(entry, 0, sizeof(*entry));
+    copy_name(entry->name, sizeof(entry->name), name);
+    entry->state = REC_CATALOG_COMPLETE;
+
+    const char* ext = strrchr(name, '.');
+    if (ext && strcmp(ext, REC_EXTENSION) == 0) {
+        static rec_reader_t reader;
+        int16_t first;
+        rec_segment_info_t segment;
+
+        if (!rec_reader_open(&reader, path)) return false;
+        entry->timestamp = reader.header.created;
+        entry->sample_rate = reader.header.sample_rate;
+        entry->size_bytes = reader.file.size;
+        if (reader.header.sample_rate > 0) {
+            entry->duration_ms = (uint32_t)((uint64_t)reader.total_samples * 1000 /
+                                            reader.header.sample_rate);
+        }
+        if (rec_reader_read(&reader, &first, 1) > 0 && rec_reader_get_segment(&reader, &segment)) {
+            copy_name(entry->peer_id, sizeof(entry->peer_id), segment.peer_id);
+        }
+        rec_reader_close(&reader);
+        return true;
+    }
+
+    if (ext && strcmp(ext, RECORDING_EXTENSION) == 0) {
+        storage_file_t file;
+        uint8_t wav[44];
+
+        if (storage_file_open(&file, path, FILE_MODE_READ) != STORAGE_OK) return false;
+        bool ok = storage_file_read(&file, wav, sizeof(wav)) == (int32_t)sizeof(wav) &&
+                  memcmp(wav, "RIFF", 4) == 0 && memcmp(wav + 8, "WAVE", 4) == 0;
+        entry->size_bytes = file.size;
+        storage_file_close(&file);
+        if (!ok) return false;
+
+        uint32_t rate, data_size;
+        uint16_t block_align;
+        memcpy(&rate, wav + 24, 4);
+        memcpy(&block_align, wav + 32, 2);
+        memcpy(&data_size, wav + 40, 4);
+        entry->sample_rate = rate;
+        if (rate > 0 && block_align > 0) {
+            entry->duration_ms = (uint32_t)((uint64_t)(data_size / block_align) * 1000 / rate);
+        }
+        return true;
+    }
+
+    return false;
+}
+
+static int compare_entries(const void* a, const void* b) {
+    const rec_catalog_entry_t* ea = (const rec_catalog_entry_t*)a;
+    const rec_catalog_entry_t* eb = (const rec_catalog_entry_t*)b;
+    if (ea->timestamp != eb->timestamp) {
+        return (ea->timestamp < eb->timestamp) ? -1 : 1;
+    }
+    return strcmp(ea->name, eb->name);
+}
+
+/**
+ * כתיבת קטלוג שלם לקובץ זמני והחלפה - קטלוג חלקי אף פעם לא נראה
+ */
+static bool write_catalog(const rec_catalog_entry_t* entries, uint32_t count) {
+    char tmp[CATALOG_PATH_SIZE];
+    storage_file_t file;
+    catalog_header_t header;
+
+    snprintf(tmp, sizeof(tmp), "%s/%s", g_dir, CATALOG_TMP_NAME);
+    if (storage_file_open(&file, tmp, FILE_MODE_WRITE) != STORAGE_OK) {
+        return false;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, REC_CATALOG_MAGIC, 4);
+    header.version = REC_CATALOG_VERSION;
+    header.entry_size = CATALOG_ENTRY_SIZE;
+
+    bool ok = storage_file_write(&file, &header, sizeof(header)) == (int32_t)sizeof(header);
+    if (ok && count > 0) {
+        int32_t bytes = (int32_t)(count * CATALOG_ENTRY_SIZE);
+        ok = storage_file_write(&file, entries, (uint32_t)bytes) == bytes;
+    }
+    storage_file_sync(&file);
+    storage_file_close(&file);
+
+    if (!ok) {
+        storage_file_delete(tmp);
+        return false;
+    }
+
+    if (storage_file_exists(g_path)) {
+        storage_file_delete(g_path);
+    }
+    if (storage_file_rename(tmp, g_path) != STORAGE_OK) {
+        return false;
+    }
+
+    memset(g_live, 0, sizeof(g_live));
+    g_count = count;
+    g_live_count = 0;
+    g_total_size = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        account_entry(i, &entries[i]);
+    }
+    return true;
+}
+
+static bool rebuild_locked(void) {
+    rec_catalog_entry_t* entries = malloc(REC_CATALOG_MAX * sizeof(rec_catalog_entry_t));
+    if (!entries) {
+        LOG_ERROR("No memory for catalog rebuild");
+        return false;
+    }
+
+    uint32_t count = 0;
+    DIR* dir = opendir(g_dir);
+    if (dir) {
+        struct dirent* de;
+        while ((de = readdir(dir)) != NULL && count < REC_CATALOG_MAX) {
+            if (de->d_name[0] == '.' || strlen(de->d_name) > REC_CATALOG_NAME_LENGTH) continue;
+            if (entry_from_file(de->d_name, &entries[count])) {
+                count++;
+            }
+        }
+        closedir(dir);
+    }
+
+    // הדפדוף מניח סדר כרונולוגי בקובץ
+    qsort(entries, count, sizeof(rec_catalog_entry_t), compare_entries);
+
+    bool ok = write_catalog(entries, count);
+    free(entries);
+
+    if (ok) {
+        LOG_INFO("Catalog rebuilt: %u recordings", (unsigned)count);
+    } else {
+        LOG_ERROR("Failed to write catalog");
+    }
+    return ok;
+}
+
+/**
+ * קריאה רציפה אחת בהפעלה - רק כדי לבנות את מפת הרשומות החיות.
+ * זנב חלקי (הוספה שנקטעה) מתעלמים ממנו; ההוספה הבאה דורסת אותו.
+ */
+static bool load_locked(void) {
+    storage_file_t file;
+    catalog_header_t header;
+
+    if (!storage_file_exists(g_path) ||
+        storage_file_open(&file, g_path, FILE_MODE_READ) != STORAGE_OK) {
+        return false;
+    }
+
+    if (storage_file_read(&file, &header, sizeof(header)) != (int32_t)sizeof(header) ||
+        memcmp(header.magic, REC_CATALOG_MAGIC, 4) != 0 ||
+        header.version != REC_CATALOG_VERSION ||
+        header.entry_size != CATALOG_ENTRY_SIZE) {
+        storage_file_close(&file);
+        return false;
+    }
+
+    uint32_t count = (file.size - CATALOG_HEADER_SIZE) / CATALOG_ENTRY_SIZE;
+    if (count > REC_CATALOG_MAX) {
+        storage_file_close(&file);
+        return false;
+    }
+
+    memset(g_live, 0, sizeof(g_live));
+    g_live_count = 0;
+    g_total_size = 0;
+
+    rec_catalog_entry_t batch[CATALOG_READ_ENTRIES];
+    uint32_t id = 0;
+    while (id < count) {
+        uint32_t n = count - id;
+        if (n > CATALOG_READ_ENTRIES) n = CATALOG_READ_ENTRIES;
+        int32_t bytes = (int32_t)(n * CATALOG_ENTRY_SIZE);
+        if (storage_file_read(&file, batch, (uint32_t)bytes) != bytes) break;
+        for (uint32_t i = 0; i < n; i++) {
+            account_entry(id + i, &batch[i]);
+        }
+        id += n;
+    }
+    storage_file_close(&file);
+
+    if (id != count) return false;
+
+    if (file.size != CATALOG_HEADER_SIZE + count * CATALOG_ENTRY_SIZE) {
+        storage_file_t fix;
+        if (storage_file_open(&fix, g_path, FILE_MODE_READ_WRITE) == STORAGE_OK) {
+            storage_file_truncate(&fix, CATALOG_HEADER_SIZE + count * CATALOG_ENTRY_SIZE);
+            storage_file_close(&fix);
+        }
+    }
+
+    g_count = count;
+    return true;
+}
+
+// הקטלוג שייך לתיקיית ההקלטות הפעילה (SD או SPIFFS)
+static bool select_dir(void) {
+    char dir[STORAGE_MAX_PATH_LENGTH];
+
+    if (storage_recording_dir(dir, sizeof(dir)) != STORAGE_OK) {
+        g_loaded = false;
+        return false;
+    }
+    if (strcmp(dir, g_dir) != 0) {
+        g_loaded = false;
+        strncpy(g_dir, dir, sizeof(g_dir) - 1);
+        g_dir[sizeof(g_dir) - 1] = '\0';
+        snprintf(g_path, sizeof(g_path), "%s/%s", g_dir, REC_CATALOG_FILE_NAME);
+    }
+    if (!storage_file_exists(g_dir)) {
+        storage_mkdir(g_dir);
+    }
+    return true;
+}
+
+// טעינה עצלה - הקטלוג נפתח בשימוש הראשון (או שוב אחרי החלפת כרטיס)
+static bool ensure_loaded(void) {
+    if (!select_dir()) return false;
+    if (!g_loaded) {
+        g_loaded = load_locked() || rebuild_locked();
+    }
+    return g_loaded;
+}
+
+// מחיקות נצברות כחורים - דוחסים כשחצי מהקובץ מחוק
+static void compact_locked(void) {
+    rec_catalog_entry_t* entries = malloc(g_live_count * sizeof(rec_catalog_entry_t) + 1);
+    if (!entries) return;
+
+    uint32_t n = 0;
+    for (uint32_t id = 0; id < g_count && n < g_live_count; id++) {
+        if (is_live(id) && read_entry(id, &entries[n])) {
+            n++;
+        }
+    }
+
+    uint32_t before = g_count;
+    if (write_catalog(entries, n)) {
+        LOG_INFO("Catalog compacted: %u -> %u entries", (unsigned)before, (unsigned)n);
+    }
+    free(entries);
+}
+
+// =============================================================================
+// API
+// =============================================================================
+
+bool rec_catalog_init(void) {
+#ifdef ESP32
+    if (!g_mutex) {
+        g_mutex = xSemaphoreCreateMutex();
+        if (!g_mutex) {
+            LOG_ERROR("Failed to create catalog mutex");
+            return false;
+        }
+    }
+#endif
+
+    CATALOG_LOCK();
+    bool ok = ensure_loaded();
+    CATALOG_UNLOCK();
+
+    if (ok) {
+        LOG_INFO("Catalog: %u recordings, %u bytes", (unsigned)g_live_count,
+                 (unsigned)g_total_size);
+    }
+    return ok;
+}
+
+int32_t rec_catalog_add(const char* name, uint32_t timestamp, uint32_t sample_rate) {
+    if (!name) return -1;
+
+    rec_catalog_entry_t entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.state = REC_CATALOG_OPEN;
+    entry.timestamp = timestamp;
+    entry.sample_rate = sample_rate;
+    copy_name(entry.name, sizeof(entry.name), name);
+
+    CATALOG_LOCK();
+    int32_t id = -1;
+    if (ensure_loaded()) {
+        if (g_count >= REC_CATALOG_MAX) {
+            compact_locked();
+        }
+        if (g_count < REC_CATALOG_MAX && append_entry(&entry)) {
+            id = (int32_t)g_count++;
+            account_entry((uint32_t)id, &entry);
+        }
+    }
+    CATALOG_UNLOCK();
+
+    if (id < 0) {
+        LOG_ERROR("Catalog full or unavailable: %s", name);
+    }
+    return id;
+}
+
+// ההחדשה ביותר עם השם - ההקלטה הפתוחה היא בדרך כלל הרשומה האחרונה
+static int32_t find_locked(const char* name, rec_catalog_entry_t* entry) {
+    for (uint32_t id = g_count; id-- > 0;) {
+        if (is_live(id) && read_entry(id, entry) && strcmp(entry->name, name) == 0) {
+            return (int32_t)id;
+        }
+    }
+    return -1;
+}
+
+bool rec_catalog_finish(const char* name, uint32_t duration_ms, uint32_t size_bytes,
+                        const char* peer_id) {
+    if (!name) return false;
+
+    CATALOG_LOCK();
+    bool ok = false;
+    rec_catalog_entry_t entry;
+    int32_t id = ensure_loaded() ? find_locked(name, &entry) : -1;
+    if (id >= 0) {
+        g_total_size -= entry.size_bytes;
+        entry.state = REC_CATALOG_COMPLETE;
+        entry.duration_ms = duration_ms;
+        entry.size_bytes = size_bytes;
+        if (peer_id) {
+            copy_name(entry.peer_id, sizeof(entry.peer_id), peer_id);
+        }
+        g_total_size += entry.size_bytes;
+        ok = write_entry((uint32_t)id, &entry);
+    }
+    CATALOG_UNLOCK();
+    return ok;
+}
+
+int32_t rec_catalog_find(const char* name) {
+    if (!name) return -1;
+
+    CATALOG_LOCK();
+    rec_catalog_entry_t entry;
+    int32_t found = ensure_loaded() ? find_locked(name, &entry) : -1;
+    CATALOG_UNLOCK();
+    return found;
+}
+
+bool rec_catalog_delete(int32_t id) {
+    if (id < 0) return false;
+
+    CATALOG_LOCK();
+    bool ok = false;
+    rec_catalog_entry_t entry;
+    if (ensure_loaded() && (uint32_t)id < g_count && is_live((uint32_t)id) &&
+        read_entry((uint32_t)id, &entry)) {
+        char path[CATALOG_PATH_SIZE];
+        snprintf(path, sizeof(path), "%s/%s", g_dir, entry.name);
+        storage_file_delete(path);
+
+        entry.state = REC_CATALOG_DELETED;
+        ok = write_entry((uint32_t)id, &entry);
+        if (ok) {
+            set_live((uint32_t)id, false);
+            g_live_count--;
+            g_total_size -= entry.size_bytes;
+        }
+
+        if (g_count >= CATALOG_COMPACT_MIN && g_live_count <= g_count / 2) {
+            compact_locked();
+        }
+    }
+    CATALOG_UNLOCK();
+    return ok;
+}
+
+uint32_t rec_catalog_count(void) {
+    CATALOG_LOCK();
+    uint32_t count = ensure_loaded() ? g_live_count : 0;
+    CATALOG_UNLOCK();
+    return count;
+}
+
+uint32_t rec_catalog_total_size(void) {
+    CATALOG_LOCK();
+    uint32_t size = ensure_loaded() ? g_total_size : 0;
+    CATALOG_UNLOCK();
+    return size;
+}
+
+uint32_t rec_catalog_get_page(uint32_t first, rec_catalog_entry_t* entries,
+                              int32_t* ids, uint32_t max_count) {
+    if (!entries || max_count == 0) return 0;
+
+    CATALOG_LOCK();
+    uint32_t n = 0;
+    if (ensure_loaded()) {
+        storage_file_t file;
+        if (storage_file_open(&file, g_path, FILE_MODE_READ) == STORAGE_OK) {
+            // דילוג במפת הביטים, ואז קריאה של רשומות הדף בלבד
+            uint32_t skipped = 0;
+            for (uint32_t id = g_count; id-- > 0 && n < max_count;) {
+                if (!is_live(id)) continue;
+                if (skipped < first) {
+                    skipped++;
+                    continue;
+                }
+                if (storage_file_seek(&file, entry_offset(id), SEEK_SET) != STORAGE_OK ||
+                    storage_file_read(&file, &entries[n], CATALOG_ENTRY_SIZE) !=
+                        (int32_t)CATALOG_ENTRY_SIZE) {
+                    break;
+                }
+                if (ids) ids[n] = (int32_t)id;
+                n++;
+            }
+            storage_file_close(&file);
+        }
+    }
+    CATALOG_UNLOCK();
+    return n;
+}
+
+bool rec_catalog_refresh(int32_t id) {
+    if (id < 0) return false;
+
+    CATALOG_LOCK();
+    bool ok = false;
+    rec_catalog_entry_t entry;
+    rec_catalog_entry_t fresh;
+    if (ensure_loaded() && (uint32_t)id < g_count && is_live((uint32_t)id) &&
+        read_entry((uint32_t)id, &entry) && entry_from_file(entry.name, &fresh)) {
+        g_total_size = g_total_size - entry.size_bytes + fresh.size_bytes;
+        ok = write_entry((uint32_t)id, &fresh);
+    }
+    CATALOG_UNLOCK();
+    return ok;
+}
+
+bool rec_catalog_rebuild(void) {
+    CATALOG_LOCK();
+    bool ok = false;
+    if (select_dir()) {
+        g_loaded = rebuild_locked();
+        ok = g_loaded;
+    }
+    CATALOG_UNLOCK();
+    return ok;
+}
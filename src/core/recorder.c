@@ -0,0 +1,683 @@
+/**
+ * @file recorder.c
+ * @brief מימוש צינור ההקלטה
+ */
+
+#include "core/recorder.h"
+#include "core/rec_catalog.h"
+#include "core/resampler.h"
+#include "core/audio_kernels.h"
+#include "core/tasks.h"
+#include "hal/storage.h"
+#include "hal/flash_ring.h"
+#include "config.h"
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+// =============================================================================
+// Platform-Specific
+// =============================================================================
+
+#ifdef ESP32
+    #include "esp_log.h"
+    #include "esp_timer.h"
+
+    static const char* TAG = "RECORDER";
+    #define LOG_INFO(fmt, ...) ESP_LOGI(TAG, fmt, ##__VA_ARGS__)
+    #define LOG_ERROR(fmt, ...) ESP_LOGE(TAG, fmt, ##__VA_ARGS__)
+    #define GET_MILLIS() ((uint32_t)(esp_timer_get_time() / 1000))
+#else
+    #define LOG_INFO(fmt, ...) printf("[RECORDER] " fmt "\n", ##__VA_ARGS__)
+    #define LOG_ERROR(fmt, ...) printf("[RECORDER ERROR] " fmt "\n", ##__VA_ARGS__)
+    static uint32_t sim_millis(void) {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (ts.tv_sec * 1000) + (ts.tv_nsec / 1000000);
+    }
+    #define GET_MILLIS() sim_millis()
+#endif
+
+// =============================================================================
+// Internal State
+// =============================================================================
+
+#define QUEUE_MASK          (RECORDER_QUEUE_SAMPLES - 1)
+#define MARKER_MASK         (RECORDER_MAX_MARKERS - 1)
+#define STAGE_SAMPLES       (RECORDER_CHUNK_SAMPLES * 4 + 2)   // יחס מקסימלי 1:4
+
+_Static_assert((RECORDER_QUEUE_SAMPLES & QUEUE_MASK) == 0, "queue size must be a power of 2");
+_Static_assert(RECORDER_QUEUE_SAMPLES * sizeof(int16_t) >= 2 * RECORDER_WRITE_BLOCK, "queue must hold two write blocks");
+
+typedef enum {
+    REC_IDLE = 0,
+    REC_STARTING,       // ממתין שה-task יפתח קובץ
+    REC_RUNNING,
+    REC_STOPPING        // ה-task מרוקן וסוגר
+} rec_state_t;
+
+static bool g_initialized = false;
+static volatile uint8_t g_state = REC_IDLE;
+
+// תור SPSC: head נכתב רק ע"י הדוחף, tail רק ע"י ה-task.
+// אינדקסים רצים (uint32), מסכה רק בגישה למערך.
+static int16_t g_queue[RECORDER_QUEUE_SAMPLES] LARGE_TABLE_ATTR;
+static volatile uint32_t g_head = 0;
+static volatile uint32_t g_tail = 0;
+
+// תחילות מקטעים - תור SPSC קטן נוסף, ממוקם לפי head של תור הדגימות
+typedef struct {
+    uint32_t queue_pos;
+    rec_segment_info_t info;
+} segment_marker_t;
+
+static segment_marker_t g_markers[RECORDER_MAX_MARKERS];
+static volatile uint32_t g_marker_head = 0;
+static volatile uint32_t g_marker_tail = 0;
+
+// צד הכתיבה - שייך ל-task בלבד
+static storage_file_t g_file;
+static rec_writer_t g_writer;
+static uint8_t  g_block[RECORDER_WRITE_BLOCK] AUDIO_ALIGNED HOT_BUFFER_ATTR;   // DMA ל-SD
+static uint32_t g_block_fill = 0;
+static uint32_t g_file_bytes = 0;
+static uint32_t g_allocated = 0;
+static bool     g_open = false;
+static char     g_path[STORAGE_MAX_PATH_LENGTH];
+static char     g_first_peer[REC_PEER_ID_LENGTH + 1];
+
+// נקודות ביקורת: כמה דגימות כבר בכרטיס (ב-slots שנכתבו) ומתי עודכנה הכותרת
+static uint32_t g_pending_samples = 0;
+static uint32_t g_disk_samples = 0;
+static uint32_t g_checkpoint_bytes = 0;
+static uint32_t g_last_checkpoint = 0;
+
+// טבעת על מחיצה גולמית - במקום קבצים (RECORDER_RING_ENABLED)
+static bool     g_ring = false;
+static uint32_t g_ring_first_seq = 0;           // הסקטור הראשון של ההקלטה הנוכחית
+static uint8_t  g_ring_header[REC_SLOT_SIZE];   // כותרת ההקלטה הנוכחית
+static volatile bool g_save_requested = false;
+
+static resampler_t g_resampler;
+static bool g_resample = false;
+static int16_t g_stage[STAGE_SAMPLES];
+
+static recorder_stats_t g_stats;
+
+#ifdef ESP32
+static TaskHandle_t g_writer_task = NULL;
+#endif
+
+// =============================================================================
+// Queue
+// =============================================================================
+
+static inline uint8_t load_state(void) {
+    return __atomic_load_n(&g_state, __ATOMIC_ACQUIRE);
+}
+
+static inline void store_state(uint8_t state) {
+    __atomic_store_n(&g_state, state, __ATOMIC_RELEASE);
+}
+
+static void wake_writer(void) {
+#ifdef ESP32
+    if (g_writer_task) {
+        xTaskNotifyGive(g_writer_task);
+    }
+#endif
+}
+
+// =============================================================================
+// Writer Side
+// =============================================================================
+
+static void write_block(void) {
+    if (g_block_fill == 0) return;
+
+    // הבלוק יחרוג מההקצאה - מקצים עוד (רק כאן FAT מחפש clusters)
+    if (g_file_bytes + g_block_fill > g_allocated) {
+        if (storage_file_preallocate(&g_file, g_allocated + RECORDER_PREALLOC_BYTES) == STORAGE_OK) {
+            g_allocated += RECORDER_PREALLOC_BYTES;
+        }
+    }
+
+    uint32_t start = GET_MILLIS();
+    int32_t written = storage_file_write(&g_file, g_block, g_block_fill);
+    uint32_t elapsed = GET_MILLIS() - start;
+
+    if (elapsed > g_stats.max_write_ms) {
+        g_stats.max_write_ms = elapsed;
+    }
+
+    if (written != (int32_t)g_block_fill) {
+        g_stats.write_errors++;
+    } else {
+        g_file_bytes += g_block_fill;
+        g_disk_samples += g_pending_samples;
+        g_stats.bytes_written = g_file_bytes;
+        g_stats.blocks_written++;
+    }
+
+    g_block_fill = 0;
+    g_pending_samples = 0;
+}
+
+// בטבעת כל slot הוא עמוד flash - נכתב מיד, בלי בלוק ובלי נקודות ביקורת
+static void on_ring_slot(const uint8_t* slot) {
+    if (memcmp(slot, REC_MAGIC, 4) == 0) {
+        // כותרת הקלטה חדשה - פותחת סקטור משלה, ה-tag הוא ה-session
+        memcpy(g_ring_header, slot, REC_SLOT_SIZE);
+        g_ring_first_seq = flash_ring_begin(((const rec_file_header_t*)slot)->session);
+    }
+
+    if (flash_ring_append(slot)) {
+        g_stats.bytes_written += REC_SLOT_SIZE;
+        g_stats.blocks_written++;
+    } else {
+        g_stats.write_errors++;
+    }
+}
+
+// slots של rec_format נאספים לבלוק כתיבה (32 slots = 8KB)
+static void on_slot(const uint8_t* slot, void* ctx) {
+    (void)ctx;
+
+    if (g_ring) {
+        on_ring_slot(slot);
+        return;
+    }
+
+    memcpy(&g_block[g_block_fill], slot, REC_SLOT_SIZE);
+    g_block_fill += REC_SLOT_SIZE;
+
+    if (slot[0] == REC_SLOT_AUDIO) {
+        g_pending_samples += ((const rec_audio_slot_t*)slot)->samples;
+    }
+
+    if (g_block_fill == RECORDER_WRITE_BLOCK) {
+        write_block();
+    }
+}
+
+static void encode_samples(const int16_t* samples, uint32_t count) {
+    rec_writer_audio(&g_writer, samples, count);
+    g_stats.samples_written = g_writer.total_samples;
+}
+
+static void drain_queue(void) {
+    uint32_t tail = g_tail;
+    uint32_t head = __atomic_load_n(&g_head, __ATOMIC_ACQUIRE);
+
+    while (tail != head) {
+        // מקטע שמתחיל כאן - לפני הדגימות שלו
+        uint32_t marker_head = __atomic_load_n(&g_marker_head, __ATOMIC_ACQUIRE);
+        uint32_t marker_tail = g_marker_tail;
+        while (marker_tail != marker_head &&
+               (int32_t)(g_markers[marker_tail & MARKER_MASK].queue_pos - tail) <= 0) {
+            const rec_segment_info_t* info = &g_markers[marker_tail & MARKER_MASK].info;
+            if (g_first_peer[0] == '\0') {
+                strncpy(g_first_peer, info->peer_id, sizeof(g_first_peer) - 1);
+            }
+            rec_writer_segment(&g_writer, info);
+            marker_tail++;
+            __atomic_store_n(&g_marker_tail, marker_tail, __ATOMIC_RELEASE);
+        }
+
+        uint32_t n = head - tail;
+        uint32_t contiguous = RECORDER_QUEUE_SAMPLES - (tail & QUEUE_MASK);
+        if (n > contiguous) n = contiguous;
+        if (n > RECORDER_CHUNK_SAMPLES) n = RECORDER_CHUNK_SAMPLES;
+
+        // לא חוצים את המקטע הבא
+        if (marker_tail != marker_head) {
+            uint32_t until = g_markers[marker_tail & MARKER_MASK].queue_pos - tail;
+            if (n > until) n = until;
+        }
+
+        const int16_t* in = &g_queue[tail & QUEUE_MASK];
+        if (g_resample) {
+            uint16_t out = resampler_process(&g_resampler, in, (uint16_t)n,
+                                             g_stage, STAGE_SAMPLES);
+            encode_samples(g_stage, out);
+        } else {
+            encode_samples(in, n);
+        }
+
+        tail += n;
+        __atomic_store_n(&g_tail, tail, __ATOMIC_RELEASE);
+        head = __atomic_load_n(&g_head, __ATOMIC_ACQUIRE);
+    }
+}
+
+// =============================================================================
+// Journal & Checkpoints
+// =============================================================================
+
+// היומן מחזיק את נתיב ההקלטה הפתוחה - קיים רק בזמן הקלטה
+static void journal_path(const char* recording, char* out, size_t size) {
+    strncpy(out, recording, size - 1);
+    out[size - 1] = '\0';
+
+    char* slash = strrchr(out, '/');
+    size_t used = slash ? (size_t)(slash + 1 - out) : 0;
+    snprintf(out + used, size - used, "%s", RECORDER_JOURNAL_NAME);
+}
+
+static void journal_write(void) {
+    char path[STORAGE_MAX_PATH_LENGTH];
+    storage_file_t journal;
+
+    journal_path(g_path, path, sizeof(path));
+    if (storage_file_open(&journal, path, FILE_MODE_WRITE) != STORAGE_OK) {
+        LOG_ERROR("Failed to write journal");
+        return;
+    }
+    storage_file_write(&journal, g_path, strlen(g_path) + 1);
+    storage_file_sync(&journal);
+    storage_file_close(&journal);
+}
+
+static void journal_clear(void) {
+    char path[STORAGE_MAX_PATH_LENGTH];
+    journal_path(g_path, path, sizeof(path));
+    storage_file_delete(path);
+}
+
+/**
+ * הכותרת מצביעה רק על מה שכבר בכרטיס: sync לנתונים, כותרת, sync שוב.
+ * כותרת אחת (+ רשומת תיקייה) לכל כמה שניות - הגברת כתיבה זניחה.
+ */
+static void checkpoint(void) {
+    if (g_file_bytes == g_checkpoint_bytes) return;
+
+    uint8_t header[REC_SLOT_SIZE];
+    rec_writer_checkpoint(&g_writer, g_file_bytes / REC_SLOT_SIZE, g_disk_samples, header);
+
+    storage_file_sync(&g_file);
+    storage_file_seek(&g_file, 0, SEEK_SET);
+    if (storage_file_write(&g_file, header, REC_SLOT_SIZE) != REC_SLOT_SIZE) {
+        g_stats.write_errors++;
+    }
+    storage_file_seek(&g_file, (int32_t)g_file_bytes, SEEK_SET);
+    storage_file_sync(&g_file);
+
+    g_checkpoint_bytes = g_file_bytes;
+    g_stats.checkpoints++;
+}
+
+static const char* file_name(const char* path) {
+    const char* slash = strrchr(path, '/');
+    return slash ? slash + 1 : path;
+}
+
+// הקלטה שנקטעה בנפילת מתח - נסגרת באתחול הבא
+static void recover_interrupted(void) {
+    char journal[STORAGE_MAX_PATH_LENGTH];
+    storage_file_t file;
+
+    if (storage_recording_get_path(RECORDER_JOURNAL_NAME, journal, sizeof(journal)) != STORAGE_OK) {
+        return;
+    }
+
+    if (storage_file_open(&file, journal, FILE_MODE_READ) == STORAGE_OK) {
+        int32_t len = storage_file_read(&file, g_path, sizeof(g_path) - 1);
+        storage_file_close(&file);
+        g_path[(len > 0) ? len : 0] = '\0';
+
+        uint32_t start = GET_MILLIS();
+        if (g_path[0] != '\0' && rec_repair(g_path, RECORDER_REPAIR_MAX_SLOTS)) {
+            // הרשומה בקטלוג נשארה OPEN - מעדכנים מהכותרת המתוקנת
+            rec_catalog_refresh(rec_catalog_find(file_name(g_path)));
+            LOG_INFO("Recovered interrupted recording %s (%u ms)", g_path,
+                     (unsigned)(GET_MILLIS() - start));
+        } else {
+            LOG_ERROR("Failed to recover %s", g_path);
+        }
+    }
+
+    storage_file_delete(journal);
+    g_path[0] = '\0';
+}
+
+// =============================================================================
+// File Lifecycle
+// =============================================================================
+
+static bool open_file(void) {
+    if (g_ring) {
+        resampler_reset(&g_resampler);
+        rec_writer_init(&g_writer, AUDIO_RECORD_RATE, (uint32_t)time(NULL), on_slot, NULL);
+        g_open = true;
+        return true;
+    }
+
+    if (storage_recording_create(&g_file, REC_EXTENSION, g_path, sizeof(g_path)) != STORAGE_OK) {
+        return false;
+    }
+
+    g_file_bytes = 0;
+    g_block_fill = 0;
+    g_pending_samples = 0;
+    g_disk_samples = 0;
+    g_checkpoint_bytes = 0;
+    g_last_checkpoint = GET_MILLIS();
+
+    g_allocated = 0;
+    if (storage_file_preallocate(&g_file, RECORDER_PREALLOC_BYTES) == STORAGE_OK) {
+        g_allocated = RECORDER_PREALLOC_BYTES;
+    }
+
+    uint32_t created = (uint32_t)time(NULL);
+    resampler_reset(&g_resampler);
+    rec_writer_init(&g_writer, AUDIO_RECORD_RATE, created, on_slot, NULL);
+
+    journal_write();
+    g_first_peer[0] = '\0';
+    rec_catalog_add(file_name(g_path), created, AUDIO_RECORD_RATE);
+    g_open = true;
+    return true;
+}
+
+static void close_file(void) {
+    uint8_t header[REC_SLOT_SIZE];
+
+    rec_writer_finish(&g_writer, header);
+    g_stats.samples_written = g_writer.total_samples;
+    g_open = false;
+
+    // בטבעת ה-slot האחרון והאינדקס כבר נכתבו; הכותרת הסופית לא נחוצה
+    if (g_ring) {
+        g_ring_first_seq = 0;
+        return;
+    }
+    write_block();
+
+    // משחררים את ההקצאה שלא נוצלה, ואז הכותרת הסופית ל-slot 0
+    storage_file_truncate(&g_file, g_file_bytes);
+    storage_file_seek(&g_file, 0, SEEK_SET);
+    if (storage_file_write(&g_file, header, REC_SLOT_SIZE) != REC_SLOT_SIZE) {
+        g_stats.write_errors++;
+    }
+    storage_file_sync(&g_file);
+    storage_file_close(&g_file);
+    journal_clear();
+
+    rec_catalog_finish(file_name(g_path),
+                       (uint32_t)((uint64_t)g_writer.total_samples * 1000 / AUDIO_RECORD_RATE),
+                       g_file_bytes, g_first_peer);
+
+    LOG_INFO("Recording closed: %u samples in %u bytes, %u dropped, max write %u ms",
+             (unsigned)g_stats.samples_written, (unsigned)g_file_bytes,
+             (unsigned)g_stats.dropped_samples, (unsigned)g_stats.max_write_ms);
+}
+
+// =============================================================================
+// Ring Save
+// =============================================================================
+
+/**
+ * שמירת ההקלטה מהטבעת לקובץ .wtr: כותרת ההקלטה, ואחריה ה-slots
+ * של הסקטורים שעוד לא נדרסו. בלי אינדקס - rec_repair סוגר את הקובץ.
+ * התור מרוקן בין סקטורים, כדי שההקלטה עצמה תמשיך בזמן השמירה.
+ */
+static void save_ring(void) {
+    const rec_file_header_t* header = (const rec_file_header_t*)g_ring_header;
+    char path[STORAGE_MAX_PATH_LENGTH];
+    storage_file_t file;
+
+    if (g_ring_first_seq == 0) return;
+
+    uint32_t first = g_ring_first_seq;
+    uint32_t last = flash_ring_head_seq();
+    if (first < flash_ring_oldest_seq()) {
+        first = flash_ring_oldest_seq();
+    }
+
+    if (storage_recording_create(&file, REC_EXTENSION, path, sizeof(path)) != STORAGE_OK) {
+        LOG_ERROR("Failed to create file for ring save");
+        g_stats.write_errors++;
+        return;
+    }
+
+    uint32_t start = GET_MILLIS();
+    uint32_t slots = 1;
+    bool ok = storage_file_write(&file, g_ring_header, REC_SLOT_SIZE) == REC_SLOT_SIZE;
+
+    for (uint32_t seq = first; ok && seq <= last; seq++) {
+        uint32_t tag;
+        if (!flash_ring_sector_tag(seq, &tag) || tag != header->session) continue;
+
+        // רק אודיו ומקטעים - כותרות ואינדקסים מההקלטה בטבעת לא רלוונטיים לקובץ
+        uint32_t count = flash_ring_read_sector(seq, g_block);
+        uint32_t kept = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            uint8_t* slot = &g_block[i * REC_SLOT_SIZE];
+            if (slot[0] == REC_SLOT_AUDIO || slot[0] == REC_SLOT_SEGMENT) {
+                memmove(&g_block[kept * REC_SLOT_SIZE], slot, REC_SLOT_SIZE);
+                kept++;
+            }
+        }
+
+        int32_t bytes = (int32_t)(kept * REC_SLOT_SIZE);
+        ok = storage_file_write(&file, g_block, (uint32_t)bytes) == bytes;
+        slots += kept;
+
+        drain_queue();
+    }
+
+    storage_file_close(&file);
+
+    if (!ok || !rec_repair(path, slots)) {
+        LOG_ERROR("Ring save failed: %s", path);
+        g_stats.write_errors++;
+        return;
+    }
+
+    rec_catalog_refresh(rec_catalog_add(file_name(path), header->created, header->sample_rate));
+    LOG_INFO("Saved ring recording %s (%u slots, %u ms)", path, (unsigned)slots,
+             (unsigned)(GET_MILLIS() - start));
+}
+
+// =============================================================================
+// Writer Task
+// =============================================================================
+
+static void writer_step(void) {
+    uint8_t state = load_state();
+    if (state == REC_IDLE) return;
+
+    if (!g_open) {
+        if (!open_file()) {
+            LOG_ERROR("Failed to open recording file");
+            g_stats.write_errors++;
+            store_state(REC_IDLE);
+            return;
+        }
+        // stop שהגיע בזמן הפתיחה נשמר (לא דורסים STOPPING)
+        uint8_t expected = REC_STARTING;
+        __atomic_compare_exchange_n(&g_state, &expected, REC_RUNNING, false,
+                                    __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+    }
+
+    drain_queue();
+
+    uint32_t now = GET_MILLIS();
+    if (g_ring) {
+        flash_ring_maintain();
+        if (g_save_requested) {
+            g_save_requested = false;
+            save_ring();
+        }
+    } else if (now - g_last_checkpoint >= RECORDER_CHECKPOINT_MS) {
+        g_last_checkpoint = now;
+        checkpoint();
+    }
+
+    if (load_state() == REC_STOPPING) {
+        // הדוחף כבר לא כותב - מה שנשאר בתור הוא הסוף
+        drain_queue();
+        close_file();
+        store_state(REC_IDLE);
+    }
+}
+
+#ifdef ESP32
+static void writer_task(void* param) {
+    (void)param;
+    tasks_watchdog_register(TASK_ID_STORAGE, TASK_WATCHDOG_TIMEOUT_MS);
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(RECORDER_POLL_MS));
+        tasks_watchdog_feed(TASK_ID_STORAGE);
+        writer_step();
+    }
+}
+#endif
+
+// =============================================================================
+// API
+// =============================================================================
+
+bool recorder_init(uint32_t input_rate) {
+    if (g_initialized) return true;
+
+    memset(&g_stats, 0, sizeof(g_stats));
+    memset(&g_file, 0, sizeof(g_file));
+
+    rec_catalog_init();
+    recover_interrupted();
+
+    g_ring = RECORDER_RING_ENABLED && flash_ring_init(RECORDER_RING_PARTITION);
+
+    g_resample = (input_rate != AUDIO_RECORD_RATE);
+    if (g_resample && !resampler_init(&g_resampler, input_rate, AUDIO_RECORD_RATE)) {
+        LOG_ERROR("Unsupported record rate %u -> %u", (unsigned)input_rate,
+                  (unsigned)AUDIO_RECORD_RATE);
+        return false;
+    }
+
+#ifdef ESP32
+    if (xTaskCreate(writer_task, "rec_writer", TASK_STACK_STORAGE, NULL,
+                    TASK_PRIORITY_STORAGE, &g_writer_task) != pdPASS) {
+        LOG_ERROR("Failed to create writer task");
+        return false;
+    }
+#endif
+
+    g_initialized = true;
+    LOG_INFO("Recorder initialized (%u Hz -> %u Hz, %s)",
+             (unsigned)input_rate, (unsigned)AUDIO_RECORD_RATE,
+             g_ring ? "flash ring" : "files");
+    return true;
+}
+
+bool recorder_start(void) {
+    if (!g_initialized || load_state() != REC_IDLE) {
+        return false;
+    }
+
+    // ה-task לא נוגע בתור כשאין הקלטה
+    g_head = 0;
+    g_tail = 0;
+    g_marker_head = 0;
+    g_marker_tail = 0;
+    memset(&g_stats, 0, sizeof(g_stats));
+
+    store_state(REC_STARTING);
+    wake_writer();
+    return true;
+}
+
+void recorder_stop(void) {
+    uint8_t state = load_state();
+    if (state != REC_STARTING && state != REC_RUNNING) {
+        return;
+    }
+
+    // אם ה-task בדיוק עובר ל-RUNNING - ה-CAS שלו ייכשל וה-STOPPING נשאר
+    store_state(REC_STOPPING);
+    wake_writer();
+}
+
+bool recorder_is_active(void) {
+    return load_state() != REC_IDLE;
+}
+
+bool recorder_push(const int16_t* samples, uint16_t count) {
+    if (!samples || count == 0) return false;
+
+    uint8_t state = load_state();
+    if (state != REC_STARTING && state != REC_RUNNING) {
+        return false;
+    }
+
+    uint32_t head = g_head;
+    uint32_t used = head - __atomic_load_n(&g_tail, __ATOMIC_ACQUIRE);
+
+    if (used + count > RECORDER_QUEUE_SAMPLES) {
+        g_stats.dropped_samples += count;
+        return false;
+    }
+
+    uint32_t first = RECORDER_QUEUE_SAMPLES - (head & QUEUE_MASK);
+    if (first > count) first = count;
+    memcpy(&g_queue[head & QUEUE_MASK], samples, first * sizeof(int16_t));
+    memcpy(&g_queue[0], samples + first, (count - first) * sizeof(int16_t));
+
+    __atomic_store_n(&g_head, head + count, __ATOMIC_RELEASE);
+
+    used += count;
+    if (used > g_stats.queue_high_water) {
+        g_stats.queue_high_water = used;
+    }
+
+    // מעירים רק כשיש בלוק שלם לכתוב
+    if (used * sizeof(int16_t) >= RECORDER_WRITE_BLOCK) {
+        wake_writer();
+    }
+    return true;
+}
+
+bool recorder_mark_segment(const rec_segment_info_t* info) {
+    if (!info) return false;
+
+    uint8_t state = load_state();
+    if (state != REC_STARTING && state != REC_RUNNING) {
+        return false;
+    }
+
+    uint32_t head = g_marker_head;
+    if (head - __atomic_load_n(&g_marker_tail, __ATOMIC_ACQUIRE) >= RECORDER_MAX_MARKERS) {
+        return false;
+    }
+
+    g_markers[head & MARKER_MASK].queue_pos = g_head;
+    memcpy(&g_markers[head & MARKER_MASK].info, info, sizeof(rec_segment_info_t));
+    __atomic_store_n(&g_marker_head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+void recorder_update(void) {
+#ifndef ESP32
+    writer_step();
+#endif
+}
+
+void recorder_get_stats(recorder_stats_t* stats) {
+    if (!stats) return;
+    memcpy(stats, &g_stats, sizeof(recorder_stats_t));
+}
+
+bool recorder_uses_ring(void) {
+    return g_ring;
+}
+
+bool recorder_save(void) {
+    if (!g_ring || load_state() != REC_RUNNING) {
+        return false;
+    }
+    g_save_requested = true;
+    wake_writer();
+    return true;
+}
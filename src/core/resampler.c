@@ -0,0 +1,168 @@
+/**
+ * @file resampler.c
+ * @brief מימוש המרת קצב דגימה (polyphase)
+ */
+
+#include "core/resampler.h"
+#include "core/audio_kernels.h"
+#include <string.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+#define FRAC_ONE        (1u << RESAMPLER_FRAC_BITS)
+#define PHASE_SHIFT     (RESAMPLER_FRAC_BITS - 5)       // 32 פאזות = 5 ביט
+#define SUB_MASK        ((1u << PHASE_SHIFT) - 1)
+#define FILTER_DELAY    (RESAMPLER_TAPS / 2)
+#define CUTOFF_MARGIN   0.9f                            // מרווח מתחת לנייקוויסט
+
+static inline int16_t sat16(int32_t x) {
+    if (x > 32767) return 32767;
+    if (x < -32768) return -32768;
+    return (int16_t)x;
+}
+
+/**
+ * מקדמי windowed sinc (Blackman). cutoff ביחס לנייקוויסט של הקלט.
+ * נעשה פעם אחת באתחול - float רק כאן, לא בנתיב הדגימות.
+ */
+static void design_filter(resampler_t* rs, float cutoff) {
+    for (uint16_t p = 0; p <= RESAMPLER_PHASES; p++) {
+        float row[RESAMPLER_TAPS];
+        float sum = 0.0f;
+
+        for (uint16_t k = 0; k < RESAMPLER_TAPS; k++) {
+            float t = (float)k - FILTER_DELAY + (float)p / RESAMPLER_PHASES;
+            float x = cutoff * t;
+            float sinc = (fabsf(x) < 1e-6f) ? 1.0f : sinf((float)M_PI * x) / ((float)M_PI * x);
+
+            // Blackman על הטווח [-D, D]
+            float w = 0.42f + 0.5f * cosf((float)M_PI * t / FILTER_DELAY) +
+                      0.08f * cosf(2.0f * (float)M_PI * t / FILTER_DELAY);
+            if (fabsf(t) >= FILTER_DELAY) w = 0.0f;
+
+            row[k] = cutoff * sinc * w;
+            sum += row[k];
+        }
+
+        // הגבר DC = 1 בכל פאזה (אחרת יש "אדוות" ביחס שברי)
+        for (uint16_t k = 0; k < RESAMPLER_TAPS; k++) {
+            float c = (sum != 0.0f) ? row[k] / sum : 0.0f;
+            rs->coeffs[p][k] = sat16((int32_t)lrintf(c * 32767.0f));
+        }
+    }
+}
+
+static void update_step(resampler_t* rs) {
+    // ppm חיובי = צעד קטן יותר = יותר דגימות פלט
+    int64_t delta = ((int64_t)rs->step_nominal * rs->ppm) / 1000000;
+    rs->step = (uint32_t)((int64_t)rs->step_nominal - delta);
+    rs->bypass = (rs->in_rate == rs->out_rate) && rs->ppm == 0;
+}
+
+static inline void push_sample(resampler_t* rs, int16_t s) {
+    uint16_t pos = (rs->history_pos == 0) ? (RESAMPLER_TAPS - 1) : (rs->history_pos - 1);
+    rs->history[pos] = s;
+    rs->history[pos + RESAMPLER_TAPS] = s;
+    rs->history_pos = pos;
+}
+
+// =============================================================================
+// API
+// =============================================================================
+
+bool resampler_init(resampler_t* rs, uint32_t in_rate, uint32_t out_rate) {
+    if (!rs || in_rate == 0 || out_rate == 0) return false;
+    if (in_rate > out_rate * 4 || out_rate > in_rate * 4) return false;
+
+    memset(rs, 0, sizeof(resampler_t));
+    rs->in_rate = in_rate;
+    rs->out_rate = out_rate;
+    rs->step_nominal = (uint32_t)(((uint64_t)in_rate << RESAMPLER_FRAC_BITS) / out_rate);
+
+    // בהורדת קצב - cutoff בנייקוויסט של הפלט
+    float cutoff = CUTOFF_MARGIN;
+    if (out_rate < in_rate) {
+        cutoff *= (float)out_rate / (float)in_rate;
+    }
+    design_filter(rs, cutoff);
+
+    update_step(rs);
+    resampler_reset(rs);
+    return true;
+}
+
+void resampler_reset(resampler_t* rs) {
+    if (!rs) return;
+
+    memset(rs->history, 0, sizeof(rs->history));
+    rs->history_pos = 0;
+    rs->frac = 0;
+}
+
+void resampler_set_drift_ppm(resampler_t* rs, int32_t ppm) {
+    if (!rs) return;
+
+    if (ppm > RESAMPLER_MAX_PPM) ppm = RESAMPLER_MAX_PPM;
+    if (ppm < -RESAMPLER_MAX_PPM) ppm = -RESAMPLER_MAX_PPM;
+
+    rs->ppm = ppm;
+    update_step(rs);
+}
+
+uint16_t resampler_max_output(const resampler_t* rs, uint16_t in_count) {
+    if (!rs || rs->step == 0) return in_count;
+    return (uint16_t)((((uint32_t)in_count << RESAMPLER_FRAC_BITS) / rs->step) + 2);
+}
+
+bool resampler_is_bypass(const resampler_t* rs) {
+    return rs ? rs->bypass : true;
+}
+
+uint16_t resampler_process(resampler_t* rs, const int16_t* in, uint16_t in_count,
+                           int16_t* out, uint16_t out_max) {
+    if (!rs || !in || !out) return 0;
+
+    uint16_t produced = 0;
+
+    // אותו קצב: העתקה עם אותה השהיה כמו המסנן, כדי שמעבר לתיקון ppm לא "יקפוץ"
+    if (rs->bypass) {
+        for (uint16_t i = 0; i < in_count && produced < out_max; i++) {
+            push_sample(rs, in[i]);
+            out[produced++] = rs->history[rs->history_pos + FILTER_DELAY];
+        }
+        return produced;
+    }
+
+    uint32_t frac = rs->frac;
+    const uint32_t step = rs->step;
+
+    for (uint16_t i = 0; i < in_count; i++) {
+        push_sample(rs, in[i]);
+        const int16_t* window = &rs->history[rs->history_pos];
+
+        while (frac < FRAC_ONE) {
+            if (produced < out_max) {
+                uint32_t phase = frac >> PHASE_SHIFT;
+                int32_t sub = (int32_t)(frac & SUB_MASK);
+
+                int64_t ya = audio_kernel_dot(rs->coeffs[phase], window, RESAMPLER_TAPS);
+                int64_t yb = audio_kernel_dot(rs->coeffs[phase + 1], window, RESAMPLER_TAPS);
+                int64_t y = ya + (((yb - ya) * sub) >> PHASE_SHIFT);
+
+                out[produced++] = sat16((int32_t)(y >> 15));
+            }
+            frac += step;
+        }
+        frac -= FRAC_ONE;
+    }
+
+    rs->frac = frac;
+    return produced;
+}
@@ -0,0 +1,284 @@
+/**
+ * @file tasks.c
+ * @brief סטטיסטיקות tasks ו-watchdog תוכנה
+ */
+
+#include "core/tasks.h"
+#include <string.h>
+#include <stdio.h>
+
+// =============================================================================
+// Platform-Specific
+// =============================================================================
+
+#ifdef ESP32
+    #include "esp_log.h"
+    #include "esp_timer.h"
+    #include "esp_system.h"
+    #include "esp_heap_caps.h"
+
+    static const char* TAG = "TASKS";
+    #define LOG_INFO(fmt, ...) ESP_LOGI(TAG, fmt, ##__VA_ARGS__)
+    #define LOG_ERROR(fmt, ...) ESP_LOGE(TAG, fmt, ##__VA_ARGS__)
+    #define GET_MILLIS() ((uint32_t)(esp_timer_get_time() / 1000))
+    #define GET_MICROS64() ((uint64_t)esp_timer_get_time())
+
+    // זמני CPU לכל task דורשים את שתי האפשרויות ב-sdkconfig
+    #define TASKS_RUNTIME_STATS (configUSE_TRACE_FACILITY && configGENERATE_RUN_TIME_STATS)
+#else
+    #include <time.h>
+    #define LOG_INFO(fmt, ...) printf("[TASKS] " fmt "\n", ##__VA_ARGS__)
+    #define LOG_ERROR(fmt, ...) printf("[TASKS ERROR] " fmt "\n", ##__VA_ARGS__)
+    static uint64_t sim_micros(void) {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+    }
+    #define GET_MILLIS() ((uint32_t)(sim_micros() / 1000))
+    #define GET_MICROS64() sim_micros()
+    #define TASKS_RUNTIME_STATS 0
+#endif
+
+// =============================================================================
+// Internal State
+// =============================================================================
+
+typedef struct {
+    bool registered;
+    const char* name;
+#ifdef ESP32
+    TaskHandle_t handle;
+#endif
+    uint32_t timeout_ms;            // 0 = בלי watchdog
+    uint32_t last_feed_ms;          // נכתב ע"י ה-task, נקרא ע"י הבדיקה
+    uint32_t feeds;
+    uint32_t stalls;
+    bool stalled;
+
+    // נקודת ההשוואה של tasks_get_stats הקודם
+    uint32_t prev_feeds;
+    uint32_t prev_runtime;
+    uint64_t prev_us;
+} task_entry_t;
+
+static task_entry_t g_tasks[TASK_ID_COUNT];
+static const char* volatile g_last_stalled = NULL;
+
+#ifndef ESP32
+// בסימולטור אין tasks של FreeRTOS - שם לפי התפקיד
+static const char* const g_default_names[TASK_ID_COUNT] = {
+    [TASK_ID_AUDIO_IN]  = "audio_in",
+    [TASK_ID_AUDIO_OUT] = "audio_out",
+    [TASK_ID_COMM]      = "comm",
+    [TASK_ID_PROTOCOL]  = "protocol",
+    [TASK_ID_UI]        = "ui",
+    [TASK_ID_STORAGE]   = "storage",
+    [TASK_ID_MAIN]      = "main",
+};
+#endif
+
+static const uint32_t g_stack_sizes[TASK_ID_COUNT] = {
+    [TASK_ID_AUDIO_IN]  = TASK_STACK_AUDIO_IN,
+    [TASK_ID_AUDIO_OUT] = TASK_STACK_AUDIO_OUT,
+    [TASK_ID_COMM]      = TASK_STACK_COMM,
+    [TASK_ID_PROTOCOL]  = TASK_STACK_PROTOCOL,
+    [TASK_ID_UI]        = TASK_STACK_UI,
+    [TASK_ID_STORAGE]   = TASK_STACK_STORAGE,
+    [TASK_ID_MAIN]      = TASK_STACK_MAIN,
+};
+
+#ifdef ESP32
+static esp_timer_handle_t g_check_timer = NULL;
+
+static void watchdog_timer_callback(void* arg) {
+    (void)arg;
+    tasks_watchdog_check();
+}
+#endif
+
+// =============================================================================
+// Runtime Counters
+// =============================================================================
+
+/**
+ * @brief מונה זמן ה-CPU של ה-task (יחידות של ה-run-time clock, ב-IDF מיקרו-שניות)
+ */
+static uint32_t task_runtime(const task_entry_t* entry) {
+#if TASKS_RUNTIME_STATS
+    TaskStatus_t status;
+    vTaskGetInfo(entry->handle, &status, pdFALSE, eInvalid);
+    return (uint32_t)status.ulRunTimeCounter;
+#else
+    (void)entry;
+    return 0;
+#endif
+}
+
+// =============================================================================
+// Watchdog
+// =============================================================================
+
+void tasks_watchdog_register(uint8_t task_id, uint32_t timeout_ms) {
+    if (task_id >= TASK_ID_COUNT) {
+        return;
+    }
+
+    task_entry_t* entry = &g_tasks[task_id];
+    __atomic_store_n(&entry->registered, false, __ATOMIC_RELEASE);
+
+#ifdef ESP32
+    entry->handle = xTaskGetCurrentTaskHandle();
+    entry->name = pcTaskGetName(entry->handle);
+#else
+    entry->name = g_default_names[task_id];
+#endif
+    entry->timeout_ms = timeout_ms;
+    entry->feeds = 0;
+    entry->stalls = 0;
+    entry->stalled = false;
+    entry->prev_feeds = 0;
+    entry->prev_runtime = task_runtime(entry);
+    entry->prev_us = GET_MICROS64();
+    __atomic_store_n(&entry->last_feed_ms, GET_MILLIS(), __ATOMIC_RELAXED);
+    __atomic_store_n(&entry->registered, true, __ATOMIC_RELEASE);
+
+#ifdef ESP32
+    if (timeout_ms > 0 && !g_check_timer) {
+        const esp_timer_create_args_t args = {
+            .callback = watchdog_timer_callback,
+            .name = "task_wdt",
+        };
+        if (esp_timer_create(&args, &g_check_timer) == ESP_OK) {
+            esp_timer_start_periodic(g_check_timer, TASK_WATCHDOG_CHECK_MS * 1000ULL);
+        } else {
+            LOG_ERROR("Failed to start watchdog timer");
+        }
+    }
+#endif
+}
+
+void tasks_watchdog_unregister(uint8_t task_id) {
+    if (task_id < TASK_ID_COUNT) {
+        __atomic_store_n(&g_tasks[task_id].registered, false, __ATOMIC_RELEASE);
+    }
+}
+
+void tasks_watchdog_feed(uint8_t task_id) {
+    if (task_id >= TASK_ID_COUNT) {
+        return;
+    }
+
+    task_entry_t* entry = &g_tasks[task_id];
+    __atomic_store_n(&entry->last_feed_ms, GET_MILLIS(), __ATOMIC_RELAXED);
+    entry->feeds++;
+}
+
+bool tasks_watchdog_check(void) {
+    uint32_t now = GET_MILLIS();
+    bool ok = true;
+
+    for (int i = 0; i < TASK_ID_COUNT; i++) {
+        task_entry_t* entry = &g_tasks[i];
+        if (!__atomic_load_n(&entry->registered, __ATOMIC_ACQUIRE) || entry->timeout_ms == 0) {
+            continue;
+        }
+
+        uint32_t age = now - __atomic_load_n(&entry->last_feed_ms, __ATOMIC_RELAXED);
+        if (age <= entry->timeout_ms) {
+            if (entry->stalled) {
+                LOG_INFO("Task '%s' recovered", entry->name);
+                entry->stalled = false;
+            }
+            continue;
+        }
+
+        ok = false;
+        if (!entry->stalled) {
+            // פעם אחת לכל תקיעה - הבדיקה רצה כל שנייה
+            entry->stalled = true;
+            entry->stalls++;
+            g_last_stalled = entry->name;
+            LOG_ERROR("Task '%s' stalled: no feed for %u ms (timeout %u)",
+                      entry->name, (unsigned)age, (unsigned)entry->timeout_ms);
+        }
+    }
+    return ok;
+}
+
+const char* tasks_watchdog_last_stalled(void) {
+    return g_last_stalled;
+}
+
+// =============================================================================
+// Statistics
+// =============================================================================
+
+const task_stats_t* tasks_stats_of(const system_stats_t* stats, uint8_t task_id) {
+    if (!stats) {
+        return NULL;
+    }
+
+    switch (task_id) {
+        case TASK_ID_AUDIO_IN:  return &stats->audio_in;
+        case TASK_ID_AUDIO_OUT: return &stats->audio_out;
+        case TASK_ID_COMM:      return &stats->comm;
+        case TASK_ID_PROTOCOL:  return &stats->protocol;
+        case TASK_ID_UI:        return &stats->ui;
+        case TASK_ID_STORAGE:   return &stats->storage;
+        case TASK_ID_MAIN:      return &stats->main;
+        default:                return NULL;
+    }
+}
+
+static void fill_task_stats(task_entry_t* entry, uint8_t task_id, task_stats_t* out, uint32_t now) {
+    out->name = entry->name;
+    out->stack_size = g_stack_sizes[task_id];
+    out->run_count = entry->feeds;
+    out->error_count = entry->stalls;
+    out->last_run_time = now - __atomic_load_n(&entry->last_feed_ms, __ATOMIC_RELAXED);
+
+#ifdef ESP32
+    // ב-IDF גודל ה-stack והשארית בבתים
+    uint32_t free_min = uxTaskGetStackHighWaterMark(entry->handle);
+    out->high_watermark = (free_min < out->stack_size) ? out->stack_size - free_min : 0;
+#endif
+
+    // הפרשים מהקריאה הקודמת
+    uint32_t feeds = entry->feeds;
+    uint32_t runtime = task_runtime(entry);
+    uint64_t now_us = GET_MICROS64();
+    uint32_t loops = feeds - entry->prev_feeds;
+    uint32_t busy = runtime - entry->prev_runtime;
+    uint64_t wall = now_us - entry->prev_us;
+
+    out->wake_count = loops;
+    out->avg_runtime_us = loops ? busy / loops : 0;
+    out->cpu_percent = wall ? (uint8_t)((uint64_t)busy * 100 / wall) : 0;
+
+    entry->prev_feeds = feeds;
+    entry->prev_runtime = runtime;
+    entry->prev_us = now_us;
+}
+
+void tasks_get_stats(system_stats_t* stats) {
+    if (!stats) {
+        return;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    uint32_t now = GET_MILLIS();
+
+    for (uint8_t id = 0; id < TASK_ID_COUNT; id++) {
+        task_entry_t* entry = &g_tasks[id];
+        if (__atomic_load_n(&entry->registered, __ATOMIC_ACQUIRE)) {
+            fill_task_stats(entry, id, (task_stats_t*)tasks_stats_of(stats, id), now);
+        }
+    }
+
+#ifdef ESP32
+    stats->free_heap = esp_get_free_heap_size();
+    stats->min_free_heap = esp_get_minimum_free_heap_size();
+    stats->min_free_internal = heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
+#endif
+    stats->uptime_seconds = (uint32_t)(GET_MICROS64() / 1000000ULL);
+}
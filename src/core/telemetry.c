@@ -0,0 +1,290 @@
+/**
+ * @file telemetry.c
+ * @brief מימוש רישום המדדים
+ */
+
+#include "core/telemetry.h"
+#include "config.h"
+#include <string.h>
+#include <stdio.h>
+
+// =============================================================================
+// Platform-Specific
+// =============================================================================
+
+#ifdef ESP32
+    #include "esp_log.h"
+    #include "esp_timer.h"
+    #include "esp_system.h"
+
+    static const char* TAG = "TELEMETRY";
+    #define LOG_INFO(fmt, ...) ESP_LOGI(TAG, fmt, ##__VA_ARGS__)
+#else
+    #include <time.h>
+    #define LOG_INFO(fmt, ...) printf("[TELEMETRY] " fmt "\n", ##__VA_ARGS__)
+#endif
+
+// =============================================================================
+// Internal State
+// =============================================================================
+
+typedef struct {
+    uint32_t count;
+    uint32_t sum_us;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint32_t buckets[TELEMETRY_HIST_BUCKETS];
+} hist_t;
+
+static uint32_t g_metrics[TM_METRIC_COUNT];
+static hist_t g_hist[TM_HIST_COUNT];
+static telemetry_collector_t g_collector = NULL;
+static uint32_t g_last_log_ms = 0;
+
+static const char* const g_metric_names[TM_METRIC_COUNT] = {
+    [TM_UPTIME_MS]              = "uptime_ms",
+    [TM_HEAP_FREE]              = "heap_free",
+    [TM_HEAP_MIN_FREE]          = "heap_min_free",
+    [TM_VOICE_TX_FRAMES]        = "voice_tx",
+    [TM_VOICE_SID_TX]           = "voice_sid_tx",
+    [TM_VOICE_RX_FRAMES]        = "voice_rx",
+    [TM_RADIO_TX_PACKETS]       = "radio_tx",
+    [TM_RADIO_RX_PACKETS]       = "radio_rx",
+    [TM_RADIO_CRC_ERRORS]       = "radio_crc_err",
+    [TM_RADIO_TX_TIMEOUTS]      = "radio_tx_timeout",
+    [TM_AUDIO_FRAMES_CAPTURED]  = "audio_captured",
+    [TM_AUDIO_FRAMES_PLAYED]    = "audio_played",
+    [TM_AUDIO_UNDERRUNS]        = "audio_underruns",
+    [TM_PLAYBACK_DROPPED]       = "playback_dropped",
+    [TM_PLAYBACK_MISSED]        = "playback_missed",
+    [TM_PLAYBACK_MAX_FILL]      = "playback_max_fill",
+    [TM_USB_BYTES_TX]           = "usb_tx_bytes",
+    [TM_USB_BYTES_RX]           = "usb_rx_bytes",
+    [TM_USB_RX_STALLS]          = "usb_rx_stalls",
+};
+
+static const char* const g_hist_names[TM_HIST_COUNT] = {
+    [TM_HIST_CAPTURE_TO_TX]     = "capture_to_tx",
+    [TM_HIST_RX_TO_PLAYOUT]     = "rx_to_playout",
+    [TM_HIST_TX_AIRTIME]        = "tx_airtime",
+    [TM_HIST_RENDER]            = "render",
+};
+
+_Static_assert(TM_METRIC_COUNT <= 255 && TM_HIST_COUNT <= 255, "snapshot counts are u8");
+
+// =============================================================================
+// Time
+// =============================================================================
+
+uint32_t telemetry_now_us(void) {
+#ifdef ESP32
+    return (uint32_t)esp_timer_get_time();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000);
+#endif
+}
+
+// =============================================================================
+// Updates (lock-free)
+// =============================================================================
+
+void telemetry_add(telemetry_metric_t metric, uint32_t value) {
+    if ((unsigned)metric < TM_METRIC_COUNT) {
+        __atomic_fetch_add(&g_metrics[metric], value, __ATOMIC_RELAXED);
+    }
+}
+
+void telemetry_set(telemetry_metric_t metric, uint32_t value) {
+    if ((unsigned)metric < TM_METRIC_COUNT) {
+        __atomic_store_n(&g_metrics[metric], value, __ATOMIC_RELAXED);
+    }
+}
+
+static uint32_t bucket_of(uint32_t us) {
+    if (us < (1u << TELEMETRY_HIST_MIN_SHIFT)) {
+        return 0;
+    }
+    uint32_t log2 = 31 - (uint32_t)__builtin_clz(us);
+    uint32_t bucket = log2 - (TELEMETRY_HIST_MIN_SHIFT - 1);
+    return (bucket < TELEMETRY_HIST_BUCKETS) ? bucket : TELEMETRY_HIST_BUCKETS - 1;
+}
+
+void telemetry_record(telemetry_hist_t hist, uint32_t us) {
+    if ((unsigned)hist >= TM_HIST_COUNT) {
+        return;
+    }
+
+    hist_t* h = &g_hist[hist];
+    __atomic_fetch_add(&h->buckets[bucket_of(us)], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&h->sum_us, us, __ATOMIC_RELAXED);
+
+    // min/max ב-CAS - נכשל רק כשמישהו אחר עדכן באותו רגע
+    uint32_t seen = __atomic_load_n(&h->max_us, __ATOMIC_RELAXED);
+    while (us > seen &&
+           !__atomic_compare_exchange_n(&h->max_us, &seen, us, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+    // min 0 = עוד אין מדידות; מדידה של 0 נשמרת כ-1
+    uint32_t value = us ? us : 1;
+    seen = __atomic_load_n(&h->min_us, __ATOMIC_RELAXED);
+    while ((seen == 0 || value < seen) &&
+           !__atomic_compare_exchange_n(&h->min_us, &seen, value, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+
+    // count אחרון - מי שרואה count רואה גם את הדלי
+    __atomic_fetch_add(&h->count, 1, __ATOMIC_RELEASE);
+}
+
+void telemetry_reset_histograms(void) {
+    for (int i = 0; i < TM_HIST_COUNT; i++) {
+        hist_t* h = &g_hist[i];
+        __atomic_store_n(&h->count, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&h->sum_us, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&h->min_us, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&h->max_us, 0, __ATOMIC_RELAXED);
+        for (int b = 0; b < TELEMETRY_HIST_BUCKETS; b++) {
+            __atomic_store_n(&h->buckets[b], 0, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+// =============================================================================
+// Snapshot
+// =============================================================================
+
+void telemetry_set_collector(telemetry_collector_t collector) {
+    g_collector = collector;
+}
+
+static void collect_system(void) {
+#ifdef ESP32
+    telemetry_set(TM_UPTIME_MS, (uint32_t)(esp_timer_get_time() / 1000));
+    telemetry_set(TM_HEAP_FREE, esp_get_free_heap_size());
+    telemetry_set(TM_HEAP_MIN_FREE, esp_get_minimum_free_heap_size());
+#else
+    telemetry_set(TM_UPTIME_MS, telemetry_now_us() / 1000);
+#endif
+}
+
+void telemetry_snapshot(telemetry_snapshot_t* snapshot) {
+    if (!snapshot) {
+        return;
+    }
+
+    collect_system();
+    if (g_collector) {
+        g_collector();
+    }
+
+    snapshot->magic = TELEMETRY_MAGIC;
+    snapshot->version = TELEMETRY_VERSION;
+    snapshot->metric_count = TM_METRIC_COUNT;
+    snapshot->hist_count = TM_HIST_COUNT;
+    snapshot->bucket_count = TELEMETRY_HIST_BUCKETS;
+
+    for (int i = 0; i < TM_METRIC_COUNT; i++) {
+        snapshot->metrics[i] = __atomic_load_n(&g_metrics[i], __ATOMIC_RELAXED);
+    }
+
+    // לא אטומי כמקשה אחת - מדידה באמצע הצילום יכולה להופיע בדלי ולא ב-count
+    for (int i = 0; i < TM_HIST_COUNT; i++) {
+        const hist_t* h = &g_hist[i];
+        telemetry_hist_snapshot_t* out = &snapshot->hist[i];
+        out->count = __atomic_load_n(&h->count, __ATOMIC_ACQUIRE);
+        out->sum_us = __atomic_load_n(&h->sum_us, __ATOMIC_RELAXED);
+        out->min_us = __atomic_load_n(&h->min_us, __ATOMIC_RELAXED);
+        out->max_us = __atomic_load_n(&h->max_us, __ATOMIC_RELAXED);
+        for (int b = 0; b < TELEMETRY_HIST_BUCKETS; b++) {
+            out->buckets[b] = __atomic_load_n(&h->buckets[b], __ATOMIC_RELAXED);
+        }
+    }
+}
+
+uint32_t telemetry_hist_percentile(const telemetry_hist_snapshot_t* hist, uint8_t percent) {
+    uint32_t total = 0;
+    for (int b = 0; b < TELEMETRY_HIST_BUCKETS; b++) {
+        total += hist->buckets[b];
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    uint32_t target = (uint32_t)(((uint64_t)total * percent + 99) / 100);
+    uint32_t seen = 0;
+    for (int b = 0; b < TELEMETRY_HIST_BUCKETS - 1; b++) {
+        seen += hist->buckets[b];
+        if (seen >= target) {
+            // הגבול העליון של הדלי, חסום במקסימום שנמדד
+            uint32_t upper = 1u << (b + TELEMETRY_HIST_MIN_SHIFT);
+            return (hist->max_us < upper) ? hist->max_us : upper;
+        }
+    }
+    return hist->max_us;
+}
+
+// =============================================================================
+// Text
+// =============================================================================
+
+const char* telemetry_metric_name(telemetry_metric_t metric) {
+    return ((unsigned)metric < TM_METRIC_COUNT) ? g_metric_names[metric] : "?";
+}
+
+const char* telemetry_hist_name(telemetry_hist_t hist) {
+    return ((unsigned)hist < TM_HIST_COUNT) ? g_hist_names[hist] : "?";
+}
+
+size_t telemetry_format(char* buffer, size_t size) {
+    static telemetry_snapshot_t snap;
+    size_t len = 0;
+
+    if (!buffer || size == 0) {
+        return 0;
+    }
+    buffer[0] = '\0';
+    telemetry_snapshot(&snap);
+
+    for (int i = 0; i < TM_METRIC_COUNT && len < size; i++) {
+        int n = snprintf(buffer + len, size - len, "%s %u\n",
+                         g_metric_names[i], (unsigned)snap.metrics[i]);
+        if (n < 0) break;
+        len += (size_t)n;
+    }
+    for (int i = 0; i < TM_HIST_COUNT && len < size; i++) {
+        const telemetry_hist_snapshot_t* h = &snap.hist[i];
+        int n = snprintf(buffer + len, size - len, "%s n=%u p50=%u p99=%u max=%u us\n",
+                         g_hist_names[i], (unsigned)h->count,
+                         (unsigned)telemetry_hist_percentile(h, 50),
+                         (unsigned)telemetry_hist_percentile(h, 99),
+                         (unsigned)h->max_us);
+        if (n < 0) break;
+        len += (size_t)n;
+    }
+    return (len < size) ? len : size - 1;
+}
+
+void telemetry_update(void) {
+#if TELEMETRY_LOG_INTERVAL_MS > 0
+    static telemetry_snapshot_t snap;
+    uint32_t now = telemetry_now_us() / 1000;
+
+    if (now - g_last_log_ms < TELEMETRY_LOG_INTERVAL_MS) {
+        return;
+    }
+    g_last_log_ms = now;
+
+    telemetry_snapshot(&snap);
+    LOG_INFO("tx %u rx %u crc %u underrun %u | c2tx p99 %uus | rx2play p99 %uus | air p99 %uus | render p99 %uus",
+             (unsigned)snap.metrics[TM_VOICE_TX_FRAMES], (unsigned)snap.metrics[TM_VOICE_RX_FRAMES],
+             (unsigned)snap.metrics[TM_RADIO_CRC_ERRORS], (unsigned)snap.metrics[TM_AUDIO_UNDERRUNS],
+             (unsigned)telemetry_hist_percentile(&snap.hist[TM_HIST_CAPTURE_TO_TX], 99),
+             (unsigned)telemetry_hist_percentile(&snap.hist[TM_HIST_RX_TO_PLAYOUT], 99),
+             (unsigned)telemetry_hist_percentile(&snap.hist[TM_HIST_TX_AIRTIME], 99),
+             (unsigned)telemetry_hist_percentile(&snap.hist[TM_HIST_RENDER], 99));
+#else
+    (void)g_last_log_ms;
+#endif
+}
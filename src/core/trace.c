@@ -0,0 +1,408 @@
+/**
+ * @file trace.c
+ * @brief מימוש מקליט ה-trace
+ */
+
+#include "core/trace.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+
+// =============================================================================
+// Platform-Specific
+// =============================================================================
+
+#ifdef ESP32
+    #include "esp_log.h"
+    #include "esp_cpu.h"
+    #include "esp_timer.h"
+    #include "esp_ipc.h"
+    #include "esp_rom_sys.h"
+    #include "freertos/FreeRTOS.h"
+    #include "freertos/task.h"
+
+    static const char* TAG = "TRACE";
+    #define LOG_INFO(fmt, ...) ESP_LOGI(TAG, fmt, ##__VA_ARGS__)
+    #define LOG_ERROR(fmt, ...) ESP_LOGE(TAG, fmt, ##__VA_ARGS__)
+
+    #define TRACE_CORES         portNUM_PROCESSORS
+    #define TRACE_CORE_ID()     esp_cpu_get_core_id()
+    #define TRACE_TICKS()       ((uint32_t)esp_cpu_get_cycle_count())
+    #define TRACE_TICKS_PER_US() esp_rom_get_cpu_ticks_per_us()
+    #define GET_MICROS64()      ((int64_t)esp_timer_get_time())
+    #define TRACE_TASK()        ((const void*)xTaskGetCurrentTaskHandle())
+    #define TRACE_TASK_NAME()   pcTaskGetName(NULL)
+#else
+    #include <time.h>
+    #define LOG_INFO(fmt, ...) printf("[TRACE] " fmt "\n", ##__VA_ARGS__)
+    #define LOG_ERROR(fmt, ...) fprintf(stderr, "[TRACE ERROR] " fmt "\n", ##__VA_ARGS__)
+
+    static uint64_t sim_nanos(void) {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+    }
+
+    // ב-host ה"מחזורים" הם ננו-שניות וכל החוטים נרשמים כליבה 0;
+    // כל חוט הוא "משימה" לפי כתובת משתנה thread-local
+    static _Thread_local char t_task_marker;
+
+    #define TRACE_CORES         1
+    #define TRACE_CORE_ID()     0
+    #define TRACE_TICKS()       ((uint32_t)sim_nanos())
+    #define TRACE_TICKS_PER_US() 1000
+    #define GET_MICROS64()      ((int64_t)(sim_nanos() / 1000))
+    #define TRACE_TASK()        ((const void*)&t_task_marker)
+    #define TRACE_TASK_NAME()   "thread"
+#endif
+
+// =============================================================================
+// Internal State
+// =============================================================================
+
+_Static_assert((TRACE_RING_EVENTS & (TRACE_RING_EVENTS - 1)) == 0, "trace ring size must be a power of 2");
+_Static_assert(TRACE_REGION_COUNT <= 255, "region id is u8");
+
+#define TRACE_TASK_OTHER        TRACE_MAX_TASKS     // אחרי שהטבלה התמלאה
+
+typedef struct {
+    uint32_t ticks;
+    uint8_t  region;
+    uint8_t  phase;
+    uint16_t task;                  // אינדקס ב-g_tasks (או TRACE_TASK_OTHER)
+} trace_record_t;
+
+// משימה נרשמת באירוע הראשון שלה; הטבלה מתאפסת ב-trace_start
+typedef struct {
+    const void* handle;
+    char name[16];
+} trace_task_t;
+
+typedef struct {
+    trace_record_t* events;         // TRACE_RING_EVENTS, מוקצה ב-trace_start הראשון
+    uint32_t head;                  // רץ חופשי; fetch_add מכל משימה על הליבה
+} trace_ring_t;
+
+// נקודת עיגון לכל ליבה: מונה המחזורים שלה מול הזמן המשותף (esp_timer).
+// מוני המחזורים של שתי הליבות לא מסונכרנים - כך הם מיושרים בייצוא
+typedef struct {
+    uint32_t ticks;
+    int64_t  us;
+} trace_anchor_t;
+
+volatile bool g_trace_running = false;
+
+static trace_ring_t g_rings[TRACE_MAX_CORES];
+static trace_anchor_t g_anchors[TRACE_MAX_CORES];
+static int64_t g_start_us = 0;
+
+static trace_task_t g_tasks[TRACE_MAX_TASKS];
+static uint32_t g_task_count = 0;           // תאים שנתפסו (יכול לעבור את המקסימום)
+
+static const char* const g_region_names[TRACE_REGION_COUNT] = {
+    [TRACE_AUDIO_CAPTURE]   = "audio_capture",
+    [TRACE_AUDIO_AEC]       = "aec",
+    [TRACE_AUDIO_DSP]       = "dsp",
+    [TRACE_AUDIO_PLAYBACK]  = "audio_playback",
+    [TRACE_VOICE_TX]        = "voice_tx",
+    [TRACE_VOICE_RX]        = "voice_rx",
+    [TRACE_RADIO_SEND]      = "radio_send",
+    [TRACE_RADIO_IRQ]       = "radio_irq",
+    [TRACE_RENDER]          = "render",
+    [TRACE_USB_UPDATE]      = "usb_update",
+};
+
+_Static_assert(TRACE_CORES <= TRACE_MAX_CORES, "more cores than trace rings");
+
+// =============================================================================
+// Recording
+// =============================================================================
+
+static uint16_t task_index(void) {
+    const void* self = TRACE_TASK();
+    uint32_t count = __atomic_load_n(&g_task_count, __ATOMIC_ACQUIRE);
+    if (count > TRACE_MAX_TASKS) count = TRACE_MAX_TASKS;
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (__atomic_load_n(&g_tasks[i].handle, __ATOMIC_ACQUIRE) == self) {
+            return (uint16_t)i;
+        }
+    }
+
+    // רק המשימה עצמה מחפשת את עצמה, אז תא חדש אחד לכל משימה
+    uint32_t slot = __atomic_fetch_add(&g_task_count, 1, __ATOMIC_ACQ_REL);
+    if (slot >= TRACE_MAX_TASKS) {
+        return TRACE_TASK_OTHER;
+    }
+    strncpy(g_tasks[slot].name, TRACE_TASK_NAME(), sizeof(g_tasks[slot].name) - 1);
+    g_tasks[slot].name[sizeof(g_tasks[slot].name) - 1] = '\0';
+    __atomic_store_n(&g_tasks[slot].handle, self, __ATOMIC_RELEASE);
+    return (uint16_t)slot;
+}
+
+void trace_event(trace_region_t region, trace_phase_t phase) {
+    uint16_t task = task_index();
+    trace_ring_t* ring = &g_rings[TRACE_CORE_ID()];
+
+    // משימה אחרת על אותה ליבה יכולה להיכנס באמצע - כל אחת מקבלת תא משלה
+    uint32_t slot = __atomic_fetch_add(&ring->head, 1, __ATOMIC_RELAXED);
+    trace_record_t* rec = &ring->events[slot & (TRACE_RING_EVENTS - 1)];
+    rec->ticks = TRACE_TICKS();
+    rec->region = (uint8_t)region;
+    rec->phase = (uint8_t)phase;
+    rec->task = task;
+}
+
+static void capture_anchor(void* arg) {
+    (void)arg;
+    trace_anchor_t* anchor = &g_anchors[TRACE_CORE_ID()];
+    anchor->ticks = TRACE_TICKS();
+    anchor->us = GET_MICROS64();
+}
+
+bool trace_start(void) {
+#if TRACE_ENABLED
+    g_trace_running = false;
+
+    for (int core = 0; core < TRACE_CORES; core++) {
+        if (!g_rings[core].events) {
+            g_rings[core].events = malloc(TRACE_RING_EVENTS * sizeof(trace_record_t));
+            if (!g_rings[core].events) {
+                LOG_ERROR("No memory for trace ring %d", core);
+                return false;
+            }
+        }
+        __atomic_store_n(&g_rings[core].head, 0, __ATOMIC_RELAXED);
+    }
+    memset(g_tasks, 0, sizeof(g_tasks));
+    __atomic_store_n(&g_task_count, 0, __ATOMIC_RELEASE);
+
+    g_start_us = GET_MICROS64();
+    __atomic_store_n(&g_trace_running, true, __ATOMIC_RELEASE);
+    LOG_INFO("Tracing started (%d x %d events)", TRACE_CORES, TRACE_RING_EVENTS);
+    return true;
+#else
+    LOG_ERROR("Tracing not compiled in (TRACE_ENABLED)");
+    return false;
+#endif
+}
+
+void trace_stop(void) {
+    if (!g_trace_running) {
+        return;
+    }
+    __atomic_store_n(&g_trace_running, false, __ATOMIC_RELEASE);
+
+    // עיגון מכל ליבה על הליבה עצמה
+    for (int core = 0; core < TRACE_CORES; core++) {
+#ifdef ESP32
+        esp_ipc_call_blocking(core, capture_anchor, NULL);
+#else
+        capture_anchor(NULL);
+#endif
+    }
+    LOG_INFO("Tracing stopped");
+}
+
+bool trace_is_running(void) {
+    return g_trace_running;
+}
+
+void trace_get_stats(trace_stats_t* stats) {
+    if (!stats) {
+        return;
+    }
+    memset(stats, 0, sizeof(*stats));
+    stats->running = g_trace_running;
+    stats->cores = TRACE_CORES;
+    for (int core = 0; core < TRACE_CORES; core++) {
+        stats->events[core] = __atomic_load_n(&g_rings[core].head, __ATOMIC_RELAXED);
+    }
+}
+
+const char* trace_region_name(trace_region_t region) {
+    return ((unsigned)region < TRACE_REGION_COUNT) ? g_region_names[region] : "?";
+}
+
+// =============================================================================
+// Export
+// =============================================================================
+
+typedef struct {
+    trace_output_t output;
+    void* ctx;
+    char buffer[512];
+    uint32_t length;
+    bool ok;
+    bool first;                     // פסיק לפני כל אירוע חוץ מהראשון
+} json_writer_t;
+
+static void json_flush(json_writer_t* w) {
+    if (w->ok && w->length > 0) {
+        w->ok = w->output((const uint8_t*)w->buffer, w->length, w->ctx);
+    }
+    w->length = 0;
+}
+
+static void json_printf(json_writer_t* w, const char* fmt, ...) {
+    if (sizeof(w->buffer) - w->length < 160) {
+        json_flush(w);
+    }
+
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(w->buffer + w->length, sizeof(w->buffer) - w->length, fmt, args);
+    va_end(args);
+
+    if (n > 0) {
+        w->length += ((uint32_t)n < sizeof(w->buffer) - w->length) ? (uint32_t)n
+                                                                    : sizeof(w->buffer) - w->length - 1;
+    }
+}
+
+static void json_event(json_writer_t* w, const char* name, char phase, int64_t ticks,
+                       uint32_t ticks_per_us, int tid, int core) {
+    if (ticks < 0) ticks = 0;
+    uint64_t us = (uint64_t)ticks / ticks_per_us;
+    uint32_t frac = (uint32_t)((uint64_t)ticks % ticks_per_us * 1000 / ticks_per_us);
+
+    json_printf(w, "%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%llu.%03u,\"pid\":1,\"tid\":%d,"
+                   "\"args\":{\"core\":%d}}",
+                w->first ? "" : ",\n", name, phase, (unsigned long long)us, (unsigned)frac, tid, core);
+    w->first = false;
+}
+
+// קורא בטבעת של ליבה אחת, מהישן לחדש
+typedef struct {
+    uint32_t next;
+    uint32_t head;
+    uint32_t prev;                  // ticks של האירוע הקודם
+    int64_t  ticks;                 // זמן האירוע ב-next, ביחידות מ-trace_start
+} trace_cursor_t;
+
+/**
+ * @brief מיקום ההתחלה בטבעת של ליבה
+ *
+ * הזמנים נפרשים אחורה מנקודת העיגון בהפרשים עם סימן: עמידים לגלישת
+ * המונה 32 ביט, וגם לאירוע שקיבל תא לפני שכנו אבל נחתם אחריו.
+ * צריך שבין אירועים סמוכים יעברו פחות מ-2^31 מחזורים (~9 שניות ב-240MHz).
+ */
+static void cursor_init(trace_cursor_t* cur, int core, uint32_t ticks_per_us) {
+    const trace_ring_t* ring = &g_rings[core];
+    const trace_anchor_t* anchor = &g_anchors[core];
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    uint32_t count = (head < TRACE_RING_EVENTS) ? head : TRACE_RING_EVENTS;
+    uint32_t first = head - count;
+
+    // מהעיגון אחורה עד האירוע הישן ביותר
+    int64_t back = 0;
+    uint32_t prev = anchor->ticks;
+    for (uint32_t i = head; i != first; i--) {
+        uint32_t t = ring->events[(i - 1) & (TRACE_RING_EVENTS - 1)].ticks;
+        back += (int32_t)(prev - t);
+        prev = t;
+    }
+
+    cur->next = first;
+    cur->head = head;
+    cur->prev = prev;
+    cur->ticks = (anchor->us - g_start_us) * (int64_t)ticks_per_us - back;
+}
+
+static void cursor_advance(trace_cursor_t* cur, int core) {
+    cur->next++;
+    if (cur->next != cur->head) {
+        uint32_t t = g_rings[core].events[cur->next & (TRACE_RING_EVENTS - 1)].ticks;
+        cur->ticks += (int32_t)(t - cur->prev);
+        cur->prev = t;
+    }
+}
+
+/**
+ * @brief כל הליבות ממוזגות לפי זמן, track לכל משימה
+ *
+ * משימה יכולה לעבור ליבה בין B ל-E, לכן ההתאמה היא על הזרם הממוזג:
+ * לכל משימה מחסנית של אזורים פתוחים, ו-E נכתב רק אם הוא סוגר את האזור
+ * שבראשה. E שה-B שלו נדרס (או של משימה אחרת) נזרק.
+ */
+static void export_events(json_writer_t* w, uint32_t ticks_per_us) {
+    static uint8_t stack[TRACE_MAX_TASKS + 1][TRACE_MAX_DEPTH];
+    static uint8_t depth[TRACE_MAX_TASKS + 1];
+    trace_cursor_t cursors[TRACE_MAX_CORES] = {0};
+
+    uint32_t tasks = __atomic_load_n(&g_task_count, __ATOMIC_ACQUIRE);
+    if (tasks > TRACE_MAX_TASKS) {
+        tasks = TRACE_MAX_TASKS + 1;
+    }
+    for (uint32_t t = 0; t < tasks; t++) {
+        json_printf(w, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                       "\"args\":{\"name\":\"%s\"}}", w->first ? "" : ",\n", (unsigned)t,
+                    t < TRACE_MAX_TASKS ? g_tasks[t].name : "other");
+        w->first = false;
+    }
+
+    memset(depth, 0, sizeof(depth));
+    for (int core = 0; core < TRACE_CORES; core++) {
+        if (g_rings[core].events) {
+            cursor_init(&cursors[core], core, ticks_per_us);
+        } else {
+            cursors[core].next = cursors[core].head = 0;
+        }
+    }
+
+    while (w->ok) {
+        int core = -1;
+        for (int c = 0; c < TRACE_CORES; c++) {
+            if (cursors[c].next != cursors[c].head &&
+                (core < 0 || cursors[c].ticks < cursors[core].ticks)) {
+                core = c;
+            }
+        }
+        if (core < 0) break;
+
+        trace_cursor_t* cur = &cursors[core];
+        const trace_record_t* rec = &g_rings[core].events[cur->next & (TRACE_RING_EVENTS - 1)];
+        uint32_t task = (rec->task <= TRACE_MAX_TASKS) ? rec->task : TRACE_MAX_TASKS;
+        bool emit = false;
+
+        if (rec->phase == TRACE_PHASE_BEGIN) {
+            if (depth[task] < TRACE_MAX_DEPTH) {
+                stack[task][depth[task]++] = rec->region;
+                emit = true;
+            }
+        } else if (depth[task] > 0 && stack[task][depth[task] - 1] == rec->region) {
+            depth[task]--;
+            emit = true;
+        }
+
+        if (emit) {
+            json_event(w, trace_region_name((trace_region_t)rec->region),
+                       rec->phase == TRACE_PHASE_BEGIN ? 'B' : 'E', cur->ticks, ticks_per_us,
+                       (int)task, core);
+        }
+        cursor_advance(cur, core);
+    }
+}
+
+bool trace_export_json(trace_output_t output, void* ctx) {
+    static json_writer_t writer;
+
+    if (!output) {
+        return false;
+    }
+    trace_stop();
+
+    json_writer_t* w = &writer;
+    w->output = output;
+    w->ctx = ctx;
+    w->length = 0;
+    w->ok = true;
+    w->first = true;
+
+    json_printf(w, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    export_events(w, TRACE_TICKS_PER_US());
+    json_printf(w, "\n]}\n");
+    json_flush(w);
+    return w->ok;
+}
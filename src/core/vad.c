@@ -0,0 +1,184 @@
+/**
+ * @file vad.c
+ * @brief מימוש VAD, DTX ורעש נוחות
+ */
+
+#include "core/vad.h"
+#include "core/audio_dsp.h"
+#include <string.h>
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+static inline uint32_t ms_to_samples(const vad_state_t* vad, uint32_t ms) {
+    return (vad->sample_rate * ms) / 1000;
+}
+
+// =============================================================================
+// VAD / DTX
+// =============================================================================
+
+void vad_init(vad_state_t* vad, uint32_t sample_rate) {
+    if (!vad) return;
+
+    memset(vad, 0, sizeof(vad_state_t));
+    vad->enabled = true;
+    vad->sample_rate = sample_rate ? sample_rate : 8000;
+    vad_reset(vad);
+}
+
+void vad_set_enabled(vad_state_t* vad, bool enabled) {
+    if (!vad) return;
+    vad->enabled = enabled;
+}
+
+void vad_reset(vad_state_t* vad) {
+    if (!vad) return;
+
+    vad->noise_floor = VAD_MIN_ENERGY;
+    vad->sid_level = 0;
+
+    // מתחילים "בדיבור" בלי hangover - שקט ראשון ישלח DTX_START
+    vad->in_speech = true;
+    vad->hangover_left = 0;
+    vad->since_sid = 0;
+}
+
+dtx_action_t vad_process(vad_state_t* vad, const int16_t* samples, uint16_t count,
+                         uint16_t input_level) {
+    if (!vad || !samples || count == 0) return DTX_SEND_VOICE;
+
+    if (!vad->enabled) {
+        vad->frames_sent++;
+        return DTX_SEND_VOICE;
+    }
+
+    // אנרגיה ו-ZCR במעבר אחד
+    uint64_t sum_sq = 0;
+    uint32_t crossings = 0;
+    int16_t prev = samples[0];
+
+    for (uint16_t i = 0; i < count; i++) {
+        int32_t s = samples[i];
+        sum_sq += (uint64_t)(s * s);
+        if ((s ^ prev) < 0) crossings++;
+        prev = (int16_t)s;
+    }
+
+    uint32_t rms = audio_dsp_isqrt((uint32_t)(sum_sq / count));
+    uint32_t zcr = (crossings * 100) / count;
+
+    bool speech = rms > VAD_MIN_ENERGY &&
+                  ((rms * 16 > vad->noise_floor * VAD_SPEECH_RATIO_Q4) ||
+                   (rms * 16 > vad->noise_floor * VAD_UNVOICED_RATIO_Q4 &&
+                    zcr >= VAD_ZCR_UNVOICED));
+
+    // רצפת רעש: יורדת מהר, עולה לאט (גם בדיבור, למקרה של רעש רקע שעלה)
+    if (rms < vad->noise_floor) {
+        vad->noise_floor = (vad->noise_floor * 3 + rms) / 4;
+    } else {
+        vad->noise_floor += (rms - vad->noise_floor) / (speech ? 256 : 64);
+    }
+    if (vad->noise_floor < VAD_MIN_ENERGY) {
+        vad->noise_floor = VAD_MIN_ENERGY;
+    }
+
+    if (speech) {
+        vad->in_speech = true;
+        vad->hangover_left = ms_to_samples(vad, VAD_HANGOVER_MS);
+        vad->frames_sent++;
+        return DTX_SEND_VOICE;
+    }
+
+    // רמת רעש ל-SID נמדדת לפני ה-gate, אחרת היא תמיד 0
+    vad->sid_level = (vad->sid_level * 7 + input_level) / 8;
+
+    if (vad->in_speech) {
+        if (vad->hangover_left > count) {
+            vad->hangover_left -= count;
+            vad->frames_sent++;
+            return DTX_SEND_VOICE;
+        }
+
+        vad->in_speech = false;
+        vad->hangover_left = 0;
+        vad->since_sid = 0;
+        vad->sid_sent++;
+        return DTX_SEND_DTX_START;
+    }
+
+    vad->frames_suppressed++;
+    vad->since_sid += count;
+
+    if (vad->since_sid >= ms_to_samples(vad, VAD_SID_INTERVAL_MS)) {
+        vad->since_sid = 0;
+        vad->sid_sent++;
+        return DTX_SEND_SID;
+    }
+
+    return DTX_SUPPRESS;
+}
+
+uint16_t vad_get_sid_level(const vad_state_t* vad) {
+    if (!vad) return 0;
+    return (vad->sid_level > 0xFFFF) ? 0xFFFF : (uint16_t)vad->sid_level;
+}
+
+// =============================================================================
+// Comfort Noise
+// =============================================================================
+
+// RMS של רעש אחיד 16 ביט אחרי LPF עם a=1/2 (פקטור sqrt(1/3)) - לנרמול
+#define CN_UNIFORM_RMS_LP   10923
+
+void comfort_noise_init(comfort_noise_t* cn) {
+    if (!cn) return;
+
+    memset(cn, 0, sizeof(comfort_noise_t));
+    cn->seed = 0x12345678;
+}
+
+void comfort_noise_update(comfort_noise_t* cn, uint16_t level) {
+    if (!cn) return;
+
+    cn->active = true;
+    cn->level = level;
+}
+
+void comfort_noise_stop(comfort_noise_t* cn) {
+    if (!cn) return;
+    cn->active = false;
+}
+
+void comfort_noise_generate(comfort_noise_t* cn, int16_t* out, uint16_t count) {
+    if (!cn || !out) return;
+
+    if (!cn->active || cn->level == 0) {
+        memset(out, 0, count * sizeof(int16_t));
+        return;
+    }
+
+    uint32_t x = cn->seed;
+    int32_t lp = cn->lp_state;
+
+    for (uint16_t i = 0; i < count; i++) {
+        // xorshift32
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+
+        int32_t white = (int16_t)(x & 0xFFFF);
+        white = (white * cn->level) / CN_UNIFORM_RMS_LP;
+
+        // low-pass חד-קוטבי - רעש "חם" יותר מרעש לבן
+        lp += (white - lp) / 2;
+
+        if (lp > 32767) lp = 32767;
+        if (lp < -32768) lp = -32768;
+        out[i] = (int16_t)lp;
+    }
+
+    cn->seed = x;
+    cn->lp_state = lp;
+}
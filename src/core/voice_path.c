@@ -0,0 +1,213 @@
+/**
+ * @file voice_path.c
+ * @brief מימוש נתיב הקול בין האודיו לפרוטוקול
+ */
+
+#include "core/voice_path.h"
+#include "core/vad.h"
+#include "core/resampler.h"
+#include "core/clock_drift.h"
+#include "core/telemetry.h"
+#include "core/trace.h"
+#include "hal/audio.h"
+#include "hal/usb_tap.h"
+#include "config.h"
+#include <stdio.h>
+#include <string.h>
+
+// =============================================================================
+// Platform-Specific
+// =============================================================================
+
+#ifdef ESP32
+    #include "esp_log.h"
+
+    static const char* TAG = "VOICE";
+    #define LOG_INFO(fmt, ...) ESP_LOGI(TAG, fmt, ##__VA_ARGS__)
+#else
+    #define LOG_INFO(fmt, ...) printf("[VOICE] " fmt "\n", ##__VA_ARGS__)
+#endif
+
+// =============================================================================
+// Internal State
+// =============================================================================
+
+static audio_ring_buffer_t g_playback_buffer HOT_BUFFER_ATTR;
+
+// DTX - VAD בשידור, רעש נוחות בקבלה
+static vad_state_t g_vad;
+static comfort_noise_t g_comfort_noise;
+static uint32_t g_last_cn_frame_time = 0;
+
+// המרת קצב בין הלכידה/השמעה לקצב הקול ברדיו
+#define LINK_BUFFER_SAMPLES     (AUDIO_DMA_BUFFER_SIZE * 2 + 16)    // בלוק DMA מקסימלי ב-1:2 + מרווח
+static resampler_t g_tx_resampler;
+static resampler_t g_rx_resampler;
+static int16_t g_tx_link_buffer[LINK_BUFFER_SAMPLES] HOT_BUFFER_ATTR;   // הקשר של משימת האודיו
+static int16_t g_rx_link_buffer[LINK_BUFFER_SAMPLES] HOT_BUFFER_ATTR;   // הקשר של הלולאה הראשית
+
+// voice_data_t הוא מבנה packed של הפרוטוקול - audio_data לא בהכרח מיושר ל-int16
+static int16_t g_rx_voice[AUDIO_BUFFER_SIZE / sizeof(int16_t)] HOT_BUFFER_ATTR;
+
+// פיצוי סחיפת שעון מול השולח (דרך ה-resampler של הקבלה)
+static clock_drift_t g_rx_drift;
+
+// =============================================================================
+// Setup
+// =============================================================================
+
+void voice_path_init(uint32_t capture_rate) {
+    audio_buffer_init(&g_playback_buffer);
+    audio_buffer_set_jitter_depth(&g_playback_buffer, VOICE_PATH_JITTER_DEPTH);
+
+    vad_init(&g_vad, capture_rate);
+    comfort_noise_init(&g_comfort_noise);
+    clock_drift_reset(&g_rx_drift);
+    g_last_cn_frame_time = 0;
+}
+
+bool voice_path_set_link_rate(uint32_t capture_rate, uint32_t link_rate) {
+    if (!resampler_init(&g_tx_resampler, capture_rate, link_rate) ||
+        !resampler_init(&g_rx_resampler, link_rate, capture_rate)) {
+        return false;
+    }
+
+    // קצבים לכותרות של ה-taps
+    usb_tap_set_rate(USB_TAP_MIC_RAW, capture_rate);
+    usb_tap_set_rate(USB_TAP_MIC_DSP, capture_rate);
+    usb_tap_set_rate(USB_TAP_ENCODED, link_rate);
+    usb_tap_set_rate(USB_TAP_DECODED, link_rate);
+    usb_tap_set_rate(USB_TAP_PLAYBACK, capture_rate);
+
+    LOG_INFO("Audio link rate: %u Hz (capture %u Hz)", (unsigned)link_rate, (unsigned)capture_rate);
+    return true;
+}
+
+audio_ring_buffer_t* voice_path_playback_buffer(void) {
+    return &g_playback_buffer;
+}
+
+// =============================================================================
+// Transmit
+// =============================================================================
+
+void voice_path_tx_reset(void) {
+    vad_reset(&g_vad);
+}
+
+void voice_path_capture(const int16_t* samples, uint16_t sample_count) {
+    uint32_t start_us = telemetry_now_us();
+
+    TRACE_BEGIN(TRACE_VOICE_TX);
+
+    // בשקט לא משדרים frames - רק SID תקופתי
+    switch (vad_process(&g_vad, samples, sample_count, audio_get_input_level())) {
+        case DTX_SEND_VOICE:
+            // המרה לקצב הרדיו אם צריך
+            if (!resampler_is_bypass(&g_tx_resampler)) {
+                sample_count = resampler_process(&g_tx_resampler, samples, sample_count,
+                                                 g_tx_link_buffer, LINK_BUFFER_SAMPLES);
+                samples = g_tx_link_buffer;
+            }
+
+            usb_tap_push(USB_TAP_ENCODED, samples, sample_count);
+
+            // Convert to bytes for protocol
+            protocol_send_voice((const uint8_t*)samples, sample_count * sizeof(int16_t));
+            telemetry_inc(TM_VOICE_TX_FRAMES);
+            telemetry_record_since(TM_HIST_CAPTURE_TO_TX, start_us);
+            break;
+
+        case DTX_SEND_DTX_START:
+            protocol_send_sid(true, vad_get_sid_level(&g_vad));
+            telemetry_inc(TM_VOICE_SID_TX);
+            break;
+
+        case DTX_SEND_SID:
+            protocol_send_sid(false, vad_get_sid_level(&g_vad));
+            telemetry_inc(TM_VOICE_SID_TX);
+            break;
+
+        case DTX_SUPPRESS:
+            break;
+    }
+
+    TRACE_END(TRACE_VOICE_TX);
+}
+
+// =============================================================================
+// Receive
+// =============================================================================
+
+uint16_t voice_path_receive(const voice_data_t* voice, const int16_t** samples) {
+    TRACE_BEGIN(TRACE_VOICE_RX);
+    comfort_noise_stop(&g_comfort_noise);
+    telemetry_inc(TM_VOICE_RX_FRAMES);
+    uint16_t voice_len = voice->audio_len;
+    if (voice_len > AUDIO_BUFFER_SIZE) voice_len = AUDIO_BUFFER_SIZE;
+    uint16_t voice_samples = voice_len / sizeof(int16_t);
+    memcpy(g_rx_voice, voice->audio_data, voice_samples * sizeof(int16_t));
+    usb_tap_push(USB_TAP_DECODED, g_rx_voice, voice_samples);
+
+    // תמיד דרך ה-resampler - גם באותו קצב, בשביל תיקון הסחיפה
+    uint16_t count = resampler_process(&g_rx_resampler, g_rx_voice, voice_samples,
+                                       g_rx_link_buffer, LINK_BUFFER_SAMPLES);
+
+    // בהעלאת קצב התוצאה יכולה לעבור frame אחד - מפצלים
+    // timestamp 0 = זמן ההגעה המקומי (לשעון של השולח אין משמעות כאן),
+    // ממנו נמדדת ההשהיה עד ההשמעה
+    for (uint16_t off = 0; off < count; off += AUDIO_FRAME_SAMPLES) {
+        uint16_t chunk = count - off;
+        if (chunk > AUDIO_FRAME_SAMPLES) chunk = AUDIO_FRAME_SAMPLES;
+        audio_buffer_write(&g_playback_buffer,
+                          (const uint8_t*)&g_rx_link_buffer[off],
+                          chunk * sizeof(int16_t),
+                          0);
+    }
+
+    if (samples) {
+        *samples = g_rx_link_buffer;
+    }
+    TRACE_END(TRACE_VOICE_RX);
+    return count;
+}
+
+void voice_path_receive_sid(const voice_sid_t* sid) {
+    comfort_noise_update(&g_comfort_noise, sid->noise_level);
+}
+
+void voice_path_stop_comfort_noise(void) {
+    comfort_noise_stop(&g_comfort_noise);
+}
+
+// =============================================================================
+// Playback
+// =============================================================================
+
+void voice_path_update(uint32_t now) {
+    // רעש נוחות: בזמן DTX מזינים frame כל 20ms כדי שה-buffer לא יתרוקן
+    if (g_comfort_noise.active) {
+        if (now - g_last_cn_frame_time >= AUDIO_FRAME_DURATION_MS &&
+            !audio_buffer_jitter_ready(&g_playback_buffer)) {
+            int16_t noise[AUDIO_FRAME_SAMPLES];
+            comfort_noise_generate(&g_comfort_noise, noise, AUDIO_FRAME_SAMPLES);
+            audio_buffer_write(&g_playback_buffer, (const uint8_t*)noise, sizeof(noise), now);
+            g_last_cn_frame_time = now;
+        }
+    }
+
+    // Start playback if not already playing
+    if (!audio_is_playing() && audio_buffer_jitter_ready(&g_playback_buffer)) {
+        clock_drift_reset(&g_rx_drift);
+        resampler_set_drift_ppm(&g_rx_resampler, 0);
+        audio_start_playback(&g_playback_buffer);
+        return;
+    }
+
+    // סחיפת שעון: מודדים רק כשמתקבל קול (ב-DTX ה-buffer מוזן ברעש נוחות)
+    if (audio_is_playing() && !g_comfort_noise.active) {
+        if (clock_drift_update(&g_rx_drift, audio_buffer_samples(&g_playback_buffer), now)) {
+            resampler_set_drift_ppm(&g_rx_resampler, clock_drift_get_ppm(&g_rx_drift));
+        }
+    }
+}
@@ -5,6 +5,13 @@
 
 #include "hal/audio.h"
 #include "config.h"
+#include "core/audio_dsp.h"
+#include "core/audio_kernels.h"
+#include "core/aec.h"
+#include "hal/usb_tap.h"
+#include "core/telemetry.h"
+#include "core/trace.h"
+#include "core/tasks.h"
 #include <string.h>
 #include <math.h>
 
@@ -48,9 +55,10 @@
 // =============================================================================
 
 #define I2S_NUM             I2S_NUM_0
-#define DMA_BUF_COUNT       4
-#define DMA_BUF_LEN         512
+#define DMA_BUF_COUNT       AUDIO_DMA_BUFFER_COUNT
+#define DMA_BUF_LEN         AUDIO_DMA_BUFFER_SIZE
 #define NOISE_GATE_DEFAULT  500
+#define I2S_READ_TIMEOUT_MS 100     // i2s_read לא חוסם לנצח - המשימה צריכה לראות IDLE
 
 // =============================================================================
 // Internal State
@@ -79,13 +87,23 @@ static bool g_noise_gate_enabled = true;
 static uint16_t g_noise_gate_threshold = NOISE_GATE_DEFAULT;
 static bool g_agc_enabled = true;
 
+// שרשראות DSP (fixed point) - קלט ופלט
+static audio_dsp_t g_input_dsp;
+static audio_dsp_t g_output_dsp;
+
+// ביטול הד - ה-reference הוא מה שנכתב לרמקול
+static aec_state_t g_aec HOT_BUFFER_ATTR;
+
 // Levels
 static uint16_t g_current_input_level = 0;
 static uint16_t g_current_output_level = 0;
 
 // DMA buffers
-static int16_t g_dma_read_buffer[DMA_BUF_LEN];
-static int16_t g_dma_write_buffer[DMA_BUF_LEN];
+static int16_t g_dma_read_buffer[DMA_BUF_LEN] AUDIO_ALIGNED HOT_BUFFER_ATTR;
+static int16_t g_dma_write_buffer[DMA_BUF_LEN] AUDIO_ALIGNED HOT_BUFFER_ATTR;
+
+// frame מה-playback buffer מועתק שלם לבלוק אחד
+_Static_assert(DMA_BUF_LEN * sizeof(int16_t) >= AUDIO_BUFFER_SIZE, "DMA block shorter than an audio frame");
 
 #ifdef ESP32
 static TaskHandle_t g_audio_task_handle = NULL;
@@ -99,7 +117,6 @@ static SemaphoreHandle_t g_audio_mutex = NULL;
 static void audio_task(void* param);
 static void process_input_samples(int16_t* samples, uint16_t count);
 static void process_output_samples(int16_t* samples, uint16_t count);
-static uint16_t calculate_rms_level(const int16_t* samples, uint16_t count);
 
 // =============================================================================
 // Initialization
@@ -111,7 +128,7 @@ void audio_get_default_config(audio_config_t* config) {
     config->mode = AUDIO_MODE_ADC_DAC;
     config->sample_rate = AUDIO_SAMPLE_RATE;
     config->bits_per_sample = AUDIO_BITS;
-    config->use_aec = false;
+    config->use_aec = AEC_ENABLED;
     config->use_agc = true;
     config->use_noise_gate = true;
     config->input_gain = 70;
@@ -139,6 +156,21 @@ bool audio_init(const audio_config_t* config) {
     g_noise_gate_enabled = g_config.use_noise_gate;
     g_agc_enabled = g_config.use_agc;
     
+    audio_kernels_init();
+    
+    // קלט: gain + DC + gate + AGC; פלט: עוצמה בלבד
+    audio_dsp_init(&g_input_dsp, g_config.sample_rate);
+    audio_dsp_set_gain(&g_input_dsp, g_input_gain);
+    audio_dsp_set_dc_block(&g_input_dsp, true);
+    audio_dsp_set_gate(&g_input_dsp, g_noise_gate_enabled, g_noise_gate_threshold);
+    audio_dsp_set_agc(&g_input_dsp, g_agc_enabled);
+    
+    audio_dsp_init(&g_output_dsp, g_config.sample_rate);
+    audio_dsp_set_gain(&g_output_dsp, g_output_volume);
+    
+    aec_init(&g_aec);
+    aec_set_enabled(&g_aec, g_config.use_aec);
+    
 #ifdef ESP32
     g_audio_mutex = xSemaphoreCreateMutex();
     if (!g_audio_mutex) {
@@ -281,7 +313,7 @@ bool audio_start_recording(audio_ring_buffer_t* buffer) {
     
     // Create audio task if not running
     if (g_audio_task_handle == NULL) {
-        xTaskCreate(audio_task, "audio_task", 4096, NULL, 10, &g_audio_task_handle);
+        xTaskCreate(audio_task, "audio_task", TASK_STACK_AUDIO_IN, NULL, 10, &g_audio_task_handle);
     }
 #endif
     
@@ -309,7 +341,7 @@ bool audio_start_recording_callback(audio_capture_callback_t callback) {
     i2s_adc_enable(I2S_NUM);
     
     if (g_audio_task_handle == NULL) {
-        xTaskCreate(audio_task, "audio_task", 4096, NULL, 10, &g_audio_task_handle);
+        xTaskCreate(audio_task, "audio_task", TASK_STACK_AUDIO_IN, NULL, 10, &g_audio_task_handle);
     }
 #endif
     
@@ -340,12 +372,7 @@ void audio_stop_recording(void) {
     if (g_state == AUDIO_STATE_RECORDING) {
         g_state = AUDIO_STATE_IDLE;
         
-#ifdef ESP32
-        if (g_audio_task_handle) {
-            vTaskDelete(g_audio_task_handle);
-            g_audio_task_handle = NULL;
-        }
-#endif
+        // audio_task רואה IDLE, מבטל את הרישום ב-watchdog ומוחק את עצמו
     } else {
         // Was duplex, now just playback
         g_state = AUDIO_STATE_PLAYING;
@@ -385,7 +412,7 @@ bool audio_start_playback(audio_ring_buffer_t* buffer) {
     
 #ifdef ESP32
     if (g_audio_task_handle == NULL) {
-        xTaskCreate(audio_task, "audio_task", 4096, NULL, 10, &g_audio_task_handle);
+        xTaskCreate(audio_task, "audio_task", TASK_STACK_AUDIO_IN, NULL, 10, &g_audio_task_handle);
     }
 #endif
     
@@ -417,7 +444,7 @@ bool audio_start_playback_callback(audio_playback_callback_t callback) {
     
 #ifdef ESP32
     if (g_audio_task_handle == NULL) {
-        xTaskCreate(audio_task, "audio_task", 4096, NULL, 10, &g_audio_task_handle);
+        xTaskCreate(audio_task, "audio_task", TASK_STACK_AUDIO_IN, NULL, 10, &g_audio_task_handle);
     }
 #endif
     
@@ -452,12 +479,7 @@ void audio_stop_playback(void) {
     if (g_state == AUDIO_STATE_PLAYING) {
         g_state = AUDIO_STATE_IDLE;
         
-#ifdef ESP32
-        if (g_audio_task_handle) {
-            vTaskDelete(g_audio_task_handle);
-            g_audio_task_handle = NULL;
-        }
-#endif
+        // audio_task רואה IDLE, מבטל את הרישום ב-watchdog ומוחק את עצמו
     } else {
         // Was duplex, now just recording
         g_state = AUDIO_STATE_RECORDING;
@@ -497,7 +519,7 @@ bool audio_start_duplex(audio_ring_buffer_t* record_buffer,
     
 #ifdef ESP32
     if (g_audio_task_handle == NULL) {
-        xTaskCreate(audio_task, "audio_task", 4096, NULL, 10, &g_audio_task_handle);
+        xTaskCreate(audio_task, "audio_task", TASK_STACK_AUDIO_IN, NULL, 10, &g_audio_task_handle);
     }
 #endif
     
@@ -524,11 +546,13 @@ void audio_stop_duplex(void) {
 void audio_set_input_gain(uint8_t gain) {
     if (gain > 100) gain = 100;
     g_input_gain = gain;
+    audio_dsp_set_gain(&g_input_dsp, gain);
 }
 
 void audio_set_output_volume(uint8_t volume) {
     if (volume > 100) volume = 100;
     g_output_volume = volume;
+    audio_dsp_set_gain(&g_output_dsp, g_muted ? 0 : volume);
 }
 
 uint8_t audio_get_input_gain(void) {
@@ -541,6 +565,7 @@ uint8_t audio_get_output_volume(void) {
 
 void audio_set_mute(bool mute) {
     g_muted = mute;
+    audio_dsp_set_gain(&g_output_dsp, mute ? 0 : g_output_volume);
     
     if (mute) {
         audio_speaker_enable(false);
@@ -579,14 +604,22 @@ void audio_reset_stats(void) {
 
 void audio_enable_noise_gate(bool enable) {
     g_noise_gate_enabled = enable;
+    audio_dsp_set_gate(&g_input_dsp, enable, g_noise_gate_threshold);
 }
 
 void audio_set_noise_gate_threshold(uint16_t threshold) {
     g_noise_gate_threshold = threshold;
+    audio_dsp_set_gate(&g_input_dsp, g_noise_gate_enabled, threshold);
 }
 
 void audio_enable_agc(bool enable) {
     g_agc_enabled = enable;
+    audio_dsp_set_agc(&g_input_dsp, enable);
+}
+
+void audio_enable_aec(bool enable) {
+    g_config.use_aec = enable;
+    aec_set_enabled(&g_aec, enable);
 }
 
 // =============================================================================
@@ -659,94 +692,115 @@ void audio_beep(void) {
 // Internal Functions
 // =============================================================================
 
-static uint16_t calculate_rms_level(const int16_t* samples, uint16_t count) {
-    if (!samples || count == 0) return 0;
+static void process_input_samples(int16_t* samples, uint16_t count) {
+    // gain, DC, gate ו-AGC במעבר אחד
+    audio_dsp_process(&g_input_dsp, samples, count);
     
-    uint64_t sum = 0;
-    for (uint16_t i = 0; i < count; i++) {
-        int32_t val = samples[i];
-        sum += val * val;
-    }
+    // רמה לפני ה-gate (VU meter ורמת רעש ל-SID)
+    g_current_input_level = g_input_dsp.input_level;
     
-    return (uint16_t)sqrtf((float)sum / count);
+    // Update peak
+    if (g_current_input_level > g_stats.peak_input_level) {
+        g_stats.peak_input_level = g_current_input_level;
+    }
 }
 
-static void process_input_samples(int16_t* samples, uint16_t count) {
-    // Apply gain
-    int32_t gain_factor = (g_input_gain * 256) / 100;
-    
-    for (uint16_t i = 0; i < count; i++) {
-        int32_t val = samples[i];
-        val = (val * gain_factor) >> 8;
-        
-        // Clamp
-        if (val > 32767) val = 32767;
-        if (val < -32768) val = -32768;
-        
-        samples[i] = (int16_t)val;
-    }
+static void process_output_samples(int16_t* samples, uint16_t count) {
+    // Apply volume (mute = gain 0)
+    audio_dsp_process(&g_output_dsp, samples, count);
     
-    // Calculate input level
-    g_current_input_level = calculate_rms_level(samples, count);
+    g_current_output_level = g_output_dsp.output_level;
     
     // Update peak
-    if (g_current_input_level > g_stats.peak_input_level) {
-        g_stats.peak_input_level = g_current_input_level;
+    if (g_current_output_level > g_stats.peak_output_level) {
+        g_stats.peak_output_level = g_current_output_level;
+    }
+}
+
+// =============================================================================
+// Capture / Playback Passes
+// =============================================================================
+
+/**
+ * @brief מעבר לכידה אחד: taps, AEC, DSP ומסירה ל-buffer או ל-callback
+ */
+static void capture_block(int16_t* samples, uint16_t count, bool aec_running) {
+    TRACE_BEGIN(TRACE_AUDIO_CAPTURE);
+    
+    // taps ל-USB - העתקה בלבד, כבויים עולים בדיקת mask
+    usb_tap_push(USB_TAP_MIC_RAW, samples, count);
+    
+    // ביטול הד לפני gate/AGC (הם לא לינאריים)
+    if (aec_running) {
+        TRACE_BEGIN(TRACE_AUDIO_AEC);
+        aec_process(&g_aec, samples, count);
+        TRACE_END(TRACE_AUDIO_AEC);
+        g_stats.aec_erle_db = aec_get_erle_db(&g_aec);
     }
     
-    // Noise gate
-    if (g_noise_gate_enabled && g_current_input_level < g_noise_gate_threshold) {
-        memset(samples, 0, count * sizeof(int16_t));
+    // Process samples
+    TRACE_BEGIN(TRACE_AUDIO_DSP);
+    process_input_samples(samples, count);
+    TRACE_END(TRACE_AUDIO_DSP);
+    usb_tap_push(USB_TAP_MIC_DSP, samples, count);
+    
+    // Send to buffer or callback
+    if (g_record_buffer) {
+        audio_buffer_write(g_record_buffer, (uint8_t*)samples,
+                          count * sizeof(int16_t), 0);
     }
     
-    // Simple AGC (slow attack, fast release)
-    static float agc_gain = 1.0f;
-    if (g_agc_enabled) {
-        float target_level = 8000.0f;
-        if (g_current_input_level > 0) {
-            float desired_gain = target_level / g_current_input_level;
-            if (desired_gain < agc_gain) {
-                agc_gain = agc_gain * 0.9f + desired_gain * 0.1f;  // Fast attack
-            } else {
-                agc_gain = agc_gain * 0.99f + desired_gain * 0.01f;  // Slow release
-            }
-            
-            // Limit gain
-            if (agc_gain > 4.0f) agc_gain = 4.0f;
-            if (agc_gain < 0.25f) agc_gain = 0.25f;
-            
-            for (uint16_t i = 0; i < count; i++) {
-                int32_t val = (int32_t)(samples[i] * agc_gain);
-                if (val > 32767) val = 32767;
-                if (val < -32768) val = -32768;
-                samples[i] = (int16_t)val;
-            }
-        }
+    if (g_capture_callback) {
+        g_capture_callback(samples, count);
     }
+    
+    g_stats.frames_captured++;
+    TRACE_END(TRACE_AUDIO_CAPTURE);
 }
 
-static void process_output_samples(int16_t* samples, uint16_t count) {
-    // Apply volume
-    int32_t vol_factor = g_muted ? 0 : (g_output_volume * 256) / 100;
+/**
+ * @brief מעבר השמעה אחד לתוך out (עד DMA_BUF_LEN דגימות)
+ * @return מספר הדגימות להשמעה, 0 אם אין נתונים (out מלא בשקט)
+ */
+static uint16_t playback_block(int16_t* out, bool aec_running) {
+    audio_frame_t frame;
+    uint16_t count = 0;
+    TRACE_BEGIN(TRACE_AUDIO_PLAYBACK);
+    
+    // Get data from buffer or callback
+    if (g_playback_buffer && audio_buffer_read(g_playback_buffer, &frame)) {
+        memcpy(out, frame.samples, frame.length);
+        count = frame.length / sizeof(int16_t);
+        // timestamp = זמן ההגעה (ms) - ההשהיה כוללת את עומק ה-jitter buffer
+        telemetry_record(TM_HIST_RX_TO_PLAYOUT,
+                         (uint32_t)(GET_MILLIS() - frame.timestamp) * 1000);
+    } else if (g_playback_callback && g_playback_callback(out, DMA_BUF_LEN)) {
+        count = DMA_BUF_LEN;
+    }
     
-    for (uint16_t i = 0; i < count; i++) {
-        int32_t val = samples[i];
-        val = (val * vol_factor) >> 8;
+    if (count > 0) {
+        // Process samples - רק מה שהגיע; frame מה-buffer קצר מבלוק DMA
+        process_output_samples(out, count);
+        usb_tap_push(USB_TAP_PLAYBACK, out, count);
         
-        // Clamp
-        if (val > 32767) val = 32767;
-        if (val < -32768) val = -32768;
+        if (aec_running) {
+            aec_push_reference(&g_aec, out, count);
+        }
+        
+        g_stats.frames_played++;
+    } else {
+        // No data - output silence
+        memset(out, 0, DMA_BUF_LEN * sizeof(int16_t));
+        g_stats.buffer_underruns++;
         
-        samples[i] = (int16_t)val;
+        // שומרים על יישור ה-reference מול הקלט
+        if (aec_running) {
+            aec_push_reference(&g_aec, NULL, DMA_BUF_LEN);
+        }
     }
     
-    // Calculate output level
-    g_current_output_level = calculate_rms_level(samples, count);
-    
-    // Update peak
-    if (g_current_output_level > g_stats.peak_output_level) {
-        g_stats.peak_output_level = g_current_output_level;
-    }
+    TRACE_END(TRACE_AUDIO_PLAYBACK);
+    return count;
 }
 
 // =============================================================================
@@ -757,67 +811,56 @@ static void process_output_samples(int16_t* samples, uint16_t count) {
 static void audio_task(void* param) {
     (void)param;
     
-    size_t bytes_read, bytes_written;
-    audio_frame_t frame;
+    size_t bytes_read;
+    bool aec_running = false;
     
     LOG_INFO("Audio task started");
-    
-    while (g_state != AUDIO_STATE_IDLE) {
+    tasks_watchdog_register(TASK_ID_AUDIO_IN, TASK_WATCHDOG_TIMEOUT_MS);
+    
+    for (;;) {
+        if (g_state == AUDIO_STATE_IDLE) {
+            // יציאה תחת ה-mutex: start שרץ במקביל רואה handle קיים ולא יוצר
+            // משימה שנייה, ו-start שקדם לנו מחזיר את המצב ל-!IDLE
+            xSemaphoreTake(g_audio_mutex, portMAX_DELAY);
+            if (g_state == AUDIO_STATE_IDLE) {
+                break;
+            }
+            xSemaphoreGive(g_audio_mutex);
+        }
+
+        tasks_watchdog_feed(TASK_ID_AUDIO_IN);
+        
+        // AEC רק ב-duplex; כל כניסה ל-duplex מתחילה מסנן ו-FIFO נקיים
+        bool duplex = (g_state == AUDIO_STATE_DUPLEX) && g_config.use_aec;
+        if (duplex && !aec_running) {
+            aec_reset(&g_aec);
+        }
+        aec_running = duplex;
+        
         // Recording
         if (g_state == AUDIO_STATE_RECORDING || g_state == AUDIO_STATE_DUPLEX) {
             // Read from I2S/ADC
             esp_err_t err = i2s_read(I2S_NUM, g_dma_read_buffer, 
                                      DMA_BUF_LEN * sizeof(int16_t),
-                                     &bytes_read, portMAX_DELAY);
+                                     &bytes_read, pdMS_TO_TICKS(I2S_READ_TIMEOUT_MS));
             
             if (err == ESP_OK && bytes_read > 0) {
-                uint16_t sample_count = bytes_read / sizeof(int16_t);
-                
-                // Process samples
-                process_input_samples(g_dma_read_buffer, sample_count);
-                
-                // Send to buffer or callback
-                if (g_record_buffer) {
-                    audio_buffer_write(g_record_buffer, 
-                                      (uint8_t*)g_dma_read_buffer,
-                                      bytes_read, 0);
-                }
-                
-                if (g_capture_callback) {
-                    g_capture_callback(g_dma_read_buffer, sample_count);
-                }
-                
-                g_stats.frames_captured++;
+                capture_block(g_dma_read_buffer, bytes_read / sizeof(int16_t), aec_running);
             }
         }
         
         // Playback
         if (g_state == AUDIO_STATE_PLAYING || g_state == AUDIO_STATE_DUPLEX) {
-            bool have_data = false;
-            
-            // Get data from buffer or callback
-            if (g_playback_buffer && audio_buffer_read(g_playback_buffer, &frame)) {
-                memcpy(g_dma_write_buffer, frame.samples, frame.length);
-                have_data = true;
-            } else if (g_playback_callback) {
-                have_data = g_playback_callback(g_dma_write_buffer, DMA_BUF_LEN);
+            // בשקט נכתב בלוק שלם
+            uint16_t count = playback_block(g_dma_write_buffer, aec_running);
+            if (count == 0) {
+                count = DMA_BUF_LEN;
             }
             
-            if (have_data) {
-                // Process samples
-                process_output_samples(g_dma_write_buffer, DMA_BUF_LEN);
-                
-                // Write to DAC
-                for (int i = 0; i < DMA_BUF_LEN; i++) {
-                    uint8_t dac_value = (uint8_t)((g_dma_write_buffer[i] + 32768) >> 8);
-                    dac_output_voltage(DAC_CHANNEL_1, dac_value);
-                }
-                
-                g_stats.frames_played++;
-            } else {
-                // No data - output silence
-                memset(g_dma_write_buffer, 0, DMA_BUF_LEN * sizeof(int16_t));
-                g_stats.buffer_underruns++;
+            // Write to DAC
+            for (int i = 0; i < count; i++) {
+                uint8_t dac_value = (uint8_t)((g_dma_write_buffer[i] + 32768) >> 8);
+                dac_output_voltage(DAC_CHANNEL_1, dac_value);
             }
         }
         
@@ -825,9 +868,65 @@ static void audio_task(void* param) {
         vTaskDelay(1);
     }
     
-    LOG_INFO("Audio task ended");
+    // ביטול הרישום לפני המחיקה - אחרת ה-watchdog מדווח תקיעה
+    // ו-tasks_get_stats ניגש ל-handle משוחרר
+    tasks_watchdog_unregister(TASK_ID_AUDIO_IN);
     g_audio_task_handle = NULL;
+    xSemaphoreGive(g_audio_mutex);
+
+    LOG_INFO("Audio task ended");
     vTaskDelete(NULL);
 }
 #endif
 
+// =============================================================================
+// Simulator
+// =============================================================================
+
+#ifndef ESP32
+// מה שנשאר מה-frame האחרון אחרי שהרמקול לקח את חלקו
+static int16_t g_sim_pending[DMA_BUF_LEN];
+static uint16_t g_sim_pending_count = 0;
+static uint16_t g_sim_pending_pos = 0;
+
+void sim_audio_capture(const int16_t* samples, uint16_t count) {
+    if (!audio_is_recording() || !samples) return;
+    
+    // אותו מסלול כמו audio_task, בבלוקים של עד DMA_BUF_LEN
+    bool aec_running = (g_state == AUDIO_STATE_DUPLEX) && g_config.use_aec;
+    while (count > 0) {
+        uint16_t block = (count > DMA_BUF_LEN) ? DMA_BUF_LEN : count;
+        memcpy(g_dma_read_buffer, samples, block * sizeof(int16_t));
+        capture_block(g_dma_read_buffer, block, aec_running);
+        samples += block;
+        count -= block;
+    }
+}
+
+uint16_t sim_audio_playback(int16_t* out, uint16_t count) {
+    if (!out) return 0;
+    
+    bool aec_running = (g_state == AUDIO_STATE_DUPLEX) && g_config.use_aec;
+    uint16_t played = 0;
+    
+    // הרמקול מושך count דגימות; frames נקראים לפי הצורך
+    while (played < count) {
+        if (g_sim_pending_pos == g_sim_pending_count) {
+            g_sim_pending_pos = 0;
+            g_sim_pending_count = audio_is_playing() ? playback_block(g_sim_pending, aec_running) : 0;
+            if (g_sim_pending_count == 0) {
+                break;
+            }
+        }
+        
+        uint16_t n = g_sim_pending_count - g_sim_pending_pos;
+        if (n > count - played) n = count - played;
+        memcpy(&out[played], &g_sim_pending[g_sim_pending_pos], n * sizeof(int16_t));
+        g_sim_pending_pos += n;
+        played += n;
+    }
+    
+    memset(&out[played], 0, (count - played) * sizeof(int16_t));
+    return played;
+}
+#endif
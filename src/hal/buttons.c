@@ -173,7 +173,7 @@ static void scan_function_buttons(void) {
         {BTN_ABOVE_RED, PIN_BTN_ABOVE_RED},
         {BTN_MULTI, PIN_BTN_MULTI},
         {BTN_RECORD, PIN_BTN_RECORD},
-        {BTN_PTT, PIN_BTN_PTT}
+        {BTN_PTT, PIN_PTT_BUTTON}
     };
     
     for (size_t i = 0; i < sizeof(buttons)/sizeof(buttons[0]); i++) {
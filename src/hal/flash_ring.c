@@ -0,0 +1,373 @@
+/**
+ * @file flash_ring.c
+ * @brief מימוש טבעת הרשומות על flash גולמי
+ *
+ * כל הפונקציות נקראות מ-task אחד (ה-task הכותב של ההקלטות).
+ */
+
+#include "hal/flash_ring.h"
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+// =============================================================================
+// Platform-Specific Includes
+// =============================================================================
+
+#ifdef ESP32
+    #include "esp_partition.h"
+    #include "esp_timer.h"
+    #include "esp_log.h"
+
+    static const char* TAG = "FLASH_RING";
+    #define LOG_INFO(fmt, ...) ESP_LOGI(TAG, fmt, ##__VA_ARGS__)
+    #define LOG_ERROR(fmt, ...) ESP_LOGE(TAG, fmt, ##__VA_ARGS__)
+    #define GET_MICROS() ((uint32_t)esp_timer_get_time())
+#else
+    #define LOG_INFO(fmt, ...) printf("[FLASH_RING] " fmt "\n", ##__VA_ARGS__)
+    #define LOG_ERROR(fmt, ...) printf("[FLASH_RING ERROR] " fmt "\n", ##__VA_ARGS__)
+    static uint32_t sim_micros(void) {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint32_t)(ts.tv_sec * 1000000 + ts.tv_nsec / 1000);
+    }
+    #define GET_MICROS() sim_micros()
+#endif
+
+// =============================================================================
+// Internal State
+// =============================================================================
+
+#define SECTOR_MAGIC        0x47525457      // "WTRG"
+#define ERASED_BYTE         0xFF
+
+typedef struct {
+    uint32_t magic;
+    uint32_t seq;
+    uint32_t tag;
+    uint32_t reserved;
+} sector_header_t;
+
+static bool g_ready = false;
+
+#ifdef ESP32
+static const esp_partition_t* g_partition = NULL;
+#else
+static FILE* g_sim = NULL;
+#endif
+
+static uint32_t g_sectors = 0;
+static uint32_t g_head = 0;             // אינדקס הסקטור הנוכחי
+static uint32_t g_head_seq = 1;
+static uint32_t g_head_used = 0;        // רשומות בסקטור הנוכחי
+static bool     g_head_open = false;    // כותרת הסקטור הנוכחי כבר נכתבה
+static bool     g_need_new = false;     // begin() - הרשומה הבאה בסקטור חדש
+static uint32_t g_tag = 0;
+static uint32_t g_erased_ahead = 0;     // סקטורים מחוקים אחרי הראש
+
+static flash_ring_stats_t g_stats;
+
+// =============================================================================
+// Low-Level Flash Access
+// =============================================================================
+
+#ifdef ESP32
+
+static bool flash_read(uint32_t offset, void* buf, uint32_t len) {
+    return esp_partition_read(g_partition, offset, buf, len) == ESP_OK;
+}
+
+static bool flash_write(uint32_t offset, const void* buf, uint32_t len) {
+    return esp_partition_write(g_partition, offset, buf, len) == ESP_OK;
+}
+
+static bool flash_erase(uint32_t sector) {
+    return esp_partition_erase_range(g_partition, sector * FLASH_RING_SECTOR_SIZE,
+                                     FLASH_RING_SECTOR_SIZE) == ESP_OK;
+}
+
+static bool flash_open(const char* label) {
+    g_partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                           ESP_PARTITION_SUBTYPE_ANY, label);
+    if (!g_partition) {
+        return false;
+    }
+    g_sectors = g_partition->size / FLASH_RING_SECTOR_SIZE;
+    return true;
+}
+
+static void flash_close(void) {
+    g_partition = NULL;
+}
+
+#else
+
+// קובץ בגודל המחיצה; מחיקה = 0xFF, כמו ב-NOR flash
+static bool flash_read(uint32_t offset, void* buf, uint32_t len) {
+    return fseek(g_sim, (long)offset, SEEK_SET) == 0 && fread(buf, 1, len, g_sim) == len;
+}
+
+static bool flash_write(uint32_t offset, const void* buf, uint32_t len) {
+    bool ok = fseek(g_sim, (long)offset, SEEK_SET) == 0 && fwrite(buf, 1, len, g_sim) == len;
+    fflush(g_sim);
+    return ok;
+}
+
+static bool flash_erase(uint32_t sector) {
+    uint8_t erased[FLASH_RING_SECTOR_SIZE];
+    memset(erased, ERASED_BYTE, sizeof(erased));
+    return flash_write(sector * FLASH_RING_SECTOR_SIZE, erased, sizeof(erased));
+}
+
+static bool flash_open(const char* label) {
+    (void)label;
+    g_sim = fopen(FLASH_RING_SIM_FILE, "r+b");
+    if (!g_sim) {
+        g_sim = fopen(FLASH_RING_SIM_FILE, "w+b");
+        if (!g_sim) return false;
+        g_sectors = FLASH_RING_SIM_SIZE / FLASH_RING_SECTOR_SIZE;
+        for (uint32_t s = 0; s < g_sectors; s++) {
+            flash_erase(s);
+        }
+        return true;
+    }
+    fseek(g_sim, 0, SEEK_END);
+    g_sectors = (uint32_t)ftell(g_sim) / FLASH_RING_SECTOR_SIZE;
+    return true;
+}
+
+static void flash_close(void) {
+    if (g_sim) {
+        fclose(g_sim);
+        g_sim = NULL;
+    }
+}
+
+#endif
+
+static inline uint32_t sector_offset(uint32_t sector) {
+    return sector * FLASH_RING_SECTOR_SIZE;
+}
+
+static inline uint32_t record_offset(uint32_t sector, uint32_t index) {
+    return sector_offset(sector) + (index + 1) * FLASH_RING_RECORD_SIZE;
+}
+
+static bool erase_sector(uint32_t sector) {
+    if (!flash_erase(sector)) {
+        g_stats.write_errors++;
+        return false;
+    }
+    g_stats.sectors_erased++;
+    return true;
+}
+
+static bool read_header(uint32_t sector, sector_header_t* header) {
+    return flash_read(sector_offset(sector), header, sizeof(*header)) &&
+           header->magic == SECTOR_MAGIC;
+}
+
+// הסקטור של מספר סידורי - רק אם עוד לא נדרס
+static bool seq_to_sector(uint32_t seq, uint32_t* sector) {
+    uint32_t age = g_head_seq - seq;
+    if (seq > g_head_seq || age >= g_sectors - g_erased_ahead) {
+        return false;
+    }
+    *sector = (g_head + g_sectors - age) % g_sectors;
+
+    sector_header_t header;
+    return read_header(*sector, &header) && header.seq == seq;
+}
+
+// =============================================================================
+// Mount
+// =============================================================================
+
+/**
+ * הראש הוא הסקטור עם המספר הסידורי הגבוה ביותר; בתוכו - העמוד
+ * הריק הראשון. סריקה של כותרת אחת לכל סקטור, פעם אחת באתחול.
+ */
+static void find_head(void) {
+    sector_header_t header;
+    bool found = false;
+
+    for (uint32_t s = 0; s < g_sectors; s++) {
+        if (read_header(s, &header) && (!found || header.seq > g_head_seq)) {
+            g_head = s;
+            g_head_seq = header.seq;
+            g_tag = header.tag;
+            found = true;
+        }
+    }
+
+    if (!found) {
+        g_head = 0;
+        g_head_seq = 1;
+        g_head_used = 0;
+        g_head_open = false;
+        erase_sector(g_head);
+        return;
+    }
+
+    g_head_open = true;
+    g_head_used = 0;
+    uint8_t first;
+    while (g_head_used < FLASH_RING_RECORDS_PER_SECTOR &&
+           flash_read(record_offset(g_head, g_head_used), &first, 1) &&
+           first != ERASED_BYTE) {
+        g_head_used++;
+    }
+
+    // עמוד שנכתב חלקית בנפילת מתח לא נראה ריק - לא כותבים עליו שוב
+    g_need_new = true;
+}
+
+// =============================================================================
+// API
+// =============================================================================
+
+bool flash_ring_init(const char* label) {
+    if (g_ready) return true;
+
+    memset(&g_stats, 0, sizeof(g_stats));
+
+    if (!label || !flash_open(label)) {
+        LOG_ERROR("Partition '%s' not found", label ? label : "");
+        return false;
+    }
+
+    if (g_sectors < FLASH_RING_MIN_SECTORS) {
+        LOG_ERROR("Partition too small (%u sectors)", (unsigned)g_sectors);
+        flash_close();
+        return false;
+    }
+
+    find_head();
+
+    // אחרי אתחול לא יודעים מה נמחק - מוחקים מחדש את מה שלפני הראש
+    g_erased_ahead = 0;
+    flash_ring_maintain();
+
+    g_stats.sector_count = g_sectors;
+    g_ready = true;
+
+    LOG_INFO("Flash ring: %u sectors (%u KB), head seq %u",
+             (unsigned)g_sectors, (unsigned)(g_sectors * FLASH_RING_SECTOR_SIZE / 1024),
+             (unsigned)g_head_seq);
+    return true;
+}
+
+void flash_ring_deinit(void) {
+    flash_close();
+    g_ready = false;
+}
+
+bool flash_ring_is_ready(void) {
+    return g_ready;
+}
+
+uint32_t flash_ring_begin(uint32_t tag) {
+    g_tag = tag;
+    g_need_new = g_head_open;
+    return g_head_open ? g_head_seq + 1 : g_head_seq;
+}
+
+bool flash_ring_append(const void* record) {
+    if (!g_ready || !record) return false;
+
+    uint32_t start = GET_MICROS();
+
+    if (g_head_open && (g_head_used == FLASH_RING_RECORDS_PER_SECTOR || g_need_new)) {
+        g_head = (g_head + 1) % g_sectors;
+        g_head_seq++;
+        g_head_used = 0;
+        g_head_open = false;
+        g_need_new = false;
+
+        if (g_erased_ahead > 0) {
+            g_erased_ahead--;
+        } else {
+            // maintain לא נקרא בזמן - מחיקה בנתיב הכתיבה
+            g_stats.inline_erases++;
+            erase_sector(g_head);
+        }
+    }
+
+    if (!g_head_open) {
+        sector_header_t header = { SECTOR_MAGIC, g_head_seq, g_tag, 0 };
+        if (!flash_write(sector_offset(g_head), &header, sizeof(header))) {
+            g_stats.write_errors++;
+            return false;
+        }
+        g_head_open = true;
+    }
+
+    if (!flash_write(record_offset(g_head, g_head_used), record, FLASH_RING_RECORD_SIZE)) {
+        g_stats.write_errors++;
+        return false;
+    }
+    g_head_used++;
+    g_stats.records_written++;
+
+    uint32_t elapsed = GET_MICROS() - start;
+    if (elapsed > g_stats.max_append_us) {
+        g_stats.max_append_us = elapsed;
+    }
+    return true;
+}
+
+void flash_ring_maintain(void) {
+    while (g_erased_ahead < FLASH_RING_ERASE_AHEAD) {
+        uint32_t sector = (g_head + 1 + g_erased_ahead) % g_sectors;
+        if (!erase_sector(sector)) {
+            return;
+        }
+        g_erased_ahead++;
+    }
+}
+
+uint32_t flash_ring_head_seq(void) {
+    return g_head_seq;
+}
+
+uint32_t flash_ring_oldest_seq(void) {
+    uint32_t span = g_sectors - FLASH_RING_ERASE_AHEAD;
+    return (g_head_seq > span) ? g_head_seq - span + 1 : 1;
+}
+
+bool flash_ring_sector_tag(uint32_t seq, uint32_t* tag) {
+    uint32_t sector;
+    sector_header_t header;
+
+    if (!g_ready || !seq_to_sector(seq, &sector) || !read_header(sector, &header)) {
+        return false;
+    }
+    if (tag) *tag = header.tag;
+    return true;
+}
+
+uint32_t flash_ring_read_sector(uint32_t seq, void* records) {
+    uint32_t sector;
+
+    if (!g_ready || !records || !seq_to_sector(seq, &sector)) {
+        return 0;
+    }
+    if (!flash_read(record_offset(sector, 0), records,
+                    FLASH_RING_RECORDS_PER_SECTOR * FLASH_RING_RECORD_SIZE)) {
+        return 0;
+    }
+
+    const uint8_t* bytes = (const uint8_t*)records;
+    uint32_t count = 0;
+    while (count < FLASH_RING_RECORDS_PER_SECTOR &&
+           bytes[count * FLASH_RING_RECORD_SIZE] != ERASED_BYTE) {
+        count++;
+    }
+    return count;
+}
+
+void flash_ring_get_stats(flash_ring_stats_t* stats) {
+    if (stats) {
+        *stats = g_stats;
+    }
+}
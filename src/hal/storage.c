@@ -4,10 +4,13 @@
  */
 
 #include "hal/storage.h"
+#include "core/rec_catalog.h"
 #include "config.h"
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <time.h>
+#include <unistd.h>
 
 // =============================================================================
 // Platform-Specific Includes
@@ -21,6 +24,8 @@
     #include "driver/sdmmc_host.h"
     #include "driver/sdspi_host.h"
     #include "sdmmc_cmd.h"
+    #include "diskio_impl.h"
+    #include "diskio_sdmmc.h"
     #include "esp_timer.h"
     
     static const char* TAG = "STORAGE";
@@ -30,7 +35,6 @@
 #else
     #include <sys/stat.h>
     #include <dirent.h>
-    #include <unistd.h>
     #define LOG_INFO(fmt, ...) printf("[STORAGE] " fmt "\n", ##__VA_ARGS__)
     #define LOG_ERROR(fmt, ...) printf("[STORAGE ERROR] " fmt "\n", ##__VA_ARGS__)
     #define LOG_DEBUG(fmt, ...)
@@ -86,6 +90,9 @@ static bool g_spiffs_mounted = false;
 static sdmmc_card_t* g_sd_card = NULL;
 #endif
 
+static bool g_sd_raw = false;           // FAT מנותק - הכרטיס אצל USB MSC
+static uint32_t g_sd_open_files = 0;    // קבצים פתוחים ב-SD (מכמה tasks)
+
 // =============================================================================
 // Platform-Specific Implementation
 // =============================================================================
@@ -198,6 +205,86 @@ storage_error_t storage_sd_get_info(storage_info_t* info) {
     return STORAGE_OK;
 }
 
+// -----------------------------------------------------------------------------
+// ESP32: SD Raw Sectors
+// -----------------------------------------------------------------------------
+
+static void sd_drive_name(char* drv, BYTE pdrv) {
+    drv[0] = (char)('0' + pdrv);
+    drv[1] = ':';
+    drv[2] = '\0';
+}
+
+storage_error_t storage_sd_raw_begin(uint32_t* sector_count) {
+    if (!g_sd_mounted || !g_sd_card) {
+        return STORAGE_ERROR_NOT_MOUNTED;
+    }
+    
+    // ניתוק מתחת לקובץ פתוח משאיר FIL מת ו-FAT שהמחשב והמכשיר כותבים יחד
+    if (!g_sd_raw && __atomic_load_n(&g_sd_open_files, __ATOMIC_ACQUIRE) > 0) {
+        LOG_ERROR("SD busy: %u open files", (unsigned)g_sd_open_files);
+        return STORAGE_ERROR_BUSY;
+    }
+    
+    if (!g_sd_raw) {
+        // כמו esp_vfs_fat_sdcard_unmount, בלי לכבות את הכרטיס וה-SPI
+        char drv[3];
+        BYTE pdrv = ff_diskio_get_pdrv_card(g_sd_card);
+        sd_drive_name(drv, pdrv);
+        f_mount(NULL, drv, 0);
+        esp_vfs_fat_unregister_path(SD_MOUNT_POINT);
+        ff_diskio_unregister(pdrv);
+        g_sd_raw = true;
+        LOG_INFO("SD filesystem detached for USB");
+    }
+    
+    if (sector_count) {
+        *sector_count = (uint32_t)g_sd_card->csd.capacity;
+    }
+    return STORAGE_OK;
+}
+
+storage_error_t storage_sd_read_sectors(void* dst, uint32_t sector, uint32_t count) {
+    if (!g_sd_raw) return STORAGE_ERROR_NOT_MOUNTED;
+    
+    // sdmmc_read_sectors שולח CMD18 אחד כשהבאפר מתאים ל-DMA
+    return (sdmmc_read_sectors(g_sd_card, dst, sector, count) == ESP_OK)
+           ? STORAGE_OK : STORAGE_ERROR_READ;
+}
+
+storage_error_t storage_sd_write_sectors(const void* src, uint32_t sector, uint32_t count) {
+    if (!g_sd_raw) return STORAGE_ERROR_NOT_MOUNTED;
+    
+    return (sdmmc_write_sectors(g_sd_card, src, sector, count) == ESP_OK)
+           ? STORAGE_OK : STORAGE_ERROR_WRITE;
+}
+
+void storage_sd_raw_end(void) {
+    if (!g_sd_raw) {
+        return;
+    }
+    
+    char drv[3];
+    BYTE pdrv = ff_diskio_get_pdrv_card(g_sd_card);
+    if (pdrv == 0xFF) {
+        ff_diskio_get_drive(&pdrv);
+    }
+    sd_drive_name(drv, pdrv);
+    
+    FATFS* fs = NULL;
+    ff_diskio_register_sdmmc(pdrv, g_sd_card);
+    if (esp_vfs_fat_register(SD_MOUNT_POINT, drv, 5, &fs) != ESP_OK ||
+        f_mount(fs, drv, 1) != FR_OK) {
+        LOG_ERROR("Failed to re-attach SD filesystem");
+        g_sd_mounted = false;
+    }
+    g_sd_raw = false;
+    
+    // המחשב יכול היה להוסיף או למחוק הקלטות
+    rec_catalog_rebuild();
+    LOG_INFO("SD filesystem re-attached");
+}
+
 // -----------------------------------------------------------------------------
 // ESP32: SPIFFS
 // -----------------------------------------------------------------------------
@@ -327,6 +414,73 @@ storage_error_t storage_sd_get_info(storage_info_t* info) {
     return STORAGE_OK;
 }
 
+// תמונת דיסק שטוחה - הסימולטור שומר את ה-SD כתיקייה, המחשב רואה דיסק ריק
+#define SD_SIM_IMAGE        "./simulated_sd.img"
+#define SD_SIM_SECTORS      (32u * 1024 * 1024 / STORAGE_SD_SECTOR_SIZE)
+
+static FILE* g_sd_image = NULL;
+
+storage_error_t storage_sd_raw_begin(uint32_t* sector_count) {
+    if (!g_sd_mounted) {
+        return STORAGE_ERROR_NOT_MOUNTED;
+    }
+    
+    if (!g_sd_raw && __atomic_load_n(&g_sd_open_files, __ATOMIC_ACQUIRE) > 0) {
+        LOG_ERROR("SD busy: %u open files", (unsigned)g_sd_open_files);
+        return STORAGE_ERROR_BUSY;
+    }
+    
+    if (!g_sd_image) {
+        g_sd_image = fopen(SD_SIM_IMAGE, "r+b");
+        if (!g_sd_image) {
+            g_sd_image = fopen(SD_SIM_IMAGE, "w+b");
+        }
+        if (!g_sd_image || ftruncate(fileno(g_sd_image),
+                                     (off_t)SD_SIM_SECTORS * STORAGE_SD_SECTOR_SIZE) != 0) {
+            LOG_ERROR("Cannot open %s", SD_SIM_IMAGE);
+            if (g_sd_image) fclose(g_sd_image);
+            g_sd_image = NULL;
+            return STORAGE_ERROR_READ;
+        }
+    }
+    
+    g_sd_raw = true;
+    if (sector_count) {
+        *sector_count = SD_SIM_SECTORS;
+    }
+    return STORAGE_OK;
+}
+
+storage_error_t storage_sd_read_sectors(void* dst, uint32_t sector, uint32_t count) {
+    if (!g_sd_raw) return STORAGE_ERROR_NOT_MOUNTED;
+    if (sector + count > SD_SIM_SECTORS || sector + count < sector) return STORAGE_ERROR_READ;
+    
+    if (fseeko(g_sd_image, (off_t)sector * STORAGE_SD_SECTOR_SIZE, SEEK_SET) != 0 ||
+        fread(dst, STORAGE_SD_SECTOR_SIZE, count, g_sd_image) != count) {
+        return STORAGE_ERROR_READ;
+    }
+    return STORAGE_OK;
+}
+
+storage_error_t storage_sd_write_sectors(const void* src, uint32_t sector, uint32_t count) {
+    if (!g_sd_raw) return STORAGE_ERROR_NOT_MOUNTED;
+    if (sector + count > SD_SIM_SECTORS || sector + count < sector) return STORAGE_ERROR_WRITE;
+    
+    if (fseeko(g_sd_image, (off_t)sector * STORAGE_SD_SECTOR_SIZE, SEEK_SET) != 0 ||
+        fwrite(src, STORAGE_SD_SECTOR_SIZE, count, g_sd_image) != count) {
+        return STORAGE_ERROR_WRITE;
+    }
+    return STORAGE_OK;
+}
+
+void storage_sd_raw_end(void) {
+    if (g_sd_image) {
+        fclose(g_sd_image);
+        g_sd_image = NULL;
+    }
+    g_sd_raw = false;
+}
+
 storage_error_t storage_spiffs_mount(void) {
     g_spiffs_mounted = true;
     mkdir("./simulated_spiffs", 0775);
@@ -421,12 +575,19 @@ storage_error_t storage_file_open(storage_file_t* file, const char* path, file_m
     
     memset(file, 0, sizeof(storage_file_t));
     
+    storage_type_t type = storage_get_type_from_path(path);
+    if (type == STORAGE_TYPE_SD && g_sd_raw) {
+        LOG_ERROR("SD is attached to USB: %s", path);
+        return STORAGE_ERROR_NOT_MOUNTED;
+    }
+    
     const char* mode_str;
     switch (mode) {
         case FILE_MODE_READ:       mode_str = "rb"; break;
         case FILE_MODE_WRITE:      mode_str = "wb"; break;
         case FILE_MODE_APPEND:     mode_str = "ab"; break;
         case FILE_MODE_READ_WRITE: mode_str = "r+b"; break;
+        case FILE_MODE_WRITE_STREAM: mode_str = "wb"; break;
         default: return STORAGE_ERROR_INVALID_PATH;
     }
     
@@ -436,6 +597,12 @@ storage_error_t storage_file_open(storage_file_t* file, const char* path, file_m
         return STORAGE_ERROR_NOT_FOUND;
     }
     
+    // הכותב מגיש בלוקים מלאים - באפר stdio רק היה מפצל אותם ומעתיק פעמיים
+    // (חייב לקרות לפני כל פעולה אחרת על ה-stream)
+    if (mode == FILE_MODE_WRITE_STREAM) {
+        setvbuf(fp, NULL, _IONBF, 0);
+    }
+    
     // Get file size
     fseek(fp, 0, SEEK_END);
     file->size = ftell(fp);
@@ -445,7 +612,10 @@ storage_error_t storage_file_open(storage_file_t* file, const char* path, file_m
     file->mode = mode;
     file->position = 0;
     file->is_open = true;
-    file->type = storage_get_type_from_path(path);
+    file->type = type;
+    if (type == STORAGE_TYPE_SD) {
+        __atomic_add_fetch(&g_sd_open_files, 1, __ATOMIC_RELEASE);
+    }
     
     LOG_DEBUG("Opened file: %s (size: %u)", path, file->size);
     
@@ -460,6 +630,9 @@ void storage_file_close(storage_file_t* file) {
     fclose((FILE*)file->handle);
     file->handle = NULL;
     file->is_open = false;
+    if (file->type == STORAGE_TYPE_SD) {
+        __atomic_sub_fetch(&g_sd_open_files, 1, __ATOMIC_RELEASE);
+    }
     
     LOG_DEBUG("Closed file");
 }
@@ -512,7 +685,12 @@ storage_error_t storage_file_sync(storage_file_t* file) {
         return STORAGE_ERROR_NOT_FOUND;
     }
     
-    fflush((FILE*)file->handle);
+    // fflush מרוקן רק את stdio; fsync מעדכן את ה-FAT ואת רשומת התיקייה
+    FILE* fp = (FILE*)file->handle;
+    fflush(fp);
+    if (file->mode != FILE_MODE_READ && fsync(fileno(fp)) != 0) {
+        return STORAGE_ERROR_WRITE;
+    }
     return STORAGE_OK;
 }
 
@@ -523,6 +701,49 @@ bool storage_file_eof(storage_file_t* file) {
     return feof((FILE*)file->handle) != 0;
 }
 
+storage_error_t storage_file_preallocate(storage_file_t* file, uint32_t size) {
+    if (!file || !file->is_open) {
+        return STORAGE_ERROR_NOT_FOUND;
+    }
+    if (size <= file->size) {
+        return STORAGE_OK;
+    }
+    
+    FILE* fp = (FILE*)file->handle;
+    
+    // בית אחד בסוף - FAT מקצה את כל שרשרת ה-clusters עד אליו
+    if (fseek(fp, (long)(size - 1), SEEK_SET) != 0 || fputc(0, fp) == EOF) {
+        fseek(fp, (long)file->position, SEEK_SET);
+        LOG_ERROR("Preallocate failed (%u bytes)", size);
+        return STORAGE_ERROR_NO_SPACE;
+    }
+    fflush(fp);
+    
+    file->size = size;
+    fseek(fp, (long)file->position, SEEK_SET);
+    return STORAGE_OK;
+}
+
+storage_error_t storage_file_truncate(storage_file_t* file, uint32_t size) {
+    if (!file || !file->is_open) {
+        return STORAGE_ERROR_NOT_FOUND;
+    }
+    
+    FILE* fp = (FILE*)file->handle;
+    fflush(fp);
+    
+    if (ftruncate(fileno(fp), (off_t)size) != 0) {
+        LOG_ERROR("Truncate failed (%u bytes)", size);
+        return STORAGE_ERROR_WRITE;
+    }
+    
+    file->size = size;
+    if (file->position > size) {
+        storage_file_seek(file, (int32_t)size, SEEK_SET);
+    }
+    return STORAGE_OK;
+}
+
 // =============================================================================
 // File Management
 // =============================================================================
@@ -565,29 +786,46 @@ storage_error_t storage_file_copy(const char* src_path, const char* dst_path) {
     if (!src_path || !dst_path) return STORAGE_ERROR_INVALID_PATH;
     
     storage_file_t src, dst;
-    uint8_t buffer[STORAGE_BUFFER_SIZE];
     
     if (storage_file_open(&src, src_path, FILE_MODE_READ) != STORAGE_OK) {
         return STORAGE_ERROR_NOT_FOUND;
     }
     
-    if (storage_file_open(&dst, dst_path, FILE_MODE_WRITE) != STORAGE_OK) {
+    if (storage_file_open(&dst, dst_path, FILE_MODE_WRITE_STREAM) != STORAGE_OK) {
         storage_file_close(&src);
         return STORAGE_ERROR_CREATE;
     }
     
+    // בלוקים גדולים - בבלוק של 512 בתים כל העתקה היא אלפי פניות ל-FAT
+    uint8_t fallback[STORAGE_BUFFER_SIZE];
+    uint8_t* buffer = malloc(STORAGE_IO_BLOCK_SIZE);
+    uint32_t buffer_size = STORAGE_IO_BLOCK_SIZE;
+    if (!buffer) {
+        buffer = fallback;
+        buffer_size = sizeof(fallback);
+    }
+    
+    storage_file_preallocate(&dst, src.size);
+    
+    storage_error_t ret = STORAGE_OK;
     int32_t bytes;
-    while ((bytes = storage_file_read(&src, buffer, sizeof(buffer))) > 0) {
+    while ((bytes = storage_file_read(&src, buffer, buffer_size)) > 0) {
         if (storage_file_write(&dst, buffer, bytes) != bytes) {
-            storage_file_close(&src);
-            storage_file_close(&dst);
-            return STORAGE_ERROR_WRITE;
+            ret = STORAGE_ERROR_WRITE;
+            break;
         }
     }
     
+    if (buffer != fallback) {
+        free(buffer);
+    }
     storage_file_close(&src);
     storage_file_close(&dst);
     
+    if (ret != STORAGE_OK) {
+        return ret;
+    }
+    
     LOG_INFO("Copied: %s -> %s", src_path, dst_path);
     return STORAGE_OK;
 }
@@ -596,38 +834,104 @@ storage_error_t storage_file_copy(const char* src_path, const char* dst_path) {
 // Recording Management
 // =============================================================================
 
-storage_error_t storage_recording_start(storage_file_t* file) {
-    if (!file) return STORAGE_ERROR_INVALID_PATH;
-    
-    char filename[STORAGE_MAX_PATH_LENGTH];
-    char path[STORAGE_MAX_PATH_LENGTH];
+storage_error_t storage_recording_dir(char* path, size_t path_size) {
+    if (!path || path_size == 0) return STORAGE_ERROR_INVALID_PATH;
     
-    storage_generate_recording_name(filename, sizeof(filename));
+    // הכרטיס אצל המחשב - לא עוברים בשקט ל-SPIFFS (קטלוג והקלטות נכשלים)
+    if (g_sd_raw) {
+        return STORAGE_ERROR_NOT_MOUNTED;
+    }
     
     // Prefer SD card, fall back to SPIFFS
     if (g_sd_mounted) {
-        snprintf(path, sizeof(path), "%s%s/%s", 
-                 SD_MOUNT_POINT, STORAGE_RECORDING_DIR, filename);
+        snprintf(path, path_size, "%s%s", SD_MOUNT_POINT, STORAGE_RECORDING_DIR);
     } else if (g_spiffs_mounted) {
-        snprintf(path, sizeof(path), "%s%s/%s", 
-                 SPIFFS_MOUNT_POINT, STORAGE_RECORDING_DIR, filename);
+        snprintf(path, path_size, "%s%s", SPIFFS_MOUNT_POINT, STORAGE_RECORDING_DIR);
     } else {
         return STORAGE_ERROR_NOT_MOUNTED;
     }
+    return STORAGE_OK;
+}
+
+storage_error_t storage_recording_create(storage_file_t* file, const char* extension,
+                                         char* path_out, size_t path_size) {
+    if (!file) return STORAGE_ERROR_INVALID_PATH;
+    if (!extension) extension = RECORDING_EXTENSION;
+    
+    char filename[STORAGE_MAX_FILENAME_LENGTH];
+    char dir[STORAGE_MAX_PATH_LENGTH];
+    char path[STORAGE_MAX_PATH_LENGTH];
     
-    storage_error_t ret = storage_file_open(file, path, FILE_MODE_WRITE);
+    storage_error_t ret = storage_recording_dir(dir, sizeof(dir));
+    if (ret != STORAGE_OK) {
+        return ret;
+    }
+    
+    // הסיומת ש-generate מוסיף מוחלפת בסיומת של הפורמט
+    storage_generate_recording_name(filename, sizeof(filename));
+    char* dot = strrchr(filename, '.');
+    if (dot) *dot = '\0';
+    size_t base_len = strlen(filename);
+    
+    // שתי הקלטות באותה שנייה - סיומת מספרית במקום לדרוס
+    snprintf(path, sizeof(path), "%s/%s%s", dir, filename, extension);
+    for (int n = 1; n < 10 && storage_file_exists(path); n++) {
+        snprintf(filename + base_len, sizeof(filename) - base_len, "_%d", n);
+        snprintf(path, sizeof(path), "%s/%s%s", dir, filename, extension);
+    }
+    
+    ret = storage_file_open(file, path, FILE_MODE_WRITE_STREAM);
+    if (ret != STORAGE_OK) {
+        return ret;
+    }
+    
+    if (path_out && path_size > 0) {
+        strncpy(path_out, path, path_size - 1);
+        path_out[path_size - 1] = '\0';
+    }
+    
+    LOG_INFO("Created recording: %s", path);
+    return STORAGE_OK;
+}
+
+storage_error_t storage_recording_get_path(const char* filename, char* path, size_t path_size) {
+    if (!filename || !path || path_size == 0) return STORAGE_ERROR_INVALID_PATH;
+    
+    // אין תיקיות בשם - רק קבצים מתיקיית ההקלטות
+    if (strchr(filename, '/') || strstr(filename, "..")) {
+        return STORAGE_ERROR_INVALID_PATH;
+    }
+    
+    if (g_sd_mounted) {
+        snprintf(path, path_size, "%s%s/%s", SD_MOUNT_POINT, STORAGE_RECORDING_DIR, filename);
+        if (storage_file_exists(path)) return STORAGE_OK;
+    }
+    
+    if (g_spiffs_mounted) {
+        snprintf(path, path_size, "%s%s/%s", SPIFFS_MOUNT_POINT, STORAGE_RECORDING_DIR, filename);
+        if (storage_file_exists(path)) return STORAGE_OK;
+    }
+    
+    return STORAGE_ERROR_NOT_FOUND;
+}
+
+storage_error_t storage_recording_start(storage_file_t* file, uint32_t sample_rate) {
+    if (!file) return STORAGE_ERROR_INVALID_PATH;
+    if (sample_rate == 0) sample_rate = AUDIO_RECORD_RATE;
+    
+    storage_error_t ret = storage_recording_create(file, RECORDING_EXTENSION, NULL, 0);
     if (ret != STORAGE_OK) {
         return ret;
     }
     
     // Write placeholder WAV header
-    ret = storage_wav_write_header(file, 8000, 16, 1);
+    ret = storage_wav_write_header(file, (uint16_t)sample_rate, 16, 1);
     if (ret != STORAGE_OK) {
         storage_file_close(file);
         return ret;
     }
     
-    LOG_INFO("Started recording: %s", filename);
+    LOG_INFO("Started WAV recording (%u Hz)", (unsigned)sample_rate);
     return STORAGE_OK;
 }
 
@@ -652,24 +956,89 @@ storage_error_t storage_recording_finish(storage_file_t* file, uint32_t sample_c
     return STORAGE_OK;
 }
 
+/*
+ * רשימה, מחיקה וסטטיסטיקות עוברות דרך הקטלוג (core/rec_catalog.h) -
+ * בלי לסרוק את התיקייה ובלי לפתוח קבצי הקלטה.
+ */
+int32_t storage_recording_list(recording_info_t* recordings, uint32_t max_count) {
+    if (!recordings) return 0;
+    
+    rec_catalog_entry_t entries[8];
+    uint32_t total = 0;
+    
+    while (total < max_count) {
+        uint32_t want = max_count - total;
+        if (want > 8) want = 8;
+        
+        uint32_t n = rec_catalog_get_page(total, entries, NULL, want);
+        for (uint32_t i = 0; i < n; i++) {
+            recording_info_t* info = &recordings[total + i];
+            const char* ext = strrchr(entries[i].name, '.');
+            
+            memset(info, 0, sizeof(*info));
+            strncpy(info->filename, entries[i].name, sizeof(info->filename) - 1);
+            info->duration_ms = entries[i].duration_ms;
+            info->size_bytes = entries[i].size_bytes;
+            info->timestamp = entries[i].timestamp;
+            info->sample_rate = (uint16_t)entries[i].sample_rate;
+            info->channels = 1;
+            info->bits_per_sample = (ext && strcmp(ext, REC_EXTENSION) == 0) ? 4 : 16;
+        }
+        total += n;
+        if (n < want) break;
+    }
+    
+    return (int32_t)total;
+}
+
+storage_error_t storage_recording_delete(const char* filename) {
+    if (!filename) return STORAGE_ERROR_INVALID_PATH;
+    
+    int32_t id = rec_catalog_find(filename);
+    if (id < 0) {
+        return STORAGE_ERROR_NOT_FOUND;
+    }
+    return rec_catalog_delete(id) ? STORAGE_OK : STORAGE_ERROR_DELETE;
+}
+
+storage_error_t storage_recording_delete_all(void) {
+    rec_catalog_entry_t entry;
+    int32_t id;
+    
+    // תמיד הראשונה בדף - הקטלוג נדחס תוך כדי
+    while (rec_catalog_get_page(0, &entry, &id, 1) == 1) {
+        if (!rec_catalog_delete(id)) {
+            return STORAGE_ERROR_DELETE;
+        }
+    }
+    return STORAGE_OK;
+}
+
+uint32_t storage_recording_total_size(void) {
+    return rec_catalog_total_size();
+}
+
+uint32_t storage_recording_count(void) {
+    return rec_catalog_count();
+}
+
 // =============================================================================
 // WAV File Helpers
 // =============================================================================
 
-storage_error_t storage_wav_write_header(storage_file_t* file, 
-                                         uint16_t sample_rate,
-                                         uint8_t bits_per_sample,
-                                         uint8_t channels) {
-    if (!file || !file->is_open) {
-        return STORAGE_ERROR_NOT_FOUND;
-    }
+uint32_t storage_wav_build_header(uint8_t* buffer,
+                                  uint32_t sample_rate,
+                                  uint8_t bits_per_sample,
+                                  uint8_t channels,
+                                  uint32_t data_size) {
+    if (!buffer) return 0;
     
     wav_header_t header;
     memset(&header, 0, sizeof(header));
     
     // RIFF chunk
     memcpy(header.riff_tag, "RIFF", 4);
-    header.riff_size = 0;  // Will be updated later
+    header.riff_size = data_size + WAV_HEADER_SIZE - 8;
     memcpy(header.wave_tag, "WAVE", 4);
     
     // Format chunk
@@ -684,9 +1053,25 @@ storage_error_t storage_wav_write_header(storage_file_t* file,
     
     // Data chunk
     memcpy(header.data_tag, "data", 4);
-    header.data_size = 0;  // Will be updated later
+    header.data_size = data_size;
+    
+    memcpy(buffer, &header, sizeof(header));
+    return sizeof(header);
+}
+
+storage_error_t storage_wav_write_header(storage_file_t* file, 
+                                         uint16_t sample_rate,
+                                         uint8_t bits_per_sample,
+                                         uint8_t channels) {
+    if (!file || !file->is_open) {
+        return STORAGE_ERROR_NOT_FOUND;
+    }
+    
+    // הגדלים יעודכנו בסיום (storage_wav_update_header)
+    uint8_t header[WAV_HEADER_SIZE];
+    storage_wav_build_header(header, sample_rate, bits_per_sample, channels, 0);
     
-    if (storage_file_write(file, &header, sizeof(header)) != sizeof(header)) {
+    if (storage_file_write(file, header, sizeof(header)) != sizeof(header)) {
         return STORAGE_ERROR_WRITE;
     }
     
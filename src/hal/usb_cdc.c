@@ -4,10 +4,21 @@
  */
 
 #include "hal/usb_cdc.h"
+#include "hal/usb_proto.h"
+#include "hal/usb_tap.h"
+#include "hal/usb_msc.h"
+#include "hal/storage.h"
+#include "core/rec_format.h"
+#include "core/rec_catalog.h"
+#include "core/recorder.h"
+#include "core/telemetry.h"
+#include "core/trace.h"
+#include "core/tasks.h"
 #include "config.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdarg.h>
+#include <stdlib.h>
 
 // =============================================================================
 // Platform-Specific Includes
@@ -16,11 +27,12 @@
 #ifdef ESP32
     #include "esp_log.h"
     #include "driver/gpio.h"
+    #include "freertos/FreeRTOS.h"
+    #include "freertos/semphr.h"
     
     #if defined(CONFIG_TINYUSB_ENABLED) || defined(ESP32S3)
         #include "tinyusb.h"
         #include "tusb_cdc_acm.h"
-        #include "tusb_msc_storage.h"
         #define USB_SUPPORTED 1
     #else
         #define USB_SUPPORTED 0
@@ -49,13 +61,20 @@ static usb_state_t g_state = USB_STATE_DISCONNECTED;
 static usb_cdc_rx_callback_t g_rx_callback = NULL;
 static usb_state_callback_t g_state_callback = NULL;
 
-static uint8_t g_rx_buffer[USB_CDC_BUFFER_SIZE];
-static size_t g_rx_head = 0;
-static size_t g_rx_tail = 0;
+// טבעת SPSC: head נכתב רק ב-rx_pull (תחת g_rx_mutex), tail רק בלופ הראשי.
+// אינדקסים רצים (uint32) - המילוי הוא head - tail גם אחרי גלישה.
+// טבעת מלאה לא זורקת: משאירים את הנתונים ב-TinyUSB (ה-endpoint עוצר את
+// המחשב), והצרכן מושך את השאר אחרי שפינה מקום
+_Static_assert((USB_CDC_RX_RING_SIZE & (USB_CDC_RX_RING_SIZE - 1)) == 0, "rx ring size must be a power of 2");
+static uint8_t g_rx_buffer[USB_CDC_RX_RING_SIZE];
+static uint32_t g_rx_head = 0;
+static uint32_t g_rx_tail = 0;
+static uint32_t g_rx_stalls = 0;
 
 static char g_serial_number[32] = "";
 
 static uint32_t g_bytes_sent = 0;
+static bool g_tx_pending = false;       // נתונים בתור שעוד לא נשלחו (flush)
 static uint32_t g_bytes_received = 0;
 
 // =============================================================================
@@ -64,35 +83,67 @@ static uint32_t g_bytes_received = 0;
 
 #if USB_SUPPORTED && defined(ESP32)
 
+static SemaphoreHandle_t g_rx_mutex = NULL;
+static bool g_rx_stalled = false;       // נשארו נתונים ב-TinyUSB כי הטבעת התמלאה
+
+/**
+ * מעתיק מ-TinyUSB למקום הפנוי בטבעת - עד שני קטעים רציפים.
+ * נקרא מה-callback ומהצרכן, ולכן תחת g_rx_mutex.
+ */
+static void rx_pull(void) {
+    while (1) {
+        uint32_t head = g_rx_head;
+        uint32_t tail = __atomic_load_n(&g_rx_tail, __ATOMIC_SEQ_CST);
+        uint32_t offset = head & (USB_CDC_RX_RING_SIZE - 1);
+        size_t span = USB_CDC_RX_RING_SIZE - (head - tail);
+        if (span > USB_CDC_RX_RING_SIZE - offset) span = USB_CDC_RX_RING_SIZE - offset;
+        
+        if (span == 0) {
+            // מסמנים ובודקים שוב: אם הצרכן פינה בינתיים הוא לא ראה את הסימון
+            if (!g_rx_stalled) g_rx_stalls++;
+            __atomic_store_n(&g_rx_stalled, true, __ATOMIC_SEQ_CST);
+            if (__atomic_load_n(&g_rx_tail, __ATOMIC_SEQ_CST) != tail) {
+                continue;
+            }
+            break;
+        }
+        
+        size_t rx_size = 0;
+        tinyusb_cdcacm_read(TINYUSB_CDC_ACM_0, &g_rx_buffer[offset], span, &rx_size);
+        if (rx_size == 0) {
+            break;
+        }
+        __atomic_store_n(&g_rx_head, head + (uint32_t)rx_size, __ATOMIC_RELEASE);
+        g_bytes_received += rx_size;
+        
+        if (g_rx_callback) {
+            g_rx_callback(&g_rx_buffer[offset], rx_size);
+        }
+    }
+}
+
 // TinyUSB callbacks
 static void cdc_rx_callback(int itf, cdcacm_event_t* event) {
     (void)itf;
+    if (event->type != CDC_EVENT_RX) {
+        return;
+    }
     
-    if (event->type == CDC_EVENT_RX) {
-        uint8_t buf[64];
-        size_t rx_size = 0;
-        
-        // Read from TinyUSB
-        tinyusb_cdcacm_read(itf, buf, sizeof(buf), &rx_size);
-        
-        if (rx_size > 0) {
-            g_bytes_received += rx_size;
-            
-            // Store in ring buffer
-            for (size_t i = 0; i < rx_size; i++) {
-                size_t next = (g_rx_head + 1) % USB_CDC_BUFFER_SIZE;
-                if (next != g_rx_tail) {
-                    g_rx_buffer[g_rx_head] = buf[i];
-                    g_rx_head = next;
-                }
-            }
-            
-            // Call user callback
-            if (g_rx_callback) {
-                g_rx_callback(buf, rx_size);
-            }
-        }
+    xSemaphoreTake(g_rx_mutex, portMAX_DELAY);
+    __atomic_store_n(&g_rx_stalled, false, __ATOMIC_SEQ_CST);
+    rx_pull();
+    xSemaphoreGive(g_rx_mutex);
+}
+
+// הצרכן פינה מקום - מושכים את מה שחיכה ב-TinyUSB (אין callback חדש עליו)
+static void rx_resume(void) {
+    if (!__atomic_load_n(&g_rx_stalled, __ATOMIC_SEQ_CST)) {
+        return;
     }
+    xSemaphoreTake(g_rx_mutex, portMAX_DELAY);
+    __atomic_store_n(&g_rx_stalled, false, __ATOMIC_SEQ_CST);
+    rx_pull();
+    xSemaphoreGive(g_rx_mutex);
 }
 
 static void cdc_line_state_callback(int itf, cdcacm_event_t* event) {
@@ -111,6 +162,10 @@ static void cdc_line_state_callback(int itf, cdcacm_event_t* event) {
     }
 }
 
+#else
+
+static void rx_resume(void) {}
+
 #endif
 
 // =============================================================================
@@ -155,6 +210,14 @@ bool usb_init(usb_mode_t mode) {
     
     // Initialize CDC
     if (mode == USB_MODE_CDC || mode == USB_MODE_CDC_MSC) {
+        if (!g_rx_mutex) {
+            g_rx_mutex = xSemaphoreCreateMutex();
+            if (!g_rx_mutex) {
+                LOG_ERROR("Failed to create CDC rx mutex");
+                return false;
+            }
+        }
+        
         tinyusb_config_cdcacm_t acm_cfg = {
             .usb_dev = TINYUSB_USBDEV_0,
             .cdc_port = TINYUSB_CDC_ACM_0,
@@ -176,9 +239,10 @@ bool usb_init(usb_mode_t mode) {
     
     // Initialize MSC
     if (mode == USB_MODE_MSC || mode == USB_MODE_CDC_MSC) {
-        // MSC initialization depends on storage backend
-        // This would be configured based on SD card or SPIFFS
-        LOG_INFO("MSC initialization (placeholder)");
+        // ה-class של TinyUSB פעיל מ-Kconfig; הדיסק עצמו נפתח ב-usb_msc_enable
+        if (!usb_msc_disk_open()) {
+            LOG_ERROR("MSC disk unavailable");
+        }
     }
     
 #else
@@ -197,6 +261,9 @@ void usb_deinit(void) {
         return;
     }
     
+    // מטמון הכתיבה ל-SD וה-FAT חוזר לקושחה
+    usb_msc_disk_close();
+    
 #if USB_SUPPORTED && defined(ESP32)
     // Deinitialize TinyUSB components
 #endif
@@ -242,6 +309,7 @@ void usb_get_info(usb_info_t* info) {
     info->msc_connected = usb_msc_is_connected();
     info->bytes_sent = g_bytes_sent;
     info->bytes_received = g_bytes_received;
+    info->rx_stalls = g_rx_stalls;
     strncpy(info->serial_number, g_serial_number, sizeof(info->serial_number) - 1);
 }
 
@@ -262,18 +330,26 @@ int32_t usb_cdc_write(const uint8_t* data, size_t length) {
     }
     
 #if USB_SUPPORTED && defined(ESP32)
+    // רק לתור - ה-flush מאוחד ב-usb_update, או כשה-FIFO מתמלא
     size_t written = 0;
-    esp_err_t ret = tinyusb_cdcacm_write_queue(TINYUSB_CDC_ACM_0, data, length);
-    if (ret == ESP_OK) {
-        tinyusb_cdcacm_write_flush(TINYUSB_CDC_ACM_0, 0);
-        written = length;
+    while (written < length) {
+        size_t queued = tinyusb_cdcacm_write_queue(TINYUSB_CDC_ACM_0, data + written,
+                                                   length - written);
+        written += queued;
+        if (written < length &&
+            tinyusb_cdcacm_write_flush(TINYUSB_CDC_ACM_0,
+                                       pdMS_TO_TICKS(USB_CDC_WRITE_TIMEOUT_MS)) != ESP_OK &&
+            queued == 0) {
+            break;      // המחשב לא קורא
+        }
     }
+    g_tx_pending = true;
     g_bytes_sent += written;
     return written;
 #else
-    // Simulator: write to stdout
+    // Simulator: write to stdout (flushed in usb_update)
     fwrite(data, 1, length, stdout);
-    fflush(stdout);
+    g_tx_pending = true;
     g_bytes_sent += length;
     return length;
 #endif
@@ -297,18 +373,43 @@ int32_t usb_cdc_printf(const char* format, ...) {
     return 0;
 }
 
+// מה שממתין בטבעת; head עם acquire - הבתים שלפניו כבר כתובים
+static uint32_t rx_fill(uint32_t* tail) {
+    *tail = g_rx_tail;
+    return __atomic_load_n(&g_rx_head, __ATOMIC_ACQUIRE) - *tail;
+}
+
+// העתקה מהטבעת בשני קטעים לכל היותר, ושחרור המקום ל-callback
+static void rx_take(uint8_t* buffer, uint32_t tail, uint32_t length) {
+    uint32_t offset = tail & (USB_CDC_RX_RING_SIZE - 1);
+    uint32_t first = USB_CDC_RX_RING_SIZE - offset;
+    if (first > length) first = length;
+    
+    memcpy(buffer, &g_rx_buffer[offset], first);
+    memcpy(buffer + first, g_rx_buffer, length - first);
+    __atomic_store_n(&g_rx_tail, tail + length, __ATOMIC_SEQ_CST);
+    rx_resume();
+}
+
+// סוף שורה (\n או \r) בקטע רציף
+static const uint8_t* find_eol(const uint8_t* data, size_t length) {
+    const uint8_t* lf = memchr(data, '\n', length);
+    const uint8_t* cr = memchr(data, '\r', lf ? (size_t)(lf - data) : length);
+    return cr ? cr : lf;
+}
+
 int32_t usb_cdc_read(uint8_t* buffer, size_t max_length) {
     if (!buffer || max_length == 0) {
         return 0;
     }
     
-    size_t count = 0;
-    while (count < max_length && g_rx_tail != g_rx_head) {
-        buffer[count++] = g_rx_buffer[g_rx_tail];
-        g_rx_tail = (g_rx_tail + 1) % USB_CDC_BUFFER_SIZE;
+    uint32_t tail;
+    uint32_t count = rx_fill(&tail);
+    if (count > max_length) count = (uint32_t)max_length;
+    if (count > 0) {
+        rx_take(buffer, tail, count);
     }
-    
-    return count;
+    return (int32_t)count;
 }
 
 int32_t usb_cdc_readline(char* buffer, size_t max_length) {
@@ -316,38 +417,51 @@ int32_t usb_cdc_readline(char* buffer, size_t max_length) {
         return 0;
     }
     
-    size_t count = 0;
-    while (count < max_length - 1 && g_rx_tail != g_rx_head) {
-        char c = g_rx_buffer[g_rx_tail];
-        g_rx_tail = (g_rx_tail + 1) % USB_CDC_BUFFER_SIZE;
-        
-        buffer[count++] = c;
-        
-        if (c == '\n') {
-            break;
-        }
+    uint32_t tail;
+    uint32_t avail = rx_fill(&tail);
+    uint32_t limit = (uint32_t)max_length - 1;
+    if (limit > avail) limit = avail;
+    
+    // חיפוש בשני הקטעים הרציפים של הטבעת
+    uint32_t offset = tail & (USB_CDC_RX_RING_SIZE - 1);
+    uint32_t first = USB_CDC_RX_RING_SIZE - offset;
+    if (first > limit) first = limit;
+    
+    uint32_t count = 0;
+    const uint8_t* eol = find_eol(&g_rx_buffer[offset], first);
+    if (eol) {
+        count = (uint32_t)(eol - &g_rx_buffer[offset]) + 1;
+    } else if ((eol = find_eol(g_rx_buffer, limit - first)) != NULL) {
+        count = first + (uint32_t)(eol - g_rx_buffer) + 1;
+    } else if (limit == max_length - 1) {
+        count = limit;      // שורה ארוכה מהבאפר - בחלקים
     }
     
+    if (count > 0) {
+        rx_take((uint8_t*)buffer, tail, count);
+    }
     buffer[count] = '\0';
-    return count;
+    return (int32_t)count;
 }
 
 int32_t usb_cdc_available(void) {
-    if (g_rx_head >= g_rx_tail) {
-        return g_rx_head - g_rx_tail;
-    }
-    return USB_CDC_BUFFER_SIZE - g_rx_tail + g_rx_head;
+    uint32_t tail;
+    return (int32_t)rx_fill(&tail);
 }
 
 void usb_cdc_flush_rx(void) {
-    g_rx_head = 0;
-    g_rx_tail = 0;
+    // רק הצרכן זז - ה-callback יכול להמשיך לכתוב באותו זמן
+    __atomic_store_n(&g_rx_tail, __atomic_load_n(&g_rx_head, __ATOMIC_ACQUIRE), __ATOMIC_SEQ_CST);
+    rx_resume();
 }
 
 void usb_cdc_flush_tx(void) {
 #if USB_SUPPORTED && defined(ESP32)
     tinyusb_cdcacm_write_flush(TINYUSB_CDC_ACM_0, pdMS_TO_TICKS(100));
+#else
+    fflush(stdout);
 #endif
+    g_tx_pending = false;
 }
 
 void usb_cdc_set_rx_callback(usb_cdc_rx_callback_t callback) {
@@ -362,8 +476,11 @@ bool usb_msc_is_connected(void) {
     if (!g_initialized || g_mode == USB_MODE_NONE || g_mode == USB_MODE_CDC) {
         return false;
     }
-    // MSC connection state would come from TinyUSB
-    return false;
+#if USB_SUPPORTED && defined(ESP32)
+    return usb_msc_disk_is_open() && tud_mounted();
+#else
+    return usb_msc_disk_is_open();
+#endif
 }
 
 bool usb_msc_enable(void) {
@@ -371,28 +488,28 @@ bool usb_msc_enable(void) {
         return false;
     }
     
-    LOG_INFO("Enabling MSC mode");
-    
-#if USB_SUPPORTED && defined(ESP32)
-    // Configure MSC with SD card backend
-    // This requires tinyusb_msc component
-#endif
+    // ה-FAT מתנתק - אסור שההקלטה תכתוב ל-SD בזמן שהמחשב מחזיק בו.
+    // הטבעת ב-flash לא נוגעת בכרטיס; קובץ פתוח אחר נבדק ב-storage_sd_raw_begin
+    if (recorder_is_active() && !recorder_uses_ring()) {
+        LOG_ERROR("MSC refused: recording in progress");
+        return false;
+    }
     
-    return true;
+    LOG_INFO("Enabling MSC mode");
+    return usb_msc_disk_open();
 }
 
 void usb_msc_disable(void) {
     LOG_INFO("Disabling MSC mode");
+    usb_msc_disk_close();
 }
 
 bool usb_msc_is_writing(void) {
-    return false;  // Would check TinyUSB MSC state
+    return usb_msc_disk_dirty();
 }
 
 void usb_msc_sync(void) {
-#if USB_SUPPORTED && defined(ESP32)
-    // Sync filesystem
-#endif
+    usb_msc_disk_flush();
 }
 
 // =============================================================================
@@ -440,6 +557,63 @@ void usb_set_serial_number(const char* serial) {
 // Command Processing
 // =============================================================================
 
+// ייצוא בזרימה - ה-WAV לא נבנה בזיכרון או על הכרטיס
+static bool export_output(const uint8_t* data, uint32_t length, void* ctx) {
+    (void)ctx;
+    return usb_cdc_write(data, length) == (int32_t)length;
+}
+
+/**
+ * @brief ייצוא הקלטה כ-WAV: שורת "OK <bytes>" ואחריה בדיוק <bytes> בתים
+ */
+static bool export_recording(const char* filename, char* response, size_t response_size) {
+    char path[STORAGE_MAX_PATH_LENGTH];
+    static rec_reader_t reader;
+    
+    if (storage_recording_get_path(filename, path, sizeof(path)) != STORAGE_OK) {
+        snprintf(response, response_size, "ERROR: Recording not found\n");
+        return false;
+    }
+    
+    if (!rec_reader_open(&reader, path)) {
+        snprintf(response, response_size, "ERROR: Not a recording file\n");
+        return false;
+    }
+    
+    usb_cdc_printf("OK %u\n", (unsigned)rec_export_wav_size(&reader));
+    bool ok = rec_export_wav(&reader, export_output, NULL);
+    rec_reader_close(&reader);
+    
+    if (!ok) {
+        LOG_ERROR("Export aborted: %s", filename);
+    }
+    return ok;
+}
+
+#define USB_LIST_PAGE_SIZE  6           // נכנס בתשובה של 512 בתים
+
+/**
+ * @brief דף מרשימת ההקלטות (מהחדשה לישנה), שורה לכל הקלטה
+ */
+static bool list_recordings(const char* arg, char* response, size_t response_size) {
+    rec_catalog_entry_t entries[USB_LIST_PAGE_SIZE];
+    uint32_t page = (uint32_t)strtoul(arg, NULL, 10);
+    uint32_t total = rec_catalog_count();
+    uint32_t n = rec_catalog_get_page(page * USB_LIST_PAGE_SIZE, entries, NULL,
+                                      USB_LIST_PAGE_SIZE);
+    
+    int len = snprintf(response, response_size, "OK %u/%u\n", (unsigned)n, (unsigned)total);
+    for (uint32_t i = 0; i < n && len > 0 && (size_t)len < response_size; i++) {
+        len += snprintf(response + len, response_size - len, "%s %u %u %u %s\n",
+                        entries[i].name,
+                        (unsigned)entries[i].timestamp,
+                        (unsigned)entries[i].duration_ms,
+                        (unsigned)entries[i].size_bytes,
+                        entries[i].peer_id[0] ? entries[i].peer_id : "-");
+    }
+    return true;
+}
+
 bool usb_process_command(const char* cmd, char* response, size_t response_size) {
     if (!cmd || !response || response_size == 0) {
         return false;
@@ -465,9 +639,10 @@ bool usb_process_command(const char* cmd, char* response, size_t response_size)
                  "  \"usb_mode\": %d,\n"
                  "  \"usb_state\": %d,\n"
                  "  \"bytes_tx\": %u,\n"
-                 "  \"bytes_rx\": %u\n"
+                 "  \"bytes_rx\": %u,\n"
+                 "  \"rx_stalls\": %u\n"
                  "}\n",
-                 g_mode, g_state, g_bytes_sent, g_bytes_received);
+                 g_mode, g_state, g_bytes_sent, g_bytes_received, g_rx_stalls);
         return true;
     }
     
@@ -479,11 +654,96 @@ bool usb_process_command(const char* cmd, char* response, size_t response_size)
         return true;
     }
     
+    if (strncmp(cmd, "EXPORT ", 7) == 0) {
+        return export_recording(cmd + 7, response, response_size);
+    }
+    
+    if (strncmp(cmd, "LIST", 4) == 0) {
+        return list_recordings(cmd + 4, response, response_size);
+    }
+    
+    if (strncmp(cmd, "DELETE ", 7) == 0) {
+        if (storage_recording_delete(cmd + 7) != STORAGE_OK) {
+            snprintf(response, response_size, "ERROR: Recording not found\n");
+            return false;
+        }
+        snprintf(response, response_size, "OK\n");
+        return true;
+    }
+    
+    if (strncmp(cmd, "TAP", 3) == 0) {
+        usb_tap_stats_t stats;
+        if (cmd[3] == ' ') {
+            usb_tap_set_mask((uint32_t)strtoul(cmd + 4, NULL, 0));
+        }
+        usb_tap_get_stats(&stats);
+        int len = snprintf(response, response_size, "OK TAP 0x%02X\n", (unsigned)stats.mask);
+        for (int tap = 0; tap < USB_TAP_COUNT && len > 0 && (size_t)len < response_size; tap++) {
+            len += snprintf(response + len, response_size - len, "  %d: sent %u dropped %u\n", tap,
+                            (unsigned)stats.records_sent[tap], (unsigned)stats.records_dropped[tap]);
+        }
+        return true;
+    }
+    
+    if (strncmp(cmd, "METRICS", 7) == 0) {
+        telemetry_format(response, response_size);
+        if (strcmp(cmd + 7, " RESET") == 0) {
+            telemetry_reset_histograms();
+        }
+        return true;
+    }
+    
+    if (strncmp(cmd, "TRACE", 5) == 0) {
+        trace_stats_t stats;
+        if (strcmp(cmd + 5, " START") == 0) {
+            if (!trace_start()) {
+                snprintf(response, response_size, "ERROR: Tracing not available\n");
+                return false;
+            }
+        } else if (strcmp(cmd + 5, " STOP") == 0) {
+            trace_stop();
+        } else if (strcmp(cmd + 5, " DUMP") == 0) {
+            // JSON ישר ל-CDC עד השורה "]}"
+            usb_cdc_print("OK\n");
+            return trace_export_json(export_output, NULL);
+        }
+        trace_get_stats(&stats);
+        snprintf(response, response_size, "OK %s %u/%u events\n",
+                 stats.running ? "running" : "stopped",
+                 (unsigned)stats.events[0], (unsigned)stats.events[1]);
+        return true;
+    }
+    
+    if (strncmp(cmd, "TASKS", 5) == 0) {
+        static system_stats_t stats;
+        tasks_get_stats(&stats);
+        int len = snprintf(response, response_size, "OK heap %u min %u internal_min %u\n",
+                           (unsigned)stats.free_heap, (unsigned)stats.min_free_heap,
+                           (unsigned)stats.min_free_internal);
+        for (uint8_t id = 0; id < TASK_ID_COUNT && len > 0 && (size_t)len < response_size; id++) {
+            const task_stats_t* t = tasks_stats_of(&stats, id);
+            if (!t->name) continue;
+            len += snprintf(response + len, response_size - len,
+                            "  %-12s stack %u/%u cpu %u%% avg %uus loops %u stalls %u\n",
+                            t->name, (unsigned)t->high_watermark, (unsigned)t->stack_size,
+                            (unsigned)t->cpu_percent, (unsigned)t->avg_runtime_us,
+                            (unsigned)t->run_count, (unsigned)t->error_count);
+        }
+        return true;
+    }
+    
     if (strncmp(cmd, "HELP", 4) == 0) {
         snprintf(response, response_size,
                  "Available commands:\n"
                  "  INFO    - Device information\n"
                  "  STATUS  - Current status\n"
+                 "  LIST [page] - Recordings, newest first\n"
+                 "  EXPORT <file> - Download recording as WAV\n"
+                 "  DELETE <file> - Delete recording\n"
+                 "  TAP [mask] - Live audio taps (1 mic, 2 dsp, 4 tx, 8 rx, 16 out)\n"
+                 "  METRICS [RESET] - Counters and latency percentiles\n"
+                 "  TRACE [START|STOP|DUMP] - Hot-path trace (Chrome JSON)\n"
+                 "  TASKS   - Stack high-water marks, CPU and watchdog\n"
                  "  REBOOT  - Restart device\n"
                  "  HELP    - This help\n");
         return true;
@@ -493,11 +753,27 @@ bool usb_process_command(const char* cmd, char* response, size_t response_size)
     return false;
 }
 
+static bool rx_peek(uint8_t* byte) {
+    uint32_t tail;
+    if (rx_fill(&tail) == 0) {
+        return false;
+    }
+    *byte = g_rx_buffer[tail & (USB_CDC_RX_RING_SIZE - 1)];
+    return true;
+}
+
 void usb_command_loop(void) {
     if (!usb_cdc_is_connected()) {
         return;
     }
     
+    // מסגרת בינארית (או המשך שלה) - לפני שורות טקסט
+    uint8_t first;
+    if (usb_proto_busy() || (rx_peek(&first) && first == USB_PROTO_SYNC0)) {
+        usb_proto_poll();
+        return;
+    }
+    
     if (usb_cdc_available() > 0) {
         char cmd[128];
         int len = usb_cdc_readline(cmd, sizeof(cmd));
@@ -509,7 +785,8 @@ void usb_command_loop(void) {
             }
             
             if (len > 0) {
-                char response[512];
+                // METRICS ארוך מדי למחסנית של 512
+                static char response[1024];
                 usb_process_command(cmd, response, sizeof(response));
                 usb_cdc_print(response);
             }
@@ -529,6 +806,22 @@ void usb_update(void) {
     // Process any pending data
     usb_command_loop();
     
+    // אודיו חי שהצטבר מאז הסבב הקודם
+    usb_tap_poll();
+    
+    // מטמון הכתיבה של MSC יוצא ל-SD כשהמחשב מפסיק לכתוב
+    usb_msc_disk_update();
+    
+    // flush אחד לכל סבב - כתיבות קטנות מתאחדות לחבילות מלאות
+    if (g_tx_pending) {
+#if USB_SUPPORTED && defined(ESP32)
+        tinyusb_cdcacm_write_flush(TINYUSB_CDC_ACM_0, 0);
+#else
+        fflush(stdout);
+#endif
+        g_tx_pending = false;
+    }
+    
     // Update state if needed
 #if USB_SUPPORTED && defined(ESP32)
     // TinyUSB handles most of this internally
@@ -0,0 +1,447 @@
+/**
+ * @file usb_msc.c
+ * @brief מימוש דיסק ה-USB Mass Storage מעל סקטורי ה-SD
+ */
+
+#include "hal/usb_msc.h"
+#include "hal/usb_cdc.h"
+#include "hal/storage.h"
+#include <stdlib.h>
+#include <string.h>
+
+// =============================================================================
+// Platform-Specific
+// =============================================================================
+
+#ifdef ESP32
+    #include "esp_log.h"
+    #include "esp_timer.h"
+    #include "esp_heap_caps.h"
+    #include "freertos/FreeRTOS.h"
+    #include "freertos/semphr.h"
+
+    #if (defined(CONFIG_TINYUSB_ENABLED) || defined(ESP32S3)) && defined(CONFIG_TINYUSB_MSC_ENABLED)
+        #include "tusb.h"
+        #define MSC_SUPPORTED 1
+    #else
+        #define MSC_SUPPORTED 0
+    #endif
+
+    static const char* TAG = "USB_MSC";
+    #define LOG_INFO(fmt, ...) ESP_LOGI(TAG, fmt, ##__VA_ARGS__)
+    #define LOG_ERROR(fmt, ...) ESP_LOGE(TAG, fmt, ##__VA_ARGS__)
+    #define GET_MILLIS() ((uint32_t)(esp_timer_get_time() / 1000))
+
+    // המטמונים הם יעד/מקור של DMA ב-SPI
+    #define MSC_ALLOC(size) heap_caps_malloc((size), MALLOC_CAP_DMA)
+    #define MSC_FREE(ptr)   heap_caps_free(ptr)
+
+    static SemaphoreHandle_t g_mutex = NULL;
+    #define MSC_LOCK()   xSemaphoreTake(g_mutex, portMAX_DELAY)
+    #define MSC_UNLOCK() xSemaphoreGive(g_mutex)
+#else
+    #include <stdio.h>
+    #include <time.h>
+    #define MSC_SUPPORTED 0
+    #define LOG_INFO(fmt, ...) printf("[USB_MSC] " fmt "\n", ##__VA_ARGS__)
+    #define LOG_ERROR(fmt, ...) printf("[USB_MSC ERROR] " fmt "\n", ##__VA_ARGS__)
+    static uint32_t sim_millis(void) {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (ts.tv_sec * 1000) + (ts.tv_nsec / 1000000);
+    }
+    #define GET_MILLIS() sim_millis()
+
+    #define MSC_ALLOC(size) malloc(size)
+    #define MSC_FREE(ptr)   free(ptr)
+
+    #define MSC_LOCK()
+    #define MSC_UNLOCK()
+#endif
+
+_Static_assert(USB_MSC_SECTOR_SIZE == STORAGE_SD_SECTOR_SIZE, "MSC block size must match the SD sector");
+
+// =============================================================================
+// Internal State
+// =============================================================================
+
+static bool g_open = false;
+static bool g_ejected = false;
+static uint32_t g_sectors = 0;
+
+// חלון קריאה מוקדמת - עותק נקי של סקטורים רצופים
+static uint8_t* g_window = NULL;
+static uint32_t g_window_first = 0;
+static uint32_t g_window_count = 0;
+
+// מטמון כתיבה - רצף סקטורים סמוכים שעוד לא נכתב
+static uint8_t* g_cache = NULL;
+static uint32_t g_cache_first = 0;
+static uint32_t g_cache_count = 0;
+static uint32_t g_last_write_ms = 0;
+
+static usb_msc_stats_t g_stats;
+
+// =============================================================================
+// SD Transfers
+// =============================================================================
+
+static bool sd_read(uint32_t sector, void* buffer, uint32_t count) {
+    g_stats.sd_transfers++;
+    if (storage_sd_read_sectors(buffer, sector, count) != STORAGE_OK) {
+        g_stats.errors++;
+        LOG_ERROR("Read failed: %u+%u", (unsigned)sector, (unsigned)count);
+        return false;
+    }
+    return true;
+}
+
+static bool sd_write(uint32_t sector, const void* buffer, uint32_t count) {
+    g_stats.sd_transfers++;
+    if (storage_sd_write_sectors(buffer, sector, count) != STORAGE_OK) {
+        g_stats.errors++;
+        LOG_ERROR("Write failed: %u+%u", (unsigned)sector, (unsigned)count);
+        return false;
+    }
+    return true;
+}
+
+static bool overlaps(uint32_t a_first, uint32_t a_count, uint32_t b_first, uint32_t b_count) {
+    return a_count > 0 && b_count > 0 &&
+           a_first < b_first + b_count && b_first < a_first + a_count;
+}
+
+// =============================================================================
+// Write Cache
+// =============================================================================
+
+static bool cache_flush(void) {
+    if (g_cache_count == 0) {
+        return true;
+    }
+
+    bool ok = sd_write(g_cache_first, g_cache, g_cache_count);
+    g_stats.write_flushes++;
+    g_cache_count = 0;
+    return ok;
+}
+
+// עדכון החלון בנתונים שנכתבו - קריאה אחרי כתיבה רואה את החדש
+static void window_patch(uint32_t sector, const uint8_t* data, uint32_t count) {
+    if (!overlaps(sector, count, g_window_first, g_window_count)) {
+        return;
+    }
+
+    uint32_t first = (sector > g_window_first) ? sector : g_window_first;
+    uint32_t end = sector + count;
+    if (end > g_window_first + g_window_count) end = g_window_first + g_window_count;
+
+    memcpy(&g_window[(first - g_window_first) * USB_MSC_SECTOR_SIZE],
+           &data[(first - sector) * USB_MSC_SECTOR_SIZE],
+           (end - first) * USB_MSC_SECTOR_SIZE);
+}
+
+static bool disk_write(uint32_t sector, const uint8_t* data, uint32_t count) {
+    window_patch(sector, data, count);
+    g_stats.write_sectors += count;
+    g_last_write_ms = GET_MILLIS();
+
+    // כתיבה גדולה ממילא יוצאת ב-CMD25 אחד - ישר, אחרי מה שלפניה
+    if (count >= USB_MSC_WRITE_CACHE_SECTORS) {
+        return cache_flush() && sd_write(sector, data, count);
+    }
+
+    // המשך (או כתיבה חוזרת) של הרצף שבמטמון
+    bool joins = g_cache_count > 0 &&
+                 sector >= g_cache_first &&
+                 sector <= g_cache_first + g_cache_count &&
+                 sector + count <= g_cache_first + USB_MSC_WRITE_CACHE_SECTORS;
+    if (!joins) {
+        if (!cache_flush()) {
+            return false;
+        }
+        g_cache_first = sector;
+    }
+
+    memcpy(&g_cache[(sector - g_cache_first) * USB_MSC_SECTOR_SIZE], data,
+           count * USB_MSC_SECTOR_SIZE);
+    if (sector + count - g_cache_first > g_cache_count) {
+        g_cache_count = sector + count - g_cache_first;
+    }
+
+    return (g_cache_count < USB_MSC_WRITE_CACHE_SECTORS) || cache_flush();
+}
+
+// =============================================================================
+// Read-Ahead
+// =============================================================================
+
+static bool disk_read(uint32_t sector, uint8_t* data, uint32_t count) {
+    // המחשב קורא מה שכתב - לפני כן המטמון יוצא ל-SD
+    if (overlaps(sector, count, g_cache_first, g_cache_count) && !cache_flush()) {
+        return false;
+    }
+
+    while (count > 0) {
+        if (sector >= g_window_first && sector < g_window_first + g_window_count) {
+            uint32_t n = g_window_first + g_window_count - sector;
+            if (n > count) n = count;
+            memcpy(data, &g_window[(sector - g_window_first) * USB_MSC_SECTOR_SIZE],
+                   n * USB_MSC_SECTOR_SIZE);
+            g_stats.read_hits += n;
+            sector += n;
+            data += n * USB_MSC_SECTOR_SIZE;
+            count -= n;
+            continue;
+        }
+
+        // בקשה בגודל החלון ומעלה - CMD18 ישר לבאפר של TinyUSB
+        if (count >= USB_MSC_READAHEAD_SECTORS) {
+            g_stats.read_misses += count;
+            return sd_read(sector, data, count);
+        }
+
+        // החטאה: חלון חדש מהסקטור המבוקש קדימה
+        uint32_t fill = USB_MSC_READAHEAD_SECTORS;
+        if (fill > g_sectors - sector) fill = g_sectors - sector;
+        g_window_count = 0;
+        // גם מה שבמטמון ונופל בחלון - אחרת החלון יחזיק עותק ישן
+        if (overlaps(sector, fill, g_cache_first, g_cache_count) && !cache_flush()) {
+            return false;
+        }
+        if (!sd_read(sector, g_window, fill)) {
+            return false;
+        }
+        g_window_first = sector;
+        g_window_count = fill;
+
+        uint32_t n = (count < fill) ? count : fill;
+        memcpy(data, g_window, n * USB_MSC_SECTOR_SIZE);
+        g_stats.read_misses += n;
+        sector += n;
+        data += n * USB_MSC_SECTOR_SIZE;
+        count -= n;
+    }
+    return true;
+}
+
+// =============================================================================
+// API
+// =============================================================================
+
+bool usb_msc_disk_open(void) {
+    if (g_open) {
+        return true;
+    }
+
+#ifdef ESP32
+    if (!g_mutex) {
+        g_mutex = xSemaphoreCreateMutex();
+        if (!g_mutex) {
+            LOG_ERROR("Failed to create MSC mutex");
+            return false;
+        }
+    }
+#endif
+
+    g_window = (uint8_t*)MSC_ALLOC(USB_MSC_READAHEAD_SECTORS * USB_MSC_SECTOR_SIZE);
+    g_cache = (uint8_t*)MSC_ALLOC(USB_MSC_WRITE_CACHE_SECTORS * USB_MSC_SECTOR_SIZE);
+    if (!g_window || !g_cache) {
+        LOG_ERROR("No memory for MSC buffers");
+        usb_msc_disk_close();
+        return false;
+    }
+
+    storage_error_t ret = storage_sd_raw_begin(&g_sectors);
+    if (ret != STORAGE_OK || g_sectors == 0) {
+        if (ret == STORAGE_ERROR_BUSY) {
+            LOG_ERROR("SD card has open files");
+        } else {
+            LOG_ERROR("SD card not available for USB");
+        }
+        usb_msc_disk_close();
+        return false;
+    }
+
+    MSC_LOCK();
+    g_window_count = 0;
+    g_cache_count = 0;
+    g_ejected = false;
+    g_open = true;
+    MSC_UNLOCK();
+
+    LOG_INFO("MSC disk: %u sectors", (unsigned)g_sectors);
+    return true;
+}
+
+void usb_msc_disk_close(void) {
+    if (g_open) {
+        MSC_LOCK();
+        cache_flush();
+        g_open = false;
+        g_window_count = 0;
+        MSC_UNLOCK();
+
+        storage_sd_raw_end();
+        LOG_INFO("MSC disk closed: %u hits, %u misses, %u SD transfers",
+                 (unsigned)g_stats.read_hits, (unsigned)g_stats.read_misses,
+                 (unsigned)g_stats.sd_transfers);
+    }
+
+    if (g_window) {
+        MSC_FREE(g_window);
+        g_window = NULL;
+    }
+    if (g_cache) {
+        MSC_FREE(g_cache);
+        g_cache = NULL;
+    }
+}
+
+bool usb_msc_disk_is_open(void) {
+    return g_open && !g_ejected;
+}
+
+uint32_t usb_msc_disk_sectors(void) {
+    return g_open ? g_sectors : 0;
+}
+
+bool usb_msc_disk_read(uint32_t sector, void* buffer, uint32_t count) {
+    if (!g_open || !buffer || sector >= g_sectors || count > g_sectors - sector) {
+        return false;
+    }
+
+    MSC_LOCK();
+    bool ok = disk_read(sector, (uint8_t*)buffer, count);
+    MSC_UNLOCK();
+    return ok;
+}
+
+bool usb_msc_disk_write(uint32_t sector, const void* buffer, uint32_t count) {
+    if (!g_open || !buffer || sector >= g_sectors || count > g_sectors - sector) {
+        return false;
+    }
+
+    MSC_LOCK();
+    bool ok = disk_write(sector, (const uint8_t*)buffer, count);
+    MSC_UNLOCK();
+    return ok;
+}
+
+bool usb_msc_disk_flush(void) {
+    if (!g_open) {
+        return true;
+    }
+
+    MSC_LOCK();
+    bool ok = cache_flush();
+    MSC_UNLOCK();
+    return ok;
+}
+
+bool usb_msc_disk_dirty(void) {
+    return g_open && g_cache_count > 0;
+}
+
+void usb_msc_disk_update(void) {
+    if (!usb_msc_disk_dirty()) {
+        return;
+    }
+
+    MSC_LOCK();
+    if (g_cache_count > 0 && GET_MILLIS() - g_last_write_ms >= USB_MSC_FLUSH_IDLE_MS) {
+        cache_flush();
+    }
+    MSC_UNLOCK();
+}
+
+void usb_msc_disk_get_stats(usb_msc_stats_t* stats) {
+    if (stats) {
+        *stats = g_stats;
+    }
+}
+
+// =============================================================================
+// TinyUSB MSC Callbacks
+// =============================================================================
+
+#if MSC_SUPPORTED
+
+void tud_msc_inquiry_cb(uint8_t lun, uint8_t vendor_id[8], uint8_t product_id[16],
+                        uint8_t product_rev[4]) {
+    (void)lun;
+    memcpy(vendor_id, "WT-PRO  ", 8);
+    memcpy(product_id, "Recordings      ", 16);
+    memcpy(product_rev, "1.0 ", 4);
+}
+
+bool tud_msc_test_unit_ready_cb(uint8_t lun) {
+    (void)lun;
+    if (!usb_msc_disk_is_open()) {
+        tud_msc_set_sense(lun, SCSI_SENSE_NOT_READY, 0x3A, 0x00);   // medium not present
+        return false;
+    }
+    return true;
+}
+
+void tud_msc_capacity_cb(uint8_t lun, uint32_t* block_count, uint16_t* block_size) {
+    (void)lun;
+    *block_count = usb_msc_disk_sectors();
+    *block_size = USB_MSC_SECTOR_SIZE;
+}
+
+bool tud_msc_start_stop_cb(uint8_t lun, uint8_t power_condition, bool start, bool load_eject) {
+    (void)lun;
+    (void)power_condition;
+
+    // הוצאה מהמחשב - כל מה שבמטמון חייב להגיע ל-SD
+    if (load_eject && !start) {
+        usb_msc_disk_flush();
+        g_ejected = true;
+    }
+    return true;
+}
+
+int32_t tud_msc_read10_cb(uint8_t lun, uint32_t lba, uint32_t offset, void* buffer,
+                          uint32_t bufsize) {
+    (void)lun;
+
+    // CONFIG_TINYUSB_MSC_BUFSIZE הוא כפולה של סקטור - offset תמיד על גבול סקטור
+    if ((offset | bufsize) % USB_MSC_SECTOR_SIZE != 0 ||
+        !usb_msc_disk_read(lba + offset / USB_MSC_SECTOR_SIZE, buffer,
+                           bufsize / USB_MSC_SECTOR_SIZE)) {
+        return -1;
+    }
+    return (int32_t)bufsize;
+}
+
+int32_t tud_msc_write10_cb(uint8_t lun, uint32_t lba, uint32_t offset, uint8_t* buffer,
+                           uint32_t bufsize) {
+    (void)lun;
+
+    if ((offset | bufsize) % USB_MSC_SECTOR_SIZE != 0 ||
+        !usb_msc_disk_write(lba + offset / USB_MSC_SECTOR_SIZE, buffer,
+                            bufsize / USB_MSC_SECTOR_SIZE)) {
+        return -1;
+    }
+    return (int32_t)bufsize;
+}
+
+int32_t tud_msc_scsi_cb(uint8_t lun, uint8_t const scsi_cmd[16], void* buffer, uint16_t bufsize) {
+    (void)buffer;
+    (void)bufsize;
+
+    switch (scsi_cmd[0]) {
+        case 0x35:      // SYNCHRONIZE CACHE (10)
+            return usb_msc_disk_flush() ? 0 : -1;
+
+        case SCSI_CMD_PREVENT_ALLOW_MEDIUM_REMOVAL:
+            return 0;
+
+        default:
+            tud_msc_set_sense(lun, SCSI_SENSE_ILLEGAL_REQUEST, 0x20, 0x00);
+            return -1;
+    }
+}
+
+#endif // MSC_SUPPORTED
@@ -0,0 +1,464 @@
+/**
+ * @file usb_proto.c
+ * @brief מימוש הפרוטוקול הבינארי ב-USB CDC
+ */
+
+#include "hal/usb_proto.h"
+#include "hal/usb_cdc.h"
+#include "hal/usb_tap.h"
+#include "hal/storage.h"
+#include "core/rec_format.h"
+#include "core/rec_catalog.h"
+#include "core/telemetry.h"
+#include "core/trace.h"
+#include <string.h>
+#include <stdio.h>
+
+// =============================================================================
+// Platform-Specific
+// =============================================================================
+
+#ifdef ESP32
+    #include "esp_log.h"
+
+    static const char* TAG = "USB_PROTO";
+    #define LOG_ERROR(fmt, ...) ESP_LOGE(TAG, fmt, ##__VA_ARGS__)
+#else
+    #define LOG_ERROR(fmt, ...) fprintf(stderr, "[USB_PROTO ERROR] " fmt "\n", ##__VA_ARGS__)
+#endif
+
+// =============================================================================
+// Internal State
+// =============================================================================
+
+#define RX_FRAME_MAX    (USB_PROTO_HEADER_SIZE + USB_PROTO_MAX_REQUEST + USB_PROTO_CRC_SIZE)
+
+_Static_assert(sizeof(usb_frame_header_t) == USB_PROTO_HEADER_SIZE, "frame header size");
+
+// מסגרת נכנסת בהרכבה
+static uint8_t  g_rx_frame[RX_FRAME_MAX];
+static uint32_t g_rx_fill = 0;
+
+// זרם יוצא - מסגרת אחת בהרכבה
+static uint8_t  g_stream_buf[USB_PROTO_MAX_PAYLOAD];
+static uint32_t g_stream_fill = 0;
+
+// קריאת קבצים לזרם
+static uint8_t  g_io_buf[USB_PROTO_MAX_PAYLOAD];
+
+static usb_proto_stats_t g_stats;
+
+// =============================================================================
+// CRC
+// =============================================================================
+
+// טבלת nibbles - 32 בתים, ~2 חיפושים לבית
+static const uint16_t crc16_nibble[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+uint16_t usb_proto_crc16(uint16_t crc, const void* data, size_t length) {
+    const uint8_t* p = (const uint8_t*)data;
+
+    while (length--) {
+        crc = (uint16_t)((crc << 4) ^ crc16_nibble[(crc >> 12) ^ (*p >> 4)]);
+        crc = (uint16_t)((crc << 4) ^ crc16_nibble[(crc >> 12) ^ (*p & 0x0F)]);
+        p++;
+    }
+    return crc;
+}
+
+// =============================================================================
+// Sending
+// =============================================================================
+
+bool usb_proto_send(uint8_t type, uint8_t flags, uint16_t request_id,
+                    const void* payload, uint16_t length) {
+    if (length > USB_PROTO_MAX_PAYLOAD || (length > 0 && !payload)) {
+        return false;
+    }
+
+    usb_frame_header_t header = {
+        .sync = { USB_PROTO_SYNC0, USB_PROTO_SYNC1 },
+        .length = length,
+        .type = type,
+        .flags = flags,
+        .request_id = request_id
+    };
+
+    uint16_t crc = usb_proto_crc16(0xFFFF, (const uint8_t*)&header + 2, USB_PROTO_HEADER_SIZE - 2);
+    crc = usb_proto_crc16(crc, payload, length);
+
+    // שלוש כתיבות לתור - ה-flush מאוחד ב-usb_update
+    bool ok = usb_cdc_write((const uint8_t*)&header, sizeof(header)) == (int32_t)sizeof(header);
+    if (ok && length > 0) {
+        ok = usb_cdc_write((const uint8_t*)payload, length) == (int32_t)length;
+    }
+    ok = ok && usb_cdc_write((const uint8_t*)&crc, sizeof(crc)) == (int32_t)sizeof(crc);
+
+    if (ok) {
+        g_stats.frames_tx++;
+    }
+    return ok;
+}
+
+bool usb_proto_send_error(uint8_t type, uint16_t request_id, usb_proto_error_t error) {
+    uint16_t code = (uint16_t)error;
+    return usb_proto_send(type, USB_FRAME_FLAG_RESPONSE | USB_FRAME_FLAG_ERROR,
+                          request_id, &code, sizeof(code));
+}
+
+// =============================================================================
+// Streams
+// =============================================================================
+
+static uint8_t stream_flags(const usb_stream_t* stream) {
+    // זרם יזום (request_id 0) אינו תשובה
+    return USB_FRAME_FLAG_STREAM | (stream->request_id ? USB_FRAME_FLAG_RESPONSE : 0);
+}
+
+void usb_proto_stream_begin(usb_stream_t* stream, uint8_t type, uint16_t request_id) {
+    stream->type = type;
+    stream->request_id = request_id;
+    stream->total = 0;
+    stream->ok = true;
+    g_stream_fill = 0;
+}
+
+bool usb_proto_stream_write(usb_stream_t* stream, const void* data, uint32_t length) {
+    const uint8_t* p = (const uint8_t*)data;
+
+    while (stream->ok && length > 0) {
+        // מסגרת מלאה ישר מהבאפר של הקורא - בלי העתקה
+        if (g_stream_fill == 0 && length >= USB_PROTO_MAX_PAYLOAD) {
+            stream->ok = usb_proto_send(stream->type, stream_flags(stream), stream->request_id,
+                                        p, USB_PROTO_MAX_PAYLOAD);
+            p += USB_PROTO_MAX_PAYLOAD;
+            length -= USB_PROTO_MAX_PAYLOAD;
+            stream->total += USB_PROTO_MAX_PAYLOAD;
+            continue;
+        }
+
+        uint32_t n = USB_PROTO_MAX_PAYLOAD - g_stream_fill;
+        if (n > length) n = length;
+        memcpy(&g_stream_buf[g_stream_fill], p, n);
+        g_stream_fill += n;
+        p += n;
+        length -= n;
+        stream->total += n;
+
+        if (g_stream_fill == USB_PROTO_MAX_PAYLOAD) {
+            stream->ok = usb_proto_send(stream->type, stream_flags(stream), stream->request_id,
+                                        g_stream_buf, USB_PROTO_MAX_PAYLOAD);
+            g_stream_fill = 0;
+        }
+    }
+
+    return stream->ok;
+}
+
+bool usb_proto_stream_end(usb_stream_t* stream) {
+    if (stream->ok) {
+        stream->ok = usb_proto_send(stream->type, stream_flags(stream) | USB_FRAME_FLAG_END,
+                                    stream->request_id, g_stream_buf, (uint16_t)g_stream_fill);
+    }
+    g_stream_fill = 0;
+    g_stats.stream_bytes += stream->total;
+    return stream->ok;
+}
+
+// =============================================================================
+// Request Handlers
+// =============================================================================
+
+// שם קובץ מה-payload (לא מסתיים ב-0 בחוט)
+static bool payload_name(const uint8_t* payload, uint16_t length, char* name, size_t size) {
+    if (length == 0 || length >= size) return false;
+    memcpy(name, payload, length);
+    name[length] = '\0';
+    return true;
+}
+
+static bool export_output(const uint8_t* data, uint32_t length, void* ctx) {
+    return usb_proto_stream_write((usb_stream_t*)ctx, data, length);
+}
+
+static void handle_command(const usb_frame_header_t* req, const uint8_t* payload) {
+    char cmd[USB_PROTO_MAX_REQUEST + 1];
+    static char response[1024];
+
+    memcpy(cmd, payload, req->length);
+    cmd[req->length] = '\0';
+
+    // EXPORT ו-TRACE DUMP בטקסט כותבים ישר ל-CDC - במסגרות יש USB_FRAME_EXPORT/TRACE
+    if (strncmp(cmd, "EXPORT", 6) == 0 || strncmp(cmd, "TRACE DUMP", 10) == 0) {
+        usb_proto_send_error(req->type, req->request_id, USB_PROTO_ERR_BAD_REQUEST);
+        return;
+    }
+
+    bool ok = usb_process_command(cmd, response, sizeof(response));
+    usb_proto_send(req->type, USB_FRAME_FLAG_RESPONSE | (ok ? 0 : USB_FRAME_FLAG_ERROR),
+                   req->request_id, response, (uint16_t)strlen(response));
+}
+
+static void handle_list(const usb_frame_header_t* req, const uint8_t* payload) {
+    uint32_t first;
+    uint16_t count;
+    rec_catalog_entry_t entries[8];
+    usb_stream_t stream;
+
+    if (req->length != 6) {
+        usb_proto_send_error(req->type, req->request_id, USB_PROTO_ERR_BAD_REQUEST);
+        return;
+    }
+    memcpy(&first, payload, 4);
+    memcpy(&count, payload + 4, 2);
+
+    usb_proto_stream_begin(&stream, req->type, req->request_id);
+    while (count > 0 && stream.ok) {
+        uint32_t want = (count < 8) ? count : 8;
+        uint32_t n = rec_catalog_get_page(first, entries, NULL, want);
+        usb_proto_stream_write(&stream, entries, n * sizeof(rec_catalog_entry_t));
+        if (n < want) break;
+        first += n;
+        count -= (uint16_t)n;
+    }
+    usb_proto_stream_end(&stream);
+}
+
+static void handle_read(const usb_frame_header_t* req, const uint8_t* payload) {
+    char name[STORAGE_MAX_FILENAME_LENGTH];
+    char path[STORAGE_MAX_PATH_LENGTH];
+    storage_file_t file;
+    usb_stream_t stream;
+    uint32_t offset;
+
+    if (req->length < 5 || !payload_name(payload + 4, req->length - 4, name, sizeof(name))) {
+        usb_proto_send_error(req->type, req->request_id, USB_PROTO_ERR_BAD_REQUEST);
+        return;
+    }
+    memcpy(&offset, payload, 4);
+
+    if (storage_recording_get_path(name, path, sizeof(path)) != STORAGE_OK ||
+        storage_file_open(&file, path, FILE_MODE_READ) != STORAGE_OK) {
+        usb_proto_send_error(req->type, req->request_id, USB_PROTO_ERR_NOT_FOUND);
+        return;
+    }
+    if (offset > 0 && storage_file_seek(&file, (int32_t)offset, SEEK_SET) != STORAGE_OK) {
+        storage_file_close(&file);
+        usb_proto_send_error(req->type, req->request_id, USB_PROTO_ERR_BAD_REQUEST);
+        return;
+    }
+
+    // קריאות של מסגרת שלמה - כל אחת יוצאת בלי העתקה
+    usb_proto_stream_begin(&stream, req->type, req->request_id);
+    int32_t n;
+    while (stream.ok && (n = storage_file_read(&file, g_io_buf, sizeof(g_io_buf))) > 0) {
+        usb_proto_stream_write(&stream, g_io_buf, (uint32_t)n);
+    }
+    storage_file_close(&file);
+
+    if (!usb_proto_stream_end(&stream)) {
+        LOG_ERROR("Read aborted: %s", name);
+    }
+}
+
+static void handle_export(const usb_frame_header_t* req, const uint8_t* payload) {
+    char name[STORAGE_MAX_FILENAME_LENGTH];
+    char path[STORAGE_MAX_PATH_LENGTH];
+    static rec_reader_t reader;
+    usb_stream_t stream;
+
+    if (!payload_name(payload, req->length, name, sizeof(name))) {
+        usb_proto_send_error(req->type, req->request_id, USB_PROTO_ERR_BAD_REQUEST);
+        return;
+    }
+    if (storage_recording_get_path(name, path, sizeof(path)) != STORAGE_OK ||
+        !rec_reader_open(&reader, path)) {
+        usb_proto_send_error(req->type, req->request_id, USB_PROTO_ERR_NOT_FOUND);
+        return;
+    }
+
+    usb_proto_stream_begin(&stream, req->type, req->request_id);
+    rec_export_wav(&reader, export_output, &stream);
+    rec_reader_close(&reader);
+
+    if (!usb_proto_stream_end(&stream)) {
+        LOG_ERROR("Export aborted: %s", name);
+    }
+}
+
+static void handle_delete(const usb_frame_header_t* req, const uint8_t* payload) {
+    char name[STORAGE_MAX_FILENAME_LENGTH];
+
+    if (!payload_name(payload, req->length, name, sizeof(name))) {
+        usb_proto_send_error(req->type, req->request_id, USB_PROTO_ERR_BAD_REQUEST);
+        return;
+    }
+    if (storage_recording_delete(name) != STORAGE_OK) {
+        usb_proto_send_error(req->type, req->request_id, USB_PROTO_ERR_NOT_FOUND);
+        return;
+    }
+    usb_proto_send(req->type, USB_FRAME_FLAG_RESPONSE, req->request_id, NULL, 0);
+}
+
+static void handle_tap(const usb_frame_header_t* req, const uint8_t* payload) {
+    if (req->length > 1) {
+        usb_proto_send_error(req->type, req->request_id, USB_PROTO_ERR_BAD_REQUEST);
+        return;
+    }
+
+    uint8_t mask = (uint8_t)(req->length ? usb_tap_set_mask(payload[0]) : usb_tap_get_mask());
+    usb_proto_send(req->type, USB_FRAME_FLAG_RESPONSE, req->request_id, &mask, sizeof(mask));
+}
+
+static void handle_metrics(const usb_frame_header_t* req, const uint8_t* payload) {
+    static telemetry_snapshot_t snapshot;
+
+    if (req->length > 1) {
+        usb_proto_send_error(req->type, req->request_id, USB_PROTO_ERR_BAD_REQUEST);
+        return;
+    }
+
+    telemetry_snapshot(&snapshot);
+    // איפוס אחרי הצילום - כדי שכל בקשה תחזיר חלון נקי
+    if (req->length && payload[0]) {
+        telemetry_reset_histograms();
+    }
+    usb_proto_send(req->type, USB_FRAME_FLAG_RESPONSE, req->request_id,
+                   &snapshot, sizeof(snapshot));
+}
+
+static void handle_trace(const usb_frame_header_t* req, const uint8_t* payload) {
+    static usb_stream_t stream;
+
+    if (req->length > 1) {
+        usb_proto_send_error(req->type, req->request_id, USB_PROTO_ERR_BAD_REQUEST);
+        return;
+    }
+
+    if (req->length == 1) {
+        // לא מקומפל (TRACE_ENABLED 0) או אין זיכרון לטבעות
+        if (payload[0] && !trace_start()) {
+            usb_proto_send_error(req->type, req->request_id, USB_PROTO_ERR_BAD_REQUEST);
+            return;
+        }
+        if (!payload[0]) {
+            trace_stop();
+        }
+        uint8_t running = trace_is_running();
+        usb_proto_send(req->type, USB_FRAME_FLAG_RESPONSE, req->request_id,
+                       &running, sizeof(running));
+        return;
+    }
+
+    usb_proto_stream_begin(&stream, req->type, req->request_id);
+    trace_export_json(export_output, &stream);
+    if (!usb_proto_stream_end(&stream)) {
+        LOG_ERROR("Trace export aborted");
+    }
+}
+
+static void dispatch(const usb_frame_header_t* req, const uint8_t* payload) {
+    switch (req->type) {
+        case USB_FRAME_PING:
+            usb_proto_send(req->type, USB_FRAME_FLAG_RESPONSE, req->request_id,
+                           payload, req->length);
+            break;
+        case USB_FRAME_COMMAND: handle_command(req, payload); break;
+        case USB_FRAME_LIST:    handle_list(req, payload);    break;
+        case USB_FRAME_READ:    handle_read(req, payload);    break;
+        case USB_FRAME_EXPORT:  handle_export(req, payload);  break;
+        case USB_FRAME_DELETE:  handle_delete(req, payload);  break;
+        case USB_FRAME_TAP:     handle_tap(req, payload);     break;
+        case USB_FRAME_METRICS: handle_metrics(req, payload); break;
+        case USB_FRAME_TRACE:   handle_trace(req, payload);   break;
+        default:
+            usb_proto_send_error(req->type, req->request_id, USB_PROTO_ERR_UNKNOWN_TYPE);
+            break;
+    }
+}
+
+// =============================================================================
+// Receiving
+// =============================================================================
+
+// בית אחד קדימה - חיפוש ה-sync הבא אחרי זבל או CRC שגוי
+static void resync(void) {
+    uint32_t skip = 1;
+    while (skip < g_rx_fill && g_rx_frame[skip] != USB_PROTO_SYNC0) {
+        skip++;
+    }
+    memmove(g_rx_frame, g_rx_frame + skip, g_rx_fill - skip);
+    g_rx_fill -= skip;
+    g_stats.dropped_bytes += skip;
+}
+
+bool usb_proto_busy(void) {
+    return g_rx_fill > 0;
+}
+
+// מסגרת שלמה בתחילת הבאפר: בדיקת sync, אורך ו-CRC
+static bool frame_valid(uint32_t* frame_size, bool* complete) {
+    const usb_frame_header_t* header = (const usb_frame_header_t*)g_rx_frame;
+
+    *complete = false;
+    if (g_rx_frame[0] != USB_PROTO_SYNC0 ||
+        (g_rx_fill >= 2 && g_rx_frame[1] != USB_PROTO_SYNC1)) {
+        return false;
+    }
+    if (g_rx_fill < USB_PROTO_HEADER_SIZE) {
+        *frame_size = USB_PROTO_HEADER_SIZE;
+        return true;
+    }
+    if (header->length > USB_PROTO_MAX_REQUEST) {
+        return false;
+    }
+
+    *frame_size = USB_PROTO_HEADER_SIZE + header->length + USB_PROTO_CRC_SIZE;
+    if (g_rx_fill < *frame_size) {
+        return true;
+    }
+
+    uint16_t crc;
+    memcpy(&crc, &g_rx_frame[*frame_size - USB_PROTO_CRC_SIZE], sizeof(crc));
+    if (usb_proto_crc16(0xFFFF, &g_rx_frame[2], *frame_size - 2 - USB_PROTO_CRC_SIZE) != crc) {
+        g_stats.crc_errors++;
+        return false;
+    }
+    *complete = true;
+    return true;
+}
+
+void usb_proto_poll(void) {
+    while (1) {
+        uint32_t frame_size = USB_PROTO_HEADER_SIZE;
+        bool complete = false;
+
+        if (g_rx_fill > 0 && !frame_valid(&frame_size, &complete)) {
+            resync();
+            if (g_rx_fill == 0) return;     // אולי שורת טקסט
+            continue;
+        }
+
+        if (complete) {
+            g_stats.frames_rx++;
+            dispatch((const usb_frame_header_t*)g_rx_frame, &g_rx_frame[USB_PROTO_HEADER_SIZE]);
+            g_rx_fill -= frame_size;
+            memmove(g_rx_frame, g_rx_frame + frame_size, g_rx_fill);
+            return;     // בקשה אחת לכל קריאה - הלופ הראשי ממשיך
+        }
+
+        // בדיוק מה שחסר למסגרת - לא קוראים בתים של הבקשה הבאה
+        int32_t n = usb_cdc_read(&g_rx_frame[g_rx_fill], frame_size - g_rx_fill);
+        if (n <= 0) return;
+        g_rx_fill += (uint32_t)n;
+    }
+}
+
+void usb_proto_get_stats(usb_proto_stats_t* stats) {
+    if (stats) {
+        *stats = g_stats;
+    }
+}
@@ -0,0 +1,239 @@
+/**
+ * @file usb_tap.c
+ * @brief מימוש הזרמת האודיו החי ל-USB
+ */
+
+#include "hal/usb_tap.h"
+#include "hal/usb_proto.h"
+#include "hal/usb_cdc.h"
+#include <stdlib.h>
+#include <string.h>
+
+// =============================================================================
+// Platform-Specific
+// =============================================================================
+
+#ifdef ESP32
+    #include "esp_log.h"
+    #include "esp_timer.h"
+
+    static const char* TAG = "USB_TAP";
+    #define LOG_INFO(fmt, ...) ESP_LOGI(TAG, fmt, ##__VA_ARGS__)
+    #define LOG_ERROR(fmt, ...) ESP_LOGE(TAG, fmt, ##__VA_ARGS__)
+    #define GET_MICROS() ((uint32_t)esp_timer_get_time())
+#else
+    #include <stdio.h>
+    #include <time.h>
+    #define LOG_INFO(fmt, ...) fprintf(stderr, "[USB_TAP] " fmt "\n", ##__VA_ARGS__)
+    #define LOG_ERROR(fmt, ...) fprintf(stderr, "[USB_TAP ERROR] " fmt "\n", ##__VA_ARGS__)
+    static uint32_t sim_micros(void) {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint32_t)(ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000);
+    }
+    #define GET_MICROS() sim_micros()
+#endif
+
+// =============================================================================
+// Internal State
+// =============================================================================
+
+_Static_assert((USB_TAP_RING_SIZE & (USB_TAP_RING_SIZE - 1)) == 0, "tap ring size must be a power of 2");
+_Static_assert(sizeof(usb_tap_frame_t) == 12, "tap frame header size");
+
+// רשומה בטבעת: כותרת ואחריה הדגימות (יכולה להתפצל בסוף הטבעת)
+typedef struct {
+    uint32_t timestamp_us;
+    uint16_t seq;
+    uint16_t bytes;
+} tap_record_t;
+
+typedef struct {
+    uint8_t* ring;                  // USB_TAP_RING_SIZE, מוקצה בהפעלה הראשונה
+    uint32_t head;                  // נכתב רק ע"י המפיק
+    uint32_t tail;                  // נכתב רק ע"י usb_tap_poll
+    uint16_t seq;                   // של המפיק
+    uint16_t sample_rate;
+    uint32_t dropped;               // של המפיק
+    uint32_t sent;
+} tap_channel_t;
+
+static tap_channel_t g_taps[USB_TAP_COUNT];
+static uint32_t g_mask = 0;
+static uint32_t g_bytes_sent = 0;
+
+// מסגרת יוצאת: כותרת + רשומה אחת
+static uint8_t g_frame[sizeof(usb_tap_frame_t) + USB_TAP_MAX_RECORD * sizeof(int16_t)];
+
+// =============================================================================
+// Ring Helpers
+// =============================================================================
+
+static void ring_write(tap_channel_t* ch, uint32_t pos, const void* data, uint32_t length) {
+    uint32_t offset = pos & (USB_TAP_RING_SIZE - 1);
+    uint32_t first = USB_TAP_RING_SIZE - offset;
+    if (first > length) first = length;
+
+    memcpy(&ch->ring[offset], data, first);
+    memcpy(ch->ring, (const uint8_t*)data + first, length - first);
+}
+
+static void ring_read(const tap_channel_t* ch, uint32_t pos, void* data, uint32_t length) {
+    uint32_t offset = pos & (USB_TAP_RING_SIZE - 1);
+    uint32_t first = USB_TAP_RING_SIZE - offset;
+    if (first > length) first = length;
+
+    memcpy(data, &ch->ring[offset], first);
+    memcpy((uint8_t*)data + first, ch->ring, length - first);
+}
+
+// הצרכן מוותר על כל מה שבטבעת
+static void ring_discard(tap_channel_t* ch) {
+    __atomic_store_n(&ch->tail, __atomic_load_n(&ch->head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+}
+
+// =============================================================================
+// Control
+// =============================================================================
+
+uint32_t usb_tap_set_mask(uint32_t mask) {
+    mask &= USB_TAP_MASK_ALL;
+
+    for (int tap = 0; tap < USB_TAP_COUNT; tap++) {
+        tap_channel_t* ch = &g_taps[tap];
+        if (!(mask & USB_TAP_MASK(tap))) {
+            continue;
+        }
+        if (!ch->ring) {
+            ch->ring = (uint8_t*)malloc(USB_TAP_RING_SIZE);
+            if (!ch->ring) {
+                LOG_ERROR("No memory for tap %d", tap);
+                mask &= ~USB_TAP_MASK(tap);
+                continue;
+            }
+        }
+        // הפעלה מתחילה מטבעת ריקה - בלי שאריות מהפעם הקודמת
+        if (!(g_mask & USB_TAP_MASK(tap))) {
+            ring_discard(ch);
+        }
+    }
+
+    // הטבעות מוכנות לפני שהמפיקים רואים את ה-mask
+    __atomic_store_n(&g_mask, mask, __ATOMIC_RELEASE);
+    LOG_INFO("Audio taps: 0x%02X", (unsigned)mask);
+    return mask;
+}
+
+uint32_t usb_tap_get_mask(void) {
+    return __atomic_load_n(&g_mask, __ATOMIC_ACQUIRE);
+}
+
+void usb_tap_set_rate(usb_tap_t tap, uint32_t sample_rate) {
+    if ((unsigned)tap < USB_TAP_COUNT) {
+        g_taps[tap].sample_rate = (uint16_t)sample_rate;
+    }
+}
+
+// =============================================================================
+// Producer
+// =============================================================================
+
+void usb_tap_push(usb_tap_t tap, const int16_t* samples, uint16_t count) {
+    if ((unsigned)tap >= USB_TAP_COUNT ||
+        !(__atomic_load_n(&g_mask, __ATOMIC_ACQUIRE) & USB_TAP_MASK(tap))) {
+        return;
+    }
+    if (!samples || count == 0 || count > USB_TAP_MAX_RECORD) {
+        return;
+    }
+
+    tap_channel_t* ch = &g_taps[tap];
+    tap_record_t record = {
+        .timestamp_us = GET_MICROS(),
+        .seq = ch->seq++,
+        .bytes = (uint16_t)(count * sizeof(int16_t))
+    };
+    uint32_t need = sizeof(record) + record.bytes;
+
+    uint32_t head = ch->head;
+    uint32_t tail = __atomic_load_n(&ch->tail, __ATOMIC_ACQUIRE);
+    if (USB_TAP_RING_SIZE - (head - tail) < need) {
+        // המחשב לא עומד בקצב - רשומה שלמה נזרקת, ה-seq מראה את הפער
+        ch->dropped++;
+        return;
+    }
+
+    ring_write(ch, head, &record, sizeof(record));
+    ring_write(ch, head + sizeof(record), samples, record.bytes);
+    __atomic_store_n(&ch->head, head + need, __ATOMIC_RELEASE);
+}
+
+// =============================================================================
+// Consumer
+// =============================================================================
+
+void usb_tap_poll(void) {
+    uint32_t mask = usb_tap_get_mask();
+    if (mask == 0) {
+        return;
+    }
+
+    bool connected = usb_cdc_is_connected();
+    uint32_t budget = USB_TAP_POLL_BUDGET;
+
+    for (int tap = 0; tap < USB_TAP_COUNT; tap++) {
+        tap_channel_t* ch = &g_taps[tap];
+        if (!(mask & USB_TAP_MASK(tap))) {
+            continue;
+        }
+        if (!connected) {
+            ring_discard(ch);
+            continue;
+        }
+
+        uint32_t tail = ch->tail;
+        uint32_t head = __atomic_load_n(&ch->head, __ATOMIC_ACQUIRE);
+
+        while (head - tail >= sizeof(tap_record_t) && budget > 0) {
+            tap_record_t record;
+            ring_read(ch, tail, &record, sizeof(record));
+
+            usb_tap_frame_t header = {
+                .tap = (uint8_t)tap,
+                .format = USB_TAP_FORMAT_PCM16,
+                .sample_rate = ch->sample_rate,
+                .timestamp_us = record.timestamp_us,
+                .seq = record.seq,
+                .reserved = 0
+            };
+            memcpy(g_frame, &header, sizeof(header));
+            ring_read(ch, tail + sizeof(record), g_frame + sizeof(header), record.bytes);
+            tail += sizeof(record) + record.bytes;
+
+            // המקום בטבעת מתפנה לפני השליחה - השליחה יכולה לחכות ל-FIFO
+            __atomic_store_n(&ch->tail, tail, __ATOMIC_RELEASE);
+
+            uint16_t length = (uint16_t)(sizeof(header) + record.bytes);
+            if (!usb_proto_send(USB_FRAME_AUDIO_TAP, USB_FRAME_FLAG_STREAM, 0, g_frame, length)) {
+                ring_discard(ch);
+                break;
+            }
+            ch->sent++;
+            g_bytes_sent += length;
+            budget = (budget > length) ? budget - length : 0;
+        }
+    }
+}
+
+void usb_tap_get_stats(usb_tap_stats_t* stats) {
+    if (!stats) {
+        return;
+    }
+
+    stats->mask = usb_tap_get_mask();
+    for (int tap = 0; tap < USB_TAP_COUNT; tap++) {
+        stats->records_sent[tap] = g_taps[tap].sent;
+        stats->records_dropped[tap] = g_taps[tap].dropped;
+    }
+    stats->bytes_sent = g_bytes_sent;
+}
@@ -8,6 +8,7 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 
 #include "config.h"
 #include "hal/buttons.h"
@@ -17,10 +18,17 @@
 #include "core/dial_manager.h"
 #include "core/audio_buffer.h"
 #include "core/device_id.h"
+#include "core/voice_path.h"
+#include "core/recorder.h"
+#include "core/aec.h"
+#include "core/telemetry.h"
+#include "core/trace.h"
+#include "core/tasks.h"
 #include "comm/protocol.h"
 #include "comm/radio.h"
 #include "hal/storage.h"
 #include "hal/usb_cdc.h"
+#include "hal/usb_tap.h"
 
 // =============================================================================
 // Platform-Specific Includes
@@ -31,36 +39,49 @@
     #include "freertos/task.h"
     #include "esp_log.h"
     #include "nvs_flash.h"
+    #include "esp_timer.h"
     
     static const char* TAG = "WT-MAIN";
     #define LOG_INFO(fmt, ...) ESP_LOGI(TAG, fmt, ##__VA_ARGS__)
     #define LOG_ERROR(fmt, ...) ESP_LOGE(TAG, fmt, ##__VA_ARGS__)
     #define LOG_DEBUG(fmt, ...) ESP_LOGD(TAG, fmt, ##__VA_ARGS__)
     #define DELAY_MS(ms) vTaskDelay(pdMS_TO_TICKS(ms))
+    #define GET_MILLIS() (esp_timer_get_time() / 1000)
 #else
     // Simulator / PC build
     #include <unistd.h>
+    #include <time.h>
     #define LOG_INFO(fmt, ...) printf("[INFO] " fmt "\n", ##__VA_ARGS__)
     #define LOG_ERROR(fmt, ...) printf("[ERROR] " fmt "\n", ##__VA_ARGS__)
     #define LOG_DEBUG(fmt, ...)
     #define DELAY_MS(ms) usleep((ms) * 1000)
+    static uint32_t sim_millis(void) {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (ts.tv_sec * 1000) + (ts.tv_nsec / 1000000);
+    }
+    #define GET_MILLIS() sim_millis()
 #endif
 
 // =============================================================================
 // Global State
 // =============================================================================
 
-static device_context_t g_device_ctx;
-static dial_manager_t g_dial_manager;
+static device_context_t g_device_ctx LARGE_TABLE_ATTR;
+static dial_manager_t g_dial_manager LARGE_TABLE_ATTR;
 static bool g_running = true;
 
 // Audio buffers
-static audio_ring_buffer_t g_record_buffer;
-static audio_ring_buffer_t g_playback_buffer;
+static audio_ring_buffer_t g_record_buffer HOT_BUFFER_ATTR;
 
 // Transmission state
 static bool g_is_transmitting = false;
 
+// הקלטת הקבלה - הכתיבה לכרטיס ב-task נפרד
+static bool g_recording_requested = false;
+static char g_rec_peer[DEVICE_ID_LENGTH + 1];
+static uint32_t g_rec_last_voice = 0;
+
 // =============================================================================
 // Forward Declarations
 // =============================================================================
@@ -74,12 +95,49 @@ static void handle_audio_playback(void);
 // Audio Capture Callback
 // =============================================================================
 
+// VAD, resampler ושליחה ב-core/voice_path.c
 static void on_audio_captured(const int16_t* samples, uint16_t sample_count) {
     // Send audio over radio if transmitting
-    if (g_is_transmitting && g_device_ctx.is_connected) {
-        // Convert to bytes for protocol
-        protocol_send_voice((const uint8_t*)samples, sample_count * sizeof(int16_t));
+    if (!g_is_transmitting || !g_device_ctx.is_connected) {
+        return;
     }
+    
+    voice_path_capture(samples, sample_count);
+}
+
+// =============================================================================
+// Telemetry
+// =============================================================================
+
+// מעתיק את הסטטיסטיקות הקיימות של המודולים לרישום רגע לפני snapshot
+static void collect_telemetry(void) {
+    const radio_stats_t* radio = radio_get_stats();
+    if (radio) {
+        telemetry_set(TM_RADIO_TX_PACKETS, radio->packets_sent);
+        telemetry_set(TM_RADIO_RX_PACKETS, radio->packets_received);
+        telemetry_set(TM_RADIO_CRC_ERRORS, radio->crc_errors);
+        telemetry_set(TM_RADIO_TX_TIMEOUTS, radio->tx_timeouts);
+    }
+    
+    const audio_stats_t* audio = audio_get_stats();
+    if (audio) {
+        telemetry_set(TM_AUDIO_FRAMES_CAPTURED, audio->frames_captured);
+        telemetry_set(TM_AUDIO_FRAMES_PLAYED, audio->frames_played);
+        telemetry_set(TM_AUDIO_UNDERRUNS, audio->buffer_underruns);
+    }
+    
+    const audio_buffer_stats_t* playback = audio_buffer_get_stats(voice_path_playback_buffer());
+    if (playback) {
+        telemetry_set(TM_PLAYBACK_DROPPED, playback->frames_dropped);
+        telemetry_set(TM_PLAYBACK_MISSED, playback->frames_missed);
+        telemetry_set(TM_PLAYBACK_MAX_FILL, playback->max_fill_level);
+    }
+    
+    usb_info_t usb;
+    usb_get_info(&usb);
+    telemetry_set(TM_USB_BYTES_TX, usb.bytes_sent);
+    telemetry_set(TM_USB_BYTES_RX, usb.bytes_received);
+    telemetry_set(TM_USB_RX_STALLS, usb.rx_stalls);
 }
 
 // =============================================================================
@@ -147,6 +205,37 @@ static void on_volume_change(int8_t delta) {
     audio_set_output_volume(vol.absolute);
 }
 
+// =============================================================================
+// Recording
+// =============================================================================
+
+/**
+ * @brief הקלטת קול שהתקבל - מקטע חדש לכל דובר או אחרי הפסקה
+ */
+static void record_voice(const char* src_id, const voice_data_t* voice,
+                         const int16_t* samples, uint16_t count) {
+    uint32_t now = GET_MILLIS();
+    
+    if (strncmp(src_id, g_rec_peer, DEVICE_ID_LENGTH) != 0 ||
+        now - g_rec_last_voice > RECORDER_SEGMENT_GAP_MS) {
+        rec_segment_info_t info;
+        memset(&info, 0, sizeof(info));
+        strncpy(info.peer_id, src_id, REC_PEER_ID_LENGTH);
+        info.rssi = radio_get_rssi();
+        info.snr = radio_get_snr();
+        info.timestamp = (uint32_t)time(NULL);
+        info.remote_timestamp = voice->timestamp;
+        
+        if (recorder_mark_segment(&info)) {
+            strncpy(g_rec_peer, src_id, DEVICE_ID_LENGTH);
+            g_rec_peer[DEVICE_ID_LENGTH] = '\0';
+        }
+    }
+    g_rec_last_voice = now;
+    
+    recorder_push(samples, count);
+}
+
 // =============================================================================
 // Protocol Message Callback
 // =============================================================================
@@ -178,7 +267,7 @@ static void on_protocol_message(message_type_t type, const char* src_id,
             device_set_state(&g_device_ctx, STATE_IN_CALL);
             
             // Start audio playback
-            audio_start_playback(&g_playback_buffer);
+            audio_start_playback(voice_path_playback_buffer());
             audio_beep();
             break;
             
@@ -197,7 +286,7 @@ static void on_protocol_message(message_type_t type, const char* src_id,
             device_set_state(&g_device_ctx, STATE_IN_FREQUENCY);
             
             // Start audio playback
-            audio_start_playback(&g_playback_buffer);
+            audio_start_playback(voice_path_playback_buffer());
             audio_beep();
             break;
             
@@ -215,15 +304,25 @@ static void on_protocol_message(message_type_t type, const char* src_id,
             }
             break;
             
+        case MSG_VOICE_DTX:
+        case MSG_VOICE_SILENCE:
+            // הצד השני בשקט - ממלאים ברעש נוחות
+            if (len >= sizeof(voice_sid_t)) {
+                voice_path_receive_sid((const voice_sid_t*)payload);
+            }
+            break;
+            
         case MSG_VOICE_DATA:
             // Handle incoming audio
             if (len >= sizeof(voice_data_t)) {
                 const voice_data_t* voice = (const voice_data_t*)payload;
-                // Add to playback buffer
-                audio_buffer_write(&g_playback_buffer, 
-                                  voice->audio_data, 
-                                  voice->audio_len, 
-                                  voice->timestamp);
+                const int16_t* samples;
+                uint16_t count = voice_path_receive(voice, &samples);
+                
+                // לא חוסם - רק העתקה לתור של ה-recorder
+                if (recorder_is_active()) {
+                    record_voice(src_id, voice, samples, count);
+                }
             }
             break;
             
@@ -232,6 +331,7 @@ static void on_protocol_message(message_type_t type, const char* src_id,
         case MSG_FREQ_KICK:
             LOG_INFO("Disconnected");
             g_device_ctx.is_connected = false;
+            voice_path_stop_comfort_noise();
             
             // Stop audio
             audio_stop_recording();
@@ -252,6 +352,7 @@ static void on_protocol_message(message_type_t type, const char* src_id,
 static void init_system(void) {
     LOG_INFO("Initializing Walkie-Talkie v%s (%s)", FIRMWARE_VERSION, BUILD_TYPE);
     LOG_INFO("Build: %s", BUILD_INFO);
+    LOG_INFO("Profile: %s", PROFILE_NAME);
     
 #ifdef ESP32
     // Initialize NVS
@@ -274,6 +375,7 @@ static void init_system(void) {
     // Initialize USB CDC
     LOG_INFO("Initializing USB...");
     usb_init(USB_MODE_CDC);
+    telemetry_set_collector(collect_telemetry);
     
     // Initialize HAL
     LOG_INFO("Initializing HAL...");
@@ -289,8 +391,20 @@ static void init_system(void) {
     
     // Initialize audio buffers
     audio_buffer_init(&g_record_buffer);
-    audio_buffer_init(&g_playback_buffer);
-    audio_buffer_set_jitter_depth(&g_playback_buffer, 4);
+    
+    // נתיב הקול (playback buffer, DTX) - קצב הרדיו יכול להיות שונה מקצב הלכידה
+    voice_path_init(audio_cfg.sample_rate);
+    if (!voice_path_set_link_rate(audio_cfg.sample_rate, AUDIO_LINK_RATE)) {
+        LOG_ERROR("Unsupported link rate %u - using capture rate", (unsigned)AUDIO_LINK_RATE);
+        voice_path_set_link_rate(audio_cfg.sample_rate, audio_cfg.sample_rate);
+    }
+    
+    // הקלטה - מקבלת דגימות בקצב ההשמעה
+    if (!recorder_init(audio_cfg.sample_rate)) {
+        LOG_ERROR("Failed to initialize recorder");
+    } else if (recorder_uses_ring()) {
+        recorder_start();
+    }
     
     // Set callbacks
     buttons_set_callback(on_button_event);
@@ -351,6 +465,7 @@ static void handle_audio_transmission(void) {
     if (should_transmit && !g_is_transmitting) {
         // Start transmitting
         g_is_transmitting = true;
+        voice_path_tx_reset();
         audio_start_recording_callback(on_audio_captured);
         LOG_DEBUG("Started transmitting");
     } else if (!should_transmit && g_is_transmitting) {
@@ -373,10 +488,7 @@ static void handle_audio_playback(void) {
         return;
     }
     
-    // Start playback if not already playing and we're connected
-    if (!audio_is_playing() && audio_buffer_jitter_ready(&g_playback_buffer)) {
-        audio_start_playback(&g_playback_buffer);
-    }
+    voice_path_update(GET_MILLIS());
 }
 
 // =============================================================================
@@ -385,8 +497,11 @@ static void handle_audio_playback(void) {
 
 static void main_loop(void) {
     LOG_INFO("Entering main loop");
+    tasks_watchdog_register(TASK_ID_MAIN, TASK_WATCHDOG_TIMEOUT_MS);
     
     while (g_running) {
+        tasks_watchdog_feed(TASK_ID_MAIN);
+        
         // Update buttons (poll hardware)
         buttons_update();
         
@@ -400,9 +515,19 @@ static void main_loop(void) {
         audio_update();
         
         // Handle recording (for playback recording, not transmission)
-        if (g_device_ctx.is_recording) {
-            // Recording is handled by audio system when started
+        // בטבעת ההקלטה תמידית - הכפתור שומר את מה שנאסף עד עכשיו
+        if (g_device_ctx.is_recording != g_recording_requested) {
+            g_recording_requested = g_device_ctx.is_recording;
+            if (recorder_uses_ring()) {
+                recorder_save();
+            } else if (g_recording_requested) {
+                g_rec_peer[0] = '\0';
+                recorder_start();
+            } else {
+                recorder_stop();
+            }
         }
+        recorder_update();
         
         // Handle audio transmission (PTT-based)
         handle_audio_transmission();
@@ -411,7 +536,10 @@ static void main_loop(void) {
         handle_audio_playback();
         
         // Handle USB communication
+        TRACE_BEGIN(TRACE_USB_UPDATE);
         usb_update();
+        TRACE_END(TRACE_USB_UPDATE);
+        telemetry_update();
         
         // Small delay to prevent CPU hogging
         DELAY_MS(10);
@@ -419,6 +547,11 @@ static void main_loop(void) {
     
     // Cleanup
     LOG_INFO("Shutting down...");
+    recorder_stop();
+    while (recorder_is_active()) {
+        recorder_update();
+        DELAY_MS(10);
+    }
     audio_stop_recording();
     audio_stop_playback();
     audio_deinit();
@@ -428,12 +561,13 @@ static void main_loop(void) {
 // Entry Point
 // =============================================================================
 
-#ifdef ESP32
+// test_build_src מקמפל את src/ יחד עם הבדיקות - נקודת הכניסה שלהן
+#if defined(ESP32) && !defined(PIO_UNIT_TESTING)
 void app_main(void) {
     init_system();
     main_loop();
 }
-#else
+#elif !defined(ESP32) && !defined(PIO_UNIT_TESTING)
 int main(int argc, char* argv[]) {
     (void)argc;
     (void)argv;
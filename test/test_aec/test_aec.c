@@ -0,0 +1,207 @@
+/**
+ * @file test_aec.c
+ * @brief ביטול הד מול מסלול הד סינתטי - רץ ב-env:native
+ *
+ *   pio test -e native -f test_aec -v
+ *
+ * ה-reference הוא רעש (הצד הרחוק), והמיקרופון מקבל אותו דרך מסלול הד
+ * ידוע: השהיה, הגבר והחזרה נוספת, בתוך AEC_FILTER_TAPS. נבדק:
+ * - ERLE אחרי התכנסות (נמדד כאן מהאותות, וגם מה ש-aec_get_erle_db מדווח)
+ * - דיבור מקומי בלי השמעה עובר כמו שהוא (רק הסרת DC)
+ * - double-talk: הדיבור המקומי נשמר והמסנן לא מתבדר
+ */
+
+#include <unity.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "config.h"
+#include "core/aec.h"
+#include "core/audio_buffer.h"
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#define FRAME               AUDIO_FRAME_SAMPLES
+#define CONVERGE_FRAMES     100                 // 2 שניות של הד בלבד
+#define MEASURE_FRAMES      50                  // שנייה למדידה
+#define TOTAL_FRAMES        (CONVERGE_FRAMES + MEASURE_FRAMES)
+#define TOTAL_SAMPLES       (TOTAL_FRAMES * FRAME)
+
+#define FAR_AMPLITUDE       8000
+#define NEAR_AMPLITUDE      8000
+
+#define MIN_ERLE_DB         10.0
+#define MIN_NEAR_CORR       0.95                // פלט מול הדיבור המקומי
+#define MAX_NEAR_GAIN_DB    1.0                 // שינוי עוצמת הדיבור המקומי
+
+// מסלול ההד: רמקול -> אוויר -> מיקרופון. סכום ההגברים מתחת ל-0.5 - גלאי
+// ה-Geigel מניח שההד חלש מחצי מה-reference (אחרת הכל נראה כ-double-talk)
+typedef struct {
+    uint16_t delay;
+    float    gain;
+} echo_tap_t;
+
+static const echo_tap_t ECHO_PATH[] = {
+    { 40,  0.25f },
+    { 41,  0.12f },
+    { 100, -0.06f },
+    { 180, 0.03f },
+};
+
+// =============================================================================
+// Signals
+// =============================================================================
+
+static int16_t g_far[TOTAL_SAMPLES];
+static int16_t g_near[TOTAL_SAMPLES];
+static int16_t g_echo[TOTAL_SAMPLES];
+static int16_t g_mic[TOTAL_SAMPLES];
+static aec_state_t g_aec;
+
+static void make_noise(int16_t* out, uint32_t count, uint32_t seed, int16_t amplitude) {
+    for (uint32_t i = 0; i < count; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        out[i] = (int16_t)(((int32_t)(seed >> 16) - 32768) * amplitude / 32768);
+    }
+}
+
+static void make_echo(void) {
+    for (int n = 0; n < TOTAL_SAMPLES; n++) {
+        float y = 0;
+        for (size_t t = 0; t < sizeof(ECHO_PATH) / sizeof(ECHO_PATH[0]); t++) {
+            if (n >= ECHO_PATH[t].delay) {
+                y += ECHO_PATH[t].gain * g_far[n - ECHO_PATH[t].delay];
+            }
+        }
+        g_echo[n] = (int16_t)lrintf(y);
+    }
+}
+
+static double energy(const int16_t* x, int count) {
+    double e = 0;
+    for (int i = 0; i < count; i++) {
+        e += (double)x[i] * x[i];
+    }
+    return e;
+}
+
+static double correlation(const int16_t* x, const int16_t* y, int count) {
+    double xy = 0;
+    for (int i = 0; i < count; i++) {
+        xy += (double)x[i] * y[i];
+    }
+    double xx = energy(x, count), yy = energy(y, count);
+    return (xx > 0 && yy > 0) ? xy / sqrt(xx * yy) : 0;
+}
+
+/**
+ * @brief כמו ב-audio_task: ההשמעה נדחפת, ואז frame הקלט מעובד
+ */
+static void run_frames(int first, int count, bool far_end) {
+    for (int f = first; f < first + count; f++) {
+        if (far_end) {
+            aec_push_reference(&g_aec, &g_far[f * FRAME], FRAME);
+        }
+        aec_process(&g_aec, &g_mic[f * FRAME], FRAME);
+    }
+}
+
+// =============================================================================
+// Tests
+// =============================================================================
+
+void setUp(void) {
+    aec_init(&g_aec);
+    aec_set_enabled(&g_aec, true);
+    make_noise(g_far, TOTAL_SAMPLES, 0x1234, FAR_AMPLITUDE);
+    make_noise(g_near, TOTAL_SAMPLES, 0xBEEF, NEAR_AMPLITUDE);
+    make_echo();
+}
+
+void tearDown(void) {}
+
+static void test_echo_cancelled(void) {
+    memcpy(g_mic, g_echo, sizeof(g_mic));
+    run_frames(0, TOTAL_FRAMES, true);
+
+    const int start = CONVERGE_FRAMES * FRAME;
+    const int count = MEASURE_FRAMES * FRAME;
+    double erle = 10.0 * log10(energy(&g_echo[start], count) / (energy(&g_mic[start], count) + 1));
+    printf("AEC {\"erle_db\":%.1f,\"reported_erle_db\":%d}\n", erle, aec_get_erle_db(&g_aec));
+
+    TEST_ASSERT_TRUE_MESSAGE(erle >= MIN_ERLE_DB, "echo not cancelled");
+    // האומדן הפנימי ברזולוציה של ~3dB
+    TEST_ASSERT_TRUE(aec_get_erle_db(&g_aec) >= MIN_ERLE_DB - 3);
+    TEST_ASSERT_TRUE(g_aec.fifo_underruns == 0);
+}
+
+static void test_near_end_without_playback(void) {
+    memcpy(g_mic, g_near, sizeof(g_mic));
+    run_frames(0, TOTAL_FRAMES, false);
+
+    // בלי השמעה אין מה לבטל - רק הסרת DC (קלט בלי DC כמעט לא משתנה)
+    double corr = correlation(g_near, g_mic, TOTAL_SAMPLES);
+    double gain_db = 10.0 * log10(energy(g_mic, TOTAL_SAMPLES) / energy(g_near, TOTAL_SAMPLES));
+    TEST_ASSERT_TRUE(corr >= 0.99);
+    TEST_ASSERT_TRUE(fabs(gain_db) <= MAX_NEAR_GAIN_DB);
+}
+
+static void test_double_talk(void) {
+    // התכנסות על הד בלבד, ואחריה דיבור מקומי מעל ההד
+    memcpy(g_mic, g_echo, sizeof(g_mic));
+    for (int n = CONVERGE_FRAMES * FRAME; n < TOTAL_SAMPLES; n++) {
+        g_mic[n] = (int16_t)(g_echo[n] + g_near[n]);
+    }
+    run_frames(0, TOTAL_FRAMES, true);
+
+    const int start = CONVERGE_FRAMES * FRAME;
+    const int count = MEASURE_FRAMES * FRAME;
+    double corr = correlation(&g_near[start], &g_mic[start], count);
+    double gain_db = 10.0 * log10(energy(&g_mic[start], count) / energy(&g_near[start], count));
+
+    // מה שנשאר מההד מתחת לדיבור - המסנן הוקפא ולא התבדר
+    static int16_t residual[MEASURE_FRAMES * FRAME];
+    for (int i = 0; i < count; i++) {
+        residual[i] = (int16_t)(g_mic[start + i] - g_near[start + i]);
+    }
+    double erle = 10.0 * log10(energy(&g_echo[start], count) / (energy(residual, count) + 1));
+    printf("AEC {\"double_talk_corr\":%.3f,\"near_gain_db\":%.2f,\"double_talk_erle_db\":%.1f,"
+           "\"frozen_samples\":%u}\n",
+           corr, gain_db, erle, (unsigned)g_aec.double_talk_samples);
+
+    TEST_ASSERT_TRUE(g_aec.double_talk_samples > 0);
+    TEST_ASSERT_TRUE_MESSAGE(corr >= MIN_NEAR_CORR, "near-end speech distorted");
+    TEST_ASSERT_TRUE_MESSAGE(fabs(gain_db) <= MAX_NEAR_GAIN_DB, "near-end level changed");
+    TEST_ASSERT_TRUE_MESSAGE(erle >= MIN_ERLE_DB, "filter diverged during double-talk");
+}
+
+static void test_disabled_passthrough(void) {
+    memcpy(g_mic, g_echo, sizeof(g_mic));
+    aec_set_enabled(&g_aec, false);
+    run_frames(0, TOTAL_FRAMES, true);
+
+    TEST_ASSERT_EQUAL_MEMORY(g_echo, g_mic, sizeof(g_mic));
+}
+
+static int run_tests(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_echo_cancelled);
+    RUN_TEST(test_near_end_without_playback);
+    RUN_TEST(test_double_talk);
+    RUN_TEST(test_disabled_passthrough);
+    return UNITY_END();
+}
+
+#ifdef ESP_PLATFORM
+void app_main(void) {
+    run_tests();
+}
+#else
+int main(void) {
+    return run_tests();
+}
+#endif
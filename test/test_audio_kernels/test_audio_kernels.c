@@ -0,0 +1,325 @@
+/**
+ * @file test_audio_kernels.c
+ * @brief קרנלי האודיו מול מימוש "אורקל" עצמאי - ref ו-dispatch
+ *
+ *   pio test -e native -f test_audio_kernels -v
+ *   pio test -e esp32s3 -f test_audio_kernels -v      (על הלוח - נתיב ה-PIE)
+ *
+ * האורקל כאן נכתב מחדש ב-int64 עם רוויה מפורשת, בלי לשתף קוד עם
+ * audio_kernels.c. כל קרנל נבדק בגרסת ה-_ref ובנקודת הכניסה הציבורית:
+ * ערכי קצה (-32768, 32767, הגבר -32768), כל אורך 0..67 (שארית שאינה
+ * כפולה של 8), באפרים מיושרים ולא מיושרים, ובדיקה שלא נכתב מעבר ל-count.
+ * ב-native ה-dispatch הוא ה-C; ב-S3 אותן בדיקות עוברות דרך PIE.
+ *
+ * בסוף שורת "KERNEL {json}" לכל קרנל: עלות frame (160 דגימות) ב-dispatch
+ * וב-ref - מחזורי CPU על הלוח, ns ב-native.
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "core/audio_kernels.h"
+
+#ifdef ESP_PLATFORM
+    #include "esp_cpu.h"
+    #define KERNEL_UNIT         "cycles"
+    static uint64_t now_ticks(void) {
+        return esp_cpu_get_cycle_count();
+    }
+#else
+    #include <time.h>
+    #define KERNEL_UNIT         "ns"
+    static uint64_t now_ticks(void) {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+    }
+#endif
+
+// =============================================================================
+// Fixtures
+// =============================================================================
+
+#define MAX_COUNT           67                  // שארית 3 אחרי 8 בלוקים
+#define BUF_SAMPLES         1024                // גם מעבר ל-DOT_CHUNK_SAMPLES
+#define GUARD               8                   // דגימות שמירה אחרי count
+#define GUARD_VALUE         0x5A5A
+#define FRAME_SAMPLES       160
+#define TIMING_FRAMES       2000
+
+// היסטים בדגימות: 0 מיושר, 1 ו-3 לא מיושרים ל-16 בתים
+static const uint16_t g_offsets[] = { 0, 1, 3 };
+static const int16_t g_gains[] = { 32767, 22938, 16384, 1, 0, -1, -16384, -32768 };
+
+static int16_t g_a[BUF_SAMPLES + GUARD] AUDIO_ALIGNED;
+static int16_t g_b[BUF_SAMPLES + GUARD] AUDIO_ALIGNED;
+static int16_t g_out[BUF_SAMPLES + GUARD] AUDIO_ALIGNED;
+static int16_t g_expect[BUF_SAMPLES + GUARD] AUDIO_ALIGNED;
+
+static volatile int64_t g_sink;
+
+/**
+ * @brief אות עם ערכי קצה צפופים - כל 8 דגימות מכילות -32768/32767
+ */
+static void fill_signals(uint32_t seed) {
+    for (int i = 0; i < BUF_SAMPLES; i++) {
+        seed = seed * 1103515245u + 12345u;
+        g_a[i] = (int16_t)(seed >> 16);
+        seed = seed * 1103515245u + 12345u;
+        g_b[i] = (int16_t)(seed >> 16);
+    }
+    for (int i = 0; i < BUF_SAMPLES; i += 8) {
+        g_a[i] = -32768;        g_b[i] = -32768;
+        g_a[i + 1] = 32767;     g_b[i + 1] = 32767;
+        g_a[i + 2] = -32768;    g_b[i + 2] = 32767;
+    }
+}
+
+static void fill_guard(int16_t* buf, uint16_t count) {
+    for (int i = 0; i < GUARD; i++) {
+        buf[count + i] = (int16_t)GUARD_VALUE;
+    }
+}
+
+static void assert_guard(const int16_t* buf, uint16_t count, const char* name) {
+    for (int i = 0; i < GUARD; i++) {
+        TEST_ASSERT_TRUE_MESSAGE(buf[count + i] == (int16_t)GUARD_VALUE, name);
+    }
+}
+
+static void assert_equal(const int16_t* expect, const int16_t* actual, uint16_t count,
+                         const char* name, uint16_t offset, int16_t gain) {
+    for (uint16_t i = 0; i < count; i++) {
+        if (expect[i] != actual[i]) {
+            char message[128];
+            snprintf(message, sizeof(message), "%s: count=%u offset=%u gain=%d [%u] %d != %d",
+                     name, count, offset, gain, i, expect[i], actual[i]);
+            TEST_ASSERT_TRUE_MESSAGE(false, message);
+        }
+    }
+}
+
+// =============================================================================
+// Oracle
+// =============================================================================
+
+static int16_t oracle_sat(int64_t x) {
+    return (int16_t)(x > 32767 ? 32767 : (x < -32768 ? -32768 : x));
+}
+
+static int16_t oracle_scale1(int16_t s, int16_t gain) {
+    // הזזה אריתמטית = floor, גם לשליליים
+    int64_t product = (int64_t)s * gain;
+    int64_t shifted = (product >= 0) ? product / 32768 : -((-product + 32767) / 32768);
+    return oracle_sat(shifted);
+}
+
+// =============================================================================
+// Tests
+// =============================================================================
+
+typedef void (*scale_fn_t)(int16_t*, const int16_t*, int16_t, uint16_t);
+typedef void (*mix_fn_t)(int16_t*, const int16_t*, const int16_t*, uint16_t);
+typedef int64_t (*dot_fn_t)(const int16_t*, const int16_t*, uint16_t);
+
+static void check_scale(scale_fn_t fn, const char* name) {
+    for (size_t o = 0; o < sizeof(g_offsets) / sizeof(g_offsets[0]); o++) {
+        uint16_t off = g_offsets[o];
+        for (size_t g = 0; g < sizeof(g_gains) / sizeof(g_gains[0]); g++) {
+            for (uint16_t count = 0; count <= MAX_COUNT; count++) {
+                for (uint16_t i = 0; i < count; i++) {
+                    g_expect[i] = oracle_scale1(g_a[off + i], g_gains[g]);
+                }
+                fill_guard(g_out + off, count);
+                fn(g_out + off, g_a + off, g_gains[g], count);
+                assert_equal(g_expect, g_out + off, count, name, off, g_gains[g]);
+                assert_guard(g_out + off, count, name);
+            }
+        }
+    }
+
+    // במקום (dst == src)
+    memcpy(g_out, g_a, BUF_SAMPLES * sizeof(int16_t));
+    for (uint16_t i = 0; i < FRAME_SAMPLES; i++) {
+        g_expect[i] = oracle_scale1(g_a[i], -32768);
+    }
+    fn(g_out, g_out, -32768, FRAME_SAMPLES);
+    assert_equal(g_expect, g_out, FRAME_SAMPLES, name, 0, -32768);
+}
+
+static void check_mac(scale_fn_t fn, const char* name) {
+    for (size_t o = 0; o < sizeof(g_offsets) / sizeof(g_offsets[0]); o++) {
+        uint16_t off = g_offsets[o];
+        for (size_t g = 0; g < sizeof(g_gains) / sizeof(g_gains[0]); g++) {
+            for (uint16_t count = 0; count <= MAX_COUNT; count++) {
+                // ה-accumulator הוא b - רוויה בשני הכיוונים
+                for (uint16_t i = 0; i < count; i++) {
+                    g_expect[i] = oracle_sat((int64_t)g_b[off + i] +
+                                             oracle_scale1(g_a[off + i], g_gains[g]));
+                }
+                memcpy(g_out + off, g_b + off, count * sizeof(int16_t));
+                fill_guard(g_out + off, count);
+                fn(g_out + off, g_a + off, g_gains[g], count);
+                assert_equal(g_expect, g_out + off, count, name, off, g_gains[g]);
+                assert_guard(g_out + off, count, name);
+            }
+        }
+    }
+}
+
+static void check_mix(mix_fn_t fn, const char* name) {
+    for (size_t o = 0; o < sizeof(g_offsets) / sizeof(g_offsets[0]); o++) {
+        uint16_t off = g_offsets[o];
+        for (uint16_t count = 0; count <= MAX_COUNT; count++) {
+            for (uint16_t i = 0; i < count; i++) {
+                g_expect[i] = oracle_sat((int64_t)g_a[off + i] + g_b[off + i]);
+            }
+            fill_guard(g_out + off, count);
+            fn(g_out + off, g_a + off, g_b + off, count);
+            assert_equal(g_expect, g_out + off, count, name, off, 0);
+            assert_guard(g_out + off, count, name);
+        }
+    }
+}
+
+static void check_dot(dot_fn_t fn, const char* name) {
+    static const uint16_t long_counts[] = { 160, 255, 256, 257, 513, BUF_SAMPLES };
+    char message[96];
+
+    for (size_t o = 0; o < sizeof(g_offsets) / sizeof(g_offsets[0]); o++) {
+        uint16_t off = g_offsets[o];
+        for (uint16_t count = 0; count <= MAX_COUNT + sizeof(long_counts) / sizeof(long_counts[0]); count++) {
+            uint16_t n = (count <= MAX_COUNT) ? count : long_counts[count - MAX_COUNT - 1];
+            if (n + off > BUF_SAMPLES) continue;
+
+            int64_t expect = 0;
+            for (uint16_t i = 0; i < n; i++) {
+                expect += (int64_t)g_a[off + i] * g_b[off + i];
+            }
+            snprintf(message, sizeof(message), "%s: count=%u offset=%u", name, n, off);
+            TEST_ASSERT_TRUE_MESSAGE(fn(g_a + off, g_b + off, n) == expect, message);
+        }
+    }
+
+    // אנרגיה מקסימלית: 1024 * 2^30 - מעבר ל-32 ביט ובתוך accumulator של 40
+    for (int i = 0; i < BUF_SAMPLES; i++) {
+        g_out[i] = -32768;
+    }
+    snprintf(message, sizeof(message), "%s: full-scale energy", name);
+    TEST_ASSERT_TRUE_MESSAGE(fn(g_out, g_out, BUF_SAMPLES) == (int64_t)BUF_SAMPLES << 30, message);
+}
+
+static void test_scale_ref(void)    { check_scale(audio_kernel_scale_ref, "scale_ref"); }
+static void test_scale(void)        { check_scale(audio_kernel_scale, "scale"); }
+static void test_mac_ref(void)      { check_mac(audio_kernel_mac_ref, "mac_ref"); }
+static void test_mac(void)          { check_mac(audio_kernel_mac, "mac"); }
+static void test_mix_ref(void)      { check_mix(audio_kernel_mix_ref, "mix_ref"); }
+static void test_mix(void)          { check_mix(audio_kernel_mix, "mix"); }
+static void test_dot_ref(void)      { check_dot(audio_kernel_dot_ref, "dot_ref"); }
+static void test_dot(void)          { check_dot(audio_kernel_dot, "dot"); }
+
+static void test_rms(void) {
+    for (int i = 0; i < FRAME_SAMPLES; i++) {
+        g_out[i] = (i & 1) ? 1000 : -1000;
+    }
+    TEST_ASSERT_TRUE(audio_kernel_rms(g_out, FRAME_SAMPLES) == 1000);
+    TEST_ASSERT_TRUE(audio_kernel_rms(g_out + 1, FRAME_SAMPLES - 1) == 1000);
+    TEST_ASSERT_TRUE(audio_kernel_rms(g_out, 0) == 0);
+
+    for (int i = 0; i < FRAME_SAMPLES; i++) {
+        g_out[i] = -32768;
+    }
+    TEST_ASSERT_TRUE(audio_kernel_rms(g_out, FRAME_SAMPLES) == 32768);
+}
+
+static void test_null_and_empty(void) {
+    // לא קורסים ולא כותבים
+    fill_guard(g_out, 0);
+    audio_kernel_scale(NULL, g_a, 32767, 8);
+    audio_kernel_scale(g_out, NULL, 32767, 8);
+    audio_kernel_mac(g_out, g_a, 32767, 0);
+    audio_kernel_mix(g_out, NULL, g_b, 8);
+    assert_guard(g_out, 0, "null/empty");
+    TEST_ASSERT_TRUE(audio_kernel_dot(NULL, g_b, 8) == 0);
+    TEST_ASSERT_TRUE(audio_kernel_dot(g_a, g_b, 0) == 0);
+}
+
+// =============================================================================
+// Frame Cost
+// =============================================================================
+
+static uint64_t frame_cost(void (*run)(void)) {
+    uint64_t best = UINT64_MAX;
+    for (int r = 0; r < 5; r++) {
+        uint64_t start = now_ticks();
+        for (int i = 0; i < TIMING_FRAMES; i++) run();
+        uint64_t t = now_ticks() - start;
+        if (t < best) best = t;
+    }
+    return best / TIMING_FRAMES;
+}
+
+static void run_scale(void)      { audio_kernel_scale(g_out, g_a, 22938, FRAME_SAMPLES); }
+static void run_scale_ref(void)  { audio_kernel_scale_ref(g_out, g_a, 22938, FRAME_SAMPLES); }
+static void run_mac(void)        { audio_kernel_mac(g_out, g_a, 22938, FRAME_SAMPLES); }
+static void run_mac_ref(void)    { audio_kernel_mac_ref(g_out, g_a, 22938, FRAME_SAMPLES); }
+static void run_mix(void)        { audio_kernel_mix(g_out, g_a, g_b, FRAME_SAMPLES); }
+static void run_mix_ref(void)    { audio_kernel_mix_ref(g_out, g_a, g_b, FRAME_SAMPLES); }
+static void run_dot(void)        { g_sink += audio_kernel_dot(g_a, g_b, FRAME_SAMPLES); }
+static void run_dot_ref(void)    { g_sink += audio_kernel_dot_ref(g_a, g_b, FRAME_SAMPLES); }
+
+static void report(const char* name, void (*fast)(void), void (*ref)(void)) {
+    uint64_t t_fast = frame_cost(fast);
+    uint64_t t_ref = frame_cost(ref);
+    printf("KERNEL {\"name\":\"%s\",\"unit\":\"%s\",\"per_frame\":%llu,\"ref_per_frame\":%llu,"
+           "\"accelerated\":%s}\n", name, KERNEL_UNIT, (unsigned long long)t_fast,
+           (unsigned long long)t_ref, audio_kernels_accelerated() ? "true" : "false");
+}
+
+static void test_frame_cost(void) {
+    fill_signals(0xC0FFEE);
+    report("scale", run_scale, run_scale_ref);
+    report("mac", run_mac, run_mac_ref);
+    report("mix", run_mix, run_mix_ref);
+    report("dot", run_dot, run_dot_ref);
+}
+
+// =============================================================================
+// Main
+// =============================================================================
+
+void setUp(void) {
+    fill_signals(0x1234567);
+}
+
+void tearDown(void) {}
+
+static int run_tests(void) {
+    // ב-S3 מדליק את PIE (אחרי הבדיקה העצמית); בשאר - C
+    audio_kernels_init();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_scale_ref);
+    RUN_TEST(test_scale);
+    RUN_TEST(test_mac_ref);
+    RUN_TEST(test_mac);
+    RUN_TEST(test_mix_ref);
+    RUN_TEST(test_mix);
+    RUN_TEST(test_dot_ref);
+    RUN_TEST(test_dot);
+    RUN_TEST(test_rms);
+    RUN_TEST(test_null_and_empty);
+    RUN_TEST(test_frame_cost);
+    return UNITY_END();
+}
+
+#ifdef ESP_PLATFORM
+void app_main(void) {
+    run_tests();
+}
+#else
+int main(void) {
+    return run_tests();
+}
+#endif
@@ -0,0 +1,48 @@
+/**
+ * @file bench_thresholds.h
+ * @brief ספי רגרסיה למדידות ב-test_bench.c (ns לפעולה, env:native)
+ *
+ * הערכים כ-3 פעמים מהנמדד על מכונת פיתוח (x86-64, בלי אופטימיזציה,
+ * כמו ברירת המחדל של env:native). מדידה מעל הסף נכשלת; מדידה בלי
+ * שורה כאן נכשלת גם היא. במכונה איטית יותר (CI משותף) מגדילים
+ * את כולם יחד: -DBENCH_THRESHOLD_SCALE=2.0 ב-build_flags.
+ */
+
+#ifndef TEST_BENCH_THRESHOLDS_H
+#define TEST_BENCH_THRESHOLDS_H
+
+#ifndef BENCH_THRESHOLD_SCALE
+#define BENCH_THRESHOLD_SCALE   1.0
+#endif
+
+typedef struct {
+    const char* name;
+    double max_ns;
+} bench_threshold_t;
+
+static const bench_threshold_t g_bench_thresholds[] = {
+    // Packet path
+    { "crc16_256B",               6000 },
+    { "packet_build_voice",       6000 },
+    { "packet_parse_voice",       5000 },
+
+    // Audio buffer
+    { "audio_buffer_write_read",  150 },
+
+    // DSP (frame = 160 samples, 20ms)
+    { "dsp_input_chain",          6500 },
+    { "aec_frame",                375000 },
+    { "vad_frame",                2000 },
+    { "resample_8k_16k",          150000 },
+    { "kernel_dot_160",           2000 },
+
+    // Codec
+    { "adpcm_encode_decode",      16000 },
+    { "voice_fec_encode",         2500 },
+    { "voice_hc_roundtrip",       300 },
+
+    // Display
+    { "display_render_screen",    130000 },
+};
+
+#endif // TEST_BENCH_THRESHOLDS_H
@@ -0,0 +1,385 @@
+/**
+ * @file test_bench.c
+ * @brief מדידות ביצועים לנתיבים החמים - רץ ב-env:native
+ *
+ *   pio test -e native -f test_bench -v
+ *   BENCH_OUTPUT=bench.json pio test -e native -f test_bench
+ *
+ * כל מדידה היא בדיקת Unity: ns לפעולה (frame או חבילה), המינימום מכמה
+ * חזרות, מול הסף ב-bench_thresholds.h. כל תוצאה מודפסת כשורת
+ * "BENCH {json}", ו-BENCH_OUTPUT שומר את כולן כמערך JSON אחד.
+ *
+ * אין כאן מימוש של security.h (הצפנה) - אין מה למדוד עד שיהיה.
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "config.h"
+#include "comm/protocol.h"
+#include "comm/voice_fec.h"
+#include "comm/voice_hc.h"
+#include "core/audio_buffer.h"
+#include "core/audio_dsp.h"
+#include "core/audio_kernels.h"
+#include "core/aec.h"
+#include "core/vad.h"
+#include "core/resampler.h"
+#include "core/adpcm.h"
+#include "hal/display.h"
+
+#include "bench_thresholds.h"
+
+// =============================================================================
+// Harness
+// =============================================================================
+
+#define BENCH_REPEATS       5
+#define BENCH_MIN_NS        20000000ULL     // כל חזרה לפחות 20ms
+#define BENCH_MAX_RESULTS   32
+
+typedef void (*bench_fn_t)(void);
+
+typedef struct {
+    const char* name;
+    const char* unit;
+    double ns_per_op;
+    double threshold_ns;
+} bench_result_t;
+
+static bench_result_t g_results[BENCH_MAX_RESULTS];
+static int g_result_count = 0;
+
+// תוצאות שהקומפיילר לא יכול לזרוק
+static volatile uint32_t g_sink;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static double threshold_of(const char* name) {
+    for (size_t i = 0; i < sizeof(g_bench_thresholds) / sizeof(g_bench_thresholds[0]); i++) {
+        if (strcmp(g_bench_thresholds[i].name, name) == 0) {
+            return g_bench_thresholds[i].max_ns * BENCH_THRESHOLD_SCALE;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief מריץ fn עד BENCH_MIN_NS, BENCH_REPEATS פעמים, ובודק מול הסף
+ */
+static void bench(const char* name, const char* unit, bench_fn_t fn) {
+    // כיול: כמה איטרציות ממלאות חזרה אחת
+    uint64_t iterations = 1;
+    for (;;) {
+        uint64_t start = now_ns();
+        for (uint64_t i = 0; i < iterations; i++) fn();
+        if (now_ns() - start >= BENCH_MIN_NS / 4) break;
+        iterations *= 2;
+    }
+    iterations *= 4;
+
+    double best = 0;
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        uint64_t start = now_ns();
+        for (uint64_t i = 0; i < iterations; i++) fn();
+        double ns = (double)(now_ns() - start) / (double)iterations;
+        if (r == 0 || ns < best) best = ns;
+    }
+
+    double threshold = threshold_of(name);
+    printf("BENCH {\"name\":\"%s\",\"unit\":\"%s\",\"ns_per_op\":%.1f,\"threshold_ns\":%.0f}\n",
+           name, unit, best, threshold);
+
+    if (g_result_count < BENCH_MAX_RESULTS) {
+        g_results[g_result_count++] = (bench_result_t){ name, unit, best, threshold };
+    }
+
+    char message[96];
+    snprintf(message, sizeof(message), "%s: %.1f ns > %.0f ns", name, best, threshold);
+    TEST_ASSERT_TRUE_MESSAGE(threshold > 0, "no threshold in bench_thresholds.h");
+    TEST_ASSERT_TRUE_MESSAGE(best <= threshold, message);
+}
+
+static void write_results(void) {
+    const char* path = getenv("BENCH_OUTPUT");
+    if (!path) return;
+
+    FILE* f = fopen(path, "w");
+    if (!f) return;
+    fprintf(f, "[\n");
+    for (int i = 0; i < g_result_count; i++) {
+        fprintf(f, "  {\"name\":\"%s\",\"unit\":\"%s\",\"ns_per_op\":%.1f,\"threshold_ns\":%.0f}%s\n",
+                g_results[i].name, g_results[i].unit, g_results[i].ns_per_op,
+                g_results[i].threshold_ns, (i + 1 < g_result_count) ? "," : "");
+    }
+    fprintf(f, "]\n");
+    fclose(f);
+}
+
+// =============================================================================
+// Fixtures
+// =============================================================================
+
+#define VOICE_SAMPLES       (AUDIO_FRAME_SAMPLES / 2)   // protocol_send_voice מפצל frame לשתי חבילות
+
+static int16_t g_speech[AUDIO_FRAME_SAMPLES];           // "דיבור": סינוסים ורעש
+static int16_t g_work[AUDIO_FRAME_SAMPLES * 2];
+static uint8_t g_packet[MAX_PACKET_SIZE];
+static uint16_t g_packet_len;
+static voice_data_t g_voice;
+
+static audio_ring_buffer_t g_ring;
+static audio_dsp_t g_dsp;
+static aec_state_t g_aec;
+static vad_state_t g_vad;
+static resampler_t g_up;
+static adpcm_state_t g_adpcm_enc;
+static adpcm_state_t g_adpcm_dec;
+static uint8_t g_adpcm[AUDIO_FRAME_SAMPLES / 2];
+static voice_fec_encoder_t g_fec;
+static voice_fec_parity_t g_parity;
+static voice_hc_tx_t g_hc_tx;
+static voice_hc_rx_t g_hc_rx;
+
+static void make_speech(void) {
+    uint32_t seed = 12345;
+    for (int i = 0; i < AUDIO_FRAME_SAMPLES; i++) {
+        // שני טונים (רבע ושמינית מהקצב הגבוה) ורעש לבן קטן
+        static const int16_t tone[8] = { 0, 7071, 10000, 7071, 0, -7071, -10000, -7071 };
+        seed = seed * 1103515245u + 12345u;
+        g_speech[i] = (int16_t)(tone[i & 7] + tone[(i * 3) & 7] / 2 + (int16_t)((seed >> 16) & 0x3FF) - 512);
+    }
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// =============================================================================
+// Packet Path
+// =============================================================================
+
+static void run_crc16(void) {
+    g_sink += protocol_crc16(g_packet, MAX_PACKET_SIZE);
+}
+
+static void run_build_packet(void) {
+    g_packet_len = protocol_build_packet(MSG_VOICE_DATA, "12345678", &g_voice,
+                                         VOICE_DATA_HEADER_SIZE + g_voice.audio_len, g_packet);
+    g_sink += g_packet_len;
+}
+
+static void run_parse_packet(void) {
+    packet_header_t header;
+    const void* payload;
+    g_sink += protocol_parse_packet(g_packet, g_packet_len, &header, &payload);
+}
+
+static void test_crc16(void) {
+    memset(g_packet, 0xA5, sizeof(g_packet));
+    bench("crc16_256B", "packet", run_crc16);
+}
+
+static void test_packet_build(void) {
+    bench("packet_build_voice", "packet", run_build_packet);
+}
+
+static void test_packet_parse(void) {
+    run_build_packet();
+    packet_header_t header;
+    const void* payload;
+    TEST_ASSERT_TRUE(protocol_parse_packet(g_packet, g_packet_len, &header, &payload));
+    bench("packet_parse_voice", "packet", run_parse_packet);
+}
+
+// =============================================================================
+// Audio Buffer
+// =============================================================================
+
+static void run_buffer_write_read(void) {
+    audio_frame_t frame;
+    audio_buffer_write(&g_ring, (const uint8_t*)g_speech, AUDIO_FRAME_SIZE, 1);
+    g_sink += audio_buffer_read(&g_ring, &frame);
+}
+
+static void test_audio_buffer(void) {
+    audio_buffer_init(&g_ring);
+    bench("audio_buffer_write_read", "frame", run_buffer_write_read);
+}
+
+// =============================================================================
+// DSP
+// =============================================================================
+
+static void run_dsp(void) {
+    memcpy(g_work, g_speech, sizeof(g_speech));
+    audio_dsp_process(&g_dsp, g_work, AUDIO_FRAME_SAMPLES);
+    g_sink += g_dsp.output_level;
+}
+
+static void run_aec(void) {
+    memcpy(g_work, g_speech, sizeof(g_speech));
+    aec_push_reference(&g_aec, g_speech, AUDIO_FRAME_SAMPLES);
+    aec_process(&g_aec, g_work, AUDIO_FRAME_SAMPLES);
+    g_sink += (uint16_t)g_work[0];
+}
+
+static void run_vad(void) {
+    g_sink += vad_process(&g_vad, g_speech, AUDIO_FRAME_SAMPLES, 2000);
+}
+
+static void run_resample_up(void) {
+    g_sink += resampler_process(&g_up, g_speech, AUDIO_FRAME_SAMPLES,
+                                g_work, AUDIO_FRAME_SAMPLES * 2);
+}
+
+static void run_kernel_dot(void) {
+    g_sink += (uint32_t)audio_kernel_dot(g_speech, g_speech, AUDIO_FRAME_SAMPLES);
+}
+
+// שרשרת הקלט של process_input_samples (hal/audio.c): gain, DC, gate, AGC
+static void test_dsp_input_chain(void) {
+    audio_dsp_init(&g_dsp, AUDIO_SAMPLE_RATE);
+    audio_dsp_set_gain(&g_dsp, 70);
+    audio_dsp_set_dc_block(&g_dsp, true);
+    audio_dsp_set_gate(&g_dsp, true, 500);
+    audio_dsp_set_agc(&g_dsp, true);
+    bench("dsp_input_chain", "frame", run_dsp);
+}
+
+static void test_aec(void) {
+    aec_init(&g_aec);
+    aec_set_enabled(&g_aec, true);
+    bench("aec_frame", "frame", run_aec);
+}
+
+static void test_vad(void) {
+    vad_init(&g_vad, AUDIO_SAMPLE_RATE);
+    bench("vad_frame", "frame", run_vad);
+}
+
+static void test_resampler(void) {
+    TEST_ASSERT_TRUE(resampler_init(&g_up, 8000, 16000));
+    bench("resample_8k_16k", "frame", run_resample_up);
+}
+
+static void test_kernel_dot(void) {
+    audio_kernels_init();
+    bench("kernel_dot_160", "frame", run_kernel_dot);
+}
+
+// =============================================================================
+// Codec
+// =============================================================================
+
+static void run_adpcm(void) {
+    adpcm_encode(&g_adpcm_enc, g_speech, AUDIO_FRAME_SAMPLES, g_adpcm);
+    adpcm_decode(&g_adpcm_dec, g_adpcm, AUDIO_FRAME_SAMPLES, g_work);
+    g_sink += (uint16_t)g_work[0];
+}
+
+static void run_fec(void) {
+    g_voice.sequence++;
+    g_sink += voice_fec_encoder_add(&g_fec, &g_voice, &g_parity);
+}
+
+static void run_hc(void) {
+    uint8_t out[MAX_PACKET_SIZE];
+    voice_data_t restored;
+    g_voice.sequence++;
+    g_voice.timestamp += VOICE_SAMPLES * 1000 / AUDIO_LINK_RATE;
+    uint16_t len = voice_hc_compress(&g_hc_tx, &g_voice, out, sizeof(out));
+    if (len == 0) {
+        voice_hc_rx_refresh(&g_hc_rx, &g_voice);
+    } else {
+        g_sink += voice_hc_decompress(&g_hc_rx, out, len, &restored);
+    }
+}
+
+static void test_adpcm(void) {
+    adpcm_init(&g_adpcm_enc);
+    adpcm_init(&g_adpcm_dec);
+    bench("adpcm_encode_decode", "frame", run_adpcm);
+}
+
+static void test_voice_fec(void) {
+    voice_fec_encoder_init(&g_fec, 4);
+    bench("voice_fec_encode", "packet", run_fec);
+}
+
+static void test_voice_hc(void) {
+    voice_hc_tx_init(&g_hc_tx, 7);
+    voice_hc_rx_init(&g_hc_rx, 7, "12345678");
+
+    // החבילה הראשונה מרעננת את ה-context, השנייה כבר דחוסה
+    uint8_t out[MAX_PACKET_SIZE];
+    voice_data_t restored;
+    run_hc();
+    g_voice.sequence++;
+    g_voice.timestamp += VOICE_SAMPLES * 1000 / AUDIO_LINK_RATE;
+    uint16_t len = voice_hc_compress(&g_hc_tx, &g_voice, out, sizeof(out));
+    TEST_ASSERT_TRUE(len > 0);
+    TEST_ASSERT_TRUE(voice_hc_decompress(&g_hc_rx, out, len, &restored));
+    TEST_ASSERT_TRUE(restored.sequence == g_voice.sequence);
+
+    bench("voice_hc_roundtrip", "packet", run_hc);
+}
+
+// =============================================================================
+// Display
+// =============================================================================
+
+static void run_render(void) {
+    static const char* items[] = { "12345678", "FREQ 0042", "87654321", "FREQ 0007" };
+
+    display_clear();
+    display_status_bar(80, 3, true, false);
+    display_print_aligned(16, "IN CALL", FONT_MEDIUM, ALIGN_CENTER);
+    display_list(items, 4, 1, 32);
+    display_progress_bar(8, 56, 112, 60);
+    display_update();
+}
+
+static void test_display_render(void) {
+    display_init();
+    bench("display_render_screen", "frame", run_render);
+}
+
+// =============================================================================
+// Main
+// =============================================================================
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+
+    make_speech();
+    memset(&g_voice, 0, sizeof(g_voice));
+    g_voice.audio_len = VOICE_SAMPLES * sizeof(int16_t);
+    memcpy(g_voice.audio_data, g_speech, g_voice.audio_len);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_crc16);
+    RUN_TEST(test_packet_build);
+    RUN_TEST(test_packet_parse);
+    RUN_TEST(test_audio_buffer);
+    RUN_TEST(test_dsp_input_chain);
+    RUN_TEST(test_aec);
+    RUN_TEST(test_vad);
+    RUN_TEST(test_resampler);
+    RUN_TEST(test_kernel_dot);
+    RUN_TEST(test_adpcm);
+    RUN_TEST(test_voice_fec);
+    RUN_TEST(test_voice_hc);
+    RUN_TEST(test_display_render);
+    int failures = UNITY_END();
+
+    write_results();
+    return failures;
+}
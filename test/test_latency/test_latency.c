@@ -0,0 +1,518 @@
+/**
+ * @file test_latency.c
+ * @brief השהיית פה-לאוזן בין שני מכשירים מדומים - רץ ב-env:native
+ *
+ *   pio test -e native -f test_latency -v
+ *
+ * מכשיר A מקבל גל ידוע כ"מיקרופון" (sim_audio_capture -> ה-callback של
+ * audio_start_recording_callback), משדר דרך protocol_send_voice ותור השידור
+ * לערוץ מדומה, ומכשיר B מקבל (sim_radio_receive -> protocol -> buffer
+ * ההשמעה) ומשמיע (sim_audio_playback). הפלט של B מושווה לקלט של A
+ * ב-cross-correlation: ההשהיה לכל חבילת קול ואחוז החבילות שלא נשמעו.
+ *
+ * לפני הדיבור A מחייג ל-B ו-B עונה (MSG_CALL_REQUEST/ACCEPT דרך הערוץ),
+ * כך ש-FEC ודחיסת ה-header פעילים כמו בשיחה אמיתית.
+ *
+ * הערוץ הוא LoRa בתצורת ברירת המחדל: כל חבילה תופסת את האוויר למשך
+ * radio_get_airtime_us, ה-TX done (והחבילה הבאה מהתור) מגיעים רק בסופו,
+ * ושידור שמתחיל לפני שהקודם הסתיים מכשיל את הבדיקה. ב-SF7/125kHz ערוץ
+ * PCM של 128kbps גדול פי ~25 ממה שהאוויר נושא - התור מתמלא וזורק, ומה
+ * שעובר מגיע באיחור של עד תור מלא של זמני שידור. הבדיקה מודדת את זה
+ * כמו שזה ונכשלת רק אם המצב מחמיר.
+ *
+ * בערוץ רווי קבוצת FEC אף פעם לא מגיעה עם חבילה חסרה אחת בלבד, ולכן
+ * תרחישי האובדן רצים גם על ערוץ שנושא את הזרם (FAST_LINK_BPS) - שם
+ * נמדדים הצינור עצמו ושחזור ה-FEC.
+ *
+ * שני המכשירים חולקים את אותם מודולים בתהליך אחד: A משתמש רק בצד השידור
+ * של core/voice_path (VAD, resampler שידור, מקודדי FEC/HC) ו-B רק בצד
+ * הקבלה (מפענחים, resampler קבלה, buffer ו-DSP השמעה). אלה אותן פונקציות
+ * ש-main.c קורא - אין כאן עותק של הנתיב. AEC כבוי - בתהליך אחד
+ * ה-reference של B היה מגיע למיקרופון של A.
+ *
+ * הזמן מדומה בצעדים של 1ms, בלי sleep ובלי שעון קיר, ולכן התוצאה זהה
+ * בכל ריצה.
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "config.h"
+#include "comm/protocol.h"
+#include "comm/radio.h"
+#include "comm/voice_fec.h"
+#include "core/audio_buffer.h"
+#include "core/telemetry.h"
+#include "core/voice_path.h"
+#include "hal/audio.h"
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#define TICK_SAMPLES        AUDIO_FRAME_SAMPLES         // 20ms
+#define TEST_SECONDS        3
+#define TEST_TICKS          (TEST_SECONDS * 1000 / AUDIO_FRAME_DURATION_MS)
+#define DRAIN_TICKS         200                         // תור מלא + jitter buffer
+#define TOTAL_MS            ((TEST_TICKS + DRAIN_TICKS) * AUDIO_FRAME_DURATION_MS)
+#define INPUT_SAMPLES       (TEST_TICKS * TICK_SAMPLES)
+#define OUTPUT_SAMPLES      ((TEST_TICKS + DRAIN_TICKS) * TICK_SAMPLES)
+
+// frame של 20ms יוצא בשתי חבילות (VOICE_MAX_AUDIO_LEN ב-protocol.c)
+#define BLOCK_SAMPLES       (TICK_SAMPLES / 2)
+#define INPUT_BLOCKS        (INPUT_SAMPLES / BLOCK_SAMPLES)
+
+#define CHANNEL_MAX_PACKETS 64
+
+#define MAX_LAG_MS          2500
+#define DELIVERED_CORR      0.8         // מתחת לזה = לא נשמע
+
+#define LORA_LINK           0           // זמן באוויר לפי radio_get_airtime_us
+#define FAST_LINK_BPS       500000      // ערוץ שנושא PCM עם parity (~5ms לחבילה)
+#define SETUP_MAX_MS        2000        // חיוג + מענה ב-SF7
+
+// ספי הבדיקה - תקרות: שיפור לא מכשיל, החמרה כן
+#define LOSS_LOSSY_PERCENT  5           // אובדן חבילות בערוץ
+#define LATENCY_MARGIN_MS   200         // frame לכידה + jitter buffer + resampler
+#define LORA_MAX_LOSS_PCT   99.5        // היום ~99% (התור זורק, ו-parity תופס אוויר)
+#define LORA_MAX_DROP_PCT   97.0        // היום ~96% מהחבילות נזרקות בתור
+#define FAST_MAX_LATENCY_MS 200         // יעד הטבלה ב-TESTING.md 2.3
+#define FAST_MAX_LOSS_PCT   1.0         // ערוץ נקי - רק ה-frame הראשון/אחרון
+
+// =============================================================================
+// Simulated Channel
+// =============================================================================
+
+typedef struct {
+    uint8_t  data[RADIO_MAX_PACKET_SIZE];
+    uint8_t  length;
+    uint32_t deliver_ms;
+} air_packet_t;
+
+typedef struct {
+    air_packet_t packets[CHANNEL_MAX_PACKETS];
+    uint16_t head;
+    uint16_t tail;
+    uint32_t now_ms;
+    uint32_t busy_until_ms;     // סוף ה-TX הנוכחי
+    uint32_t busy_ms;           // זמן באוויר בזמן הדיבור
+    uint32_t max_airtime_ms;
+    uint8_t  loss_percent;
+    uint32_t link_bps;          // LORA_LINK או קצב קבוע
+    uint32_t seed;
+    uint32_t sent;
+    uint32_t dropped;
+} channel_t;
+
+static channel_t g_channel;
+
+static uint32_t channel_random(channel_t* ch) {
+    ch->seed = ch->seed * 1103515245u + 12345u;
+    return (ch->seed >> 16) & 0x7FFF;
+}
+
+static void channel_on_air(const uint8_t* data, uint8_t length, void* ctx) {
+    channel_t* ch = (channel_t*)ctx;
+    TEST_ASSERT_TRUE_MESSAGE(ch->now_ms >= ch->busy_until_ms, "TX started while the previous one was on air");
+
+    uint32_t airtime_us = ch->link_bps ? (uint32_t)((uint64_t)length * 8 * 1000000 / ch->link_bps)
+                                       : radio_get_airtime_us(length);
+    uint32_t airtime_ms = (airtime_us + 999) / 1000;
+    TEST_ASSERT_TRUE(airtime_ms > 0);
+    ch->busy_until_ms = ch->now_ms + airtime_ms;
+    if (airtime_ms > ch->max_airtime_ms) {
+        ch->max_airtime_ms = airtime_ms;
+    }
+    ch->sent++;
+
+    if (channel_random(ch) % 100 < ch->loss_percent) {
+        ch->dropped++;
+        return;
+    }
+
+    uint16_t next = (ch->head + 1) % CHANNEL_MAX_PACKETS;
+    TEST_ASSERT_TRUE_MESSAGE(next != ch->tail, "channel queue full");
+
+    air_packet_t* pkt = &ch->packets[ch->head];
+    memcpy(pkt->data, data, length);
+    pkt->length = length;
+    pkt->deliver_ms = ch->busy_until_ms;        // RX done של B עם TX done של A
+    ch->head = next;
+}
+
+static void channel_update(channel_t* ch, bool talking) {
+    // TX done רק כשהחבילה סיימה לצאת - ממנו התור של A שולח את הבאה
+    if (radio_get_state() == RADIO_STATE_TX && ch->now_ms >= ch->busy_until_ms) {
+        radio_update();
+    }
+    if (talking && radio_get_state() == RADIO_STATE_TX) {
+        ch->busy_ms++;
+    }
+
+    while (ch->tail != ch->head && ch->packets[ch->tail].deliver_ms <= ch->now_ms) {
+        air_packet_t* pkt = &ch->packets[ch->tail];
+        ch->tail = (ch->tail + 1) % CHANNEL_MAX_PACKETS;
+        sim_radio_receive(pkt->data, pkt->length, -60, 8);
+    }
+}
+
+// =============================================================================
+// Device A (TX) / Device B (RX) - core/voice_path כמו ב-main.c
+// =============================================================================
+
+static bool g_call_accepted = false;
+
+static void on_audio_captured(const int16_t* samples, uint16_t sample_count) {
+    voice_path_capture(samples, sample_count);
+}
+
+static void on_protocol_message(message_type_t type, const char* src_id,
+                                const void* payload, uint16_t len) {
+    switch (type) {
+        // B עונה לחיוג; A מקבל את המענה (בתהליך אחד - אותו protocol)
+        case MSG_CALL_REQUEST:
+            protocol_send_call_response(src_id, true);
+            break;
+
+        case MSG_CALL_ACCEPT:
+            g_call_accepted = true;
+            break;
+
+        case MSG_VOICE_DTX:
+        case MSG_VOICE_SILENCE:
+            if (len >= sizeof(voice_sid_t)) {
+                voice_path_receive_sid((const voice_sid_t*)payload);
+            }
+            break;
+
+        case MSG_VOICE_DATA:
+            if (len >= sizeof(voice_data_t)) {
+                voice_path_receive((const voice_data_t*)payload, NULL);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+// =============================================================================
+// Signal & Analysis
+// =============================================================================
+
+static int16_t g_input[INPUT_SAMPLES];
+static int16_t g_output[OUTPUT_SAMPLES];
+static uint32_t g_output_active[OUTPUT_SAMPLES + 1];    // דגימות לא-אפס עד i (סכום מצטבר)
+
+/**
+ * @brief "דיבור": רעש מסונן עם מעטפת הברות (~3 בשנייה), בלי שקט מלא
+ *
+ * רעש ולא טון - ל-cross-correlation יש שיא אחד חד ולא שיא בכל מחזור.
+ */
+static void make_input(void) {
+    uint32_t seed = 0xC0FFEE;
+    int32_t lp = 0;
+
+    for (int i = 0; i < INPUT_SAMPLES; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        int32_t white = (int32_t)(seed >> 16) - 32768;
+        lp += (white - lp) / 2;                                     // מעט פחות ZCR
+
+        double env = 0.35 + 0.65 * fabs(sin(M_PI * 3.0 * i / AUDIO_SAMPLE_RATE));
+        g_input[i] = (int16_t)(lp * env * 0.5);
+    }
+}
+
+/**
+ * @brief מתאם מנורמל של בלוק קלט מול הפלט בהיסט lag
+ */
+static double block_correlation(int start, int lag) {
+    int64_t xy = 0, xx = 0, yy = 0;
+    for (int i = 0; i < BLOCK_SAMPLES; i++) {
+        int64_t x = g_input[start + i];
+        int64_t y = g_output[start + lag + i];
+        xy += x * y;
+        xx += x * x;
+        yy += y * y;
+    }
+    if (xx == 0 || yy == 0) return 0;
+    return (double)xy / sqrt((double)xx * (double)yy);
+}
+
+typedef struct {
+    uint32_t blocks;
+    uint32_t lost;
+    double   loss_pct;
+    double   latency_ms;            // חציון
+    double   latency_min_ms;
+    double   latency_max_ms;
+} latency_result_t;
+
+static int compare_int(const void* a, const void* b) {
+    return *(const int*)a - *(const int*)b;
+}
+
+static void analyze(latency_result_t* result) {
+    const int max_lag = MAX_LAG_MS * AUDIO_SAMPLE_RATE / 1000;
+    static int lags[INPUT_BLOCKS];
+    int delivered = 0;
+
+    memset(result, 0, sizeof(*result));
+
+    // רוב הפלט שקט (החבילות שנזרקו) - בלוק פלט של אפסים לא נבדק
+    g_output_active[0] = 0;
+    for (int i = 0; i < OUTPUT_SAMPLES; i++) {
+        g_output_active[i + 1] = g_output_active[i] + (g_output[i] != 0);
+    }
+
+    // ה-frame הראשון מחמם את ה-DC/AGC - לא נספר
+    for (int b = 2; b < INPUT_BLOCKS; b++) {
+        int start = b * BLOCK_SAMPLES;
+        double best = 0;
+        int best_lag = 0;
+
+        // כל חבילה בנפרד: בין חבילות שנזרקו אין הסתרה וההיסט משתנה
+        for (int lag = 0; lag <= max_lag && start + lag + BLOCK_SAMPLES <= OUTPUT_SAMPLES; lag++) {
+            if (g_output_active[start + lag + BLOCK_SAMPLES] == g_output_active[start + lag]) {
+                continue;
+            }
+            double c = block_correlation(start, lag);
+            if (c > best) {
+                best = c;
+                best_lag = lag;
+            }
+        }
+
+        result->blocks++;
+        if (best >= DELIVERED_CORR) {
+            lags[delivered++] = best_lag;
+        } else {
+            result->lost++;
+        }
+    }
+
+    result->loss_pct = 100.0 * result->lost / result->blocks;
+    if (delivered > 0) {
+        qsort(lags, delivered, sizeof(int), compare_int);
+        result->latency_ms = 1000.0 * lags[delivered / 2] / AUDIO_SAMPLE_RATE;
+        result->latency_min_ms = 1000.0 * lags[0] / AUDIO_SAMPLE_RATE;
+        result->latency_max_ms = 1000.0 * lags[delivered - 1] / AUDIO_SAMPLE_RATE;
+    }
+}
+
+// =============================================================================
+// Scenario
+// =============================================================================
+
+typedef struct {
+    latency_result_t latency;
+    uint32_t voice_frames_tx;
+    uint32_t voice_packets_rx;
+    uint32_t tx_queue_dropped;
+    uint32_t fec_recovered;
+    double   link_busy_pct;         // זמן באוויר מתוך זמן הדיבור
+    double   tx_drop_pct;           // חבילות (קול ו-parity) שנזרקו בתור
+} scenario_result_t;
+
+/**
+ * @brief A מחייג ל-B ו-B עונה - בסוף FEC ודחיסת header פעילים
+ */
+static void negotiate_call(void) {
+    g_call_accepted = false;
+    protocol_send_call_request(protocol_get_device_id());
+
+    while (g_channel.now_ms < SETUP_MAX_MS) {
+        channel_update(&g_channel, false);
+        if (g_call_accepted && radio_get_state() != RADIO_STATE_TX) {
+            break;
+        }
+        g_channel.now_ms++;
+    }
+
+    TEST_ASSERT_TRUE_MESSAGE(g_call_accepted, "call not set up");
+    TEST_ASSERT_TRUE_MESSAGE(protocol_get_fec_group_size() == VOICE_FEC_GROUP_SIZE,
+                             "FEC not negotiated");
+}
+
+static void run_scenario(const char* name, uint32_t link_bps, uint8_t loss_percent,
+                         scenario_result_t* result) {
+    audio_config_t audio_cfg;
+    audio_get_default_config(&audio_cfg);
+    audio_cfg.use_aec = false;
+    audio_deinit();
+    TEST_ASSERT_TRUE(audio_init(&audio_cfg));
+
+    protocol_init();
+    protocol_set_device_id("12345678");
+    protocol_set_callback(on_protocol_message);
+
+    memset(&g_channel, 0, sizeof(g_channel));
+    g_channel.link_bps = link_bps;
+    g_channel.seed = 2024;
+    sim_radio_set_air(channel_on_air, &g_channel);
+
+    voice_path_init(audio_cfg.sample_rate);
+    TEST_ASSERT_TRUE(voice_path_set_link_rate(audio_cfg.sample_rate, AUDIO_LINK_RATE));
+
+    // השיחה נקבעת בערוץ נקי; המדדים נספרים מתחילת הדיבור
+    negotiate_call();
+    uint32_t start_ms = g_channel.now_ms + 1;
+    g_channel.loss_percent = loss_percent;
+    g_channel.sent = 0;
+    g_channel.max_airtime_ms = 0;
+
+    static telemetry_snapshot_t before, after;
+    telemetry_snapshot(&before);
+    uint32_t tx_dropped = protocol_get_tx_dropped();
+    voice_fec_reset_stats();
+
+    // A לוחץ PTT
+    voice_path_tx_reset();
+    TEST_ASSERT_TRUE(audio_start_recording_callback(on_audio_captured));
+
+    memset(g_output, 0, sizeof(g_output));
+    for (uint32_t now = 0; now < TOTAL_MS; now++) {
+        uint32_t tick = now / AUDIO_FRAME_DURATION_MS;
+        bool frame_edge = (now % AUDIO_FRAME_DURATION_MS) == 0;
+        g_channel.now_ms = start_ms + now;
+
+        // ה-frame שהוקלט ב-tick הקודם מגיע עכשיו מה-I2S, כמו במכשיר
+        if (frame_edge && tick >= 1 && tick <= TEST_TICKS) {
+            sim_audio_capture(&g_input[(tick - 1) * TICK_SAMPLES], TICK_SAMPLES);
+        } else if (frame_edge && tick == TEST_TICKS + 1) {
+            audio_stop_recording();
+        }
+
+        channel_update(&g_channel, tick >= 1 && tick <= TEST_TICKS);
+
+        // B: כמו handle_audio_playback, והרמקול מושך frame כל 20ms
+        if (frame_edge) {
+            voice_path_update(start_ms + now);
+            sim_audio_playback(&g_output[tick * TICK_SAMPLES], TICK_SAMPLES);
+        }
+    }
+
+    audio_stop_playback();
+    sim_radio_set_air(NULL, NULL);
+    TEST_ASSERT_TRUE_MESSAGE(radio_get_state() != RADIO_STATE_TX, "TX queue not drained");
+
+    telemetry_snapshot(&after);
+    result->voice_frames_tx = after.metrics[TM_VOICE_TX_FRAMES] - before.metrics[TM_VOICE_TX_FRAMES];
+    result->voice_packets_rx = after.metrics[TM_VOICE_RX_FRAMES] - before.metrics[TM_VOICE_RX_FRAMES];
+    result->tx_queue_dropped = protocol_get_tx_dropped() - tx_dropped;
+    result->fec_recovered = voice_fec_get_stats()->frames_recovered;
+    result->link_busy_pct = 100.0 * g_channel.busy_ms / (TEST_TICKS * AUDIO_FRAME_DURATION_MS);
+    uint32_t offered = g_channel.sent + result->tx_queue_dropped;
+    result->tx_drop_pct = offered ? 100.0 * result->tx_queue_dropped / offered : 0;
+
+    latency_result_t* latency = &result->latency;
+    analyze(latency);
+    printf("LATENCY {\"scenario\":\"%s\",\"link_bps\":%u,\"channel_loss_pct\":%u,\"max_airtime_ms\":%u,"
+           "\"link_busy_pct\":%.1f,\"packets\":%u,\"packets_dropped\":%u,\"tx_queue_dropped\":%u,"
+           "\"voice_frames_tx\":%u,\"voice_packets_rx\":%u,\"fec_recovered\":%u,"
+           "\"blocks\":%u,\"blocks_lost\":%u,\"loss_pct\":%.1f,"
+           "\"latency_ms\":%.1f,\"latency_min_ms\":%.1f,\"latency_max_ms\":%.1f}\n",
+           name, (unsigned)link_bps, (unsigned)loss_percent, (unsigned)g_channel.max_airtime_ms,
+           result->link_busy_pct, (unsigned)g_channel.sent, (unsigned)g_channel.dropped,
+           (unsigned)result->tx_queue_dropped,
+           (unsigned)result->voice_frames_tx, (unsigned)result->voice_packets_rx,
+           (unsigned)result->fec_recovered,
+           (unsigned)latency->blocks, (unsigned)latency->lost, latency->loss_pct,
+           latency->latency_ms, latency->latency_min_ms, latency->latency_max_ms);
+}
+
+// =============================================================================
+// Tests
+// =============================================================================
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void test_airtime(void) {
+    radio_config_t cfg;
+    radio_get_default_config(&cfg);
+    radio_set_config(&cfg);
+
+    // SF7/125kHz/CR4/5, preamble 8, header מפורש, CRC - LoRa calculator של Semtech
+    TEST_ASSERT_UINT32_WITHIN(50, 41216, radio_get_airtime_us(10));
+    TEST_ASSERT_UINT32_WITHIN(50, 399616, radio_get_airtime_us(255));
+
+    // SF12 מפעיל low data rate optimize
+    radio_set_spreading_factor(12);
+    TEST_ASSERT_UINT32_WITHIN(500, 991232, radio_get_airtime_us(10));
+    radio_set_config(&cfg);
+}
+
+static void test_clean_channel(void) {
+    scenario_result_t result;
+    run_scenario("clean", LORA_LINK, 0, &result);
+    const latency_result_t* latency = &result.latency;
+
+    TEST_ASSERT_TRUE(result.voice_frames_tx > 0);
+    TEST_ASSERT_TRUE(result.voice_packets_rx > 0);
+
+    // PCM לא נכנס לאוויר - תקרות על המצב של היום, לא דרישה שיישאר כך
+    TEST_ASSERT_TRUE_MESSAGE(latency->loss_pct <= LORA_MAX_LOSS_PCT, "more voice lost than today");
+    TEST_ASSERT_TRUE_MESSAGE(result.tx_drop_pct <= LORA_MAX_DROP_PCT, "more packets dropped in the TX queue");
+
+    // התור חוסם את ההשהיה: עד DEPTH חבילות ממתינות + זו שבאוויר
+    uint32_t queue_bound_ms = (PROTOCOL_TX_QUEUE_DEPTH + 1) * g_channel.max_airtime_ms;
+    TEST_ASSERT_TRUE_MESSAGE(latency->latency_max_ms <= queue_bound_ms + LATENCY_MARGIN_MS,
+                             "latency above a full TX queue");
+}
+
+static void test_pipeline_latency(void) {
+    // ערוץ שנושא את הזרם: ההשהיה היא של הצינור עצמו
+    scenario_result_t result;
+    run_scenario("fast_clean", FAST_LINK_BPS, 0, &result);
+    const latency_result_t* latency = &result.latency;
+
+    TEST_ASSERT_TRUE(result.tx_queue_dropped == 0);
+    TEST_ASSERT_TRUE_MESSAGE(latency->loss_pct <= FAST_MAX_LOSS_PCT, "voice lost on a clean link");
+    TEST_ASSERT_TRUE_MESSAGE(latency->latency_max_ms <= FAST_MAX_LATENCY_MS,
+                             "mouth-to-ear latency above target");
+}
+
+static void test_lossy_channel(void) {
+    scenario_result_t clean, lossy;
+    run_scenario("fast_clean", FAST_LINK_BPS, 0, &clean);
+    run_scenario("fast_lossy", FAST_LINK_BPS, LOSS_LOSSY_PERCENT, &lossy);
+
+    TEST_ASSERT_TRUE(g_channel.dropped > 0);
+    TEST_ASSERT_TRUE_MESSAGE(lossy.voice_packets_rx <= clean.voice_packets_rx,
+                             "more voice than was sent");
+
+    // parity משחזר חבילה בודדת שאבדה בקבוצה
+    TEST_ASSERT_TRUE_MESSAGE(lossy.fec_recovered > 0, "FEC recovered nothing");
+    TEST_ASSERT_TRUE_MESSAGE(lossy.latency.loss_pct < LOSS_LOSSY_PERCENT,
+                             "FEC did not reduce the audible loss below the channel loss");
+}
+
+static void test_repeatable(void) {
+    scenario_result_t first, second;
+    run_scenario("repeat_1", LORA_LINK, LOSS_LOSSY_PERCENT, &first);
+    run_scenario("repeat_2", LORA_LINK, LOSS_LOSSY_PERCENT, &second);
+
+    TEST_ASSERT_TRUE(first.latency.lost == second.latency.lost);
+    TEST_ASSERT_TRUE(first.latency.latency_ms == second.latency.latency_ms);
+    TEST_ASSERT_TRUE(first.latency.latency_max_ms == second.latency.latency_max_ms);
+    TEST_ASSERT_TRUE(first.tx_queue_dropped == second.tx_queue_dropped);
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+
+    make_input();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_airtime);
+    RUN_TEST(test_clean_channel);
+    RUN_TEST(test_pipeline_latency);
+    RUN_TEST(test_lossy_channel);
+    RUN_TEST(test_repeatable);
+    return UNITY_END();
+}
@@ -0,0 +1,183 @@
+/**
+ * @file test_voice_fec.c
+ * @brief שחזור חבילות קול מ-parity ושחרור לפי הסדר - רץ ב-env:native
+ *
+ *   pio test -e native -f test_voice_fec -v
+ *
+ * המקודד בונה parity לקבוצה, המפענח מקבל את הקבוצה עם חבילה חסרה
+ * (או בלי) ומשחרר ל-callback. נבדק שהחבילה המשוחזרת זהה בבית למקור,
+ * שהסדר נשמר, ושכל frame משוחרר עם audio_data מיושר ל-int16 - הצרכן
+ * (core/voice_path) קורא אותו כ-int16, וב-Xtensa גישה לא מיושרת נופלת
+ * ב-LoadStoreAlignment.
+ */
+
+#include <unity.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "comm/voice_fec.h"
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+#define GROUP_SIZE          4
+#define MAX_RELEASED        32
+
+typedef struct {
+    voice_data_t frames[MAX_RELEASED];
+    bool recovered[MAX_RELEASED];
+    uint8_t count;
+    uint8_t misaligned;
+} release_log_t;
+
+static release_log_t g_log;
+static voice_fec_decoder_t g_decoder;
+static voice_fec_encoder_t g_encoder;
+
+static void on_release(const voice_data_t* voice, bool recovered, void* user_data) {
+    release_log_t* log = (release_log_t*)user_data;
+    if ((uintptr_t)voice->audio_data % sizeof(int16_t) != 0) {
+        log->misaligned++;
+    }
+    TEST_ASSERT_TRUE(log->count < MAX_RELEASED);
+    memcpy(&log->frames[log->count], voice, sizeof(voice_data_t));
+    log->recovered[log->count] = recovered;
+    log->count++;
+}
+
+// חבילה עם תוכן שונה לכל sequence ואורך משתנה (parity_len = המקסימום)
+static void make_voice(voice_data_t* voice, uint16_t sequence) {
+    memset(voice, 0, sizeof(*voice));
+    voice->sequence = sequence;
+    voice->timestamp = 1000u + sequence * 10u;
+    voice->audio_len = (uint16_t)(AUDIO_BUFFER_SIZE - 2 * (sequence % 3));
+
+    int16_t samples[AUDIO_BUFFER_SIZE / sizeof(int16_t)];
+    for (uint16_t i = 0; i < voice->audio_len / sizeof(int16_t); i++) {
+        samples[i] = (int16_t)(sequence * 977 + i * 131 - 16000);
+    }
+    memcpy(voice->audio_data, samples, voice->audio_len);
+}
+
+static void assert_same_voice(const voice_data_t* expected, const voice_data_t* actual) {
+    TEST_ASSERT_TRUE(expected->sequence == actual->sequence);
+    TEST_ASSERT_TRUE(expected->timestamp == actual->timestamp);
+    TEST_ASSERT_TRUE(expected->audio_len == actual->audio_len);
+    TEST_ASSERT_TRUE(memcmp(expected->audio_data, actual->audio_data, expected->audio_len) == 0);
+}
+
+/**
+ * @brief קבוצה אחת דרך מקודד ומפענח; lost_index = חבילה שלא מגיעה (-1 = אין)
+ */
+static void run_group(uint16_t base, int lost_index, voice_data_t sent[GROUP_SIZE]) {
+    static voice_fec_parity_t parity;
+    uint16_t parity_len = 0;
+
+    for (int i = 0; i < GROUP_SIZE; i++) {
+        make_voice(&sent[i], (uint16_t)(base + i));
+        parity_len = voice_fec_encoder_add(&g_encoder, &sent[i], &parity);
+        TEST_ASSERT_TRUE((i == GROUP_SIZE - 1) == (parity_len > 0));
+
+        if (i != lost_index) {
+            voice_fec_decoder_push_voice(&g_decoder, &sent[i], on_release, &g_log);
+        }
+    }
+    voice_fec_decoder_push_parity(&g_decoder, &parity, parity_len, on_release, &g_log);
+}
+
+// =============================================================================
+// Tests
+// =============================================================================
+
+void setUp(void) {
+    memset(&g_log, 0, sizeof(g_log));
+    voice_fec_encoder_init(&g_encoder, GROUP_SIZE);
+    voice_fec_decoder_init(&g_decoder, GROUP_SIZE);
+    voice_fec_reset_stats();
+}
+
+void tearDown(void) {}
+
+static void test_frames_aligned(void) {
+    // frames[] של המפענח: כל audio_data מיושר, גם ב-decoder שאינו מיושר בעצמו
+    for (int i = 0; i < VOICE_FEC_MAX_GROUP; i++) {
+        TEST_ASSERT_TRUE((uintptr_t)g_decoder.frames[i].audio_data % sizeof(int16_t) == 0);
+    }
+}
+
+static void test_no_loss_in_order(void) {
+    voice_data_t sent[GROUP_SIZE];
+    run_group(0, -1, sent);
+
+    TEST_ASSERT_TRUE(g_log.count == GROUP_SIZE);
+    TEST_ASSERT_TRUE(g_log.misaligned == 0);
+    for (int i = 0; i < GROUP_SIZE; i++) {
+        TEST_ASSERT_FALSE(g_log.recovered[i]);
+        assert_same_voice(&sent[i], &g_log.frames[i]);
+    }
+}
+
+static void test_recover_each_position(void) {
+    // המפענח מתחיל מה-frame הראשון שהגיע - קבוצה נקייה קודם,
+    // כדי שחבילה 0 חסרה תיחשב חור ולא תחילת שידור
+    voice_data_t sent[GROUP_SIZE];
+    run_group(0, -1, sent);
+
+    for (int lost = 0; lost < GROUP_SIZE; lost++) {
+        uint8_t start = g_log.count;
+        uint16_t base = (uint16_t)(GROUP_SIZE * (lost + 1));
+
+        run_group(base, lost, sent);
+
+        TEST_ASSERT_TRUE(g_log.count - start == GROUP_SIZE);
+        for (int i = 0; i < GROUP_SIZE; i++) {
+            TEST_ASSERT_TRUE(g_log.recovered[start + i] == (i == lost));
+            assert_same_voice(&sent[i], &g_log.frames[start + i]);
+        }
+    }
+
+    TEST_ASSERT_TRUE_MESSAGE(g_log.misaligned == 0, "released audio_data not int16-aligned");
+    TEST_ASSERT_TRUE(voice_fec_get_stats()->frames_recovered == GROUP_SIZE);
+    TEST_ASSERT_TRUE(voice_fec_get_stats()->frames_lost == 0);
+}
+
+static void test_two_lost_not_recovered(void) {
+    voice_data_t sent[GROUP_SIZE];
+    static voice_fec_parity_t parity;
+    uint16_t parity_len = 0;
+
+    for (int i = 0; i < GROUP_SIZE; i++) {
+        make_voice(&sent[i], (uint16_t)i);
+        parity_len = voice_fec_encoder_add(&g_encoder, &sent[i], &parity);
+        if (i != 1 && i != 2) {
+            voice_fec_decoder_push_voice(&g_decoder, &sent[i], on_release, &g_log);
+        }
+    }
+    voice_fec_decoder_push_parity(&g_decoder, &parity, parity_len, on_release, &g_log);
+
+    // XOR משחזר רק חבילה אחת - השאר משתחרר בלי להמציא אודיו
+    TEST_ASSERT_TRUE(g_log.count == 2);
+    assert_same_voice(&sent[0], &g_log.frames[0]);
+    assert_same_voice(&sent[3], &g_log.frames[1]);
+    TEST_ASSERT_TRUE(voice_fec_get_stats()->frames_recovered == 0);
+}
+
+static int run_tests(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_frames_aligned);
+    RUN_TEST(test_no_loss_in_order);
+    RUN_TEST(test_recover_each_position);
+    RUN_TEST(test_two_lost_not_recovered);
+    return UNITY_END();
+}
+
+#ifdef ESP_PLATFORM
+void app_main(void) {
+    run_tests();
+}
+#else
+int main(void) {
+    return run_tests();
+}
+#endif
@@ -0,0 +1,251 @@
+/**
+ * @file test_voice_hc.c
+ * @brief דחיסת header על רצף אמיתי של protocol_send_voice - רץ ב-env:native
+ *
+ *   pio test -e native -f test_voice_hc -v
+ *
+ * המכשיר מחייג לעצמו דרך הרדיו המדומה (בתהליך אחד השולח והמקבל הם אותו
+ * protocol), כך שה-sessions של הדחיסה נקבעים כמו בשיחה. אחר כך frames של
+ * 20ms נשלחים ב-protocol_send_voice, כל frame בשתי חבילות. כל חבילה
+ * שיוצאת לאוויר נרשמת ומוחזרת כקבלה. נבדק:
+ * - חבילה מלאה רק בתחילת השידור ואחת ל-VOICE_HC_REFRESH_INTERVAL
+ * - כל חבילה דחוסה עם header מינימלי (ה-timestamp צפוי)
+ * - sequence, timestamp ואודיו שמתקבלים זהים למה שנשלח
+ */
+
+#include <unity.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "config.h"
+#include "comm/protocol.h"
+#include "comm/radio.h"
+#include "comm/voice_hc.h"
+#include "core/audio_buffer.h"
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#define LOCAL_ID            "12345678"
+#define FRAME_BYTES         (AUDIO_FRAME_SAMPLES * sizeof(int16_t))
+#define PACKETS_PER_FRAME   2
+#define PACKET_AUDIO_LEN    (FRAME_BYTES / PACKETS_PER_FRAME)
+#define PACKET_MS           (AUDIO_FRAME_DURATION_MS / PACKETS_PER_FRAME)
+
+// רענון אחד באמצע ועוד קצת אחריו
+#define TEST_PACKETS        (VOICE_HC_REFRESH_INTERVAL + 20)
+#define TEST_FRAMES         (TEST_PACKETS / PACKETS_PER_FRAME)
+
+#define AIR_MAX_PACKETS     8
+
+// =============================================================================
+// Simulated Air
+// =============================================================================
+
+typedef struct {
+    uint8_t data[RADIO_MAX_PACKET_SIZE];
+    uint8_t length;
+} air_packet_t;
+
+static air_packet_t g_air[AIR_MAX_PACKETS];
+static uint8_t g_air_count;
+
+// כל חבילת קול שיצאה: דחוסה או מלאה, וגודל ה-header
+static uint16_t g_voice_tx;
+static uint16_t g_full_tx;
+static uint16_t g_full_at[4];
+static uint16_t g_min_header_tx;
+
+static void on_air(const uint8_t* data, uint8_t length, void* ctx) {
+    (void)ctx;
+    TEST_ASSERT_TRUE(g_air_count < AIR_MAX_PACKETS);
+    memcpy(g_air[g_air_count].data, data, length);
+    g_air[g_air_count].length = length;
+    g_air_count++;
+
+    if (voice_hc_is_compressed(data, length)) {
+        if (length - PACKET_AUDIO_LEN == VOICE_HC_MIN_HEADER) {
+            g_min_header_tx++;
+        }
+        g_voice_tx++;
+        return;
+    }
+
+    packet_header_t header;
+    const void* payload;
+    if (protocol_parse_packet(data, length, &header, &payload) &&
+        header.msg_type == MSG_VOICE_DATA) {
+        if (g_full_tx < sizeof(g_full_at) / sizeof(g_full_at[0])) {
+            g_full_at[g_full_tx] = g_voice_tx;
+        }
+        g_full_tx++;
+        g_voice_tx++;
+    }
+}
+
+/**
+ * @brief TX done לכל מה שבתור, ואז קבלה של מה שיצא - עד שהאוויר ריק
+ */
+static void pump(void) {
+    while (radio_get_state() == RADIO_STATE_TX || g_air_count > 0) {
+        while (radio_get_state() == RADIO_STATE_TX) {
+            radio_update();
+        }
+
+        uint8_t count = g_air_count;
+        static air_packet_t pending[AIR_MAX_PACKETS];
+        memcpy(pending, g_air, sizeof(air_packet_t) * count);
+        g_air_count = 0;
+        for (uint8_t i = 0; i < count; i++) {
+            sim_radio_receive(pending[i].data, pending[i].length, -60, 8);
+        }
+    }
+}
+
+// =============================================================================
+// Receiver
+// =============================================================================
+
+static voice_data_t g_rx[TEST_PACKETS];
+static uint16_t g_rx_count;
+static bool g_call_accepted;
+
+static void on_message(message_type_t type, const char* src_id,
+                       const void* payload, uint16_t len) {
+    switch (type) {
+        case MSG_CALL_REQUEST:
+            protocol_send_call_response(src_id, true);
+            break;
+
+        case MSG_CALL_ACCEPT:
+            g_call_accepted = true;
+            break;
+
+        case MSG_VOICE_DATA:
+            TEST_ASSERT_TRUE(len >= sizeof(voice_data_t));
+            TEST_ASSERT_TRUE(g_rx_count < TEST_PACKETS);
+            memcpy(&g_rx[g_rx_count++], payload, sizeof(voice_data_t));
+            break;
+
+        default:
+            break;
+    }
+}
+
+// =============================================================================
+// Tests
+// =============================================================================
+
+static uint8_t g_frames[TEST_FRAMES][FRAME_BYTES];
+
+void setUp(void) {
+    protocol_init();
+    protocol_set_device_id(LOCAL_ID);
+    protocol_set_callback(on_message);
+    // בלי parity - כל חבילה באוויר היא חבילת קול
+    protocol_set_fec_group_size(0);
+    sim_radio_set_air(on_air, NULL);
+
+    g_air_count = 0;
+    g_voice_tx = 0;
+    g_full_tx = 0;
+    g_min_header_tx = 0;
+    g_rx_count = 0;
+    g_call_accepted = false;
+
+    uint32_t seed = 7;
+    for (int f = 0; f < TEST_FRAMES; f++) {
+        for (size_t i = 0; i < FRAME_BYTES; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            g_frames[f][i] = (uint8_t)(seed >> 24);
+        }
+    }
+}
+
+void tearDown(void) {
+    sim_radio_set_air(NULL, NULL);
+}
+
+static void test_send_voice_roundtrip(void) {
+    protocol_send_call_request(LOCAL_ID);
+    pump();
+    TEST_ASSERT_TRUE_MESSAGE(g_call_accepted, "call not set up");
+
+    for (int f = 0; f < TEST_FRAMES; f++) {
+        protocol_send_voice(g_frames[f], FRAME_BYTES);
+        pump();
+    }
+
+    // חבילה מלאה בתחילה ואחרי REFRESH_INTERVAL חבילות דחוסות
+    TEST_ASSERT_TRUE(g_voice_tx == TEST_PACKETS);
+    TEST_ASSERT_TRUE(g_full_tx == 2);
+    TEST_ASSERT_TRUE(g_full_at[0] == 0);
+    TEST_ASSERT_TRUE(g_full_at[1] == VOICE_HC_REFRESH_INTERVAL + 1);
+    TEST_ASSERT_TRUE_MESSAGE(g_min_header_tx == TEST_PACKETS - g_full_tx,
+                             "compressed packet with an explicit timestamp");
+
+    // כל חבילה חוזרת כמו שנשלחה; ה-timestamp מתקדם במשך האודיו שבחבילה
+    TEST_ASSERT_TRUE(g_rx_count == TEST_PACKETS);
+    for (int i = 0; i < TEST_PACKETS; i++) {
+        const voice_data_t* voice = &g_rx[i];
+        TEST_ASSERT_TRUE(voice->sequence == (uint16_t)(g_rx[0].sequence + i));
+        TEST_ASSERT_TRUE(voice->timestamp == g_rx[0].timestamp + (uint32_t)i * PACKET_MS);
+        TEST_ASSERT_TRUE(voice->audio_len == PACKET_AUDIO_LEN);
+        TEST_ASSERT_EQUAL_MEMORY(&g_frames[i / PACKETS_PER_FRAME][(i % PACKETS_PER_FRAME) * PACKET_AUDIO_LEN],
+                                 voice->audio_data, PACKET_AUDIO_LEN);
+    }
+}
+
+static void test_unpredicted_timestamp_is_explicit(void) {
+    voice_hc_tx_t tx;
+    voice_hc_rx_t rx;
+    voice_hc_tx_init(&tx, 9);
+    voice_hc_rx_init(&rx, 9, LOCAL_ID);
+
+    uint8_t out[RADIO_MAX_PACKET_SIZE];
+    voice_data_t voice, restored;
+    memset(&voice, 0, sizeof(voice));
+    voice.sequence = 500;
+    voice.timestamp = 123456;
+    voice.audio_len = PACKET_AUDIO_LEN;
+    memcpy(voice.audio_data, g_frames[0], PACKET_AUDIO_LEN);
+
+    TEST_ASSERT_TRUE(voice_hc_compress(&tx, &voice, out, sizeof(out)) == 0);
+    voice_hc_rx_refresh(&rx, &voice);
+
+    // חבילה בקצב הצפוי - header מינימלי
+    voice.sequence++;
+    voice.timestamp += PACKET_MS;
+    uint16_t len = voice_hc_compress(&tx, &voice, out, sizeof(out));
+    TEST_ASSERT_TRUE(len == VOICE_HC_MIN_HEADER + PACKET_AUDIO_LEN);
+    TEST_ASSERT_TRUE(voice_hc_decompress(&rx, out, len, &restored));
+    TEST_ASSERT_TRUE(restored.timestamp == voice.timestamp);
+
+    // קפיצה בשעון המדיה (פער DTX) - delta מפורש, ומשוחזר בדיוק
+    voice.sequence++;
+    voice.timestamp += 300;
+    len = voice_hc_compress(&tx, &voice, out, sizeof(out));
+    TEST_ASSERT_TRUE(len == VOICE_HC_MAX_HEADER + PACKET_AUDIO_LEN);
+    TEST_ASSERT_TRUE(voice_hc_decompress(&rx, out, len, &restored));
+    TEST_ASSERT_TRUE(restored.timestamp == voice.timestamp);
+    TEST_ASSERT_TRUE(restored.sequence == voice.sequence);
+    TEST_ASSERT_EQUAL_MEMORY(voice.audio_data, restored.audio_data, PACKET_AUDIO_LEN);
+}
+
+static int run_tests(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_send_voice_roundtrip);
+    RUN_TEST(test_unpredicted_timestamp_is_explicit);
+    return UNITY_END();
+}
+
+#ifdef ESP_PLATFORM
+void app_main(void) {
+    run_tests();
+}
+#else
+int main(void) {
+    return run_tests();
+}
+#endif